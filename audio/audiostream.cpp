@@ -453,6 +453,7 @@ public:
 	bool endOfStream() const override { return _parentStream->endOfStream() || reachedLimit(); }
 	bool isStereo() const override { return _parentStream->isStereo(); }
 	int getRate() const override { return _parentStream->getRate(); }
+	AudioStreamType getStreamType() const override { return _parentStream->getStreamType(); }
 
 private:
 	int getChannels() const { return isStereo() ? 2 : 1; }
@@ -43,6 +43,21 @@ namespace Audio {
  * @{
  */
 
+/**
+ * Kind of audio data produced by a stream. This is only used to break down
+ * the mixer statistics.
+ */
+enum AudioStreamType {
+	kAudioStreamOther,
+	kAudioStreamRaw,
+	kAudioStreamADPCM,
+	kAudioStreamMP3,
+	kAudioStreamVorbis,
+	kAudioStreamFLAC,
+	kAudioStreamSynth,	///< Software synthesizers and emulated sound chips
+	kAudioStreamTypeCount
+};
+
 /**
  * Generic audio input stream. Subclasses of this are used to feed arbitrary
  * sampled audio data into ScummVM's audio mixer.
@@ -97,6 +112,12 @@ public:
 	 * By default, this maps to endOfData().
 	 */
 	virtual bool endOfStream() const { return endOfData(); }
+
+	/**
+	 * Return the kind of audio data this stream produces, for statistics.
+	 * Streams wrapping another stream should return the type of that stream.
+	 */
+	virtual AudioStreamType getStreamType() const { return kAudioStreamOther; }
 };
 
 /**
@@ -144,6 +165,7 @@ public:
 
 	bool isStereo() const { return _parent->isStereo(); }
 	int getRate() const { return _parent->getRate(); }
+	AudioStreamType getStreamType() const { return _parent->getStreamType(); }
 
 	/**
 	 * Return the number of loops that the stream has played.
@@ -279,6 +301,7 @@ public:
 
 	bool isStereo() const { return _parent->isStereo(); }
 	int getRate() const { return _parent->getRate(); }
+	AudioStreamType getStreamType() const { return _parent->getStreamType(); }
 private:
 	Common::DisposablePtr<SeekableAudioStream> _parent;
 
@@ -318,6 +341,7 @@ public:
 
 	bool endOfData() const { return (_pos >= _length) || _parent->endOfData(); }
 	bool endOfStream() const { return (_pos >= _length) || _parent->endOfStream(); }
+	AudioStreamType getStreamType() const { return _parent->getStreamType(); }
 
 	bool seek(const Timestamp &where);
 
@@ -65,6 +65,7 @@ public:
 	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos); }
 	virtual bool isStereo() const { return _channels == 2; }
 	virtual int getRate() const { return _rate; }
+	virtual AudioStreamType getStreamType() const { return kAudioStreamADPCM; }
 
 	virtual bool rewind();
 	virtual bool seek(const Timestamp &where) { return false; }
@@ -130,6 +130,7 @@ public:
 
 	bool isStereo() const override { return _streaminfo.channels >= 2; }
 	int getRate() const override { return _streaminfo.sample_rate; }
+	AudioStreamType getStreamType() const override { return kAudioStreamFLAC; }
 	bool endOfData() const override {
 		// End of data is reached if there either is no valid stream data available,
 		// or if we reached the last sample and completely emptied the sample cache.
@@ -55,6 +55,7 @@ public:
 	bool endOfData() const override { return _state == MP3_STATE_EOS; }
 	bool isStereo() const override { return _channels == 2; }
 	int getRate() const override { return _rate; }
+	AudioStreamType getStreamType() const override { return kAudioStreamMP3; }
 
 protected:
 	void decodeMP3Data(Common::ReadStream &stream);
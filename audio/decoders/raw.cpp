@@ -59,6 +59,7 @@ public:
 	bool endOfData() const override { return _endOfData; }
 
 	int getRate() const override         { return _rate; }
+	AudioStreamType getStreamType() const override { return kAudioStreamRaw; }
 	Timestamp getLength() const override { return _playtime; }
 
 	bool seek(const Timestamp &where) override;
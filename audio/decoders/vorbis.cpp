@@ -112,6 +112,7 @@ public:
 	bool endOfData() const override		{ return _pos >= _bufferEnd; }
 	bool isStereo() const override		{ return _isStereo; }
 	int getRate() const override			{ return _rate; }
+	AudioStreamType getStreamType() const override { return kAudioStreamVorbis; }
 
 	bool seek(const Timestamp &where) override;
 	Timestamp getLength() const override { return _length; }
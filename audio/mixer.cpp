@@ -21,6 +21,10 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/atomic.h"
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/timer.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -42,7 +46,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, ResamplerQuality quality);
 	~Channel();
 
 	/**
@@ -121,7 +125,8 @@ public:
 	void notifyGlobalVolChange() { updateChannelVolumes(); }
 
 	/**
-	 * Queries how long the channel has been playing.
+	 * Queries how long the channel has been playing. Unlike the other
+	 * methods, this may be called while the mixer thread uses the channel.
 	 */
 	Timestamp getElapsedTime();
 
@@ -147,11 +152,32 @@ public:
 	 */
 	SoundHandle getHandle() const { return _handle; }
 
+	/**
+	 * Queries the kind of audio stream played by the channel.
+	 */
+	AudioStreamType getStreamType() const { return _streamType; }
+
+	/**
+	 * Accounts time spent in mix() to the channel's statistics.
+	 *
+	 * @param micros time spent, in microseconds
+	 * @param frames number of sample pairs mixed in that time
+	 */
+	void addMixStatistics(uint32 micros, uint32 frames) { _statMicros += micros; _statFrames += frames; }
+
+	/**
+	 * Discards the channel's statistics.
+	 */
+	void resetStatistics() { _statMicros = _statFrames = 0; }
+
+	uint64 getStatisticsMicros() const { return _statMicros; }
+	uint64 getStatisticsFrames() const { return _statFrames; }
+
 private:
 	const Mixer::SoundType _type;
 	SoundHandle _handle;
 	bool _permanent;
-	int _pauseLevel;
+	volatile int _pauseLevel;
 	int _id;
 
 	byte _volume;
@@ -162,14 +188,21 @@ private:
 
 	Mixer *_mixer;
 
-	uint32 _samplesConsumed;
+	// The timing values are read by getElapsedTime() on engine threads.
+	// _timingSeq is odd while the mixer thread updates them.
+	volatile uint32 _timingSeq;
+	volatile uint32 _samplesConsumed;
 	uint32 _samplesDecoded;
-	uint32 _mixerTimeStamp;
-	uint32 _pauseStartTime;
-	uint32 _pauseTime;
+	volatile uint32 _mixerTimeStamp;
+	volatile uint32 _pauseStartTime;
+	volatile uint32 _pauseTime;
 
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
+	AudioStreamType _streamType;
+
+	uint64 _statMicros;
+	uint64 _statFrames;
 };
 
 #pragma mark -
@@ -177,17 +210,38 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _resamplerQuality(kResamplerLinear), _soundTypeSettings(),
+	  _mixEpoch(0), _statsEnabled(false) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	if (ConfMan.get("audio_resampler") == "sinc")
+		_resamplerQuality = kResamplerSinc;
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = nullptr;
+		_slots[i].channel = nullptr;
+	}
+
+	memset(&_stats, 0, sizeof(_stats));
 }
 
 MixerImpl::~MixerImpl() {
+	if (_statsEnabled && g_system->getTimerManager())
+		g_system->getTimerManager()->removeTimerProc(&statisticsTimerProc);
+
+	// Channels started since the last callback are still queued
+	{
+		Common::StackLock lock(_mutex);
+		applyCommands();
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	Channel *chan;
+	while (_retiredChannels.pop(chan))
+		delete chan;
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -204,29 +258,165 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
-	int index = -1;
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == nullptr) {
-			index = i;
-			break;
+void MixerImpl::postCommand(Command::Type type, uint32 handle, int value) {
+	Command cmd;
+	cmd.type = type;
+	cmd.handle = handle;
+	cmd.value = value;
+	cmd.channel = nullptr;
+
+	freeRetiredChannels();
+
+	for (;;) {
+		{
+			Common::StackLock lock(_commandMutex);
+			if (_commands.push(cmd))
+				return;
 		}
+
+		// The queue is full, so apply the queued commands right away and
+		// try again. _commandMutex has been released first, so that other
+		// threads posting commands do not have to wait for the mixer
+		// callback as well.
+		flushCommands();
 	}
-	if (index == -1) {
-		warning("MixerImpl::out of mixer slots");
-		delete chan;
+}
+
+void MixerImpl::flushCommands() {
+	// Must be called without _commandMutex held
+	Common::StackLock lock(_mutex);
+	applyCommands();
+}
+
+int MixerImpl::applyCommands() {
+	// Must be called with _mutex held
+	int count = 0;
+	Command cmd;
+	while (_commands.pop(cmd)) {
+		applyCommand(cmd);
+		count++;
+	}
+	return count;
+}
+
+void MixerImpl::applyCommand(const Command &cmd) {
+	if (cmd.type == Command::kStart) {
+		// The slot is only handed out again once its old channel was deleted
+		const int index = cmd.handle % NUM_CHANNELS;
+		assert(!_channels[index]);
+		_channels[index] = cmd.channel;
+
+		if (_statsEnabled)
+			_stats.streamTypes[cmd.channel->getStreamType()].channels++;
+		return;
+	} else if (cmd.type == Command::kPauseAll) {
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (_channels[i])
+				_channels[i]->pause(cmd.value != 0);
+		}
 		return;
+	} else if (cmd.type == Command::kGlobalVolumeChange) {
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (_channels[i] && _channels[i]->getType() == (SoundType)cmd.handle)
+				_channels[i]->notifyGlobalVolChange();
+		}
+		return;
+	}
+
+	// Simply ignore requests for handles of sounds that already terminated
+	const int index = cmd.handle % NUM_CHANNELS;
+	if (!_channels[index] || _channels[index]->getHandle()._val != cmd.handle)
+		return;
+
+	switch (cmd.type) {
+	case Command::kStop:
+		retireChannel(index);
+		break;
+	case Command::kSetVolume:
+		_channels[index]->setVolume((byte)cmd.value);
+		break;
+	case Command::kSetBalance:
+		_channels[index]->setBalance((int8)cmd.value);
+		break;
+	case Command::kPause:
+		_channels[index]->pause(cmd.value != 0);
+		break;
+	default:
+		break;
 	}
+}
+
+void MixerImpl::retireChannel(int index) {
+	// Must be called with _mutex held
 
-	_channels[index] = chan;
+	// The engine thread which deletes the channel also frees its slot
+	if (!_retiredChannels.push(_channels[index]))
+		error("MixerImpl::retireChannel(): Too many retired channels");
+	_channels[index] = nullptr;
+}
 
-	SoundHandle chanHandle;
-	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+void MixerImpl::freeRetiredChannels() {
+	// Must be called without _mutex held, from an engine thread
+	Channel *retired[64];
+	int count = 0;
+
+	{
+		Common::StackLock lock(_commandMutex);
+		while (count < ARRAYSIZE(retired) && _retiredChannels.pop(retired[count])) {
+			ChannelSlot &slot = _slots[retired[count]->getHandle()._val % NUM_CHANNELS];
+			assert(slot.channel == retired[count]);
+			slot.channel = nullptr;
+			count++;
+		}
+	}
 
-	chan->setHandle(chanHandle);
-	_handleSeed++;
-	if (handle)
-		*handle = chanHandle;
+	for (int i = 0; i < count; ++i)
+		delete retired[i];
+}
+
+MixerImpl::ChannelSlot *MixerImpl::findSlot(SoundHandle handle) {
+	// Must be called with _commandMutex held
+	const int index = handle._val % NUM_CHANNELS;
+	if (!isSlotActive(index) || _slots[index].handle != handle._val)
+		return nullptr;
+	return &_slots[index];
+}
+
+void MixerImpl::stopSlot(int index, uint32 handle) {
+	// Must be called without _commandMutex held
+	Command cmd;
+	cmd.type = Command::kStop;
+	cmd.handle = handle;
+	cmd.value = 0;
+	cmd.channel = nullptr;
+
+	for (;;) {
+		{
+			Common::StackLock lock(_commandMutex);
+
+			// Simply ignore stop requests for sounds that already terminated
+			if (!isSlotActive(index) || _slots[index].handle != handle)
+				return;
+
+			if (_commands.push(cmd)) {
+				_slots[index].stopped = true;
+				return;
+			}
+		}
+
+		// The queue is full
+		flushCommands();
+	}
+}
+
+void MixerImpl::waitForMixer() {
+	// Commands which have been queued are applied by the next callback
+	// before it mixes anything. Only a callback which is mixing right now
+	// may still read from the streams of the channels just stopped, so
+	// wait for it to finish by taking the lock it holds.
+	if (Common::atomicAdd(&_mixEpoch, 0U) & 1) {
+		Common::StackLock lock(_mutex);
+	}
 }
 
 void MixerImpl::playStream(
@@ -237,7 +427,7 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
-	Common::StackLock lock(_mutex);
+	freeRetiredChannels();
 
 	if (stream == nullptr) {
 		warning("stream is 0");
@@ -247,37 +437,88 @@ void MixerImpl::playStream(
 
 	assert(_mixerReady);
 
-	// Prevent duplicate sounds
-	if (id != -1) {
-		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-				// Delete the stream if were asked to auto-dispose it.
-				// Note: This could cause trouble if the client code does not
-				// yet expect the stream to be gone. The primary example to
-				// keep in mind here is QueuingAudioStream.
-				// Thus, as a quick rule of thumb, you should never, ever,
-				// try to play QueuingAudioStreams with a sound id.
-				if (autofreeStream == DisposeAfterUse::YES)
-					delete stream;
-				return;
-			}
-	}
-
 #ifdef AUDIO_REVERSE_STEREO
 	reverseStereo = !reverseStereo;
 #endif
 
-	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	// Create the channel. The mixer picks it up from the command queue.
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _resamplerQuality);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
-	insertChannel(handle, chan);
+
+	Command cmd;
+	cmd.type = Command::kStart;
+	cmd.value = 0;
+	cmd.channel = chan;
+
+	for (;;) {
+		{
+			Common::StackLock lock(_commandMutex);
+
+			// Prevent duplicate sounds
+			if (id != -1) {
+				for (int i = 0; i != NUM_CHANNELS; i++)
+					if (isSlotActive(i) && _slots[i].id == id) {
+						// Delete the stream if were asked to auto-dispose it.
+						// Note: This could cause trouble if the client code does not
+						// yet expect the stream to be gone. The primary example to
+						// keep in mind here is QueuingAudioStream.
+						// Thus, as a quick rule of thumb, you should never, ever,
+						// try to play QueuingAudioStreams with a sound id.
+						delete chan;
+						return;
+					}
+			}
+
+			int index = -1;
+			for (int i = 0; i != NUM_CHANNELS; i++) {
+				if (_slots[i].channel == nullptr) {
+					index = i;
+					break;
+				}
+			}
+			if (index == -1) {
+				warning("MixerImpl::out of mixer slots");
+				delete chan;
+				return;
+			}
+
+			SoundHandle chanHandle;
+			chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+			chan->setHandle(chanHandle);
+			cmd.handle = chanHandle._val;
+
+			if (_commands.push(cmd)) {
+				ChannelSlot &slot = _slots[index];
+				slot.channel = chan;
+				slot.handle = chanHandle._val;
+				slot.id = id;
+				slot.type = type;
+				slot.permanent = permanent;
+				slot.stopped = false;
+				slot.volume = volume;
+				slot.balance = balance;
+
+				_handleSeed++;
+				if (handle)
+					*handle = chanHandle;
+				return;
+			}
+		}
+
+		// The queue is full
+		flushCommands();
+	}
 }
 
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
 	Common::StackLock lock(_mutex);
+	Common::atomicAdd(&_mixEpoch, 1U);
+
+	const bool statsEnabled = _statsEnabled;
+	const uint64 startMicros = g_system->getMicros();
 
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
@@ -287,6 +528,9 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	// Apply the changes requested by the engine since the last callback
+	const int commands = applyCommands();
+
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
@@ -295,59 +539,212 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
+				retireChannel(i);
 			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
+				if (statsEnabled) {
+					const uint64 chanStart = g_system->getMicros();
+					tmp = _channels[i]->mix(buf, len);
+					const uint32 micros = (uint32)(g_system->getMicros() - chanStart);
+
+					_channels[i]->addMixStatistics(micros, tmp);
+					StreamTypeStats &typeStats = _stats.streamTypes[_channels[i]->getStreamType()];
+					typeStats.micros += micros;
+					typeStats.frames += tmp;
+				} else {
+					tmp = _channels[i]->mix(buf, len);
+				}
 
 				if (tmp > res)
 					res = tmp;
 			}
 		}
 
+	_callbackStats.callbacks++;
+	_callbackStats.commandsApplied += commands;
+	_callbackStats.lastCommands = commands;
+	_callbackStats.maxCommands = MAX<uint32>(_callbackStats.maxCommands, commands);
+
+	const uint32 micros = (uint32)(g_system->getMicros() - startMicros);
+	_callbackStats.maxDuration = MAX(_callbackStats.maxDuration, micros);
+
+	if (statsEnabled) {
+		// The callback has to finish before the audio it produced has been played
+		const uint32 deadline = (uint32)((uint64)len * 1000000 / _sampleRate);
+
+		_stats.callbacks++;
+		_stats.totalMicros += micros;
+		_stats.maxMicros = MAX(_stats.maxMicros, micros);
+		if (micros > deadline)
+			_stats.underruns++;
+
+		int bucket = 0;
+		while (bucket < kHistogramBuckets - 1 && micros >= (250U << bucket))
+			bucket++;
+		_stats.histogram[bucket]++;
+	}
+
+	Common::atomicAdd(&_mixEpoch, 1U);
 	return res;
 }
 
-void MixerImpl::stopAll() {
+void MixerImpl::enableStatistics(bool enable) {
+	{
+		Common::StackLock lock(_mutex);
+		if (_statsEnabled == enable)
+			return;
+
+		if (enable && !_stats.startTime)
+			_stats.startTime = g_system->getMicros();
+		_statsEnabled = enable;
+	}
+
+	// The timer manager must not be called with _mutex held, since the
+	// timer proc takes it, too.
+	Common::TimerManager *timer = g_system->getTimerManager();
+	if (!timer)
+		return;
+
+	if (enable)
+		timer->installTimerProc(&statisticsTimerProc, kStatisticsLogInterval, this, "MixerStatistics");
+	else
+		timer->removeTimerProc(&statisticsTimerProc);
+}
+
+void MixerImpl::resetStatistics() {
 	Common::StackLock lock(_mutex);
+
+	memset(&_stats, 0, sizeof(_stats));
+	_stats.startTime = g_system->getMicros();
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
-		}
+		if (_channels[i])
+			_channels[i]->resetStatistics();
 	}
 }
 
-void MixerImpl::stopID(int id) {
+static const char *const streamTypeNames[kAudioStreamTypeCount] = {
+	"other",
+	"raw",
+	"ADPCM",
+	"MP3",
+	"Vorbis",
+	"FLAC",
+	"synth"
+};
+
+static const char *const soundTypeNames[] = {
+	"plain",
+	"music",
+	"sfx",
+	"speech"
+};
+
+Common::String MixerImpl::getStatisticsReport() {
 	Common::StackLock lock(_mutex);
+	applyCommands();
+
+	const uint64 now = g_system->getMicros();
+	const uint32 elapsed = _stats.startTime ? (uint32)((now - _stats.startTime) / 1000) : 0;
+
+	Common::String report = Common::String::format("Mixer statistics over %u.%03u s (%s):\n",
+		elapsed / 1000, elapsed % 1000, _statsEnabled ? "enabled" : "disabled");
+
+	report += Common::String::format("  Callbacks: %u, underruns: %u, average %u us, max %u us\n",
+		_stats.callbacks, _stats.underruns,
+		_stats.callbacks ? (uint32)(_stats.totalMicros / _stats.callbacks) : 0, _stats.maxMicros);
+
+	report += "  Callback duration:";
+	for (int i = 0; i < kHistogramBuckets; i++) {
+		if (i < kHistogramBuckets - 1)
+			report += Common::String::format(" <%uus: %u", 250U << i, _stats.histogram[i]);
+		else
+			report += Common::String::format(" >=%uus: %u\n", 250U << (i - 1), _stats.histogram[i]);
+	}
+
+	report += Common::String::format("  Commands: %u applied, at most %u per callback\n",
+		_callbackStats.commandsApplied, _callbackStats.maxCommands);
+	report += Common::String::format("  Longest callback since startup: %u us\n", _callbackStats.maxDuration);
+
+	for (int i = 0; i < kAudioStreamTypeCount; i++) {
+		const StreamTypeStats &typeStats = _stats.streamTypes[i];
+		if (!typeStats.channels && !typeStats.frames)
+			continue;
+
+		report += Common::String::format("  Stream type %s: %u channels, %u frames, %u us (%u ns per frame)\n",
+			streamTypeNames[i], typeStats.channels, (uint32)typeStats.frames, (uint32)typeStats.micros,
+			typeStats.frames ? (uint32)(typeStats.micros * 1000 / typeStats.frames) : 0);
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
-		}
+		const Channel *chan = _channels[i];
+		if (!chan)
+			continue;
+
+		report += Common::String::format("  Channel %d (id %d, %s, %s%s): %u frames, %u us (%u ns per frame)\n",
+			i, chan->getId(), soundTypeNames[chan->getType()], streamTypeNames[chan->getStreamType()],
+			chan->isPaused() ? ", paused" : "",
+			(uint32)chan->getStatisticsFrames(), (uint32)chan->getStatisticsMicros(),
+			chan->getStatisticsFrames() ? (uint32)(chan->getStatisticsMicros() * 1000 / chan->getStatisticsFrames()) : 0);
 	}
+
+	return report;
 }
 
-void MixerImpl::stopHandle(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+void MixerImpl::statisticsTimerProc(void *refCon) {
+	MixerImpl *mixer = (MixerImpl *)refCon;
+	debug("%s", mixer->getStatisticsReport().c_str());
+}
 
-	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+void MixerImpl::stopAll() {
+	freeRetiredChannels();
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+	uint32 handles[NUM_CHANNELS];
+	{
+		Common::StackLock lock(_commandMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			handles[i] = (isSlotActive(i) && !_slots[i].permanent) ? _slots[i].handle : SoundHandle()._val;
+	}
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (handles[i] != SoundHandle()._val)
+			stopSlot(i, handles[i]);
+	}
+
+	waitForMixer();
+}
+
+void MixerImpl::stopID(int id) {
+	freeRetiredChannels();
+
+	uint32 handles[NUM_CHANNELS];
+	{
+		Common::StackLock lock(_commandMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			handles[i] = (isSlotActive(i) && _slots[i].id == id) ? _slots[i].handle : SoundHandle()._val;
+	}
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (handles[i] != SoundHandle()._val)
+			stopSlot(i, handles[i]);
+	}
+
+	waitForMixer();
+}
+
+void MixerImpl::stopHandle(SoundHandle handle) {
+	freeRetiredChannels();
+
+	// The channel is only deleted once the mixer has retired it, but the
+	// caller may free the sample data of the stream as soon as we return.
+	stopSlot(handle._val % NUM_CHANNELS, handle._val);
+	waitForMixer();
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	postCommand(Command::kGlobalVolumeChange, type, 0);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -356,39 +753,39 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+	{
+		Common::StackLock lock(_commandMutex);
+		ChannelSlot *slot = findSlot(handle);
+		if (!slot)
+			return;
+		slot->volume = volume;
+	}
 
-	_channels[index]->setVolume(volume);
+	postCommand(Command::kSetVolume, handle._val, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getVolume();
+	Common::StackLock lock(_commandMutex);
+	const ChannelSlot *slot = findSlot(handle);
+	return slot ? slot->volume : 0;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+	{
+		Common::StackLock lock(_commandMutex);
+		ChannelSlot *slot = findSlot(handle);
+		if (!slot)
+			return;
+		slot->balance = balance;
+	}
 
-	_channels[index]->setBalance(balance);
+	postCommand(Command::kSetBalance, handle._val, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getBalance();
+	Common::StackLock lock(_commandMutex);
+	const ChannelSlot *slot = findSlot(handle);
+	return slot ? slot->balance : 0;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -396,17 +793,18 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	// The channel can't be deleted while we hold _commandMutex
+	Common::StackLock lock(_commandMutex);
+	const ChannelSlot *slot = findSlot(handle);
+	if (!slot)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	return slot->channel->getElapsedTime();
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	applyCommands();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -416,71 +814,66 @@ void MixerImpl::loopChannel(SoundHandle handle) {
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr) {
-			_channels[i]->pause(paused);
-		}
-	}
+	postCommand(Command::kPauseAll, 0, paused);
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
-			return;
+	uint32 handle = SoundHandle()._val;
+	{
+		Common::StackLock lock(_commandMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (isSlotActive(i) && _slots[i].id == id) {
+				handle = _slots[i].handle;
+				break;
+			}
 		}
 	}
+
+	if (handle != SoundHandle()._val)
+		postCommand(Command::kPause, handle, paused);
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
-
-	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->pause(paused);
+	postCommand(Command::kPause, handle._val, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
+	freeRetiredChannels();
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
+	Common::StackLock lock(_commandMutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (isSlotActive(i) && _slots[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
-	return 0;
+	Common::StackLock lock(_commandMutex);
+	const ChannelSlot *slot = findSlot(handle);
+	return slot ? slot->id : 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	freeRetiredChannels();
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	Common::StackLock lock(_commandMutex);
+	return findSlot(handle) != nullptr;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
+	freeRetiredChannels();
+
+	Common::StackLock lock(_commandMutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (isSlotActive(i) && _slots[i].type == type)
 			return true;
 	return false;
 }
@@ -494,13 +887,9 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	postCommand(Command::kGlobalVolumeChange, type, 0);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -515,16 +904,16 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, ResamplerQuality quality)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
+	  _balance(0), _pauseLevel(0), _timingSeq(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
 	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
-	  _stream(stream, autofreeStream) {
+	  _stream(stream, autofreeStream), _streamType(stream->getStreamType()), _statMicros(0), _statFrames(0) {
 	assert(mixer);
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, quality);
 }
 
 Channel::~Channel() {
@@ -579,6 +968,7 @@ void Channel::updateChannelVolumes() {
 void Channel::pause(bool paused) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
+	Common::atomicAdd(&_timingSeq, 1U);
 	if (paused) {
 		_pauseLevel++;
 
@@ -592,6 +982,7 @@ void Channel::pause(bool paused) {
 			_pauseStartTime = 0;
 		}
 	}
+	Common::atomicAdd(&_timingSeq, 1U);
 }
 
 Timestamp Channel::getElapsedTime() {
@@ -600,17 +991,29 @@ Timestamp Channel::getElapsedTime() {
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	// Read the values until the mixer thread did not change them meanwhile
+	uint32 seq, samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime;
+	bool paused;
+	do {
+		seq = Common::atomicLoad(&_timingSeq);
+		samplesConsumed = Common::atomicLoad(&_samplesConsumed);
+		mixerTimeStamp = Common::atomicLoad(&_mixerTimeStamp);
+		pauseStartTime = Common::atomicLoad(&_pauseStartTime);
+		pauseTime = Common::atomicLoad(&_pauseTime);
+		paused = Common::atomicLoad(&_pauseLevel) != 0;
+	} while ((seq & 1) || Common::atomicLoad(&_timingSeq) != seq);
+
+	if (mixerTimeStamp == 0)
 		return ts;
 
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
+	if (paused)
+		delta = pauseStartTime - mixerTimeStamp;
 	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
+		delta = g_system->getMillis(true) - mixerTimeStamp - pauseTime;
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -642,9 +1045,11 @@ int Channel::mix(int16 *data, uint len) {
 		// TODO: call drain method
 	} else {
 		assert(_converter);
+		Common::atomicAdd(&_timingSeq, 1U);
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis(true);
 		_pauseTime = 0;
+		Common::atomicAdd(&_timingSeq, 1U);
 		res = _converter->flow(*_stream, data, len, _volL, _volR);
 		_samplesDecoded += res;
 	}
@@ -25,6 +25,7 @@
 #include "common/mutex.h"
 #include "common/types.h"
 #include "common/noncopyable.h"
+#include "common/str.h"
 
 namespace Audio {
 
@@ -144,6 +145,10 @@ public:
 	/**
 	 * Stop playing the sound corresponding to the given handle.
 	 *
+	 * The mixer is guaranteed not to read from the stream anymore once this
+	 * returns. If the mixer was asked to dispose of the audio stream, the
+	 * stream may be destroyed some time after this call returns.
+	 *
 	 * @param handle  The sound to stop playing.
 	 */
 	virtual void stopHandle(SoundHandle handle) = 0;
@@ -311,6 +316,34 @@ public:
 	 * @return The number of samples processed at each audio callback.
 	 */
 	virtual uint getOutputBufSize() const = 0;
+
+	/**
+	 * Enable or disable the collection of mixing statistics.
+	 *
+	 * While enabled, the mixer measures how long each callback takes, how
+	 * many callbacks missed their deadline, and how much time each channel
+	 * and each kind of audio stream spends decoding. A summary is written
+	 * to the log periodically. Disabling does not reset the statistics.
+	 */
+	virtual void enableStatistics(bool enable) {}
+
+	/**
+	 * Check whether mixing statistics are being collected.
+	 */
+	virtual bool isStatisticsEnabled() const { return false; }
+
+	/**
+	 * Discard all mixing statistics collected so far.
+	 */
+	virtual void resetStatistics() {}
+
+	/**
+	 * Return a human-readable summary of the mixing statistics.
+	 *
+	 * @return The report, one item per line, or an empty string if
+	 *         the mixer does not support statistics.
+	 */
+	virtual Common::String getStatisticsReport() { return Common::String(); }
 };
 
 /** @} */
@@ -24,7 +24,10 @@
 
 #include "common/scummsys.h"
 #include "common/mutex.h"
+#include "common/spsc-queue.h"
+#include "audio/audiostream.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -56,6 +59,18 @@ namespace Audio {
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
+public:
+	/** Statistics about the mixer callback and the command queue. */
+	struct CallbackStats {
+		CallbackStats() : callbacks(0), commandsApplied(0), lastCommands(0), maxCommands(0), maxDuration(0) {}
+
+		uint32 callbacks;       ///< Number of mixer callbacks so far
+		uint32 commandsApplied; ///< Total number of commands applied by the mixer callback
+		uint32 lastCommands;    ///< Commands applied during the last callback
+		uint32 maxCommands;     ///< Most commands applied during a single callback
+		uint32 maxDuration;     ///< Longest duration of a single callback, in microseconds
+	};
+
 private:
 	enum {
 		NUM_CHANNELS = 32
@@ -67,6 +82,7 @@ private:
 	const uint _outBufSize;
 	bool _mixerReady;
 	uint32 _handleSeed;
+	ResamplerQuality _resamplerQuality;
 
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
@@ -78,9 +94,107 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * A change of channel state requested by an engine thread. Commands are
+	 * queued without taking _mutex, and applied by whoever holds _mutex next,
+	 * usually the mixer callback right before it starts mixing.
+	 */
+	struct Command {
+		enum Type {
+			kStart,
+			kStop,
+			kSetVolume,
+			kSetBalance,
+			kPause,
+			kPauseAll,
+			kGlobalVolumeChange
+		};
+
+		Type type;
+		uint32 handle;    ///< Handle of the target channel, or the SoundType for kGlobalVolumeChange
+		int value;
+		Channel *channel; ///< The new channel for kStart
+	};
 
-public:
+	/** Pending commands. Producers are serialized by _commandMutex, the consumer holds _mutex. */
+	Common::SPSCQueue<Command, 256> _commands;
+	Common::Mutex _commandMutex;
+
+	/**
+	 * Channels removed by the holder of _mutex, which are deleted later by an
+	 * engine thread (holding _commandMutex), so that the mixer callback never
+	 * has to free streams and decoders itself. A slot is only reused once its
+	 * channel has been deleted, so this can never hold more than NUM_CHANNELS.
+	 */
+	Common::SPSCQueue<Channel *, 64> _retiredChannels;
+
+	/**
+	 * What the engine threads know about a channel slot. Protected by
+	 * _commandMutex, so that engine threads never wait for the mixer callback
+	 * to start, stop or query channels.
+	 */
+	struct ChannelSlot {
+		Channel *channel; ///< Channel in this slot, until an engine thread deletes it
+		uint32 handle;
+		int id;
+		SoundType type;
+		bool permanent;
+		bool stopped;     ///< Whether the channel has been stopped by an engine thread
+		byte volume;
+		int8 balance;
+	};
+
+	ChannelSlot _slots[NUM_CHANNELS];
+
+	/** Incremented by the mixer callback when it starts and when it finishes. */
+	volatile uint32 _mixEpoch;
+
+	CallbackStats _callbackStats;
 
+	enum {
+		/** Callback durations are sorted into buckets of 250us << i. */
+		kHistogramBuckets = 8,
+		/** Interval for writing the statistics to the log, in microseconds. */
+		kStatisticsLogInterval = 10 * 1000 * 1000
+	};
+
+	/** Decoding cost of all channels playing one kind of audio stream. */
+	struct StreamTypeStats {
+		uint32 channels; ///< Number of channels created
+		uint64 micros;   ///< Total time spent mixing
+		uint64 frames;   ///< Total number of frames mixed
+	};
+
+	/** Statistics collected while enableStatistics(true) is in effect. Protected by _mutex. */
+	struct Statistics {
+		uint64 startTime;
+		uint32 callbacks;
+		uint32 underruns; ///< Callbacks which took longer than the audio they produced
+		uint64 totalMicros;
+		uint32 maxMicros;
+		uint32 histogram[kHistogramBuckets];
+		StreamTypeStats streamTypes[kAudioStreamTypeCount];
+	};
+
+	volatile bool _statsEnabled;
+	Statistics _stats;
+
+	static void statisticsTimerProc(void *refCon);
+
+	void postCommand(Command::Type type, uint32 handle, int value);
+	void flushCommands();
+	int applyCommands();
+	void applyCommand(const Command &cmd);
+	void retireChannel(int index);
+	void freeRetiredChannels();
+
+	ChannelSlot *findSlot(SoundHandle handle);
+	bool isSlotActive(int index) const { return _slots[index].channel && !_slots[index].stopped; }
+	void stopSlot(int index, uint32 handle);
+	void waitForMixer();
+
+
+public:
 	MixerImpl(uint sampleRate, uint outBufSize = 0);
 	~MixerImpl();
 
@@ -131,8 +245,10 @@ public:
 	virtual uint getOutputRate() const;
 	virtual uint getOutputBufSize() const;
 
-protected:
-	void insertChannel(SoundHandle *handle, Channel *chan);
+	virtual void enableStatistics(bool enable);
+	virtual bool isStatisticsEnabled() const { return _statsEnabled; }
+	virtual void resetStatistics();
+	virtual Common::String getStatisticsReport();
 
 public:
 	/**
@@ -146,6 +262,12 @@ public:
 	 */
 	int mixCallback(byte *samples, uint len);
 
+	/**
+	 * Get statistics about the mixer callback. The values are updated by the
+	 * mixer thread, so they should only be used for diagnostic purposes.
+	 */
+	const CallbackStats &getCallbackStats() const { return _callbackStats; }
+
 	/**
 	 * Set the internal 'is ready' flag of the mixer.
 	 * Backends should invoke Mixer::setReady(true) once initialisation of
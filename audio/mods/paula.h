@@ -99,6 +99,7 @@ public:
 	bool isStereo() const { return _stereo; }
 	bool endOfData() const { return _end; }
 	int getRate() const { return _rate; }
+	AudioStreamType getStreamType() const { return kAudioStreamSynth; }
 
 protected:
 	struct Channel {
@@ -34,6 +34,16 @@
 #include "common/textconsole.h"
 #include "common/util.h"
 
+#if !defined(OUTPUT_UNSIGNED_AUDIO)
+#if defined(__SSE2__)
+#define AUDIO_MIX_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define AUDIO_MIX_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
 namespace Audio {
 
 
@@ -56,6 +66,147 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+#pragma mark -
+
+
+/*
+ * The mixing kernels below apply the channel volume and mix a block of
+ * samples into the output buffer. The vector versions reproduce the scalar
+ * code bit for bit: products are computed with 32 bits of precision, the
+ * division by kMaxMixerVolume rounds towards zero and the final add
+ * saturates, exactly like clampedAdd() does.
+ */
+
+template<bool stereo, bool reverseStereo>
+static void mixBufferScalar(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	while (frames--) {
+		st_sample_t out0, out1;
+		out0 = *ibuf++;
+		out1 = (stereo ? *ibuf++ : out0);
+
+		// output left channel
+		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+	}
+}
+
+#if defined(AUDIO_MIX_SSE2)
+
+static inline __m128i scaleSSE2(__m128i in, __m128i vol) {
+	// 32 bit products of the 16 bit samples and volumes
+	const __m128i lo = _mm_mullo_epi16(in, vol);
+	const __m128i hi = _mm_mulhi_epi16(in, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+	// Divide by kMaxMixerVolume (256), rounding towards zero
+	const __m128i bias = _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), 8);
+
+	return _mm_packs_epi32(p0, p1);
+}
+
+template<bool stereo, bool reverseStereo>
+static void mixBufferSIMD(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	for (; frames >= 4; frames -= 4) {
+		__m128i in;
+		if (stereo) {
+			in = _mm_loadu_si128((const __m128i *)ibuf);
+			ibuf += 8;
+		} else {
+			in = _mm_loadl_epi64((const __m128i *)ibuf);
+			in = _mm_unpacklo_epi16(in, in);
+			ibuf += 4;
+		}
+
+		__m128i out = scaleSSE2(in, vol);
+		if (reverseStereo) {
+			out = _mm_shufflelo_epi16(out, _MM_SHUFFLE(2, 3, 0, 1));
+			out = _mm_shufflehi_epi16(out, _MM_SHUFFLE(2, 3, 0, 1));
+		}
+
+		out = _mm_adds_epi16(_mm_loadu_si128((const __m128i *)obuf), out);
+		_mm_storeu_si128((__m128i *)obuf, out);
+		obuf += 8;
+	}
+
+	mixBufferScalar<stereo, reverseStereo>(obuf, ibuf, frames, vol_l, vol_r);
+}
+
+#elif defined(AUDIO_MIX_NEON)
+
+static inline int16x4_t scaleNEON(int16x4_t in, int16x4_t vol) {
+	int32x4_t p = vmull_s16(in, vol);
+
+	// Divide by kMaxMixerVolume (256), rounding towards zero
+	const uint32x4_t bias = vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p, 31)), 24);
+	p = vshrq_n_s32(vaddq_s32(p, vreinterpretq_s32_u32(bias)), 8);
+
+	return vmovn_s32(p);
+}
+
+template<bool stereo, bool reverseStereo>
+static void mixBufferSIMD(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const int16_t volArray[4] = { (int16_t)vol_l, (int16_t)vol_r, (int16_t)vol_l, (int16_t)vol_r };
+	const int16x4_t vol = vld1_s16(volArray);
+
+	for (; frames >= 4; frames -= 4) {
+		int16x8_t in;
+		if (stereo) {
+			in = vld1q_s16(ibuf);
+			ibuf += 8;
+		} else {
+			const int16x4_t mono = vld1_s16(ibuf);
+			const int16x4x2_t dup = vzip_s16(mono, mono);
+			in = vcombine_s16(dup.val[0], dup.val[1]);
+			ibuf += 4;
+		}
+
+		int16x8_t out = vcombine_s16(scaleNEON(vget_low_s16(in), vol), scaleNEON(vget_high_s16(in), vol));
+		if (reverseStereo)
+			out = vrev32q_s16(out);
+
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), out));
+		obuf += 8;
+	}
+
+	mixBufferScalar<stereo, reverseStereo>(obuf, ibuf, frames, vol_l, vol_r);
+}
+
+#else
+
+template<bool stereo, bool reverseStereo>
+static void mixBufferSIMD(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	mixBufferScalar<stereo, reverseStereo>(obuf, ibuf, frames, vol_l, vol_r);
+}
+
+#endif
+
+void mixBuffer(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, bool stereo, bool reverseStereo, st_volume_t vol_l, st_volume_t vol_r) {
+	if (stereo) {
+		if (reverseStereo)
+			mixBufferSIMD<true, true>(obuf, ibuf, frames, vol_l, vol_r);
+		else
+			mixBufferSIMD<true, false>(obuf, ibuf, frames, vol_l, vol_r);
+	} else {
+		if (reverseStereo)
+			mixBufferSIMD<false, true>(obuf, ibuf, frames, vol_l, vol_r);
+		else
+			mixBufferSIMD<false, false>(obuf, ibuf, frames, vol_l, vol_r);
+	}
+}
+
+
+#pragma mark -
+
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -66,6 +217,7 @@ template<bool stereo, bool reverseStereo>
 class SimpleRateConverter : public RateConverter {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	st_sample_t mixBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
 	int inLen;
 
@@ -112,45 +264,55 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
  */
 template<bool stereo, bool reverseStereo>
 int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
-
-	ostart = obuf;
-	oend = obuf + osamp * 2;
-
-	while (obuf < oend) {
+	st_size_t produced = 0;
+
+	while (produced < osamp) {
+		// Resample into the mix buffer, then mix the whole block at once
+		const st_size_t batch = MIN<st_size_t>(osamp - produced, ARRAYSIZE(mixBuf) / (stereo ? 2 : 1));
+		st_sample_t *mixPtr = mixBuf;
+		st_size_t frames = 0;
+		bool endOfInput = false;
+
+		while (frames < batch) {
+
+			// read enough input samples so that opos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				opos--;
+				if (opos >= 0) {
+					inPtr += (stereo ? 2 : 1);
+				}
+			} while (opos >= 0);
+
+			if (endOfInput)
+				break;
+
+			*mixPtr++ = *inPtr++;
+			if (stereo)
+				*mixPtr++ = *inPtr++;
 
-		// read enough input samples so that opos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
-			}
-			inLen -= (stereo ? 2 : 1);
-			opos--;
-			if (opos >= 0) {
-				inPtr += (stereo ? 2 : 1);
-			}
-		} while (opos >= 0);
-
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
+			// Increment output position
+			opos += opos_inc;
 
-		// Increment output position
-		opos += opos_inc;
+			frames++;
+		}
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		mixBuffer(obuf + produced * 2, mixBuf, frames, stereo, reverseStereo, vol_l, vol_r);
+		produced += frames;
 
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-		obuf += 2;
+		if (endOfInput)
+			break;
 	}
-	return (obuf - ostart) / 2;
+	return produced;
 }
 
 /**
@@ -168,6 +330,7 @@ template<bool stereo, bool reverseStereo>
 class LinearRateConverter : public RateConverter {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	st_sample_t mixBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
 	int inLen;
 
@@ -221,55 +384,260 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
  */
 template<bool stereo, bool reverseStereo>
 int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
+	st_size_t produced = 0;
+
+	while (produced < osamp) {
+		// Interpolate into the mix buffer, then mix the whole block at once
+		const st_size_t batch = MIN<st_size_t>(osamp - produced, ARRAYSIZE(mixBuf) / (stereo ? 2 : 1));
+		st_sample_t *mixPtr = mixBuf;
+		st_size_t frames = 0;
+		bool endOfInput = false;
+
+		while (frames < batch) {
+
+			// read enough input samples so that opos < 0
+			while ((frac_t)FRAC_ONE_LOW <= opos) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				ilast0 = icur0;
+				icur0 = *inPtr++;
+				if (stereo) {
+					ilast1 = icur1;
+					icur1 = *inPtr++;
+				}
+				opos -= FRAC_ONE_LOW;
+			}
 
-	ostart = obuf;
-	oend = obuf + osamp * 2;
+			if (endOfInput)
+				break;
 
-	while (obuf < oend) {
+			// Loop as long as the outpos trails behind, and as long as there is
+			// still space in the mix buffer.
+			while (opos < (frac_t)FRAC_ONE_LOW && frames < batch) {
+				// interpolate
+				*mixPtr++ = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+				if (stereo)
+					*mixPtr++ = (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
 
-		// read enough input samples so that opos < 0
-		while ((frac_t)FRAC_ONE_LOW <= opos) {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
-			}
-			inLen -= (stereo ? 2 : 1);
-			ilast0 = icur0;
-			icur0 = *inPtr++;
-			if (stereo) {
-				ilast1 = icur1;
-				icur1 = *inPtr++;
+				frames++;
+
+				// Increment output position
+				opos += opos_inc;
 			}
-			opos -= FRAC_ONE_LOW;
 		}
 
-		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
-			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  out0);
+		mixBuffer(obuf + produced * 2, mixBuf, frames, stereo, reverseStereo, vol_l, vol_r);
+		produced += frames;
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		if (endOfInput)
+			break;
+	}
+	return produced;
+}
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
 
-			obuf += 2;
+#pragma mark -
 
-			// Increment output position
-			opos += opos_inc;
+
+/**
+ * Parameters of the windowed-sinc filter bank. Every output sample is
+ * computed from SINC_TAPS input samples, which puts the latency of the
+ * converter at SINC_TAPS / 2 input samples. The fractional position
+ * between two input samples is quantized to SINC_PHASES sub-filters.
+ */
+enum {
+	SINC_TAPS = 16,
+	SINC_PHASE_BITS = 8,
+	SINC_PHASES = (1 << SINC_PHASE_BITS),
+	SINC_COEF_BITS = 14
+};
+
+static inline int sincDotProduct(const st_sample_t *samples, const int16 *coefs) {
+#if defined(AUDIO_MIX_SSE2)
+	__m128i sum = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)samples), _mm_loadu_si128((const __m128i *)coefs));
+	sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(samples + 8)), _mm_loadu_si128((const __m128i *)(coefs + 8))));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+#elif defined(AUDIO_MIX_NEON)
+	int32x4_t sum = vmull_s16(vld1_s16(samples), vld1_s16(coefs));
+	sum = vmlal_s16(sum, vld1_s16(samples + 4), vld1_s16(coefs + 4));
+	sum = vmlal_s16(sum, vld1_s16(samples + 8), vld1_s16(coefs + 8));
+	sum = vmlal_s16(sum, vld1_s16(samples + 12), vld1_s16(coefs + 12));
+	int32x2_t half = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	return vget_lane_s32(vpadd_s32(half, half), 0);
+#else
+	int sum = 0;
+	for (int i = 0; i < SINC_TAPS; ++i)
+		sum += samples[i] * coefs[i];
+	return sum;
+#endif
+}
+
+/**
+ * Audio rate converter based on band-limited (windowed-sinc) interpolation.
+ *
+ * The interpolation filter is precomputed as a bank of polyphase
+ * sub-filters when the converter is created; the cutoff is lowered when
+ * downsampling so the filter doubles as anti-aliasing filter. This is
+ * considerably more expensive than linear interpolation, but avoids the
+ * aliasing artifacts the latter produces when upsampling low rate audio.
+ *
+ * Limited to sampling frequency <= 131071 Hz.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	st_sample_t mixBuf[INTERMEDIATE_BUFFER_SIZE];
+	const st_sample_t *inPtr;
+	int inLen;
+
+	/** fractional position of the output stream in input stream unit */
+	frac_t opos;
+
+	/** fractional position increment in the output stream */
+	frac_t opos_inc;
+
+	/**
+	 * The last SINC_TAPS input samples (left/right channel). Each sample is
+	 * stored twice, so a contiguous window always starts at histPos.
+	 */
+	st_sample_t hist0[SINC_TAPS * 2], hist1[SINC_TAPS * 2];
+	int histPos;
+
+	/** The polyphase filter bank */
+	int16 coefs[SINC_PHASES][SINC_TAPS];
+
+	void computeFilterBank(double cutoff);
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override;
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) override {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate) {
+	if (inrate >= 131072 || outrate >= 131072) {
+		error("rate effect can only handle rates < 131072");
+	}
+
+	opos = FRAC_ONE_LOW;
+	opos_inc = (inrate << FRAC_BITS_LOW) / outrate;
+
+	memset(hist0, 0, sizeof(hist0));
+	memset(hist1, 0, sizeof(hist1));
+	histPos = 0;
+
+	inLen = 0;
+
+	// Keep some headroom below the Nyquist frequency of the lower of both
+	// rates, since the short filter has a rather wide transition band.
+	computeFilterBank(0.9 * MIN<double>(1.0, (double)outrate / inrate));
+}
+
+template<bool stereo, bool reverseStereo>
+void SincRateConverter<stereo, reverseStereo>::computeFilterBank(double cutoff) {
+	const int half = SINC_TAPS / 2;
+
+	for (int phase = 0; phase < SINC_PHASES; ++phase) {
+		const double frac = (double)phase / SINC_PHASES;
+		double taps[SINC_TAPS];
+		double sum = 0.0;
+
+		for (int i = 0; i < SINC_TAPS; ++i) {
+			// Distance of the output position to this tap, in input samples
+			const double x = (half - 1 - i) + frac;
+			const double sinc = (x == 0.0) ? 1.0 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+			const double window = 0.42 + 0.5 * cos(M_PI * x / half) + 0.08 * cos(2.0 * M_PI * x / half);
+			taps[i] = sinc * window;
+			sum += taps[i];
 		}
+
+		// Normalize each sub-filter to unity gain, and push the rounding
+		// error into the largest tap to keep the DC gain exact.
+		int total = 0, largest = 0;
+		for (int i = 0; i < SINC_TAPS; ++i) {
+			coefs[phase][i] = (int16)floor(taps[i] / sum * (1 << SINC_COEF_BITS) + 0.5);
+			total += coefs[phase][i];
+			if (coefs[phase][i] > coefs[phase][largest])
+				largest = i;
+		}
+		coefs[phase][largest] += (1 << SINC_COEF_BITS) - total;
 	}
-	return (obuf - ostart) / 2;
+}
+
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_size_t produced = 0;
+
+	while (produced < osamp) {
+		// Filter into the mix buffer, then mix the whole block at once
+		const st_size_t batch = MIN<st_size_t>(osamp - produced, ARRAYSIZE(mixBuf) / (stereo ? 2 : 1));
+		st_sample_t *mixPtr = mixBuf;
+		st_size_t frames = 0;
+		bool endOfInput = false;
+
+		while (frames < batch) {
+
+			// read enough input samples so that opos < 0
+			while ((frac_t)FRAC_ONE_LOW <= opos) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				hist0[histPos] = hist0[histPos + SINC_TAPS] = *inPtr++;
+				if (stereo)
+					hist1[histPos] = hist1[histPos + SINC_TAPS] = *inPtr++;
+				histPos = (histPos + 1) % SINC_TAPS;
+				opos -= FRAC_ONE_LOW;
+			}
+
+			if (endOfInput)
+				break;
+
+			// Loop as long as the outpos trails behind, and as long as there is
+			// still space in the mix buffer.
+			while (opos < (frac_t)FRAC_ONE_LOW && frames < batch) {
+				const int16 *filter = coefs[opos >> (FRAC_BITS_LOW - SINC_PHASE_BITS)];
+				const int out0 = (sincDotProduct(hist0 + histPos, filter) + (1 << (SINC_COEF_BITS - 1))) >> SINC_COEF_BITS;
+				*mixPtr++ = (st_sample_t)CLIP<int>(out0, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+				if (stereo) {
+					const int out1 = (sincDotProduct(hist1 + histPos, filter) + (1 << (SINC_COEF_BITS - 1))) >> SINC_COEF_BITS;
+					*mixPtr++ = (st_sample_t)CLIP<int>(out1, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+				}
+
+				frames++;
+
+				// Increment output position
+				opos += opos_inc;
+			}
+		}
+
+		mixBuffer(obuf + produced * 2, mixBuf, frames, stereo, reverseStereo, vol_l, vol_r);
+		produced += frames;
+
+		if (endOfInput)
+			break;
+	}
+	return produced;
 }
 
 
@@ -292,11 +660,8 @@ public:
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
-		st_sample_t *ostart = obuf;
-
 		if (stereo)
 			osamp *= 2;
 
@@ -314,21 +679,9 @@ public:
 		len = input.readBuffer(_buffer, osamp);
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
-		}
-		return (obuf - ostart) / 2;
+		const st_size_t frames = len / (stereo ? 2 : 1);
+		mixBuffer(obuf, _buffer, frames, stereo, reverseStereo, vol_l, vol_r);
+		return frames;
 	}
 
 	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) override {
@@ -340,9 +693,11 @@ public:
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, ResamplerQuality quality) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (quality == kResamplerSinc) {
+			return new SincRateConverter<stereo, reverseStereo>(inrate, outrate);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -355,14 +710,14 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, ResamplerQuality quality) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, quality);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, quality);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, quality);
 }
 
 } // End of namespace Audio
@@ -84,7 +84,33 @@ public:
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+/**
+ * Interpolation method used when the input rate differs from the output rate.
+ */
+enum ResamplerQuality {
+	kResamplerLinear,	///< Linear interpolation; cheap, but prone to aliasing.
+	kResamplerSinc		///< Windowed-sinc polyphase filter; higher quality, but more expensive.
+};
+
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, ResamplerQuality quality = kResamplerLinear);
+
+/**
+ * Mix a block of samples into a stereo output buffer.
+ *
+ * Each sample is scaled by the left/right volume (in the range
+ * 0 - Mixer::kMaxMixerVolume) and added to the output with clipping,
+ * just like clampedAdd() does. An SSE2 or NEON kernel is used when the
+ * compiler targets a CPU supporting it, with a portable C++ fallback.
+ *
+ * @param obuf          Output buffer holding @p frames sample pairs.
+ * @param ibuf          Input buffer holding @p frames samples, or sample pairs if @p stereo is set.
+ * @param frames        Number of frames to mix.
+ * @param stereo        Whether the input is stereo.
+ * @param reverseStereo Whether the left and right output channels should be swapped.
+ * @param vol_l         Volume of the left channel.
+ * @param vol_r         Volume of the right channel.
+ */
+void mixBuffer(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, bool stereo, bool reverseStereo, st_volume_t vol_l, st_volume_t vol_r);
 /** @} */
 } // End of namespace Audio
 
@@ -87,6 +87,8 @@ public:
 	}
 
 	// AudioStream API
+	virtual Audio::AudioStreamType getStreamType() const { return Audio::kAudioStreamSynth; }
+
 	virtual int readBuffer(int16 *data, const int numSamples) {
 		const int stereoFactor = isStereo() ? 2 : 1;
 		int len = numSamples / stereoFactor;
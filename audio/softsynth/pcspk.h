@@ -91,6 +91,7 @@ public:
 	bool endOfData() const	{ return false; }
 	bool endOfStream() const { return false; }
 	int getRate() const	{ return _rate; }
+	AudioStreamType getStreamType() const { return kAudioStreamSynth; }
 
 protected:
 	Common::Mutex _mutex;
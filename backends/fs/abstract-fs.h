@@ -172,6 +172,18 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and the time of the last modification of the file
+	 * referred by this node, without opening it. The time is in seconds,
+	 * relative to an epoch which depends on the backend.
+	 *
+	 * Backends which cannot provide this information cheaply do not need to
+	 * override this method.
+	 *
+	 * @return bool true if both values were retrieved, false otherwise.
+	 */
+	virtual bool getFileStatus(int64 &size, int64 &modificationTime) const { return false; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -152,6 +152,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mutex/sdl/sdl-mutex.o \
 	plugins/sdl/sdl-provider.o \
+	threads/sdl/sdl-threads.o \
 	timer/sdl/sdl-timer.o
 
 # SDL 2 removed audio CD support
@@ -183,6 +184,7 @@ MODULE_OBJS += \
 	plugins/posix/posix-provider.o \
 	saves/posix/posix-saves.o \
 	taskbar/unity/unity-taskbar.o \
+	threads/pthread/pthread-threads.o \
 	dialogs/gtk/gtk-dialogs.o
 
 ifdef USE_SPEECH_DISPATCHER
@@ -340,6 +342,10 @@ endif
 ifeq ($(BACKEND),null)
 MODULE_OBJS += \
 	mixer/null/null-mixer.o
+ifdef POSIX
+MODULE_OBJS += \
+	mutex/pthread/pthread-mutex.o
+endif
 endif
 
 ifeq ($(BACKEND),opendingux)
@@ -23,7 +23,7 @@
 
 #include "common/scummsys.h"
 
-#if defined(__ANDROID__) || defined(IPHONE)
+#if defined(POSIX) || defined(__ANDROID__) || defined(IPHONE)
 
 #include "backends/mutex/pthread/pthread-mutex.h"
 
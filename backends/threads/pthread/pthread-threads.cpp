@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(POSIX)
+
+#include "backends/threads/pthread/pthread-threads.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * pthreads thread
+ */
+class PthreadThreadInternal final : public Common::ThreadInternal {
+public:
+	PthreadThreadInternal(Common::ThreadProc proc, void *param) : _proc(proc), _param(param) {
+		_valid = (pthread_create(&_thread, nullptr, threadEntry, this) == 0);
+	}
+
+	~PthreadThreadInternal() override {
+		if (_valid)
+			pthread_join(_thread, nullptr);
+	}
+
+	bool isValid() const { return _valid; }
+
+private:
+	static void *threadEntry(void *data) {
+		PthreadThreadInternal *thread = (PthreadThreadInternal *)data;
+		thread->_proc(thread->_param);
+		return nullptr;
+	}
+
+	pthread_t _thread;
+	bool _valid;
+	Common::ThreadProc _proc;
+	void *_param;
+};
+
+/**
+ * Semaphore built from a mutex and a condition variable, since unnamed
+ * POSIX semaphores are not available everywhere (e.g. macOS).
+ */
+class PthreadSemaphoreInternal final : public Common::SemaphoreInternal {
+public:
+	PthreadSemaphoreInternal() : _count(0) {
+		pthread_mutex_init(&_mutex, nullptr);
+		pthread_cond_init(&_cond, nullptr);
+	}
+
+	~PthreadSemaphoreInternal() override {
+		pthread_cond_destroy(&_cond);
+		pthread_mutex_destroy(&_mutex);
+	}
+
+	void post() override {
+		pthread_mutex_lock(&_mutex);
+		_count++;
+		pthread_cond_signal(&_cond);
+		pthread_mutex_unlock(&_mutex);
+	}
+
+	void wait() override {
+		pthread_mutex_lock(&_mutex);
+		while (_count == 0)
+			pthread_cond_wait(&_cond, &_mutex);
+		_count--;
+		pthread_mutex_unlock(&_mutex);
+	}
+
+private:
+	pthread_mutex_t _mutex;
+	pthread_cond_t _cond;
+	uint _count;
+};
+
+Common::ThreadInternal *createPthreadThreadInternal(Common::ThreadProc proc, void *param) {
+	PthreadThreadInternal *thread = new PthreadThreadInternal(proc, param);
+	if (!thread->isValid()) {
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+Common::SemaphoreInternal *createPthreadSemaphoreInternal() {
+	return new PthreadSemaphoreInternal();
+}
+
+uint getPthreadCPUCount() {
+#ifdef _SC_NPROCESSORS_ONLN
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count > 0)
+		return count;
+#endif
+	return 1;
+}
+
+#endif
@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/threads/sdl/sdl-threads.h"
+#include "backends/platform/sdl/sdl-sys.h"
+
+/**
+ * SDL thread
+ */
+class SdlThreadInternal final : public Common::ThreadInternal {
+public:
+	SdlThreadInternal(Common::ThreadProc proc, void *param) : _proc(proc), _param(param) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		_thread = SDL_CreateThread(threadEntry, "ScummVM worker", this);
+#else
+		_thread = SDL_CreateThread(threadEntry, this);
+#endif
+	}
+
+	~SdlThreadInternal() override {
+		if (_thread)
+			SDL_WaitThread(_thread, nullptr);
+	}
+
+	bool isValid() const { return _thread != nullptr; }
+
+private:
+	static int SDLCALL threadEntry(void *data) {
+		SdlThreadInternal *thread = (SdlThreadInternal *)data;
+		thread->_proc(thread->_param);
+		return 0;
+	}
+
+	SDL_Thread *_thread;
+	Common::ThreadProc _proc;
+	void *_param;
+};
+
+/**
+ * SDL semaphore
+ */
+class SdlSemaphoreInternal final : public Common::SemaphoreInternal {
+public:
+	SdlSemaphoreInternal() { _semaphore = SDL_CreateSemaphore(0); }
+	~SdlSemaphoreInternal() override { SDL_DestroySemaphore(_semaphore); }
+
+	void post() override { SDL_SemPost(_semaphore); }
+	void wait() override { SDL_SemWait(_semaphore); }
+
+	bool isValid() const { return _semaphore != nullptr; }
+
+private:
+	SDL_sem *_semaphore;
+};
+
+Common::ThreadInternal *createSdlThreadInternal(Common::ThreadProc proc, void *param) {
+	SdlThreadInternal *thread = new SdlThreadInternal(proc, param);
+	if (!thread->isValid()) {
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+Common::SemaphoreInternal *createSdlSemaphoreInternal() {
+	SdlSemaphoreInternal *semaphore = new SdlSemaphoreInternal();
+	if (!semaphore->isValid()) {
+		delete semaphore;
+		return nullptr;
+	}
+	return semaphore;
+}
+
+uint getSdlCPUCount() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	return MAX(SDL_GetCPUCount(), 1);
+#else
+	return 1;
+#endif
+}
+
+#endif
@@ -30,6 +30,7 @@
 // FIXME: Avoid using printf
 #define FORBIDDEN_SYMBOL_EXCEPTION_printf
 
+#include "engines/advancedDetector.h"
 #include "engines/engine.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
@@ -52,11 +53,13 @@
 #include "common/translation.h"
 #include "common/text-to-speech.h"
 #include "common/osd_message_queue.h"
+#include "common/worker-pool.h"
 
 #include "gui/gui-manager.h"
 #include "gui/error.h"
 
 #include "audio/mididrv.h"
+#include "audio/mixer.h"
 #include "audio/musicplugin.h"  /* for music manager */
 
 #include "graphics/cursorman.h"
@@ -484,6 +487,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 		if (res.getCode() != Common::kNoError)
 			warning("%s", res.getDesc().c_str());
 
+		MD5Man.savePersistent();
 		PluginManager::instance().unloadDetectionPlugin();
 		PluginManager::instance().unloadAllPlugins();
 		PluginManager::destroy();
@@ -555,6 +559,9 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	// Now as the event manager is created, setup the keymapper
 	setupKeymapper(system);
 
+	if (ConfMan.getBool("audio_stats"))
+		system.getMixer()->enableStatistics(true);
+
 #ifdef USE_UPDATES
 	if (!ConfMan.hasKey("updates_check") && g_system->getUpdateManager()) {
 		GUI::UpdatesDialog dlg;
@@ -716,9 +723,11 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	Cloud::CloudManager::destroy();
 #endif
 #endif
+	MD5Man.savePersistent();
 	PluginManager::instance().unloadDetectionPlugin();
 	PluginManager::instance().unloadAllPlugins();
 	PluginManager::destroy();
+	Common::WorkerPool::destroy();
 	GUI::GuiManager::destroy();
 	Common::ConfigManager::destroy();
 	Common::DebugManager::destroy();
@@ -25,10 +25,9 @@
 #include "common/debug.h"
 #include "common/debug-channels.h"
 #include "common/config-manager.h"
-
-#ifdef DYNAMIC_MODULES
 #include "common/fs.h"
-#endif
+#include "common/system.h"
+#include "common/worker-pool.h"
 
 #include "base/detection/detection.h"
 
@@ -717,10 +716,64 @@ QualifiedGameList EngineManager::findGameInLoadedPlugins(const Common::String &g
 	return results;
 }
 
+namespace {
+
+/** State of the part of the detection which runs on the worker pool. */
+struct ConcurrentDetectionState {
+	const PluginList *plugins;
+	Common::StringArray paths;	///< Paths of the files to detect, not shared with the main thread
+
+	Common::Array<MetaEngineDetection::ConcurrentDetection *> partials;
+	Common::Array<uint32> micros;
+};
+
+/**
+ * Node and string reference counts are not atomic, so every task works on
+ * its own copy of the file list.
+ */
+Common::FSList copyFileList(const Common::StringArray &paths) {
+	Common::FSList fslist;
+	fslist.reserve(paths.size());
+	for (uint i = 0; i < paths.size(); i++)
+		fslist.push_back(Common::FSNode(Common::String(paths[i].c_str())));
+	return fslist;
+}
+
+void detectConcurrently(uint index, void *param) {
+	ConcurrentDetectionState *state = (ConcurrentDetectionState *)param;
+	const uint64 start = g_system->getMicros();
+
+	MetaEngineDetection &metaEngine = (*state->plugins)[index]->get<MetaEngineDetection>();
+	Common::FSList fslist = copyFileList(state->paths);
+	state->partials[index] = metaEngine.detectGamesConcurrently(fslist);
+
+	state->micros[index] = (uint32)(g_system->getMicros() - start);
+}
+
+/**
+ * Prepare the paths for the concurrent detection. Returns false if a node
+ * cannot be recreated from its path, e.g. because it is provided by an
+ * archive, in which case all detectors run on the main thread.
+ */
+bool prepareConcurrentDetection(const Common::FSList &fslist, Common::StringArray &paths) {
+	paths.reserve(fslist.size());
+	for (Common::FSList::const_iterator file = fslist.begin(); file != fslist.end(); ++file) {
+		Common::String path = file->getPath();
+		Common::FSNode copy(path);
+		if (copy.exists() != file->exists() || copy.isDirectory() != file->isDirectory())
+			return false;
+
+		paths.push_back(Common::String(path.c_str()));
+	}
+
+	return true;
+}
+
+} // End of anonymous namespace
+
 DetectionResults EngineManager::detectGames(const Common::FSList &fslist) {
 	DetectedGames candidates;
 	PluginList plugins;
-	PluginList::const_iterator iter;
 
 	// MetaEngines are always loaded into memory, so, get them and
 	// run detection for all of them.
@@ -728,20 +781,60 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist) {
 
 	// Clear md5 cache before each detection starts, just in case.
 	MD5Man.clear();
+	MD5Man.loadPersistent();
+
+	const uint64 start = g_system->getMicros();
+
+	// First run the parts of the detectors which do not depend on global
+	// state, i.e. matching the detection tables, for all engines in parallel.
+	// The MD5s computed there are shared through MD5Man.
+	ConcurrentDetectionState state;
+	state.plugins = &plugins;
+	state.partials.resize(plugins.size());
+	state.micros.resize(plugins.size());
+	for (uint i = 0; i < plugins.size(); i++) {
+		state.partials[i] = nullptr;
+		state.micros[i] = 0;
+	}
+
+	Common::WorkerPool &pool = Common::WorkerPool::instance();
+	const bool concurrent = !fslist.empty() && pool.getThreadCount() > 1 && prepareConcurrentDetection(fslist, state.paths);
+	if (concurrent)
+		pool.run(plugins.size(), detectConcurrently, &state);
+
+	const uint32 concurrentMicros = (uint32)(g_system->getMicros() - start);
+
+	// Then finish the detection on this thread. This runs everything else,
+	// such as the fallback detectors, and keeps the results in the order of
+	// the plugins.
+	for (uint p = 0; p < plugins.size(); p++) {
+		MetaEngineDetection &metaEngine = plugins[p]->get<MetaEngineDetection>();
+		const uint64 engineStart = g_system->getMicros();
 
-	// Iterate over all known games and for each check if it might be
-	// the game in the presented directory.
-	for (iter = plugins.begin(); iter != plugins.end(); ++iter) {
-		MetaEngineDetection &metaEngine = (*iter)->get<MetaEngineDetection>();
 		// set the debug flags
 		DebugMan.addAllDebugChannels(metaEngine.getDebugChannels());
-		DetectedGames engineCandidates = metaEngine.detectGames(fslist);
+		DetectedGames engineCandidates = metaEngine.finishDetectGames(fslist, state.partials[p]);
 
 		for (uint i = 0; i < engineCandidates.size(); i++) {
 			engineCandidates[i].path = fslist.begin()->getParent().getPath();
 			engineCandidates[i].shortPath = fslist.begin()->getParent().getDisplayName();
 			candidates.push_back(engineCandidates[i]);
 		}
+
+		state.micros[p] += (uint32)(g_system->getMicros() - engineStart);
+	}
+
+	if (DebugMan.isDebugChannelEnabled(kDebugGlobalDetection) && !fslist.empty()) {
+		debugC(1, kDebugGlobalDetection, "Detection in '%s' took %u ms, %u ms of which on %u threads",
+		       fslist.begin()->getParent().getPath().c_str(), (uint)((g_system->getMicros() - start) / 1000),
+		       concurrentMicros / 1000, concurrent ? pool.getThreadCount() : 1);
+
+		for (uint p = 0; p < plugins.size(); p++) {
+			if (state.micros[p] >= 1000) {
+				debugC(2, kDebugGlobalDetection, "  %s: %u ms", plugins[p]->get<MetaEngineDetection>().getEngineId(),
+				       state.micros[p] / 1000);
+			}
+		}
 	}
 
 	return DetectionResults(candidates);
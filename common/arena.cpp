@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/arena.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Common {
+
+Arena::Arena(size_t blockSize)
+	: _blockSize(blockSize), _first(nullptr), _current(nullptr), _offset(0) {
+	assert(blockSize > 0);
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+Arena::~Arena() {
+	release();
+}
+
+void *Arena::allocateSlow(size_t size, size_t alignment) {
+	// Move on to the next block, reusing the blocks of previous frames
+	// where possible. Blocks too small for this allocation are skipped,
+	// but stay in the chain.
+	Block *prev = _current;
+	Block *block = _current ? _current->next : _first;
+	while (block && block->size < size + alignment - 1) {
+		prev = block;
+		block = block->next;
+	}
+
+	if (!block) {
+		const size_t blockSize = MAX(_blockSize, size + alignment - 1);
+		block = (Block *)malloc(sizeof(Block) + blockSize);
+		if (!block)
+			error("Arena: Failed to allocate %u bytes", (uint)blockSize);
+		block->size = blockSize;
+		block->next = nullptr;
+		_stats.reservedBytes += blockSize;
+
+		if (prev)
+			prev->next = block;
+		else
+			_first = block;
+	}
+
+	_current = block;
+	_offset = 0;
+
+	void *result = allocate(size, alignment);
+	assert(result);
+	return result;
+}
+
+void Arena::reset() {
+	_stats.peakBytes = MAX(_stats.peakBytes, _stats.bytesUsed);
+	_stats.peakAllocations = MAX(_stats.peakAllocations, _stats.allocations);
+	_stats.lastFrameBytes = _stats.bytesUsed;
+	_stats.lastFrameAllocations = _stats.allocations;
+	_stats.bytesUsed = 0;
+	_stats.allocations = 0;
+	_stats.frames++;
+
+	_current = _first;
+	_offset = 0;
+}
+
+void Arena::release() {
+	reset();
+
+	while (_first) {
+		Block *next = _first->next;
+		free(_first);
+		_first = next;
+	}
+
+	_current = nullptr;
+	_stats.reservedBytes = 0;
+}
+
+Arena::Stats Arena::getStats() const {
+	Stats stats = _stats;
+	stats.peakBytes = MAX(stats.peakBytes, stats.bytesUsed);
+	stats.peakAllocations = MAX(stats.peakAllocations, stats.allocations);
+	return stats;
+}
+
+} // End of namespace Common
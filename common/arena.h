@@ -0,0 +1,150 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ARENA_H
+#define COMMON_ARENA_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_arena Arena allocator
+ * @ingroup common_memory
+ *
+ * @brief Allocator for temporary data which is freed all at once.
+ * @{
+ */
+
+/**
+ * An arena hands out memory from large blocks by simply advancing a pointer,
+ * and frees everything it handed out at once when reset() is called. This
+ * makes it a good fit for the many small temporary objects created while
+ * drawing one frame or loading one scene.
+ *
+ * reset() takes constant time: the blocks are kept and reused for the next
+ * frame, so an arena which is reset regularly stops calling malloc() once
+ * it has grown to the size needed by a frame.
+ *
+ * Arenas are not thread-safe. Objects created in an arena with the
+ * placement new operator below are not destroyed by reset(), so only
+ * objects without a meaningful destructor should be allocated there,
+ * unless their destructor is called explicitly.
+ */
+class Arena : NonCopyable {
+public:
+	/** Allocation statistics. Sizes are in bytes. */
+	struct Stats {
+		uint32 bytesUsed;            ///< Bytes allocated since the last reset()
+		uint32 allocations;          ///< Number of allocations since the last reset()
+		uint32 lastFrameBytes;       ///< Value of bytesUsed at the last reset()
+		uint32 lastFrameAllocations; ///< Value of allocations at the last reset()
+		uint32 peakBytes;            ///< Largest value of bytesUsed so far
+		uint32 peakAllocations;      ///< Largest value of allocations so far
+		uint32 reservedBytes;        ///< Size of all blocks held by the arena
+		uint32 frames;               ///< Number of calls to reset()
+	};
+
+	/**
+	 * Create an arena.
+	 *
+	 * @param blockSize	Size of the blocks obtained from malloc(). Larger
+	 *					allocations get a block of their own.
+	 */
+	explicit Arena(size_t blockSize = 64 * 1024);
+	~Arena();
+
+	/**
+	 * Allocate @p size bytes, aligned to @p alignment bytes, which has
+	 * to be a power of two. The memory is not initialized.
+	 */
+	void *allocate(size_t size, size_t alignment = 2 * sizeof(void *));
+
+	/** Allocate uninitialized storage for an array of @p count objects of type T. */
+	template<class T>
+	T *allocateArray(size_t count) {
+		return (T *)allocate(count * sizeof(T));
+	}
+
+	/**
+	 * Free everything allocated from the arena, keeping its memory for
+	 * later allocations. This also starts a new frame for the statistics.
+	 */
+	void reset();
+
+	/** Free everything allocated from the arena, and return its memory to the system. */
+	void release();
+
+	/** Return a snapshot of the allocation statistics. */
+	Stats getStats() const;
+
+private:
+	struct Block {
+		Block *next;
+		size_t size;	///< Usable size, not counting the header
+
+		byte *data() { return (byte *)(this + 1); }
+	};
+
+	void *allocateSlow(size_t size, size_t alignment);
+
+	const size_t _blockSize;
+	Block *_first;		///< First block in the chain
+	Block *_current;	///< Block currently allocated from, blocks after it are unused
+	size_t _offset;		///< Bytes used in _current
+
+	Stats _stats;
+};
+
+inline void *Arena::allocate(size_t size, size_t alignment) {
+	assert(alignment && (alignment & (alignment - 1)) == 0);
+
+	if (_current) {
+		const size_t start = (((size_t)_current->data() + _offset + alignment - 1) & ~(alignment - 1)) - (size_t)_current->data();
+		if (start + size <= _current->size) {
+			_offset = start + size;
+			_stats.bytesUsed += size;
+			_stats.allocations++;
+			return _current->data() + start;
+		}
+	}
+
+	return allocateSlow(size, alignment);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+/**
+ * A placement new operator, allocating the object in an Arena. Its
+ * destructor will not be called automatically.
+ */
+inline void *operator new(size_t nbytes, Common::Arena &arena) {
+	return arena.allocate(nbytes);
+}
+
+inline void operator delete(void *p, Common::Arena &arena) {
+	// Only called if a constructor throws; the memory is reclaimed on reset()
+}
+
+#endif
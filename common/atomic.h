@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic operations
+ * @ingroup common
+ *
+ * @brief Minimal set of atomic operations on integral values.
+ *
+ * These are used to share simple state between an engine thread and a
+ * backend thread (e.g. the audio callback) without taking a mutex. Loads
+ * have acquire and stores have release semantics, so data written before
+ * an atomicStore() is visible to a thread which observed the stored value
+ * through atomicLoad().
+ *
+ * On compilers without atomic builtins, plain volatile accesses are used,
+ * which is sufficient for the strongly ordered CPUs those targets run on.
+ * @{
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+
+template<typename T>
+inline T atomicLoad(const volatile T *ptr) {
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+template<typename T>
+inline void atomicStore(volatile T *ptr, T value) {
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+/** Atomically add @p value to @p *ptr, returning the new value. */
+template<typename T>
+inline T atomicAdd(volatile T *ptr, T value) {
+	return __atomic_add_fetch(ptr, value, __ATOMIC_ACQ_REL);
+}
+
+/**
+ * Atomically replace @p *ptr with @p desired if it equals @p expected.
+ * @return True if the value was replaced.
+ */
+template<typename T>
+inline bool atomicCompareExchange(volatile T *ptr, T expected, T desired) {
+	return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+#else
+
+template<typename T>
+inline T atomicLoad(const volatile T *ptr) {
+	return *ptr;
+}
+
+template<typename T>
+inline void atomicStore(volatile T *ptr, T value) {
+	*ptr = value;
+}
+
+template<typename T>
+inline T atomicAdd(volatile T *ptr, T value) {
+	return *ptr += value;
+}
+
+template<typename T>
+inline bool atomicCompareExchange(volatile T *ptr, T expected, T desired) {
+	if (*ptr != expected)
+		return false;
+	*ptr = desired;
+	return true;
+}
+
+#endif
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,724 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The flat hash map in this file follows the design of the "Swiss tables"
+// used by Abseil: entries are stored inline, and a separate array of
+// control bytes, holding 7 bits of the hash of each entry, is scanned 16
+// entries at a time to find candidate slots. Unlike Abseil, keys and values
+// are kept in separate arrays.
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/hashmap.h"
+#include "common/math.h"
+
+#if defined(__SSE2__)
+#define FLAT_HASHMAP_SSE2
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#define FLAT_HASHMAP_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_flat_hashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on a hash table with inline storage.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> maps objects of type Key to objects of type Val, just
+ * like HashMap, and offers the same interface, so that code can switch from
+ * one to the other by changing the type.
+ *
+ * Unlike HashMap, the entries are not allocated separately. The keys and
+ * the values are stored in two arrays, so lookups do not have to follow a
+ * pointer to each probed entry, probing only touches the keys, and iterating
+ * over the map walks memory linearly. A separate array of control bytes
+ * records for each slot whether it is empty, deleted, or full, together with
+ * 7 bits of the hash of the key stored in it. Lookups compare 16 control
+ * bytes at once (with SSE2 or NEON where available) and only call the
+ * equality functor on slots whose hash bits match.
+ *
+ * Since there are no nodes, iterators return a NodeRef holding references
+ * to the key and the value instead, which offers the same _key and _value
+ * members as the nodes of HashMap.
+ *
+ * As a consequence, inserting into a FlatHashMap may move the existing
+ * entries, so references to values and iterators are invalidated whenever
+ * a new key is added. Erasing an entry leaves all other entries in place.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+private:
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	enum {
+		FLAT_HASHMAP_GROUP_SIZE = 16,
+		FLAT_HASHMAP_MIN_CAPACITY = 16,
+
+		// The map is grown once more than 7/8 of the slots are in use,
+		// counting deleted slots.
+		FLAT_HASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLAT_HASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+	/** Control byte values. Full slots hold 7 bits of the hash instead. */
+	enum {
+		kCtrlEmpty = 0x80,
+		kCtrlDeleted = 0xFE
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	byte *_ctrl;		///< Control byte for every slot
+	Key *_keys;			///< Keys of the entries, only full slots are constructed
+	Val *_values;		///< Values of the entries, only full slots are constructed
+	size_type _mask;	///< Capacity of the FlatHashMap minus one; the capacity is a power of two
+	size_type _size;
+	size_type _deleted;	///< Number of deleted slots
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/**
+	 * Scramble the result of the hash functor. Many of the hash functions
+	 * (e.g. the one for integers) return their input unchanged, but all bits
+	 * of the result are used here.
+	 */
+	static uint32 mixHash(size_type hash) {
+		uint32 h = (uint32)hash * 0x9E3779B1;
+		return h ^ (h >> 16);
+	}
+
+	/** The 7 bits of the hash stored in the control byte. */
+	static byte hashTag(uint32 hash) { return hash & 0x7F; }
+	/** The first slot of the first group probed for the hash. */
+	size_type hashStart(uint32 hash) const { return (hash >> 7) & _mask & ~(size_type)(FLAT_HASHMAP_GROUP_SIZE - 1); }
+
+	/** Return a bit mask of the slots in the group at @p ctrl whose control byte is @p value. */
+	static uint32 matchGroup(const byte *ctrl, byte value);
+	/** Return a bit mask of the slots in the group at @p ctrl which are empty or deleted. */
+	static uint32 matchFreeGroup(const byte *ctrl);
+
+	static int lowestBit(uint32 mask) { return intLog2(mask & (0 - mask)); }
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const HM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	size_type findFreeSlot(uint32 hash) const;
+	size_type nextFull(size_type idx) const;
+	void constructSlot(size_type idx, const Key &key);
+	void constructSlot(size_type idx, const Key &key, const Val &value);
+	void destroySlot(size_type idx);
+	void eraseSlot(size_type idx);
+	void rehash(size_type newCapacity);
+
+public:
+	/**
+	 * An entry of the map, as returned by its iterators: references to the
+	 * key and the value, which are stored in separate arrays.
+	 */
+	template<class ValType>
+	struct NodeRef {
+		const Key &_key;
+		ValType &_value;
+		NodeRef(const Key &key, ValType &value) : _key(key), _value(value) {}
+	};
+
+private:
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class ValType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+		typedef NodeRef<ValType> node_t;
+
+		/** Keeps the NodeRef returned by operator->() alive. */
+		struct NodePtr {
+			node_t _node;
+			explicit NodePtr(const node_t &node) : _node(node) {}
+			const node_t *operator->() const { return &_node; }
+		};
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		node_t deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(!(_hashmap->_ctrl[_idx] & kCtrlEmpty));
+			return node_t(_hashmap->_keys[_idx], _hashmap->_values[_idx]);
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		node_t operator*() const { return deref(); }
+		NodePtr operator->() const { return NodePtr(deref()); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			_idx = _hashmap->nextFull(_idx + 1);
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Val> iterator;
+	typedef IteratorImpl<const Val> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	/**
+	 * Make room for at least @p count entries, so that they can be added
+	 * without the map having to grow in between.
+	 */
+	void reserve(size_type count);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		return iterator(nextFull(0), this);
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		return const_iterator(nextFull(0), this);
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLAT_HASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+uint32 FlatHashMap<Key, Val, HashFunc, EqualFunc>::matchGroup(const byte *ctrl, byte value) {
+#if defined(FLAT_HASHMAP_SSE2)
+	const __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)value)));
+#elif defined(FLAT_HASHMAP_NEON)
+	static const uint8 bitWeights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	const uint8x16_t match = vandq_u8(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(value)), vld1q_u8(bitWeights));
+	return vaddv_u8(vget_low_u8(match)) | (vaddv_u8(vget_high_u8(match)) << 8);
+#else
+	uint32 mask = 0;
+	for (int i = 0; i < FLAT_HASHMAP_GROUP_SIZE; ++i) {
+		if (ctrl[i] == value)
+			mask |= 1 << i;
+	}
+	return mask;
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+uint32 FlatHashMap<Key, Val, HashFunc, EqualFunc>::matchFreeGroup(const byte *ctrl) {
+	// Empty and deleted slots are the ones with the top bit set
+#if defined(FLAT_HASHMAP_SSE2)
+	return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#elif defined(FLAT_HASHMAP_NEON)
+	static const uint8 bitWeights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	const uint8x16_t match = vandq_u8(vcltzq_s8(vld1q_s8((const int8 *)ctrl)), vld1q_u8(bitWeights));
+	return vaddv_u8(vget_low_u8(match)) | (vaddv_u8(vget_high_u8(match)) << 8);
+#else
+	uint32 mask = 0;
+	for (int i = 0; i < FLAT_HASHMAP_GROUP_SIZE; ++i) {
+		if (ctrl[i] & kCtrlEmpty)
+			mask |= 1 << i;
+	}
+	return mask;
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	assert(capacity >= FLAT_HASHMAP_MIN_CAPACITY && (capacity & (capacity - 1)) == 0);
+
+	_mask = capacity - 1;
+	_size = 0;
+	_deleted = 0;
+
+	_ctrl = (byte *)malloc(capacity);
+	_keys = (Key *)malloc(capacity * sizeof(Key));
+	_values = (Val *)malloc(capacity * sizeof(Val));
+	if (!_ctrl || !_keys || !_values)
+		error("FlatHashMap: Failed to allocate storage for %u entries", capacity);
+	memset(_ctrl, kCtrlEmpty, capacity);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (size_type ctr = nextFull(0); ctr != (size_type)-1; ctr = nextFull(ctr + 1))
+		destroySlot(ctr);
+
+	free(_ctrl);
+	free(_keys);
+	free(_values);
+	_ctrl = nullptr;
+	_keys = nullptr;
+	_values = nullptr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::constructSlot(size_type idx, const Key &key) {
+	new ((void *)&_keys[idx]) Key(key);
+	new ((void *)&_values[idx]) Val();
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::constructSlot(size_type idx, const Key &key, const Val &value) {
+	new ((void *)&_keys[idx]) Key(key);
+	new ((void *)&_values[idx]) Val(value);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::destroySlot(size_type idx) {
+	_keys[idx].~Key();
+	_values[idx].~Val();
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// Both maps use the same hash function and capacity, so the entries
+	// can be copied slot by slot.
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+	for (size_type ctr = map.nextFull(0); ctr != (size_type)-1; ctr = map.nextFull(ctr + 1))
+		constructSlot(ctr, map._keys[ctr], map._values[ctr]);
+
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLAT_HASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLAT_HASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (size_type ctr = nextFull(0); ctr != (size_type)-1; ctr = nextFull(ctr + 1))
+		destroySlot(ctr);
+	memset(_ctrl, kCtrlEmpty, _mask + 1);
+
+	_size = 0;
+	_deleted = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::reserve(size_type count) {
+	size_type capacity = _mask + 1;
+	while (count * FLAT_HASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLAT_HASHMAP_LOADFACTOR_NUMERATOR)
+		capacity *= 2;
+
+	if (capacity > _mask + 1)
+		rehash(capacity);
+}
+
+/**
+ * Return the index of the first full slot at or after @p idx, or
+ * (size_type)-1 if there is none.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::nextFull(size_type idx) const {
+	if (!_ctrl)
+		return (size_type)-1;
+
+	while (idx <= _mask) {
+		const size_type group = idx & ~(size_type)(FLAT_HASHMAP_GROUP_SIZE - 1);
+		// Ignore the slots in the group before idx
+		const uint32 full = ~matchFreeGroup(_ctrl + group) & (0xFFFF << (idx - group)) & 0xFFFF;
+		if (full)
+			return group + lowestBit(full);
+		idx = group + FLAT_HASHMAP_GROUP_SIZE;
+	}
+
+	return (size_type)-1;
+}
+
+/**
+ * Return the first empty or deleted slot on the probe sequence of @p hash.
+ * There must be at least one.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeSlot(uint32 hash) const {
+	size_type pos = hashStart(hash);
+	for (size_type step = FLAT_HASHMAP_GROUP_SIZE; ; step += FLAT_HASHMAP_GROUP_SIZE) {
+		const uint32 freeSlots = matchFreeGroup(_ctrl + pos);
+		if (freeSlots)
+			return pos + lowestBit(freeSlots);
+
+		// Triangular probing over the groups visits every group once
+		pos = (pos + step) & _mask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	assert(newCapacity > _size);
+
+	const size_type oldMask = _mask;
+	byte *oldCtrl = _ctrl;
+	Key *oldKeys = _keys;
+	Val *oldValues = _values;
+#ifndef NDEBUG
+	const size_type oldSize = _size;
+#endif
+
+	allocStorage(newCapacity);
+
+	// Move all the old elements. Since we know that no key exists twice in
+	// the old table, the keys don't have to be compared.
+	for (size_type ctr = 0; ctr <= oldMask; ++ctr) {
+		if (oldCtrl[ctr] & kCtrlEmpty)
+			continue;
+
+		const uint32 hash = mixHash(_hash(oldKeys[ctr]));
+		const size_type idx = findFreeSlot(hash);
+		_ctrl[idx] = hashTag(hash);
+		constructSlot(idx, oldKeys[ctr], oldValues[ctr]);
+		oldKeys[ctr].~Key();
+		oldValues[ctr].~Val();
+		_size++;
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	assert(_size == oldSize);
+
+	free(oldCtrl);
+	free(oldKeys);
+	free(oldValues);
+}
+
+/**
+ * Return the slot holding @p key, or (size_type)-1 if it is not in the map.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const uint32 hash = mixHash(_hash(key));
+	const byte tag = hashTag(hash);
+	size_type pos = hashStart(hash);
+
+	for (size_type step = FLAT_HASHMAP_GROUP_SIZE; step <= _mask + 1; step += FLAT_HASHMAP_GROUP_SIZE) {
+		const byte *group = _ctrl + pos;
+		for (uint32 match = matchGroup(group, tag); match; match &= match - 1) {
+			const size_type idx = pos + lowestBit(match);
+			if (_equal(_keys[idx], key))
+				return idx;
+		}
+
+		// A key is never stored past a group with an empty slot
+		if (matchGroup(group, kCtrlEmpty))
+			break;
+
+		pos = (pos + step) & _mask;
+	}
+
+	return (size_type)-1;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return ctr;
+
+	// Keep the load factor below a certain threshold.
+	// Deleted slots are also counted.
+	size_type capacity = _mask + 1;
+	if ((_size + _deleted + 1) * FLAT_HASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLAT_HASHMAP_LOADFACTOR_NUMERATOR) {
+		// Only grow if the map is really filling up, otherwise getting rid
+		// of the deleted slots is enough.
+		if ((_size + 1) * 2 * FLAT_HASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLAT_HASHMAP_LOADFACTOR_NUMERATOR)
+			capacity *= 2;
+		rehash(capacity);
+	}
+
+	const uint32 hash = mixHash(_hash(key));
+	ctr = findFreeSlot(hash);
+	if (_ctrl[ctr] == kCtrlDeleted)
+		_deleted--;
+	_ctrl[ctr] = hashTag(hash);
+	constructSlot(ctr, key);
+	_size++;
+
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type idx) {
+	destroySlot(idx);
+	_size--;
+
+	// Lookups stop at the first group containing an empty slot. If the
+	// group of the erased slot already has one, no lookup can have passed
+	// through it, and the slot can become empty again.
+	const size_type group = idx & ~(size_type)(FLAT_HASHMAP_GROUP_SIZE - 1);
+	if (matchGroup(_ctrl + group, kCtrlEmpty)) {
+		_ctrl[idx] = kCtrlEmpty;
+	} else {
+		_ctrl[idx] = kCtrlDeleted;
+		_deleted++;
+	}
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != (size_type)-1;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap, adding the key if it is not present.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// The lookup may reallocate the slots, so it has to happen first
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	return _values[ctr];
+}
+
+/**
+ * Get a value from the hashmap. The key has to be present, see HashMap::getVal().
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _values[ctr];
+	else
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _values[ctr];
+	else
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _values[ctr];
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1) {
+		out = _values[ctr];
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	_values[ctr] = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	assert(entry._idx <= _mask);
+	assert(!(_ctrl[entry._idx] & kCtrlEmpty));
+
+	eraseSlot(entry._idx);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		eraseSlot(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -223,6 +223,16 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Retrieve the size and the time of the last modification of the file
+	 * referred by this node, without opening it. The time is in seconds,
+	 * relative to an epoch which depends on the backend, so it should only
+	 * be compared with other values returned by this method.
+	 *
+	 * @return True if both values are known, false otherwise.
+	 */
+	bool getFileStatus(int64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -24,8 +24,9 @@
 #ifndef COMMON_HUFFMAN_H
 #define COMMON_HUFFMAN_H
 
+#include "common/algorithm.h"
 #include "common/array.h"
-#include "common/list.h"
+#include "common/textconsole.h"
 #include "common/types.h"
 
 namespace Common {
@@ -54,6 +55,13 @@ inline uint32 REVERSEBITS(uint32 x) {
 /**
  * Huffman bit stream decoding.
  *
+ * The codes are decoded with lookup tables indexed by the next bits of the
+ * stream. Codes that do not fit in the first table continue in a second level
+ * table for their prefix, so that codes of up to 24 bits take at most two
+ * lookups. Longer codes use further levels.
+ *
+ * The codes are read starting with their most significant bit from MSB2LSB
+ * bit streams, and with their least significant bit from LSB2MSB ones.
  */
 template<class BITSTREAM>
 class Huffman {
@@ -71,30 +79,68 @@ public:
 	/** Return the next symbol in the bit stream. */
 	uint32 getSymbol(BITSTREAM &bits) const;
 
-private:
-	struct Symbol {
-		uint32 code;
-		uint32 symbol;
+	/** Decode the next @p count symbols in the bit stream into @p symbols. */
+	template<typename T>
+	void getSymbols(BITSTREAM &bits, T *symbols, uint32 count) const;
 
-		Symbol(uint32 c, uint32 s) : code(c), symbol(s) {}
+private:
+	enum {
+		kMaxTableBits = 10,    ///< Maximal number of index bits of the first level table.
+		kMaxSubTableBits = 14, ///< Maximal number of index bits of the next level tables.
+		kInvalidLength = 0xFF
 	};
 
-	typedef List<Symbol> CodeList;
-	typedef Array<CodeList> CodeLists;
+	struct TableEntry {
+		uint32 value;        ///< The symbol, or the offset of the next level table.
+		uint8  length;       ///< The bits of the code matched by this entry.
+		uint8  subTableBits; ///< The index bits of the next level table, 0 if the entry is a symbol.
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+		TableEntry() : value(0), length(kInvalidLength), subTableBits(0) {}
+	};
 
-	/** Prefix lookup table used to speed up the decoding of short codes. */
-	struct PrefixEntry {
+	/** A code, or what is left of it after the previous table levels. */
+	struct Code {
+		uint32 code;
 		uint32 symbol;
 		uint8  length;
+	};
+
+	/** Orders the codes by their first @p bits bits. */
+	struct PrefixLess {
+		uint8 bits;
 
-		PrefixEntry() : length(0xFF) {}
+		PrefixLess(uint8 b) : bits(b) {}
+
+		bool operator()(const Code &a, const Code &b) const {
+			return (a.code >> (a.length - bits)) < (b.code >> (b.length - bits));
+		}
 	};
 
-	static const uint8 _prefixTableBits = 8;
-	PrefixEntry _prefixTable[1 << _prefixTableBits];
+	/** All the lookup tables, starting with the first level one. */
+	Array<TableEntry> _table;
+	uint8 _tableBits;
+
+	/** Position in a table of the entry for the code bits @p index, in the bit stream order. */
+	static uint32 tableIndex(uint32 index, uint8 tableBits) {
+		return BITSTREAM::isMSB2LSB() ? index : REVERSEBITS(index) >> (32 - tableBits);
+	}
+
+	void buildTable(uint32 offset, uint8 tableBits, Code *codes, uint32 count);
+
+	const TableEntry &lookup(BITSTREAM &bits) const {
+		const TableEntry *entry = &_table.data()[bits.peekBits(_tableBits)];
+
+		while (entry->subTableBits) {
+			bits.skip(entry->length);
+			entry = &_table.data()[entry->value + bits.peekBits(entry->subTableBits)];
+		}
+
+		if (entry->length == kInvalidLength)
+			error("Unknown Huffman code");
+
+		bits.skip(entry->length);
+		return *entry;
+	}
 };
 
 template <class BITSTREAM>
@@ -108,64 +154,88 @@ Huffman<BITSTREAM>::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *cod
 		for (uint32 i = 0; i < codeCount; i++)
 			maxLength = MAX(maxLength, lengths[i]);
 
-	assert(maxLength <= 32);
-
-	// Codes that do not fit in the prefix table are stored in the _codes array.
-	_codes.resize(MAX(maxLength - _prefixTableBits, 0));
+	assert(maxLength > 0 && maxLength <= 32);
 
+	Array<Code> codeList;
+	codeList.reserve(codeCount);
 	for (uint i = 0; i < codeCount; i++) {
-		uint8 length = lengths[i];
+		if (lengths[i] == 0)
+			continue;
 
+		// The tables are built with the first bit of each code as its most significant one
+		Code code;
+		code.code = BITSTREAM::isMSB2LSB() ? codes[i] : REVERSEBITS(codes[i]) >> (32 - lengths[i]);
+		code.length = lengths[i];
 		// The symbol. If none was specified, assume it is identical to the code index.
-		uint32 symbol = symbols ? symbols[i] : i;
-
-		if (length <= _prefixTableBits) {
-			// Short codes go in the prefix lookup table. Set all the entries in the table
-			// with an index starting with the code to the symbol value.
-			uint32 startIndex;
-			if (BITSTREAM::isMSB2LSB()) {
-				startIndex = codes[i] << (_prefixTableBits - length);
-			} else {
-				startIndex = REVERSEBITS(codes[i]) >> (32 - _prefixTableBits);
-			}
-
-			uint32 endIndex = startIndex | ((1 << (_prefixTableBits - length)) - 1);
-
-			for (uint32 j = startIndex; j <= endIndex; j++) {
-				uint32 index = BITSTREAM::isMSB2LSB() ? j : REVERSEBITS(j) >> (32 - _prefixTableBits);
-				_prefixTable[index].symbol = symbol;
-				_prefixTable[index].length = length;
-			}
-		} else {
-			// Put the code and symbol into the correct list for the length.
-			_codes[lengths[i] - 1 - _prefixTableBits].push_back(Symbol(codes[i], symbol));
-		}
+		code.symbol = symbols ? symbols[i] : i;
+		codeList.push_back(code);
 	}
+
+	_tableBits = MIN<uint8>(maxLength, kMaxTableBits);
+	_table.resize(1 << _tableBits);
+	buildTable(0, _tableBits, codeList.data(), codeList.size());
 }
 
 template <class BITSTREAM>
-uint32 Huffman<BITSTREAM>::getSymbol(BITSTREAM &bits) const {
-	uint32 code = bits.peekBits(_prefixTableBits);
+void Huffman<BITSTREAM>::buildTable(uint32 offset, uint8 tableBits, Code *codes, uint32 count) {
+	// Short codes fill all the entries with an index starting with the code.
+	// The longer ones are moved to the front of the list.
+	uint32 longCount = 0;
+	for (uint32 i = 0; i < count; i++) {
+		const Code &code = codes[i];
+		if (code.length > tableBits) {
+			codes[longCount++] = code;
+			continue;
+		}
+
+		const uint32 startIndex = code.code << (tableBits - code.length);
+		const uint32 endIndex = startIndex | ((1u << (tableBits - code.length)) - 1);
+		for (uint32 j = startIndex; j <= endIndex; j++) {
+			TableEntry &entry = _table[offset + tableIndex(j, tableBits)];
+			entry.value = code.symbol;
+			entry.length = code.length;
+			entry.subTableBits = 0;
+		}
+	}
 
-	uint8 length = _prefixTable[code].length;
+	// The long codes sharing a prefix go in a next level table, large enough
+	// for the longest of them.
+	sort(codes, codes + longCount, PrefixLess(tableBits));
+	for (uint32 first = 0; first < longCount;) {
+		const uint32 prefix = codes[first].code >> (codes[first].length - tableBits);
+		uint8 maxLength = 0;
+		uint32 last = first;
+		for (; last < longCount && (codes[last].code >> (codes[last].length - tableBits)) == prefix; last++) {
+			Code &code = codes[last];
+			code.length -= tableBits;
+			code.code &= (1u << code.length) - 1;
+			maxLength = MAX(maxLength, code.length);
+		}
 
-	if (length != 0xFF) {
-		bits.skip(length);
-		return _prefixTable[code].symbol;
-	} else {
-		bits.skip(_prefixTableBits);
+		const uint8 subTableBits = MIN<uint8>(maxLength, kMaxSubTableBits);
+		const uint32 subTableOffset = _table.size();
+		_table.resize(subTableOffset + (1 << subTableBits));
 
-		for (uint32 i = 0; i < _codes.size(); i++) {
-			bits.addBit(code, i + _prefixTableBits);
+		TableEntry &entry = _table[offset + tableIndex(prefix, tableBits)];
+		entry.value = subTableOffset;
+		entry.length = tableBits;
+		entry.subTableBits = subTableBits;
 
-			for (typename CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-				if (code == cCode->code)
-					return cCode->symbol;
-		}
+		buildTable(subTableOffset, subTableBits, codes + first, last - first);
+		first = last;
 	}
+}
 
-	error("Unknown Huffman code");
-	return 0;
+template <class BITSTREAM>
+uint32 Huffman<BITSTREAM>::getSymbol(BITSTREAM &bits) const {
+	return lookup(bits).value;
+}
+
+template <class BITSTREAM>
+template <typename T>
+void Huffman<BITSTREAM>::getSymbols(BITSTREAM &bits, T *symbols, uint32 count) const {
+	for (uint32 i = 0; i < count; i++)
+		symbols[i] = lookup(bits).value;
 }
 
 /** @} */
@@ -78,6 +78,9 @@ public:
 	int64 size() const { return _size; }
 
 	bool seek(int64 offs, int whence = SEEK_SET);
+
+	/** Return the buffer this stream reads from. */
+	const byte *getData() const { return _ptrOrig; }
 };
 
 
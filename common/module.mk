@@ -3,6 +3,7 @@ MODULE := common
 MODULE_OBJS := \
 	achievements.o \
 	archive.o \
+	arena.o \
 	base-str.o \
 	config-manager.o \
 	coroutines.o \
@@ -29,6 +30,7 @@ MODULE_OBJS := \
 	osd_message_queue.o \
 	path.o \
 	platform.o \
+	pool-allocator.o \
 	punycode.o \
 	quicktime.o \
 	random.o \
@@ -54,6 +56,7 @@ MODULE_OBJS := \
 	winexe.o \
 	winexe_ne.o \
 	winexe_pe.o \
+	worker-pool.o \
 	xmlparser.o \
 	zlib.o
 
@@ -0,0 +1,410 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/pool-allocator.h"
+#include "common/atomic.h"
+#include "common/memorypool.h"
+#include "common/textconsole.h"
+
+// Ports whose compiler or runtime lacks support for thread_local can define
+// POOL_ALLOCATOR_NO_THREAD_CACHE, in which case every allocation goes
+// through the shared pools.
+#if !defined(POOL_ALLOCATOR_NO_THREAD_CACHE) && (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900))
+#define POOL_ALLOCATOR_THREAD_CACHE
+#endif
+
+namespace Common {
+
+enum {
+	/** Size classes: 16 to 128 bytes in steps of 16, then up to 256 in steps of 32. */
+	kNumSizeClasses = 12,
+	/** Number of chunks moved between a thread cache and the shared pools at once. */
+	kBatchSize = 32,
+	/** Maximum number of chunks a thread keeps for each size class. */
+	kMaxCachedChunks = 2 * kBatchSize,
+	/** Change of the bytes in use after which a thread updates the peak. */
+	kPeakGranularity = 16 * 1024
+};
+
+static const uint16 sizeClassSizes[kNumSizeClasses] = {
+	16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256
+};
+
+static inline int getSizeClass(size_t size) {
+	if (size <= 128)
+		return size ? (int)((size - 1) >> 4) : 0;
+	return 8 + (int)((size - 129) >> 5);
+}
+
+/**
+ * Since the critical sections are only a few instructions long, the shared
+ * state is protected by spin locks rather than Common::Mutex, which also
+ * cannot be used before the backend has been created.
+ */
+struct SpinLock {
+	volatile int value;
+
+	void acquire() {
+		while (!atomicCompareExchange(&value, 0, 1)) {
+			while (atomicLoad(&value))
+				;
+		}
+	}
+
+	void release() {
+		atomicStore(&value, 0);
+	}
+};
+
+/** The shared pools. */
+struct SharedPool {
+	explicit SharedPool(size_t chunkSize) : pool(chunkSize) { lock.value = 0; }
+
+	void acquire() { lock.acquire(); }
+	void release() { lock.release(); }
+
+	MemoryPool pool;
+	SpinLock lock;
+};
+
+struct SharedPools {
+	SharedPools() {
+		for (int i = 0; i < kNumSizeClasses; ++i)
+			pools[i] = new SharedPool(sizeClassSizes[i]);
+	}
+
+	~SharedPools() {
+		for (int i = 0; i < kNumSizeClasses; ++i)
+			delete pools[i];
+	}
+
+	SharedPool *pools[kNumSizeClasses];
+};
+
+static SharedPool &getSharedPool(int sizeClass) {
+	// Constructed on first use, so that allocations from static
+	// constructors of other translation units work.
+	static SharedPools sharedPools;
+	return *sharedPools.pools[sizeClass];
+}
+
+/**
+ * Allocation counters. Every thread with a cache counts its own allocations,
+ * so that allocating does not write to memory shared with other threads, and
+ * getStats() adds the counters of all threads up. The byte counts wrap
+ * around; only their difference is used.
+ */
+struct StatCounters {
+	volatile uint32 allocations;
+	volatile uint32 deallocations;
+	volatile uint32 largeAllocations;
+	volatile uint32 bytesAllocated;
+	volatile uint32 bytesFreed;
+
+	/** Count an allocation by the thread owning these counters. */
+	void countAllocation(uint32 size, bool large) {
+		// Only the owning thread writes, so no read-modify-write is needed
+		atomicStore(&allocations, allocations + 1);
+		atomicStore(&bytesAllocated, bytesAllocated + size);
+		if (large)
+			atomicStore(&largeAllocations, largeAllocations + 1);
+	}
+
+	void countDeallocation(uint32 size) {
+		atomicStore(&deallocations, deallocations + 1);
+		atomicStore(&bytesFreed, bytesFreed + size);
+	}
+
+	/** Add the given counts to these counters, which may be shared between threads. */
+	void addShared(uint32 otherAllocations, uint32 otherDeallocations, uint32 otherLargeAllocations, uint32 otherBytesAllocated, uint32 otherBytesFreed) {
+		atomicAdd(&allocations, otherAllocations);
+		atomicAdd(&deallocations, otherDeallocations);
+		atomicAdd(&largeAllocations, otherLargeAllocations);
+		atomicAdd(&bytesAllocated, otherBytesAllocated);
+		atomicAdd(&bytesFreed, otherBytesFreed);
+	}
+
+	void addTo(PoolAllocator::Stats &stats, uint32 &bytesFreedTotal) const {
+		stats.allocations += atomicLoad(&allocations);
+		stats.deallocations += atomicLoad(&deallocations);
+		stats.largeAllocations += atomicLoad(&largeAllocations);
+		stats.bytesInUse += atomicLoad(&bytesAllocated);
+		bytesFreedTotal += atomicLoad(&bytesFreed);
+	}
+};
+
+/**
+ * The counters of the allocations made without a thread cache, and of the
+ * threads which have exited.
+ */
+static StatCounters sharedStats;
+
+/**
+ * The bytes in use by all threads, to track the peak as it happens. Threads
+ * with a cache only add their changes in steps of kPeakGranularity bytes, so
+ * this may be off by that much for every thread, and may even be negative.
+ */
+static volatile int32 statBytesInUse = 0;
+static volatile int32 statPeakBytesInUse = 0;
+
+static void addBytesInUse(int32 bytes) {
+	const int32 inUse = atomicAdd(&statBytesInUse, bytes);
+	int32 peak = atomicLoad(&statPeakBytesInUse);
+	while (inUse > peak && !atomicCompareExchange(&statPeakBytesInUse, peak, inUse))
+		peak = atomicLoad(&statPeakBytesInUse);
+}
+
+static void *allocateLarge(size_t size) {
+	void *ptr = malloc(size);
+	if (!ptr)
+		error("PoolAllocator: Failed to allocate %u bytes", (uint)size);
+	return ptr;
+}
+
+static void *allocateShared(int sizeClass) {
+	SharedPool &shared = getSharedPool(sizeClass);
+	shared.acquire();
+	void *chunk = shared.pool.allocChunk();
+	shared.release();
+	return chunk;
+}
+
+static void deallocateShared(void *ptr, int sizeClass) {
+	SharedPool &shared = getSharedPool(sizeClass);
+	shared.acquire();
+	shared.pool.freeChunk(ptr);
+	shared.release();
+}
+
+#ifdef POOL_ALLOCATOR_THREAD_CACHE
+
+struct ThreadCache;
+
+/** All live thread caches, for getStats(), protected by threadCachesLock. */
+static ThreadCache *threadCaches = nullptr;
+static SpinLock threadCachesLock;
+
+/** Free chunks owned by one thread, kept as singly linked lists. */
+struct ThreadCache {
+	void *freeChunks[kNumSizeClasses];
+	uint count[kNumSizeClasses];
+
+	StatCounters stats;
+	/** Change of the bytes in use not yet added to statBytesInUse. */
+	int32 unpublishedBytes;
+	ThreadCache *next;
+
+	ThreadCache() : unpublishedBytes(0) {
+		for (int i = 0; i < kNumSizeClasses; ++i) {
+			freeChunks[i] = nullptr;
+			count[i] = 0;
+		}
+		stats.allocations = stats.deallocations = stats.largeAllocations = 0;
+		stats.bytesAllocated = stats.bytesFreed = 0;
+
+		threadCachesLock.acquire();
+		next = threadCaches;
+		threadCaches = this;
+		threadCachesLock.release();
+	}
+
+	~ThreadCache();
+
+	void countAllocation(uint32 size, bool large) {
+		stats.countAllocation(size, large);
+		unpublishedBytes += size;
+		if (unpublishedBytes >= kPeakGranularity)
+			publishBytesInUse();
+	}
+
+	void countDeallocation(uint32 size) {
+		stats.countDeallocation(size);
+		unpublishedBytes -= size;
+		if (unpublishedBytes <= -kPeakGranularity)
+			publishBytesInUse();
+	}
+
+	void publishBytesInUse() {
+		addBytesInUse(unpublishedBytes);
+		unpublishedBytes = 0;
+	}
+
+	void *allocate(int sizeClass) {
+		if (!freeChunks[sizeClass])
+			refill(sizeClass);
+
+		void *chunk = freeChunks[sizeClass];
+		freeChunks[sizeClass] = *(void **)chunk;
+		count[sizeClass]--;
+		return chunk;
+	}
+
+	void deallocate(void *ptr, int sizeClass) {
+		*(void **)ptr = freeChunks[sizeClass];
+		freeChunks[sizeClass] = ptr;
+		if (++count[sizeClass] > kMaxCachedChunks)
+			giveBack(sizeClass, kBatchSize);
+	}
+
+	void refill(int sizeClass) {
+		SharedPool &shared = getSharedPool(sizeClass);
+		shared.acquire();
+		for (int i = 0; i < kBatchSize; ++i) {
+			void *chunk = shared.pool.allocChunk();
+			*(void **)chunk = freeChunks[sizeClass];
+			freeChunks[sizeClass] = chunk;
+		}
+		shared.release();
+		count[sizeClass] += kBatchSize;
+	}
+
+	void giveBack(int sizeClass, uint chunks) {
+		SharedPool &shared = getSharedPool(sizeClass);
+		shared.acquire();
+		for (uint i = 0; i < chunks; ++i) {
+			void *chunk = freeChunks[sizeClass];
+			freeChunks[sizeClass] = *(void **)chunk;
+			shared.pool.freeChunk(chunk);
+		}
+		shared.release();
+		count[sizeClass] -= chunks;
+	}
+
+	void flush() {
+		for (int i = 0; i < kNumSizeClasses; ++i) {
+			if (count[i])
+				giveBack(i, count[i]);
+		}
+	}
+};
+
+static thread_local ThreadCache threadCache;
+
+/**
+ * Set once the cache of the thread has been destroyed. Objects freed after
+ * that (e.g. by destructors of global objects when the main thread exits) go
+ * straight to the shared pools. Being trivially destructible, this can still
+ * be read when threadCache itself is gone.
+ */
+static thread_local bool threadCacheDestroyed = false;
+
+ThreadCache::~ThreadCache() {
+	flush();
+	publishBytesInUse();
+	threadCacheDestroyed = true;
+
+	// Hand the counters over to the shared ones
+	threadCachesLock.acquire();
+	ThreadCache **link = &threadCaches;
+	while (*link != this)
+		link = &(*link)->next;
+	*link = next;
+	sharedStats.addShared(stats.allocations, stats.deallocations, stats.largeAllocations, stats.bytesAllocated, stats.bytesFreed);
+	threadCachesLock.release();
+}
+
+static ThreadCache *getThreadCache() {
+	// The first access constructs the cache of the thread
+	return threadCacheDestroyed ? nullptr : &threadCache;
+}
+
+#endif
+
+void *PoolAllocator::allocate(size_t size) {
+	const bool large = size > kMaxPooledSize;
+	const int sizeClass = large ? 0 : getSizeClass(size);
+	const uint32 bytes = large ? (uint32)size : sizeClassSizes[sizeClass];
+
+#ifdef POOL_ALLOCATOR_THREAD_CACHE
+	ThreadCache *cache = getThreadCache();
+	if (cache) {
+		cache->countAllocation(bytes, large);
+		return large ? allocateLarge(size) : cache->allocate(sizeClass);
+	}
+#endif
+	sharedStats.addShared(1, 0, large ? 1 : 0, bytes, 0);
+	addBytesInUse(bytes);
+	return large ? allocateLarge(size) : allocateShared(sizeClass);
+}
+
+void PoolAllocator::deallocate(void *ptr, size_t size) {
+	if (!ptr)
+		return;
+
+	const bool large = size > kMaxPooledSize;
+	const int sizeClass = large ? 0 : getSizeClass(size);
+	const uint32 bytes = large ? (uint32)size : sizeClassSizes[sizeClass];
+
+#ifdef POOL_ALLOCATOR_THREAD_CACHE
+	ThreadCache *cache = getThreadCache();
+	if (cache) {
+		cache->countDeallocation(bytes);
+		if (large)
+			free(ptr);
+		else
+			cache->deallocate(ptr, sizeClass);
+		return;
+	}
+#endif
+	sharedStats.addShared(0, 1, 0, 0, bytes);
+	addBytesInUse(-(int32)bytes);
+	if (large)
+		free(ptr);
+	else
+		deallocateShared(ptr, sizeClass);
+}
+
+void PoolAllocator::flushThreadCache() {
+#ifdef POOL_ALLOCATOR_THREAD_CACHE
+	ThreadCache *cache = getThreadCache();
+	if (cache)
+		cache->flush();
+#endif
+}
+
+PoolAllocator::Stats PoolAllocator::getStats() {
+	Stats stats;
+	stats.bytesInUse = stats.allocations = stats.deallocations = stats.largeAllocations = 0;
+	uint32 bytesFreed = 0;
+
+#ifdef POOL_ALLOCATOR_THREAD_CACHE
+	// Exiting threads move their counters to sharedStats with the lock held,
+	// so they are counted exactly once
+	threadCachesLock.acquire();
+	for (const ThreadCache *cache = threadCaches; cache; cache = cache->next)
+		cache->stats.addTo(stats, bytesFreed);
+	sharedStats.addTo(stats, bytesFreed);
+	threadCachesLock.release();
+#else
+	sharedStats.addTo(stats, bytesFreed);
+#endif
+	stats.bytesInUse -= bytesFreed;
+
+	const int32 peak = atomicLoad(&statPeakBytesInUse);
+	stats.peakBytesInUse = MAX<uint32>(peak > 0 ? (uint32)peak : 0, stats.bytesInUse);
+	return stats;
+}
+
+void PoolAllocator::resetPeak() {
+	atomicStore(&statPeakBytesInUse, atomicLoad(&statBytesInUse));
+}
+
+} // End of namespace Common
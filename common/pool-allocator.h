@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_POOL_ALLOCATOR_H
+#define COMMON_POOL_ALLOCATOR_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_pool_allocator Pool allocator
+ * @ingroup common_memory
+ *
+ * @brief Thread-safe allocator for small objects.
+ * @{
+ */
+
+/**
+ * A process-wide allocator for small memory blocks, which can be used from
+ * any thread.
+ *
+ * Requests of up to kMaxPooledSize bytes are rounded up to one of a few size
+ * classes, each of which is served by a MemoryPool. Every thread keeps a
+ * small cache of free chunks for each size class, so most allocations and
+ * deallocations neither lock nor call malloc(). Larger requests are passed
+ * on to malloc().
+ *
+ * The size of a block has to be passed when freeing it. The easiest way to
+ * use the allocator for a class is to derive it from PoolAllocated.
+ */
+class PoolAllocator {
+public:
+	enum {
+		/** Largest allocation served from the pools. */
+		kMaxPooledSize = 256
+	};
+
+	/**
+	 * Allocation statistics. Sizes are in bytes and include the rounding
+	 * to the size classes.
+	 */
+	struct Stats {
+		uint32 bytesInUse;       ///< Bytes currently allocated
+		uint32 peakBytesInUse;   ///< Largest value of bytesInUse since the last resetPeak(), to within 16 KB per thread
+		uint32 allocations;      ///< Number of allocations so far
+		uint32 deallocations;    ///< Number of deallocations so far
+		uint32 largeAllocations; ///< Number of allocations passed on to malloc()
+	};
+
+	/**
+	 * Allocate a block of at least @p size bytes. The block is aligned
+	 * for any type of up to 16 bytes (8 bytes on 32-bit systems).
+	 */
+	static void *allocate(size_t size);
+
+	/**
+	 * Free a block obtained from allocate(). @p size has to be the size
+	 * passed to allocate().
+	 */
+	static void deallocate(void *ptr, size_t size);
+
+	/**
+	 * Return the chunks cached by the calling thread to the shared pools.
+	 * This happens automatically when a thread exits.
+	 */
+	static void flushThreadCache();
+
+	/**
+	 * Return a snapshot of the allocation statistics. Every thread counts
+	 * its own allocations, which are only added up here. The peak is
+	 * updated while allocating, whenever the bytes in use by a thread
+	 * changed by 16 KB.
+	 */
+	static Stats getStats();
+
+	/** Restart tracking the peak memory use from the current value. */
+	static void resetPeak();
+};
+
+/**
+ * Base class for objects which should be allocated through PoolAllocator.
+ *
+ * Objects must be deleted through a pointer to their most derived class,
+ * or through a base class with a virtual destructor, so that the correct
+ * size is passed to PoolAllocator::deallocate().
+ */
+class PoolAllocated {
+public:
+	static void *operator new(size_t size) { return PoolAllocator::allocate(size); }
+	static void operator delete(void *ptr, size_t size) { PoolAllocator::deallocate(ptr, size); }
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
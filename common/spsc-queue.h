@@ -0,0 +1,102 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_SPSC_QUEUE_H
+#define COMMON_SPSC_QUEUE_H
+
+#include "common/scummsys.h"
+#include "common/atomic.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_spsc_queue Lock-free queue
+ * @ingroup common
+ *
+ * @brief Fixed size, lock-free single-producer/single-consumer queue.
+ * @{
+ */
+
+/**
+ * Fixed size ring buffer, which can be used to pass values from one thread
+ * to another without locking.
+ *
+ * Only one thread at a time may push, and only one thread at a time may pop.
+ * If several threads need to push (or pop), they have to serialize their
+ * accesses among themselves, e.g. with a mutex the other side never takes.
+ *
+ * @tparam T    Type of the queued values; it should be cheap to copy.
+ * @tparam SIZE Capacity of the queue, which must be a power of two.
+ */
+template<class T, uint SIZE>
+class SPSCQueue {
+public:
+	SPSCQueue() : _head(0), _tail(0) {
+		STATIC_ASSERT((SIZE & (SIZE - 1)) == 0, SPSCQueue_size_must_be_a_power_of_two);
+	}
+
+	/**
+	 * Add a value to the queue. May only be called by the producer.
+	 *
+	 * @return False if the queue is full.
+	 */
+	bool push(const T &value) {
+		const uint32 tail = _tail;
+		if (tail - atomicLoad(&_head) == SIZE)
+			return false;
+
+		_data[tail & (SIZE - 1)] = value;
+		atomicStore(&_tail, tail + 1);
+		return true;
+	}
+
+	/**
+	 * Remove the oldest value from the queue. May only be called by the consumer.
+	 *
+	 * @return False if the queue is empty.
+	 */
+	bool pop(T &value) {
+		const uint32 head = _head;
+		if (head == atomicLoad(&_tail))
+			return false;
+
+		value = _data[head & (SIZE - 1)];
+		atomicStore(&_head, head + 1);
+		return true;
+	}
+
+	/** Whether the queue is currently empty, as seen by the calling thread. */
+	bool empty() const {
+		return atomicLoad(&_head) == atomicLoad(&_tail);
+	}
+
+private:
+	T _data[SIZE];
+	volatile uint32 _head; ///< Index of the next value to pop, owned by the consumer.
+	volatile uint32 _tail; ///< Index of the next value to push, owned by the producer.
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
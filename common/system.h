@@ -61,7 +61,10 @@ class TextToSpeechManager;
 class DialogManager;
 #endif
 class TimerManager;
+typedef void (*ThreadProc)(void *param);
 class SeekableReadStream;
+class SemaphoreInternal;
+class ThreadInternal;
 class WriteStream;
 class HardwareInputSet;
 class Keymap;
@@ -1364,6 +1367,16 @@ public:
 	 */
 	virtual uint32 getMillis(bool skipRecord = false) = 0;
 
+	/**
+	 * Get the number of microseconds elapsed since an arbitrary point in time.
+	 *
+	 * This is meant for measuring short durations, e.g. for profiling, and
+	 * is never recorded by the event recorder. The default implementation is
+	 * based on getMillis(); backends with access to a more precise clock
+	 * should override it.
+	 */
+	virtual uint64 getMicros();
+
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
@@ -1449,6 +1462,32 @@ public:
 	 */
 	virtual Common::MutexInternal *createMutex() = 0;
 
+	/**
+	 * Start a new thread, which runs @p proc with @p param.
+	 *
+	 * Threads are not used to run engine code; they only allow
+	 * Common::WorkerPool to spread independent, CPU-bound work over several
+	 * cores. Backends which do not support threads keep the default
+	 * implementation, in which case all such work is done on the calling
+	 * thread.
+	 *
+	 * @return The new thread, or 0 if threads are not supported.
+	 */
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *param) { return nullptr; }
+
+	/**
+	 * Create a new semaphore with a count of zero.
+	 *
+	 * @return The new semaphore, or 0 if threads are not supported.
+	 */
+	virtual Common::SemaphoreInternal *createSemaphore() { return nullptr; }
+
+	/**
+	 * Return the number of processor cores which can run threads created
+	 * with createThread() in parallel.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
 	/** @} */
 
 
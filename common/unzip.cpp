@@ -106,8 +106,12 @@ typedef struct {
 #include "common/unzip.h"
 #include "common/memstream.h"
 
+#include "common/atomic.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/textconsole.h"
 
 #if defined(STRICTUNZIP) || defined(STRICTZIPUNZIP)
 /* like the STRICT of WIN32, we define a pointer that cannot be converted
@@ -1418,59 +1422,378 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+/**
+ * The data of an opened ZIP file, shared by the archive and by all streams
+ * created from it, so that the streams stay valid after the archive has been
+ * deleted.
+ *
+ * Archives which are held in memory are read directly from their buffer.
+ * For all others, every read seeks the underlying stream, so reads are
+ * serialized by a mutex; this allows streams of different members to be
+ * used from different threads.
+ */
+class ZipSource : NonCopyable {
+public:
+	ZipSource(SeekableReadStream *stream) : _stream(stream), _refCount(1), _data(nullptr) {
+		MemoryReadStream *memStream = dynamic_cast<MemoryReadStream *>(stream);
+		if (memStream)
+			_data = memStream->getData();
+		_size = stream->size();
+	}
 
-class ZipArchive : public Archive {
-	unzFile _zipFile;
+	void incRef() {
+		atomicAdd(&_refCount, 1);
+	}
 
+	void decRef() {
+		if (atomicAdd(&_refCount, -1) == 0)
+			delete this;
+	}
+
+	/** Whether the archive is held in memory, so that reads are plain copies. */
+	bool isInMemory() const { return _data != nullptr; }
+
+	/** Read up to @p size bytes starting at @p offset. Returns the number of bytes read. */
+	uint32 readAt(uint32 offset, void *dst, uint32 size) {
+		if (offset >= _size)
+			return 0;
+		size = MIN(size, _size - offset);
+
+		if (_data) {
+			memcpy(dst, _data + offset, size);
+			return size;
+		}
+
+		StackLock lock(_mutex);
+		if (!_stream->seek(offset, SEEK_SET))
+			return 0;
+		return _stream->read(dst, size);
+	}
+
+private:
+	ScopedPtr<SeekableReadStream> _stream;
+	Mutex _mutex;
+	volatile int _refCount;
+	const byte *_data;	///< Contents of the archive if it is held in memory
+	uint32 _size;
+};
+
+/**
+ * A member which is stored without compression. Archives held in memory are
+ * read without an intermediate copy. For all others, short reads are served
+ * from a buffer, so that they don't each lock and seek the archive stream.
+ */
+class ZipStoredStream : public SeekableReadStream {
 public:
-	ZipArchive(unzFile zipFile);
+	ZipStoredStream(ZipSource *source, uint32 begin, uint32 size) :
+		_source(source), _begin(begin), _size(size), _pos(0), _bufStart(0), _bufSize(0), _eos(false), _err(false) {
+		_source->incRef();
+	}
 
+	~ZipStoredStream() {
+		_source->decRef();
+	}
 
-	~ZipArchive();
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		if (dataSize > _size - _pos) {
+			dataSize = _size - _pos;
+			_eos = true;
+		}
 
-	bool hasFile(const Path &path) const override;
-	int listMembers(ArchiveMemberList &list) const override;
-	const ArchiveMemberPtr getMember(const Path &path) const override;
-	SeekableReadStream *createReadStreamForMember(const Path &path) const override;
+		byte *dst = (byte *)dataPtr;
+		uint32 bytesRead = 0;
+
+		if (_pos >= _bufStart && _pos < _bufStart + _bufSize) {
+			bytesRead = MIN(dataSize, _bufStart + _bufSize - _pos);
+			memcpy(dst, _buf + _pos - _bufStart, bytesRead);
+			_pos += bytesRead;
+		}
+
+		const uint32 remaining = dataSize - bytesRead;
+		if (remaining >= kBufferSize || (remaining && _source->isInMemory())) {
+			const uint32 n = _source->readAt(_begin + _pos, dst + bytesRead, remaining);
+			bytesRead += n;
+			_pos += n;
+		} else if (remaining) {
+			_bufStart = _pos;
+			_bufSize = _source->readAt(_begin + _pos, _buf, MIN<uint32>(kBufferSize, _size - _pos));
+			const uint32 n = MIN(remaining, _bufSize);
+			memcpy(dst + bytesRead, _buf, n);
+			bytesRead += n;
+			_pos += n;
+		}
+
+		if (bytesRead != dataSize)
+			_err = true;
+		return bytesRead;
+	}
+
+	bool eos() const override { return _eos; }
+	bool err() const override { return _err; }
+	void clearErr() override { _eos = _err = false; }
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+
+	bool seek(int64 offset, int whence = SEEK_SET) override {
+		if (whence == SEEK_CUR)
+			offset += _pos;
+		else if (whence == SEEK_END)
+			offset += _size;
+
+		if (offset < 0 || offset > _size)
+			return false;
+
+		_pos = offset;
+		_eos = false;
+		return true;
+	}
+
+private:
+	enum {
+		kBufferSize = 4096
+	};
+
+	ZipSource *_source;
+	const uint32 _begin;
+	const uint32 _size;
+	uint32 _pos;
+	uint32 _bufStart;	///< Position of _buf in the member
+	uint32 _bufSize;	///< Valid bytes in _buf
+	bool _eos;
+	bool _err;
+
+	byte _buf[kBufferSize];
 };
 
-/*
-class ZipArchiveMember : public ArchiveMember {
-	unzFile _zipFile;
+#ifdef USE_ZLIB
 
+/**
+ * A deflated member, which is decompressed while it is read. Every stream
+ * has its own decompressor and buffers, so streams of the same archive can
+ * be read independently, and from different threads.
+ *
+ * Seeking backwards within the last decompressed block is cheap; seeking
+ * further back restarts the decompression from the start of the member.
+ */
+class ZipInflateStream : public SeekableReadStream {
 public:
-	ZipArchiveMember(FSNode &node) : _node(node) {
+	ZipInflateStream(ZipSource *source, uint32 begin, uint32 compressedSize, uint32 size, uint32 crc) :
+		_source(source), _begin(begin), _compressedSize(compressedSize), _size(size), _crc(crc),
+		_stream(), _inPos(0), _outStart(0), _outSize(0), _outPos(0), _crcSoFar(0), _eos(false), _err(false) {
+		_source->incRef();
+
+		// Negative MAX_WBITS tells zlib there's no zlib header
+		_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+		_stream.next_in = _inBuf;
+		_stream.avail_in = 0;
+		if (_zlibErr != Z_OK)
+			_err = true;
+	}
+
+	~ZipInflateStream() {
+		inflateEnd(&_stream);
+		_source->decRef();
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		byte *dst = (byte *)dataPtr;
+		uint32 bytesRead = 0;
+
+		while (bytesRead < dataSize) {
+			if (_outPos == _outSize && !fillOutput()) {
+				_eos = true;
+				break;
+			}
+
+			const uint32 n = MIN(dataSize - bytesRead, _outSize - _outPos);
+			memcpy(dst + bytesRead, _outBuf + _outPos, n);
+			_outPos += n;
+			bytesRead += n;
+		}
+
+		return bytesRead;
 	}
 
-	String getName() const {
-		...
+	bool eos() const override { return _eos; }
+	bool err() const override { return _err; }
+	void clearErr() override {
+		// Only reset _eos; decompression errors are not recoverable
+		_eos = false;
 	}
 
-	SeekableReadStream *open() {
-		...
+	int64 pos() const override { return _outStart + _outPos; }
+	int64 size() const override { return _size; }
+
+	bool seek(int64 offset, int whence = SEEK_SET) override {
+		if (whence == SEEK_CUR)
+			offset += pos();
+		else if (whence == SEEK_END)
+			offset += _size;
+
+		if (offset < 0 || offset > _size)
+			return false;
+
+		_eos = false;
+
+		if (offset < _outStart) {
+			// Restart the decompression from the start of the member
+			_zlibErr = inflateReset(&_stream);
+			if (_zlibErr != Z_OK) {
+				_err = true;
+				return false;
+			}
+			_stream.next_in = _inBuf;
+			_stream.avail_in = 0;
+			_inPos = 0;
+			_outStart = _outSize = _outPos = 0;
+			_crcSoFar = 0;
+		}
+
+		// Skip forward block by block
+		while (offset > _outStart + _outSize) {
+			_outPos = _outSize;
+			if (!fillOutput())
+				return false;
+		}
+
+		_outPos = offset - _outStart;
+		return true;
 	}
+
+private:
+	enum {
+		kBufferSize = 16384
+	};
+
+	/** Decompress the next block into _outBuf. Returns false at the end of the member or on errors. */
+	bool fillOutput() {
+		_outStart += _outSize;
+		_outSize = _outPos = 0;
+
+		if (_outStart >= _size || _zlibErr != Z_OK)
+			return false;
+
+		_stream.next_out = _outBuf;
+		_stream.avail_out = MIN<uint32>(kBufferSize, _size - _outStart);
+
+		while (_zlibErr == Z_OK && _stream.avail_out) {
+			if (_stream.avail_in == 0) {
+				if (_inPos >= _compressedSize)
+					break;
+
+				const uint32 toRead = MIN<uint32>(kBufferSize, _compressedSize - _inPos);
+				const uint32 bytesRead = _source->readAt(_begin + _inPos, _inBuf, toRead);
+				if (bytesRead != toRead) {
+					_err = true;
+					break;
+				}
+				_inPos += bytesRead;
+				_stream.next_in = _inBuf;
+				_stream.avail_in = bytesRead;
+			}
+			_zlibErr = inflate(&_stream, Z_SYNC_FLUSH);
+		}
+
+		_outSize = _stream.next_out - _outBuf;
+		if (_zlibErr != Z_OK && _zlibErr != Z_STREAM_END)
+			_err = true;
+
+		_crcSoFar = crc32(_crcSoFar, _outBuf, _outSize);
+		if (_outStart + _outSize == _size && _crcSoFar != _crc) {
+			warning("ZipInflateStream: CRC mismatch");
+			_err = true;
+		} else if (_outSize == 0 && !_err) {
+			warning("ZipInflateStream: Member is shorter than declared");
+			_err = true;
+		}
+
+		return _outSize != 0;
+	}
+
+	ZipSource *_source;
+	const uint32 _begin;
+	const uint32 _compressedSize;
+	const uint32 _size;
+	const uint32 _crc;
+
+	z_stream _stream;
+	int _zlibErr;
+	uint32 _inPos;		///< Compressed bytes read so far
+	uint32 _outStart;	///< Position of _outBuf in the member
+	uint32 _outSize;	///< Valid bytes in _outBuf
+	uint32 _outPos;		///< Read position in _outBuf
+	uLong _crcSoFar;
+	bool _eos;
+	bool _err;
+
+	byte _inBuf[kBufferSize];
+	byte _outBuf[kBufferSize];
+};
+
+#endif
+
+/**
+ * A ZIP archive. The central directory is read once when the archive is
+ * opened; after that, every member stream reads its data independently, so
+ * any number of members can be open at the same time.
+ */
+class ZipArchive : public Archive {
+public:
+	ZipArchive(unzFile zipFile);
+	~ZipArchive();
+
+	bool hasFile(const Path &path) const override;
+	int listMembers(ArchiveMemberList &list) const override;
+	const ArchiveMemberPtr getMember(const Path &path) const override;
+	SeekableReadStream *createReadStreamForMember(const Path &path) const override;
+
+private:
+	struct MemberInfo {
+		uint32 localHeaderOffset;
+		uint32 compressedSize;
+		uint32 uncompressedSize;
+		uint32 crc;
+		uint16 compressionMethod;
+	};
+
+	typedef HashMap<String, MemberInfo, IgnoreCase_Hash, IgnoreCase_EqualTo> MemberMap;
+
+	ZipSource *_source;
+	MemberMap _members;
 };
-*/
 
-ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
-	assert(_zipFile);
+ZipArchive::ZipArchive(unzFile zipFile) {
+	assert(zipFile);
+
+	// Copy the central directory, and take over the stream of the archive
+	unz_s *archive = (unz_s *)zipFile;
+	for (ZipHash::const_iterator i = archive->_hash.begin(), end = archive->_hash.end(); i != end; ++i) {
+		MemberInfo &member = _members[i->_key];
+		member.localHeaderOffset = i->_value.cur_file_info_internal.offset_curfile + archive->byte_before_the_zipfile;
+		member.compressedSize = i->_value.cur_file_info.compressed_size;
+		member.uncompressedSize = i->_value.cur_file_info.uncompressed_size;
+		member.crc = i->_value.cur_file_info.crc;
+		member.compressionMethod = i->_value.cur_file_info.compression_method;
+	}
+
+	_source = new ZipSource(archive->_stream);
+	archive->_stream = nullptr;
+	unzClose(zipFile);
 }
 
 ZipArchive::~ZipArchive() {
-	unzClose(_zipFile);
+	_source->decRef();
 }
 
 bool ZipArchive::hasFile(const Path &path) const {
-	String name = path.toString();
-	return (unzLocateFile(_zipFile, name.c_str(), 2) == UNZ_OK);
+	return _members.contains(path.toString());
 }
 
 int ZipArchive::listMembers(ArchiveMemberList &list) const {
 	int members = 0;
 
-	const unz_s *const archive = (const unz_s *)_zipFile;
-	for (ZipHash::const_iterator i = archive->_hash.begin(), end = archive->_hash.end();
-	     i != end; ++i) {
+	for (MemberMap::const_iterator i = _members.begin(), end = _members.end(); i != end; ++i) {
 		list.push_back(ArchiveMemberList::value_type(new GenericArchiveMember(i->_key, this)));
 		++members;
 	}
@@ -1488,35 +1811,34 @@ const ArchiveMemberPtr ZipArchive::getMember(const Path &path) const {
 
 SeekableReadStream *ZipArchive::createReadStreamForMember(const Path &path) const {
 	String name = path.toString();
-	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
-		return nullptr;
-
-	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
-		return nullptr;
-
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+	const MemberMap::const_iterator i = _members.find(name);
+	if (i == _members.end())
 		return nullptr;
 
-	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
-	assert(buffer);
+	const MemberInfo &member = i->_value;
 
-	if (unzReadCurrentFile(_zipFile, buffer, fileInfo.uncompressed_size) != (int)fileInfo.uncompressed_size) {
-		free(buffer);
+	// The local header repeats the file name, and may have a different
+	// extra field than the central directory
+	byte header[SIZEZIPLOCALHEADER];
+	if (_source->readAt(member.localHeaderOffset, header, sizeof(header)) != sizeof(header) ||
+	    READ_LE_UINT32(header) != 0x04034b50) {
+		warning("ZipArchive: Bad local header for '%s'", name.c_str());
 		return nullptr;
 	}
 
-	if (unzCloseCurrentFile(_zipFile) != UNZ_OK) {
-		free(buffer);
-		return nullptr;
-	}
+	const uint32 dataOffset = member.localHeaderOffset + SIZEZIPLOCALHEADER +
+	                          READ_LE_UINT16(header + 26) + READ_LE_UINT16(header + 28);
 
-	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	if (member.compressionMethod == 0)
+		return new ZipStoredStream(_source, dataOffset, member.uncompressedSize);
+
+#ifdef USE_ZLIB
+	if (member.compressionMethod == Z_DEFLATED)
+		return new ZipInflateStream(_source, dataOffset, member.compressedSize, member.uncompressedSize, member.crc);
+#endif
 
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
+	warning("ZipArchive: Unsupported compression method %d for '%s'", member.compressionMethod, name.c_str());
+	return nullptr;
 }
 
 Archive *makeZipArchive(const String &name) {
@@ -59,7 +59,10 @@ Archive *makeZipArchive(const FSNode &node);
  * This factory method creates an Archive instance corresponding to the content
  * of the given ZIP compressed datastream.
  * This takes ownership of the stream,  in particular, it is deleted when the
- * ZipArchive is deleted.
+ * ZipArchive and all streams created from it have been deleted.
+ *
+ * Member streams are independent of each other and of the archive, and
+ * streams of different members may be read from different threads.
  *
  * May return 0 in case of a failure. In this case stream will still be deleted.
  */
@@ -0,0 +1,121 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/worker-pool.h"
+#include "common/atomic.h"
+#include "common/config-manager.h"
+#include "common/system.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(WorkerPool);
+
+enum {
+	/** Upper limit for the default number of threads. */
+	kMaxDefaultThreads = 16
+};
+
+WorkerPool::WorkerPool() : _wakeUp(nullptr), _finished(nullptr), _busy(0), _quit(0),
+	_proc(nullptr), _param(nullptr), _count(0), _nextTask(0), _threadsLeft(0) {
+	if (!g_system)
+		return;
+
+	int threads = ConfMan.getInt("worker_threads");
+	if (threads <= 0)
+		threads = MIN<uint>(g_system->getCPUCount(), kMaxDefaultThreads);
+	if (threads <= 1)
+		return;
+
+	_wakeUp = g_system->createSemaphore();
+	_finished = g_system->createSemaphore();
+	if (!_wakeUp || !_finished)
+		return;
+
+	for (int i = 1; i < threads; ++i) {
+		ThreadInternal *thread = g_system->createThread(workerMain, this);
+		if (!thread)
+			break;
+		_threads.push_back(thread);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	atomicStore(&_quit, 1);
+	for (uint i = 0; i < _threads.size(); ++i)
+		_wakeUp->post();
+	for (uint i = 0; i < _threads.size(); ++i)
+		delete _threads[i];
+
+	delete _wakeUp;
+	delete _finished;
+}
+
+void WorkerPool::run(uint count, TaskProc proc, void *param) {
+	if (_threads.empty() || count <= 1 || !atomicCompareExchange(&_busy, 0, 1)) {
+		for (uint i = 0; i < count; ++i)
+			proc(i, param);
+		return;
+	}
+
+	_proc = proc;
+	_param = param;
+	_count = count;
+	_nextTask = 0;
+
+	// Every thread taking part, including this one, has to be done before
+	// the run is over, so that no worker still looks at its parameters
+	// when the next run starts
+	const uint workers = MIN<uint>(_threads.size(), count - 1);
+	atomicStore(&_threadsLeft, workers + 1);
+	for (uint i = 0; i < workers; ++i)
+		_wakeUp->post();
+
+	processTasks();
+	_finished->wait();
+
+	atomicStore(&_busy, 0);
+}
+
+void WorkerPool::processTasks() {
+	for (;;) {
+		const uint task = atomicAdd(&_nextTask, 1U) - 1;
+		if (task >= _count)
+			break;
+		_proc(task, _param);
+	}
+
+	if (atomicAdd(&_threadsLeft, (uint)-1) == 0)
+		_finished->post();
+}
+
+void WorkerPool::workerMain(void *param) {
+	WorkerPool *pool = (WorkerPool *)param;
+
+	for (;;) {
+		pool->_wakeUp->wait();
+		if (atomicLoad(&pool->_quit))
+			break;
+		pool->processTasks();
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,102 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_WORKER_POOL_H
+#define COMMON_WORKER_POOL_H
+
+#include "common/array.h"
+#include "common/singleton.h"
+#include "common/thread.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_worker_pool Worker pool
+ * @ingroup common
+ *
+ * @brief Spreads independent pieces of work over several cores.
+ * @{
+ */
+
+/**
+ * A fixed set of worker threads, which run() uses to process a number of
+ * independent tasks in parallel.
+ *
+ * Tasks are handed out one at a time from a shared counter, so threads which
+ * finish their tasks early simply take the next one, and uneven tasks are
+ * balanced automatically. The calling thread works on tasks as well, and
+ * run() only returns once all of them have finished.
+ *
+ * The number of worker threads is taken from the "worker_threads" setting;
+ * by default there is one thread per processor core besides the calling
+ * thread. Without backend support for threads, or with "worker_threads" set
+ * to 1, all tasks run on the calling thread.
+ *
+ * Tasks must not use engine state which is not protected against concurrent
+ * access, and must not call into the backend, except for getMicros(),
+ * getMillis() and mutexes.
+ */
+class WorkerPool : public Singleton<WorkerPool> {
+public:
+	/** A task; @p index is in the range [0, count) passed to run(). */
+	typedef void (*TaskProc)(uint index, void *param);
+
+	/**
+	 * Call @p proc for every index from 0 to @p count - 1, in no particular
+	 * order, and wait until all calls have returned.
+	 *
+	 * If the pool is already processing tasks, e.g. because run() is called
+	 * from within a task, the tasks are run on the calling thread in order.
+	 */
+	void run(uint count, TaskProc proc, void *param);
+
+	/** Return the number of threads run() uses, including the calling thread. */
+	uint getThreadCount() const { return _threads.size() + 1; }
+
+private:
+	friend class Singleton<SingletonBaseType>;
+
+	WorkerPool();
+	~WorkerPool();
+
+	static void workerMain(void *param);
+	void processTasks();
+
+	Array<ThreadInternal *> _threads;
+	SemaphoreInternal *_wakeUp;		///< Posted once for every worker which should join a run
+	SemaphoreInternal *_finished;	///< Posted when the last thread of a run is done
+	volatile int _busy;
+	volatile int _quit;
+
+	// The current run
+	TaskProc _proc;
+	void *_param;
+	uint _count;
+	volatile uint _nextTask;
+	volatile uint _threadsLeft;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -22,9 +22,11 @@
 #include "common/debug.h"
 #include "common/util.h"
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/macresman.h"
 #include "common/md5.h"
 #include "common/config-manager.h"
+#include "common/ptr.h"
 #include "common/punycode.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -249,24 +251,41 @@ bool AdvancedMetaEngineDetection::cleanupPirated(ADDetectedGames &matched) const
 }
 
 DetectedGames AdvancedMetaEngineDetection::detectGames(const Common::FSList &fslist) {
-	FileMap allFiles;
-
 	if (fslist.empty())
 		return DetectedGames();
 
+	return finishDetectGamesFromTables(fslist, detectGamesFromTables(fslist));
+}
+
+MetaEngineDetection::ConcurrentDetection *AdvancedMetaEngineDetection::detectGamesConcurrently(const Common::FSList &fslist) {
+	if (fslist.empty())
+		return nullptr;
+
+	return detectGamesFromTables(fslist);
+}
+
+DetectedGames AdvancedMetaEngineDetection::finishDetectGames(const Common::FSList &fslist, ConcurrentDetection *partial) {
+	if (!partial)
+		return detectGames(fslist);
+
+	return finishDetectGamesFromTables(fslist, static_cast<TableDetection *>(partial));
+}
+
+AdvancedMetaEngineDetection::TableDetection *AdvancedMetaEngineDetection::detectGamesFromTables(const Common::FSList &fslist) {
+	TableDetection *result = new TableDetection();
+
 	// Sometimes this method is called directly, so we have to build the maps, especially
 	// the _directoryGlobsMap
 	preprocessDescriptions();
 
 	// Compose a hashmap of all files in fslist.
-	composeFileHashMap(allFiles, fslist, (_maxScanDepth == 0 ? 1 : _maxScanDepth));
+	composeFileHashMap(result->allFiles, fslist, (_maxScanDepth == 0 ? 1 : _maxScanDepth));
 
 	// Run the detector on this
-	ADDetectedGames matches = detectGame(fslist.begin()->getParent(), allFiles, Common::UNK_LANG, Common::kPlatformUnknown, "");
+	ADDetectedGames matches = detectGame(fslist.begin()->getParent(), result->allFiles, Common::UNK_LANG, Common::kPlatformUnknown, "");
 
 	cleanupPirated(matches);
 
-	DetectedGames detectedGames;
 	for (uint i = 0; i < matches.size(); i++) {
 		DetectedGame game = toDetectedGame(matches[i]);
 
@@ -274,9 +293,16 @@ DetectedGames AdvancedMetaEngineDetection::detectGames(const Common::FSList &fsl
 			game.canBeAdded = false;
 		}
 
-		detectedGames.push_back(game);
+		result->detectedGames.push_back(game);
 	}
 
+	return result;
+}
+
+DetectedGames AdvancedMetaEngineDetection::finishDetectGamesFromTables(const Common::FSList &fslist, TableDetection *partial) {
+	Common::ScopedPtr<TableDetection> result(partial);
+	DetectedGames &detectedGames = result->detectedGames;
+
 	bool foundKnownGames = false;
 	for (uint i = 0; i < detectedGames.size(); i++) {
 		foundKnownGames |= !detectedGames[i].hasUnknownFiles;
@@ -285,7 +311,7 @@ DetectedGames AdvancedMetaEngineDetection::detectGames(const Common::FSList &fsl
 	if (!foundKnownGames) {
 		// Use fallback detector if there were no matches by other means
 		ADDetectedGameExtraInfo *extraInfo = nullptr;
-		ADDetectedGame fallbackDetectionResult = fallbackDetect(allFiles, fslist, &extraInfo);
+		ADDetectedGame fallbackDetectionResult = fallbackDetect(result->allFiles, fslist, &extraInfo);
 
 		if (fallbackDetectionResult.desc) {
 			DetectedGame fallbackDetectedGame = toDetectedGame(fallbackDetectionResult, extraInfo);
@@ -493,6 +519,181 @@ namespace Common {
 	DECLARE_SINGLETON(MD5CacheManager);
 }
 
+#define MD5CACHE_FILENAME "scummvm-md5.cache"
+#define MD5CACHE_HEADER "# ScummVM MD5 cache, version 1"
+
+enum {
+	/** Entries not used since startup are dropped once the cache grows beyond this. */
+	kMaxPersistentMD5Entries = 50000
+};
+
+static bool parseInt64(const Common::String &str, int64 &value) {
+	const char *s = str.c_str();
+	const bool negative = (*s == '-');
+	if (negative)
+		s++;
+	if (!*s)
+		return false;
+
+	value = 0;
+	for (; *s; s++) {
+		if (!Common::isDigit(*s))
+			return false;
+		value = value * 10 + (*s - '0');
+	}
+	if (negative)
+		value = -value;
+	return true;
+}
+
+/**
+ * The cache is stored next to the configuration file, since detection also
+ * runs from the command line, before the backend provides a save file
+ * manager.
+ */
+static Common::FSNode getPersistentMD5CacheNode() {
+	Common::String configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+
+	return Common::FSNode(configFile).getParent().getChild(MD5CACHE_FILENAME);
+}
+
+Common::String MD5CacheManager::persistentKey(const Common::FSNode &node, char prefix, uint md5Bytes) {
+	return Common::String::format("%c:%u:%s", prefix, md5Bytes, node.getPath().c_str());
+}
+
+bool MD5CacheManager::getPersistent(const Common::FSNode &node, char prefix, uint md5Bytes, FileProperties &fileProps) {
+	Common::StackLock lock(_mutex);
+	loadPersistentIntern();
+
+	PersistentMap::iterator entry = _persistentMap.find(persistentKey(node, prefix, md5Bytes));
+	if (entry == _persistentMap.end()) {
+		_persistentStats.misses++;
+		return false;
+	}
+
+	int64 size, modificationTime;
+	if (!node.getFileStatus(size, modificationTime) ||
+	    size != entry->_value.size || modificationTime != entry->_value.modificationTime) {
+		_persistentStats.stale++;
+		return false;
+	}
+
+	_persistentStats.hits++;
+	entry->_value.used = true;
+	fileProps.md5 = copyString(entry->_value.md5);
+	fileProps.size = size;
+	return true;
+}
+
+void MD5CacheManager::setPersistent(const Common::FSNode &node, char prefix, uint md5Bytes, const FileProperties &fileProps) {
+	Common::StackLock lock(_mutex);
+	loadPersistentIntern();
+
+	// Files whose modification time cannot be determined are not cached,
+	// since there would be no way to tell when an entry becomes outdated
+	PersistentEntry entry;
+	if (!node.getFileStatus(entry.size, entry.modificationTime) || entry.size != fileProps.size)
+		return;
+
+	entry.md5 = copyString(fileProps.md5);
+	entry.used = true;
+	_persistentMap.setVal(persistentKey(node, prefix, md5Bytes), entry);
+	_persistentDirty = true;
+}
+
+void MD5CacheManager::loadPersistent() {
+	Common::StackLock lock(_mutex);
+	loadPersistentIntern();
+}
+
+void MD5CacheManager::loadPersistentIntern() {
+	if (_persistentLoaded)
+		return;
+	_persistentLoaded = true;
+
+	const Common::FSNode node = getPersistentMD5CacheNode();
+	if (!node.exists())
+		return;
+
+	Common::ScopedPtr<Common::SeekableReadStream> file(node.createReadStream());
+	if (!file)
+		return;
+
+	if (file->readLine() != MD5CACHE_HEADER) {
+		debugC(1, kDebugGlobalDetection, "Ignoring MD5 cache with unknown format");
+		return;
+	}
+
+	// Every line holds: key, size, modification time and MD5, separated by tabs.
+	// The key comes first since it is the only field which may contain spaces.
+	while (!file->eos() && !file->err()) {
+		const Common::String line = file->readLine();
+		if (line.empty())
+			continue;
+
+		// Find the tabs in front of the last three fields
+		size_t tabs[3];
+		size_t end = line.size();
+		bool valid = true;
+		for (int i = 0; i < 3 && valid; ++i) {
+			tabs[i] = line.findLastOf('\t', end - 1);
+			valid = (tabs[i] != Common::String::npos && tabs[i] != 0);
+			end = tabs[i];
+		}
+
+		PersistentEntry entry;
+		if (!valid ||
+		    !parseInt64(Common::String(line.c_str() + tabs[2] + 1, line.c_str() + tabs[1]), entry.size) ||
+		    !parseInt64(Common::String(line.c_str() + tabs[1] + 1, line.c_str() + tabs[0]), entry.modificationTime)) {
+			debugC(1, kDebugGlobalDetection, "Ignoring malformed MD5 cache entry '%s'", line.c_str());
+			continue;
+		}
+
+		entry.md5 = Common::String(line.c_str() + tabs[0] + 1);
+		entry.used = false;
+		_persistentMap.setVal(Common::String(line.c_str(), tabs[2]), entry);
+	}
+
+	debugC(1, kDebugGlobalDetection, "Loaded %u entries from the MD5 cache", _persistentMap.size());
+}
+
+void MD5CacheManager::savePersistent() {
+	Common::StackLock lock(_mutex);
+
+	debugC(1, kDebugGlobalDetection, "MD5 cache: %u hits, %u misses, %u outdated",
+	       _persistentStats.hits, _persistentStats.misses, _persistentStats.stale);
+
+	if (!_persistentDirty)
+		return;
+
+	if (_persistentMap.size() > kMaxPersistentMD5Entries) {
+		for (PersistentMap::iterator i = _persistentMap.begin(); i != _persistentMap.end(); ++i) {
+			if (!i->_value.used)
+				_persistentMap.erase(i);
+		}
+	}
+
+	Common::ScopedPtr<Common::WriteStream> file(getPersistentMD5CacheNode().createWriteStream());
+	if (!file) {
+		warning("Could not write the MD5 cache");
+		return;
+	}
+
+	file->writeString(MD5CACHE_HEADER "\n");
+	for (PersistentMap::const_iterator i = _persistentMap.begin(); i != _persistentMap.end(); ++i) {
+		file->writeString(Common::String::format("%s\t%lld\t%lld\t%s\n", i->_key.c_str(),
+			(long long)i->_value.size, (long long)i->_value.modificationTime, i->_value.md5.c_str()));
+	}
+	file->finalize();
+
+	if (file->err())
+		warning("Could not write the MD5 cache");
+	else
+		_persistentDirty = false;
+}
+
 // Sync with engines/game.cpp
 static char flagsToMD5Prefix(uint32 flags) {
 	if (flags & ADGF_MACRESFORK) {
@@ -517,7 +718,17 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, con
 		return true;
 	}
 
-	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, game, fname, fileProps);
+	// Resource forks may be stored in other files than the one listed, so
+	// only plain files are kept in the persistent cache
+	const bool persistent = !(game.flags & ADGF_MACRESFORK) && allFiles.contains(fname);
+	bool res;
+	if (persistent && MD5Man.getPersistent(allFiles[fname], flagsToMD5Prefix(game.flags), _md5Bytes, fileProps)) {
+		res = true;
+	} else {
+		res = getFilePropertiesIntern(_md5Bytes, allFiles, game, fname, fileProps);
+		if (res && persistent)
+			MD5Man.setPersistent(allFiles[fname], flagsToMD5Prefix(game.flags), _md5Bytes, fileProps);
+	}
 
 	if (res) {
 		MD5Man.setMD5(hashname, fileProps.md5);
@@ -26,6 +26,7 @@
 #include "engines/engine.h"
 
 #include "common/hash-str.h"
+#include "common/mutex.h"
 
 #include "common/gui_options.h" // FIXME: Temporary hack?
 
@@ -359,6 +360,16 @@ public:
 	 */
 	DetectedGames detectGames(const Common::FSList &fslist) override;
 
+	/**
+	 * Compose the file map and match it against the detection tables.
+	 * The fallback detector is run later by finishDetectGames(), since
+	 * many of them depend on global state.
+	 */
+	ConcurrentDetection *detectGamesConcurrently(const Common::FSList &fslist) override;
+
+	/** Run the fallback detector, if the detection tables did not match any known game. */
+	DetectedGames finishDetectGames(const Common::FSList &fslist, ConcurrentDetection *partial) override;
+
 	/**
 	 * A generic createInstance.
 	 *
@@ -400,6 +411,15 @@ protected:
 	}
 
 private:
+	/** Results of the table based part of detectGames(). */
+	struct TableDetection : public ConcurrentDetection {
+		FileMap allFiles;
+		DetectedGames detectedGames;
+	};
+
+	TableDetection *detectGamesFromTables(const Common::FSList &fslist);
+	DetectedGames finishDetectGamesFromTables(const Common::FSList &fslist, TableDetection *partial);
+
 	void initSubSystems(const ADGameDescription *gameDesc) const;
 	void preprocessDescriptions();
 	bool isEntryGrayListed(const ADGameDescription *g) const;
@@ -527,41 +547,112 @@ public:
 
 /**
  * Singleton Cache Storage for Computed MD5s
+ *
+ * Besides the per-detection cache, which is keyed by file names relative to
+ * the directory being detected and is cleared before every detection, this
+ * keeps a persistent cache keyed by absolute paths, which is stored next to
+ * the configuration file and survives restarts.
  */
 class MD5CacheManager : public Common::Singleton<MD5CacheManager> {
 public:
+	/** Hit and miss counts of the persistent cache since startup. */
+	struct PersistentStats {
+		uint32 hits;	///< Lookups answered from the cache
+		uint32 misses;	///< Lookups of files which were not in the cache
+		uint32 stale;	///< Lookups of files whose size or modification time changed
+	};
+
 	void setMD5(Common::String fname, Common::String md5) {
-		md5HashMap.setVal(fname, md5);
+		Common::StackLock lock(_mutex);
+		md5HashMap.setVal(copyString(fname), copyString(md5));
 	}
 
 	Common::String getMD5(Common::String fname) {
-		return md5HashMap.getVal(fname);
+		Common::StackLock lock(_mutex);
+		return copyString(md5HashMap.getVal(fname));
 	}
 
 	void setSize(Common::String fname, int64 size) {
-		sizeHashMap.setVal(fname, size);
+		Common::StackLock lock(_mutex);
+		sizeHashMap.setVal(copyString(fname), size);
 	}
 
 	int64 getSize(Common::String fname) {
+		Common::StackLock lock(_mutex);
 		return sizeHashMap.getVal(fname);
 	}
 
 	bool contains(Common::String fname) {
+		Common::StackLock lock(_mutex);
 		return (md5HashMap.contains(fname) && sizeHashMap.contains(fname));
 	}
 
-	MD5CacheManager() {
+	MD5CacheManager() : _persistentLoaded(false), _persistentDirty(false) {
 		clear();
+		_persistentStats.hits = _persistentStats.misses = _persistentStats.stale = 0;
 	}
 
 	void clear() {
+		Common::StackLock lock(_mutex);
 		md5HashMap.clear(true);
 		sizeHashMap.clear(true);
 	}
 
+	/**
+	 * Read the persistent cache from disk, unless this has been done
+	 * already. This happens on first use, but should be done up front
+	 * before detecting games on several threads.
+	 */
+	void loadPersistent();
+
+	/**
+	 * Look up the properties of a file in the persistent cache. Entries are
+	 * only used if the size and the modification time of the file did not
+	 * change since they were stored.
+	 *
+	 * @param node		The file
+	 * @param prefix	MD5 prefix of the detection entry, see flagsToMD5Prefix()
+	 * @param md5Bytes	Number of bytes the MD5 is computed over
+	 */
+	bool getPersistent(const Common::FSNode &node, char prefix, uint md5Bytes, FileProperties &fileProps);
+
+	/** Store the properties of a file in the persistent cache. */
+	void setPersistent(const Common::FSNode &node, char prefix, uint md5Bytes, const FileProperties &fileProps);
+
+	/** Write the persistent cache to disk, if it has been changed. */
+	void savePersistent();
+
+	const PersistentStats &getPersistentStats() const { return _persistentStats; }
+
 private:
 	friend class Common::Singleton<MD5CacheManager>;
 
+	struct PersistentEntry {
+		int64 size;
+		int64 modificationTime;
+		Common::String md5;
+		bool used;	///< Looked up or stored since startup
+	};
+
+	typedef Common::HashMap<Common::String, PersistentEntry> PersistentMap;
+
+	static Common::String persistentKey(const Common::FSNode &node, char prefix, uint md5Bytes);
+	void loadPersistentIntern();
+
+	/**
+	 * Common::String reference counts are not atomic, so strings passed
+	 * between threads are copied instead of being shared.
+	 */
+	static Common::String copyString(const Common::String &str) { return Common::String(str.c_str(), str.size()); }
+
+	/** Detection may run on several threads, see MetaEngineDetection::detectGamesConcurrently(). */
+	Common::Mutex _mutex;
+
+	PersistentMap _persistentMap;
+	PersistentStats _persistentStats;
+	bool _persistentLoaded;
+	bool _persistentDirty;
+
 	typedef Common::HashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileHashMap;
 	typedef Common::HashMap<Common::String, int64, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SizeHashMap;
 	FileHashMap md5HashMap;
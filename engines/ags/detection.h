@@ -88,6 +88,11 @@ public:
 
 	DetectedGames detectGames(const Common::FSList &fslist) override;
 
+	ConcurrentDetection *detectGamesConcurrently(const Common::FSList &fslist) override {
+		// detectGames() is overridden, so run all of it on the main thread
+		return nullptr;
+	}
+
 	ADDetectedGame fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist, ADDetectedGameExtraInfo **extra = nullptr) const override;
 
 	bool canPlayUnknownVariants() const override {
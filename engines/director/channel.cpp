@@ -60,6 +60,7 @@ Channel::Channel(Sprite *sp, int priority) {
 
 	_visible = true;
 	_dirty = true;
+	_static = false;
 
 	_sprite->updateEditable();
 }
@@ -90,11 +91,47 @@ Channel& Channel::operator=(const Channel &channel) {
 
 	_visible = channel._visible;
 	_dirty = channel._dirty;
+	_static = false;
+	_lastLook = ChannelLook();
 
 	return *this;
 }
 
 
+InkCache::InkCache() {
+	pixels = nullptr;
+	coverage = nullptr;
+	source = nullptr;
+	palette = nullptr;
+	ink = kInkTypeCopy;
+	foreColor = 0;
+	backColor = 0;
+}
+
+InkCache::~InkCache() {
+	clear();
+}
+
+void InkCache::clear() {
+	delete pixels;
+	delete coverage;
+	pixels = nullptr;
+	coverage = nullptr;
+	source = nullptr;
+}
+
+bool InkCache::matches(const DirectorPlotData &pd) const {
+	return pixels && source == pd.srf && palette == g_director->getPalette() &&
+		ink == pd.ink && foreColor == pd.foreColor && backColor == pd.backColor;
+}
+
+bool ChannelLook::operator==(const ChannelLook &look) const {
+	return bbox == look.bbox && castId == look.castId && spriteType == look.spriteType &&
+		ink == look.ink && blend == look.blend && pattern == look.pattern &&
+		thickness == look.thickness && foreColor == look.foreColor &&
+		backColor == look.backColor && visible == look.visible && !modified && !look.modified;
+}
+
 Channel::~Channel() {
 	if (_widget)
 		delete _widget;
@@ -180,6 +217,34 @@ const Graphics::Surface *Channel::getMask(bool forceMatte) {
 	return nullptr;
 }
 
+const InkCache *Channel::getInkCache(DirectorPlotData &pd) {
+	// Only bitmaps keep their pixels from one frame to the next; text and
+	// buttons may be redrawn by their widget at any time
+	if (!_static || !_sprite->_cast || _sprite->_cast->_type != kCastBitmap || isStretched() || !pd.isSourceInk())
+		return nullptr;
+
+	Common::Rect bbox = getBbox();
+	if (_inkCache.matches(pd) && _inkCache.pixels->w == bbox.width() && _inkCache.pixels->h == bbox.height())
+		return &_inkCache;
+
+	_inkCache.clear();
+	if (bbox.isEmpty() || pd.srf->w < bbox.width() || pd.srf->h < bbox.height())
+		return nullptr;
+
+	_inkCache.source = pd.srf;
+	_inkCache.palette = g_director->getPalette();
+	_inkCache.ink = pd.ink;
+	_inkCache.foreColor = pd.foreColor;
+	_inkCache.backColor = pd.backColor;
+	pd.inkRenderCache(bbox, getMask(), _inkCache);
+
+	return &_inkCache;
+}
+
+void Channel::invalidateInkCache() {
+	_inkCache.clear();
+}
+
 // TODO: eliminate this function when we got the correct method to deal with sprite size
 // since we didn't handle sprites very well for text cast members. thus we don't replace our text castmembers when only size changes
 // for explicitly changing, we have isModified to check
@@ -214,6 +279,24 @@ bool Channel::isDirty(Sprite *nextSprite) {
 	return isDirtyFlag;
 }
 
+ChannelLook Channel::getLook() {
+	ChannelLook look;
+	look.bbox = getBbox();
+	look.castId = _sprite->_castId;
+	look.spriteType = _sprite->_spriteType;
+	look.ink = _sprite->_ink;
+	look.blend = _sprite->_blend;
+	look.pattern = _sprite->_pattern;
+	look.thickness = _sprite->_thickness;
+	look.foreColor = _sprite->_foreColor;
+	look.backColor = _sprite->_backColor;
+	look.visible = _visible;
+	// Text may change without its cast member telling, so it is always redrawn
+	look.modified = (_sprite->_cast && _sprite->_cast->isModified()) || hasTextCastMember(_sprite);
+
+	return look;
+}
+
 bool Channel::isStretched() {
 	return _sprite->_puppet && _sprite->_stretch &&
 		(_sprite->_width != _width || _sprite->_height != _height);
@@ -35,6 +35,49 @@ namespace Director {
 class Sprite;
 class Cursor;
 
+// A static bitmap sprite, already inked, so that redrawing the stage around a
+// moving sprite copies it instead of inking every pixel again
+struct InkCache : Common::NonCopyable {
+	Graphics::ManagedSurface *pixels;
+	Graphics::ManagedSurface *coverage; // nullptr when the sprite is opaque
+
+	// What the pixels were inked from
+	Graphics::ManagedSurface *source;
+	const byte *palette;
+	InkType ink;
+	uint32 foreColor;
+	uint32 backColor;
+
+	InkCache();
+	~InkCache();
+
+	void clear();
+	bool matches(const DirectorPlotData &pd) const;
+};
+
+// The part of a channel which shows on the stage, to tell whether a channel
+// that was marked dirty has to be redrawn at all
+struct ChannelLook {
+	Common::Rect bbox;
+	CastMemberID castId;
+	SpriteType spriteType;
+	InkType ink;
+	byte blend;
+	uint16 pattern;
+	byte thickness;
+	uint32 foreColor;
+	uint32 backColor;
+	bool visible;
+	bool modified;
+
+	// A default look never matches, so that new channels are always drawn
+	ChannelLook() : spriteType(kInactiveSprite), ink(kInkTypeCopy), blend(0), pattern(0), thickness(0),
+		foreColor(0), backColor(0), visible(false), modified(true) {}
+
+	bool operator==(const ChannelLook &look) const;
+	bool operator!=(const ChannelLook &look) const { return !(*this == look); }
+};
+
 class Channel {
 public:
 	Channel(Sprite *sp, int priority = 0);
@@ -45,6 +88,9 @@ public:
 	DirectorPlotData getPlotData();
 	const Graphics::Surface *getMask(bool forceMatte = false);
 	Common::Rect getBbox(bool unstretched = false);
+	ChannelLook getLook();
+	const InkCache *getInkCache(DirectorPlotData &pd);
+	void invalidateInkCache();
 
 	bool isStretched();
 	bool isDirty(Sprite *nextSprite = nullptr);
@@ -113,10 +159,17 @@ public:
 	// Used in film loops
 	uint _filmLoopFrame;
 
+	// Set when the channel did not change in the last frame
+	bool _static;
+	// What the channel showed on the stage when it was last drawn
+	ChannelLook _lastLook;
+
 private:
 	Graphics::ManagedSurface *getSurface();
 	Common::Point getPosition();
 
+	InkCache _inkCache;
+
 };
 
 } // End of namespace Director
@@ -0,0 +1,82 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "director/director.h"
+#include "director/debugger.h"
+#include "director/window.h"
+#include "director/lingo/lingo.h"
+
+namespace Director {
+
+Debugger::Debugger(DirectorEngine *vm) : GUI::Debugger(), _vm(vm) {
+	registerCmd("continue", WRAP_METHOD(Debugger, cmdExit));
+	registerCmd("renderstats", WRAP_METHOD(Debugger, cmdRenderStats));
+}
+
+Debugger::~Debugger() {
+}
+
+bool Debugger::cmdRenderStats(int argc, const char **argv) {
+	bool reset = argc >= 2 && !strcmp(argv[1], "reset");
+
+	if (argc >= 2 && !reset) {
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	if (_vm->getStage())
+		printRenderStats("Stage", _vm->getStage(), reset);
+
+	FArray *windowList = g_lingo->_windowList.u.farr;
+	for (uint i = 0; i < windowList->arr.size(); i++) {
+		if (windowList->arr[i].type != OBJECT || windowList->arr[i].u.obj->getObjType() != kWindowObj)
+			continue;
+
+		Window *window = static_cast<Window *>(windowList->arr[i].u.obj);
+		printRenderStats(window->getName().c_str(), window, reset);
+	}
+
+	return true;
+}
+
+void Debugger::printRenderStats(const char *name, Window *window, bool reset) {
+	if (reset) {
+		window->resetRenderStats();
+		return;
+	}
+
+	const RenderStats &last = window->_lastRenderStats;
+	const Common::Rect &dims = window->getInnerDimensions();
+	int stagePixels = MAX(dims.width() * dims.height(), 1);
+
+	debugPrintf("%s:\n", name);
+	debugPrintf("  last frame: %d ms, %d pixels redrawn (%d%% of the stage) in %d rects\n",
+		last.millis, last.pixels, (int)(100LL * last.pixels / stagePixels), last.rects);
+	debugPrintf("  sprites: %d blits, %d from the ink cache, %d unchanged channels skipped\n",
+		last.blits, last.cachedBlits, last.skippedChannels);
+
+	if (window->_renderedFrames) {
+		debugPrintf("  %d frames: %.2f ms, %d pixels redrawn per frame on average\n", window->_renderedFrames,
+			(double)window->_renderedMillis / window->_renderedFrames, (int)(window->_renderedPixels / window->_renderedFrames));
+	}
+}
+
+} // End of namespace Director
@@ -30,6 +30,7 @@
 
 #include "director/director.h"
 #include "director/archive.h"
+#include "director/debugger.h"
 #include "director/cast.h"
 #include "director/movie.h"
 #include "director/score.h"
@@ -169,6 +170,8 @@ Common::Error DirectorEngine::run() {
 		return Common::kAudioDeviceInitFailed;
 	}
 
+	setDebugger(new Debugger(this));
+
 	_currentPalette = nullptr;
 
 	wmMode = debugChannelSet(-1, kDebugDesktop) ? wmModeDesktop : wmModeFullscreen;
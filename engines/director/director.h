@@ -62,6 +62,7 @@ class Movie;
 class Window;
 class Score;
 class Channel;
+struct InkCache;
 class CastMember;
 class Stxt;
 
@@ -151,10 +152,13 @@ struct DirectorPlotData {
 
 	// graphics.cpp
 	void setApplyColor();
+	bool isSourceInk();
 	uint32 preprocessColor(uint32 src);
 	void inkBlitShape(Common::Rect &srcRect);
 	void inkBlitSurface(Common::Rect &srcRect, const Graphics::Surface *mask);
 	void inkBlitStretchSurface(Common::Rect &srcRect, const Graphics::Surface *mask);
+	void inkRenderCache(const Common::Rect &bbox, const Graphics::Surface *mask, InkCache &cache);
+	void inkBlitCache(const InkCache &cache, Common::Rect &srcRect);
 
 	DirectorPlotData(Graphics::MacWindowManager *w, SpriteType s, InkType i, int a, uint32 b, uint32 f) : _wm(w), sprite(s), ink(i), alpha(a), backColor(b), foreColor(f) {
 		srf = nullptr;
@@ -23,6 +23,7 @@
 #include "graphics/macgui/macwindowmanager.h"
 
 #include "director/director.h"
+#include "director/channel.h"
 
 namespace Director {
 
@@ -136,6 +137,27 @@ void DirectorEngine::draw() {
 	g_system->updateScreen();
 }
 
+// Colourizes a pixel of the copy inks, which only depend on the source pixel
+static uint32 inkCopyColor(DirectorPlotData *p, uint32 src) {
+	// TODO: Improve the efficiency of this composition
+	byte rSrc, gSrc, bSrc;
+	byte rFor, gFor, bFor;
+	byte rBak, gBak, bBak;
+
+	p->_wm->decomposeColor(src, rSrc, gSrc, bSrc);
+	p->_wm->decomposeColor(p->foreColor, rFor, gFor, bFor);
+	p->_wm->decomposeColor(p->backColor, rBak, gBak, bBak);
+
+	if (p->ink == kInkTypeNotCopy)
+		return p->_wm->findBestColor((~rSrc | rFor) & (rSrc | rBak),
+									 (~gSrc | gFor) & (gSrc | gBak),
+									 (~bSrc | bFor) & (bSrc | bBak));
+
+	return p->_wm->findBestColor((rSrc | rFor) & (~rSrc | rBak),
+								 (gSrc | gFor) & (~gSrc | gBak),
+								 (bSrc | bFor) & (~bSrc | bBak));
+}
+
 template <typename T>
 void inkDrawPixel(int x, int y, int src, void *data) {
 	DirectorPlotData *p = (DirectorPlotData *)data;
@@ -181,46 +203,9 @@ void inkDrawPixel(int x, int y, int src, void *data) {
 	case kInkTypeMatte:
 	case kInkTypeMask:
 		// Only unmasked pixels make it here, so copy them straight
-	case kInkTypeCopy: {
-		if (p->applyColor) {
-			// TODO: Improve the efficiency of this composition
-			byte rSrc, gSrc, bSrc;
-			byte rDst, gDst, bDst;
-			byte rFor, gFor, bFor;
-			byte rBak, gBak, bBak;
-
-			g_director->_wm->decomposeColor(src, rSrc, gSrc, bSrc);
-			g_director->_wm->decomposeColor(*dst, rDst, gDst, bDst);
-			g_director->_wm->decomposeColor(p->foreColor, rFor, gFor, bFor);
-			g_director->_wm->decomposeColor(p->backColor, rBak, gBak, bBak);
-
-			*dst = p->_wm->findBestColor((rSrc | rFor) & (~rSrc | rBak),
-																	 (gSrc | gFor) & (~gSrc | gBak),
-																	 (bSrc | bFor) & (~bSrc | bBak));
-		} else {
-			*dst = src;
-		}
-		break;
-	}
+	case kInkTypeCopy:
 	case kInkTypeNotCopy:
-		if (p->applyColor) {
-			// TODO: Improve the efficiency of this composition
-			byte rSrc, gSrc, bSrc;
-			byte rDst, gDst, bDst;
-			byte rFor, gFor, bFor;
-			byte rBak, gBak, bBak;
-
-			g_director->_wm->decomposeColor(src, rSrc, gSrc, bSrc);
-			g_director->_wm->decomposeColor(*dst, rDst, gDst, bDst);
-			g_director->_wm->decomposeColor(p->foreColor, rFor, gFor, bFor);
-			g_director->_wm->decomposeColor(p->backColor, rBak, gBak, bBak);
-
-			*dst = p->_wm->findBestColor((~rSrc | rFor) & (rSrc | rBak),
-																	 (~gSrc | gFor) & (gSrc | gBak),
-																	 (~bSrc | bFor) & (bSrc | bBak));
-		} else {
-			*dst = src;
-		}
+		*dst = p->applyColor ? inkCopyColor(p, src) : src;
 		break;
 	case kInkTypeTransparent:
 		*dst = p->applyColor ? (~src & p->foreColor) | (*dst & src) : (*dst & src);
@@ -300,6 +285,22 @@ void DirectorPlotData::setApplyColor() {
 	}
 }
 
+bool DirectorPlotData::isSourceInk() {
+	if (!srf || ms || alpha)
+		return false;
+
+	switch (ink) {
+	case kInkTypeCopy:
+	case kInkTypeNotCopy:
+	case kInkTypeMatte:
+	case kInkTypeMask:
+	case kInkTypeBackgndTrans:
+		return true;
+	default:
+		return false;
+	}
+}
+
 uint32 DirectorPlotData::preprocessColor(uint32 src) {
 	// HACK: Right now this method is just used for adjusting the colourization on text
 	// sprites, as it would be costly to colourize the chunks on the fly each
@@ -442,6 +443,86 @@ void DirectorPlotData::inkBlitSurface(Common::Rect &srcRect, const Graphics::Sur
 	}
 }
 
+void DirectorPlotData::inkRenderCache(const Common::Rect &bbox, const Graphics::Surface *mask, InkCache &cache) {
+	// Same as inkBlitSurface() and inkDrawPixel() for the inks where
+	// isSourceInk() is true, except that the stage is left out
+	bool colorize = applyColor && sprite != kTextSprite;
+	bool opaque = true;
+
+	cache.pixels = new Graphics::ManagedSurface(bbox.width(), bbox.height(), _wm->_pixelformat);
+	cache.coverage = new Graphics::ManagedSurface(bbox.width(), bbox.height(), Graphics::PixelFormat::createFormatCLUT8());
+
+	for (int i = 0; i < bbox.height(); i++) {
+		byte *cov = (byte *)cache.coverage->getBasePtr(0, i);
+
+		for (int j = 0; j < bbox.width(); j++, cov++) {
+			uint32 src;
+			bool covered;
+
+			if (_wm->_pixelformat.bytesPerPixel == 1) {
+				src = *(const byte *)srf->getBasePtr(j, i);
+				covered = !mask || !*(const byte *)mask->getBasePtr(j, i);
+			} else {
+				src = *(const uint32 *)srf->getBasePtr(j, i);
+				covered = !mask || !*(const uint32 *)mask->getBasePtr(j, i);
+			}
+
+			src = preprocessColor(src);
+			if (ink == kInkTypeBackgndTrans && src == backColor)
+				covered = false;
+
+			*cov = covered;
+			if (!covered) {
+				opaque = false;
+				continue;
+			}
+
+			if (colorize)
+				src = inkCopyColor(this, src);
+
+			if (_wm->_pixelformat.bytesPerPixel == 1)
+				*(byte *)cache.pixels->getBasePtr(j, i) = src;
+			else
+				*(uint32 *)cache.pixels->getBasePtr(j, i) = src;
+		}
+	}
+
+	if (opaque) {
+		delete cache.coverage;
+		cache.coverage = nullptr;
+	}
+}
+
+void DirectorPlotData::inkBlitCache(const InkCache &cache, Common::Rect &srcRect) {
+	Common::Rect rect(destRect);
+	rect.clip(Common::Rect(dst->w, dst->h));
+
+	int bytesPerPixel = _wm->_pixelformat.bytesPerPixel;
+
+	for (int i = rect.top; i < rect.bottom; i++) {
+		const byte *src = (const byte *)cache.pixels->getBasePtr(rect.left - srcRect.left, i - srcRect.top);
+		byte *out = (byte *)dst->getBasePtr(rect.left, i);
+
+		if (!cache.coverage) {
+			memcpy(out, src, rect.width() * bytesPerPixel);
+			continue;
+		}
+
+		const byte *cov = (const byte *)cache.coverage->getBasePtr(rect.left - srcRect.left, i - srcRect.top);
+		if (bytesPerPixel == 1) {
+			for (int j = 0; j < rect.width(); j++) {
+				if (cov[j])
+					out[j] = src[j];
+			}
+		} else {
+			for (int j = 0; j < rect.width(); j++) {
+				if (cov[j])
+					((uint32 *)out)[j] = ((const uint32 *)src)[j];
+			}
+		}
+	}
+}
+
 void DirectorPlotData::inkBlitStretchSurface(Common::Rect &srcRect, const Graphics::Surface *mask) {
 	if (!srf)
 		return;
@@ -21,6 +21,7 @@
 
 #include "common/file.h"
 #include "common/config-manager.h"
+#include "common/memorypool.h"
 
 #include "graphics/macgui/macwindowmanager.h"
 
@@ -423,7 +424,6 @@ void Lingo::execute() {
 				break;
 		}
 
-		Common::String instr = decodeInstruction(_currentScript, _pc);
 		uint current = _pc;
 
 		if (debugChannelSet(5, kDebugLingoExec))
@@ -436,7 +436,11 @@ void Lingo::execute() {
 				debug("me: %s", _currentMe.asString(true).c_str());
 		}
 
-		debugC(3, kDebugLingoExec, "[%3d]: %s", current, instr.c_str());
+		// Disassembling every instruction is costly, only do it when it is traced
+		if (debugChannelSet(3, kDebugLingoExec)) {
+			Common::String instr = decodeInstruction(_currentScript, _pc);
+			debugC(3, kDebugLingoExec, "[%3d]: %s", current, instr.c_str());
+		}
 
 		_pc++;
 		(*((*_currentScript)[_pc - 1]))();
@@ -588,27 +592,35 @@ int Lingo::getAlignedType(const Datum &d1, const Datum &d2, bool numsOnly) {
 	return opType;
 }
 
+/**
+ * Reference counts of Datums, which are shared by all copies of a value and
+ * are created and released all the time while scripts run.
+ */
+static Common::ObjectPool<int, 256> s_refCountPool;
+
 Datum::Datum() {
 	u.s = nullptr;
 	type = VOID;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 }
 
 Datum::Datum(const Datum &d) {
 	type = d.type;
 	u = d.u;
-	refCount = d.refCount;
-	*refCount += 1;
+	refCount = d.share();
 }
 
 Datum& Datum::operator=(const Datum &d) {
-	if (this != &d && refCount != d.refCount) {
+	if (this != &d && (!refCount || refCount != d.refCount)) {
+		// Take a reference first, as d may be part of the value released
+		// here, e.g. an item of a list
+		Datum copy(d);
 		reset();
-		type = d.type;
-		u = d.u;
-		refCount = d.refCount;
-		*refCount += 1;
+		type = copy.type;
+		u = copy.u;
+		refCount = copy.refCount;
+		copy.type = VOID;
+		copy.refCount = nullptr;
 	}
 	return *this;
 }
@@ -616,22 +628,19 @@ Datum& Datum::operator=(const Datum &d) {
 Datum::Datum(int val) {
 	u.i = val;
 	type = INT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 }
 
 Datum::Datum(double val) {
 	u.f = val;
 	type = FLOAT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 }
 
 Datum::Datum(const Common::String &val) {
 	u.s = new Common::String(val);
 	type = STRING;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 }
 
 Datum::Datum(AbstractObject *val) {
@@ -642,16 +651,14 @@ Datum::Datum(AbstractObject *val) {
 		*refCount += 1;
 	} else {
 		type = VOID;
-		refCount = new int;
-		*refCount = 1;
+		refCount = nullptr;
 	}
 }
 
 Datum::Datum(const CastMemberID &val) {
 	u.cast = new CastMemberID(val);
 	type = CASTREF;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 }
 
 Datum::Datum(const Common::Rect &rect) {
@@ -661,57 +668,90 @@ Datum::Datum(const Common::Rect &rect) {
 	u.farr->arr.push_back(Datum(rect.top));
 	u.farr->arr.push_back(Datum(rect.right));
 	u.farr->arr.push_back(Datum(rect.bottom));
+	refCount = nullptr;
+}
+
+bool Datum::ownsMemory() const {
+	switch (type) {
+	case VARREF:
+	case GLOBALREF:
+	case LOCALREF:
+	case PROPREF:
+	case STRING:
+	case SYMBOL:
+	case ARRAY:
+	case POINT:
+	case RECT:
+	case PARRAY:
+	case OBJECT:
+	case CHUNKREF:
+	case CASTREF:
+	case FIELDREF:
+		return true;
+	default:
+		return false;
+	}
+}
+
+int *Datum::share() const {
+	if (refCount) {
+		*refCount += 1;
+	} else if (ownsMemory()) {
+		// The first copy of a value, until now owned by this Datum alone
+		refCount = new (s_refCountPool) int(2);
+	}
+	return refCount;
 }
 
 void Datum::reset() {
-	if (!refCount)
-		return;
+	if (refCount) {
+		*refCount -= 1;
+		if (*refCount > 0)
+			return;
+	}
 
-	*refCount -= 1;
 	// Coverity thinks that we always free memory, as it assumes
 	// (correctly) that there are cases when refCount == 0
 	// Thus, DO NOT COMPILE, trick it and shut tons of false positives
 #ifndef __COVERITY__
-	if (*refCount <= 0) {
-		switch (type) {
-		case VARREF:
-		case GLOBALREF:
-		case LOCALREF:
-		case PROPREF:
-		case STRING:
-		case SYMBOL:
-			delete u.s;
-			break;
-		case ARRAY:
-		case POINT:
-		case RECT:
-			delete u.farr;
-			break;
-		case PARRAY:
-			delete u.parr;
-			break;
-		case OBJECT:
-			if (u.obj->getObjType() == kWindowObj) {
-				Window *window = static_cast<Window *>(u.obj);
-				g_director->_wm->removeWindow(window);
-				g_director->_wm->removeMarked();
-			} else {
-				delete u.obj;
-			}
-			break;
-		case CHUNKREF:
-			delete u.cref;
-			break;
-		case CASTREF:
-		case FIELDREF:
-			delete u.cast;
-			break;
-		default:
-			break;
+	switch (type) {
+	case VARREF:
+	case GLOBALREF:
+	case LOCALREF:
+	case PROPREF:
+	case STRING:
+	case SYMBOL:
+		delete u.s;
+		break;
+	case ARRAY:
+	case POINT:
+	case RECT:
+		delete u.farr;
+		break;
+	case PARRAY:
+		delete u.parr;
+		break;
+	case OBJECT:
+		if (u.obj->getObjType() == kWindowObj) {
+			Window *window = static_cast<Window *>(u.obj);
+			g_director->_wm->removeWindow(window);
+			g_director->_wm->removeMarked();
+		} else {
+			delete u.obj;
 		}
-		if (type != OBJECT) // object owns refCount
-			delete refCount;
+		break;
+	case CHUNKREF:
+		delete u.cref;
+		break;
+	case CASTREF:
+	case FIELDREF:
+		delete u.cast;
+		break;
+	default:
+		break;
 	}
+	if (refCount && type != OBJECT) // object owns refCount
+		s_refCountPool.deleteChunk(refCount);
 #endif
 }
 
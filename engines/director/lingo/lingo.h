@@ -142,7 +142,12 @@ struct Datum {	/* interpreter stack type */
 		CastMemberID *cast;	/* CASTREF, FIELDREF */
 	} u;
 
-	int *refCount;
+	/**
+	 * Shared by the copies of a value which owns memory, like a string or a
+	 * list. Plain values like integers have none, and neither does a value
+	 * which has not been copied yet, as its Datum is the only owner.
+	 */
+	mutable int *refCount;
 
 	Datum();
 	Datum(const Datum &d);
@@ -155,6 +160,11 @@ struct Datum {	/* interpreter stack type */
 	Datum(const Common::Rect &rect);
 	void reset();
 
+	/** Return whether the value owns memory which is freed with its last copy. */
+	bool ownsMemory() const;
+	/** Add a reference for a new copy of the value, and return the reference count to use. */
+	int *share() const;
+
 	~Datum() {
 		reset();
 	}
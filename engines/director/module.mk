@@ -6,6 +6,7 @@ MODULE_OBJS = \
 	castmember.o \
 	channel.o \
 	cursor.o \
+	debugger.o \
 	director.o \
 	events.o \
 	fonts.o \
@@ -493,6 +493,8 @@ void Score::update() {
 }
 
 void Score::renderFrame(uint16 frameId, RenderMode mode) {
+	uint32 startTime = g_system->getMillis();
+
 	// Force cursor update if a new movie's started.
 	if (_window->_newMovieStarted)
 		renderCursor(_movie->getWindow()->getMousePos(), true);
@@ -507,6 +509,7 @@ void Score::renderFrame(uint16 frameId, RenderMode mode) {
 	}
 
 	_window->render();
+	_window->finishRenderStats(g_system->getMillis() - startTime);
 
 	playSoundChannel(frameId);
 	playQueuedSound(); // this is currently only used in FPlayXObj
@@ -556,18 +559,34 @@ void Score::renderSprites(uint16 frameId, RenderMode mode) {
 		}
 
 		if (channel->isDirty(nextSprite) || widgetRedrawn || mode == kRenderForceUpdate) {
-			if (!currentSprite->_trails)
-				_window->addDirtyRect(channel->getBbox());
+			// Scripts often set sprite properties to the values they already
+			// have, so compare with what the channel showed when it was last
+			// drawn before redrawing anything. Lingo may already have changed
+			// the sprite itself, so its current state can't be used for that.
+			bool trails = currentSprite->_trails;
 
 			channel->setClean(nextSprite, i);
 			// Check again to see if a video has just been started by setClean.
 			if (channel->isActiveVideo())
 				_movie->_videoPlayback = true;
 
-			_window->addDirtyRect(channel->getBbox());
+			ChannelLook look = channel->getLook();
+			if (widgetRedrawn || mode == kRenderForceUpdate || look != channel->_lastLook) {
+				channel->_static = false;
+				channel->invalidateInkCache();
+
+				if (!trails)
+					_window->addDirtyRect(channel->_lastLook.bbox);
+				_window->addDirtyRect(look.bbox);
+				channel->_lastLook = look;
+			} else {
+				channel->_static = true;
+				_window->_renderStats.skippedChannels++;
+			}
 			debugC(2, kDebugImages, "Score::renderSprites(): CH: %-3d castId: %s [ink: %d, puppet: %d, moveable: %d, visible: %d] [bbox: %d,%d,%d,%d] [type: %d fg: %d bg: %d] [script: %s]", i, currentSprite->_castId.asString().c_str(), currentSprite->_ink, currentSprite->_puppet, currentSprite->_moveable, channel->_visible, PRINT_RECT(channel->getBbox()), currentSprite->_spriteType, currentSprite->_foreColor, currentSprite->_backColor, currentSprite->_scriptId.asString().c_str());
 		} else {
 			channel->setClean(nextSprite, i, true);
+			channel->_static = true;
 		}
 
 		// update editable text channel after we render the sprites. because for the current frame, we may get those sprites only when we finished rendering
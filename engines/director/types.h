@@ -371,10 +371,10 @@ struct CastMemberID {
 	CastMemberID(int memberID, int castLibID)
 		: member(memberID), castLib(castLibID) {}
 	
-	bool operator==(const CastMemberID &c) {
+	bool operator==(const CastMemberID &c) const {
 		return member == c.member && castLib == c.castLib;
 	}
-	bool operator!=(const CastMemberID &c) {
+	bool operator!=(const CastMemberID &c) const {
 		return member != c.member || castLib != c.castLib;
 	}
 
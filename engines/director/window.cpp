@@ -58,6 +58,8 @@ Window::Window(int id, bool scrollable, bool resizable, bool editable, Graphics:
 	_objType = kWindowObj;
 	_startFrame = _vm->getStartMovie().startFrame;
 
+	resetRenderStats();
+
 	_windowType = -1;
 	_titleVisible = true;
 	updateBorderType();
@@ -137,6 +139,8 @@ bool Window::render(bool forceRedraw, Graphics::ManagedSurface *blitTo) {
 	for (Common::List<Common::Rect>::iterator i = _dirtyRects.begin(); i != _dirtyRects.end(); i++) {
 		const Common::Rect &r = *i;
 		_dirtyChannels = _currentMovie->getScore()->getSpriteIntersections(r);
+		_renderStats.rects++;
+		_renderStats.pixels += r.width() * r.height();
 
 		bool shouldClear = true;
 		for (Common::List<Channel *>::iterator j = _dirtyChannels.begin(); j != _dirtyChannels.end(); j++) {
@@ -195,6 +199,24 @@ void Window::reset() {
 	_contentIsDirty = true;
 }
 
+void Window::finishRenderStats(uint32 millis) {
+	_renderStats.millis = millis;
+	_lastRenderStats = _renderStats;
+	_renderStats = RenderStats();
+
+	_renderedFrames++;
+	_renderedMillis += millis;
+	_renderedPixels += _lastRenderStats.pixels;
+}
+
+void Window::resetRenderStats() {
+	_renderStats = RenderStats();
+	_lastRenderStats = RenderStats();
+	_renderedFrames = 0;
+	_renderedMillis = 0;
+	_renderedPixels = 0;
+}
+
 void Window::inkBlitFrom(Channel *channel, Common::Rect destRect, Graphics::ManagedSurface *blitTo) {
 	Common::Rect srcRect = channel->getBbox();
 	destRect.clip(srcRect);
@@ -203,10 +225,17 @@ void Window::inkBlitFrom(Channel *channel, Common::Rect destRect, Graphics::Mana
 	pd.destRect = destRect;
 	pd.dst = blitTo;
 
+	_renderStats.blits++;
+
 	if (pd.ms) {
 		pd.inkBlitShape(srcRect);
 	} else if (pd.srf) {
-		if (channel->isStretched()) {
+		const InkCache *cache = channel->getInkCache(pd);
+
+		if (cache) {
+			pd.inkBlitCache(*cache, srcRect);
+			_renderStats.cachedBlits++;
+		} else if (channel->isStretched()) {
 			srcRect = channel->getBbox(true);
 			pd.inkBlitStretchSurface(srcRect, channel->getMask());
 		} else {
@@ -84,6 +84,18 @@ struct TransParams {
 	}
 };
 
+// Compositing work done for one frame of the score
+struct RenderStats {
+	uint32 millis;
+	uint32 pixels;
+	uint32 rects;
+	uint32 blits;
+	uint32 cachedBlits;
+	uint32 skippedChannels;
+
+	RenderStats() : millis(0), pixels(0), rects(0), blits(0), cachedBlits(0), skippedChannels(0) {}
+};
+
 class Window : public Graphics::MacWindow, public Object<Window> {
 public:
 	Window(int id, bool scrollable, bool resizable, bool editable, Graphics::MacWindowManager *wm, DirectorEngine *vm, bool isStage);
@@ -98,6 +110,9 @@ public:
 
 	void reset();
 
+	void finishRenderStats(uint32 millis);
+	void resetRenderStats();
+
 	// transitions.cpp
 	void exitTransition(Graphics::ManagedSurface *nextFrame, Common::Rect clipRect);
 	void stepTransition();
@@ -181,6 +196,13 @@ public:
 	DatumHash *_retLocalVars;
 	Datum _retMe;
 
+	// Shown by the "renderstats" debugger command
+	RenderStats _renderStats; // frame being drawn
+	RenderStats _lastRenderStats;
+	uint32 _renderedFrames;
+	uint32 _renderedMillis;
+	uint64 _renderedPixels;
+
 private:
 	uint32 _stageColor;
 
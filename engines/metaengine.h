@@ -157,6 +157,40 @@ public:
 	 */
 	virtual DetectedGames detectGames(const Common::FSList &fslist) = 0;
 
+	/**
+	 * Intermediate results of detectGamesConcurrently(), which are passed
+	 * on to finishDetectGames().
+	 */
+	class ConcurrentDetection {
+	public:
+		virtual ~ConcurrentDetection() {}
+	};
+
+	/**
+	 * Run the part of the game detector which can run on a worker thread,
+	 * concurrently with the detectors of other engines.
+	 *
+	 * This must neither change nor depend on global state, such as the
+	 * config manager, SearchMan or the debug channels, and @p fslist must
+	 * not share nodes with other threads. Everything else is done by
+	 * finishDetectGames() on the main thread.
+	 *
+	 * The default implementation returns nullptr, in which case
+	 * finishDetectGames() runs the whole detection.
+	 */
+	virtual ConcurrentDetection *detectGamesConcurrently(const Common::FSList &fslist) {
+		return nullptr;
+	}
+
+	/**
+	 * Finish a detection started by detectGamesConcurrently(), and return
+	 * the same results as detectGames(). This takes ownership of @p partial.
+	 */
+	virtual DetectedGames finishDetectGames(const Common::FSList &fslist, ConcurrentDetection *partial) {
+		delete partial;
+		return detectGames(fslist);
+	}
+
 	/**
 	 * Return a list of extra GUI options for the specified target.
 	 *
@@ -22,6 +22,7 @@
 // Console module
 
 #include "common/md5.h"
+#include "common/worker-pool.h"
 #include "sci/sci.h"
 #include "sci/console.h"
 #include "sci/debug.h"
@@ -34,6 +35,7 @@
 #include "sci/engine/gc.h"
 #include "sci/engine/features.h"
 #include "sci/engine/scriptdebug.h"
+#include "sci/engine/script_patches.h"
 #include "sci/sound/midiparser_sci.h"
 #include "sci/sound/music.h"
 #include "sci/sound/drivers/mididriver.h"
@@ -118,6 +120,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
+	registerCmd("bench_script_patches",	WRAP_METHOD(Console, cmdBenchScriptPatches));
 	registerCmd("integrity_dump",	WRAP_METHOD(Console, cmdResourceIntegrityDump));
 	// Game
 	registerCmd("save_game",			WRAP_METHOD(Console, cmdSaveGame));
@@ -149,6 +152,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
 	registerCmd("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	registerCmd("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
+	registerCmd("frameout_stats",     WRAP_METHOD(Console, cmdFrameOutStats));
 	// Segments
 	registerCmd("segment_table",		WRAP_METHOD(Console, cmdPrintSegmentTable));
 	registerCmd("segtable",			WRAP_METHOD(Console, cmdPrintSegmentTable));	// alias
@@ -162,6 +166,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -225,6 +230,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("instruction_cache",	WRAP_METHOD(Console, cmdInstructionCache));
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -349,6 +355,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
+	debugPrintf(" bench_script_patches - Loads all scripts and measures how long the script patcher takes for them\n");
 	debugPrintf(" integrity_dump - Dumps integrity data about resources in the current game to disk\n");
 	debugPrintf("\n");
 	debugPrintf("Game:\n");
@@ -376,6 +383,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
+	debugPrintf(" frameout_stats - Shows how long the stages of rendering a frame take (SCI32)\n");
 	debugPrintf("\n");
 	debugPrintf("Segments:\n");
 	debugPrintf(" segment_table / segtable - Lists all segments\n");
@@ -388,6 +396,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows how long the garbage collector pauses the game\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -433,6 +442,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" instruction_cache - Shows or sets how the VM reuses decoded instructions\n");
 	debugPrintf(" script_objects / scro - Shows all objects inside a specified script\n");
 	debugPrintf(" script_strings / scrs - Shows all strings inside a specified script\n");
 	debugPrintf(" script_said - Shows all said - strings inside a specified script\n");
@@ -1214,6 +1224,61 @@ bool Console::cmdVerifyScripts(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdBenchScriptPatches(int argc, const char **argv) {
+	int rounds = 10;
+
+	if (argc > 2) {
+		debugPrintf("Loads all scripts of the game and measures how long the script patcher\n");
+		debugPrintf("takes to process them.\n");
+		debugPrintf("Usage: %s [<rounds>]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2)
+		rounds = MAX(atoi(argv[1]), 1);
+
+	Common::List<ResourceId> resources = _engine->getResMan()->listResources(kResourceTypeScript);
+	Common::sort(resources.begin(), resources.end());
+
+	ScriptPatcher *scriptPatcher = _engine->getScriptPatcher();
+	uint32 totalSize = 0;
+	uint64 totalMicros = 0;
+	uint64 slowestMicros = 0;
+	int slowestScript = -1;
+
+	Common::List<ResourceId>::iterator itr;
+	for (itr = resources.begin(); itr != resources.end(); ++itr) {
+		const int scriptNr = itr->getNumber();
+
+		// Load the script without patches, and patch copies of it
+		Script script;
+		script.load(scriptNr, _engine->getResMan(), scriptPatcher, false);
+		const uint32 bufSize = script.getBufSize();
+		Common::Array<byte> buffer(bufSize);
+
+		const uint64 start = g_system->getMicros();
+		for (int round = 0; round < rounds; round++) {
+			memcpy(buffer.data(), script.getBuf(), bufSize);
+			scriptPatcher->processScript(scriptNr, SciSpan<byte>(buffer.data(), bufSize));
+		}
+		const uint64 micros = g_system->getMicros() - start;
+
+		totalSize += bufSize;
+		totalMicros += micros;
+		if (micros > slowestMicros) {
+			slowestMicros = micros;
+			slowestScript = scriptNr;
+		}
+	}
+
+	debugPrintf("Patched %d scripts (%u bytes) %d times\n", resources.size(), totalSize, rounds);
+	debugPrintf("Average time per round: %u us\n", (uint)(totalMicros / rounds));
+	if (slowestScript != -1)
+		debugPrintf("Slowest script: %d, %u us per round\n", slowestScript, (uint)(slowestMicros / rounds));
+
+	return true;
+}
+
 // Same as in sound/drivers/midi.cpp
 uint8 getGmInstrument(const Mt32ToGmMap &Mt32Ins) {
 	if (Mt32Ins.gmInstr == MIDI_MAPPED_TO_RHYTHM)
@@ -2157,7 +2222,8 @@ bool Console::cmdSavedBits(int argc, const char **argv) {
 		return true;
 	}
 
-	Common::Array<reg_t> entries = hunks->listAllDeallocatable(id);
+	Common::Array<reg_t> entries;
+	hunks->listAllDeallocatable(id, entries);
 
 	for (uint i = 0; i < entries.size(); ++i) {
 		uint32 offset = entries[i].getOffset();
@@ -2803,7 +2869,8 @@ bool Console::cmdGCShowFreeable(int argc, const char **argv) {
 	}
 
 	debugPrintf("Freeable in segment %04x:\n", addr.getSegment());
-	const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(addr.getSegment());
+	Common::Array<reg_t> tmp;
+	mobj->listAllDeallocatable(addr.getSegment(), tmp);
 	for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it)
 		if (it->getSegment())
 			g_sci->getSciDebugger()->debugPrintf("  %04x:%04x\n", PRINT_REG(*it));
@@ -2841,6 +2908,65 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GCStatistics &stats = _engine->_gamestate->gcStatistics;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Garbage collector statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows how long the garbage collector pauses the game.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Collections: %u, every %d kernel calls\n", stats.runs, _engine->_gamestate->scriptGCInterval);
+	if (!stats.runs)
+		return true;
+
+	debugPrintf("Pause time: average %u us, longest %u us\n", (uint)(stats.totalPauseTime / stats.runs), (uint)stats.maxPauseTime);
+	debugPrintf("Last collection: %u us finding %u reachable addresses, %u us freeing %u objects\n",
+		(uint)stats.lastMarkTime, stats.lastReachable, (uint)stats.lastSweepTime, stats.lastFreed);
+	debugPrintf("Objects freed in total: %u\n", stats.totalFreed);
+
+	return true;
+}
+
+bool Console::cmdFrameOutStats(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	if (!_engine->_gfxFrameout) {
+		debugPrintf("This SCI version does not have this command\n");
+		return true;
+	}
+
+	FrameOutStatistics &stats = _engine->_gfxFrameout->_statistics;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Frame statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows how long the stages of rendering a frame take.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Frames: %u, %u of them drawn on %u threads\n", stats.frames, stats.concurrentFrames, Common::WorkerPool::instance().getThreadCount());
+	if (!stats.frames)
+		return true;
+
+	debugPrintf("Average: calcLists %u us, draw %u us, showBits %u us\n",
+		(uint)(stats.totalCalcListsTime / stats.frames), (uint)(stats.totalDrawTime / stats.frames), (uint)(stats.totalShowBitsTime / stats.frames));
+	debugPrintf("Last frame: calcLists %u us, draw %u us for %u cels and erase rects, showBits %u us\n",
+		stats.lastCalcListsTime, stats.lastDrawTime, stats.lastDrawCount, stats.lastShowBitsTime);
+	debugPrintf("Longest frame: %u us\n", stats.maxFrameTime);
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
@@ -3270,6 +3396,36 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdInstructionCache(int argc, const char **argv) {
+	static const char *const modeNames[] = { "on", "off", "verify" };
+
+	if (argc == 2) {
+		int mode;
+		for (mode = 0; mode < ARRAYSIZE(modeNames); mode++) {
+			if (!scumm_stricmp(argv[1], modeNames[mode]))
+				break;
+		}
+
+		if (mode == ARRAYSIZE(modeNames)) {
+			debugPrintf("Unknown mode '%s'\n", argv[1]);
+			return true;
+		}
+
+		_debugState.instructionCache = (InstructionCacheMode)mode;
+	} else if (argc > 2) {
+		debugPrintf("Shows or sets how the VM reuses decoded instructions.\n");
+		debugPrintf("Usage: %s [on | off | verify]\n", argv[0]);
+		debugPrintf("on: reuse decoded instructions (default)\n");
+		debugPrintf("off: decode every instruction when it is executed\n");
+		debugPrintf("verify: reuse decoded instructions, and stop with an error if they differ\n");
+		debugPrintf("        from freshly decoded ones\n");
+		return true;
+	}
+
+	debugPrintf("Instruction cache: %s\n", modeNames[_debugState.instructionCache]);
+	return true;
+}
+
 bool Console::cmdScriptObjects(int argc, const char **argv) {
 	int curScriptNr = -1;
 
@@ -71,6 +71,12 @@ enum DebugSeeking {
 	kDebugSeekStepOver = 5      // Step forward until we reach same stack-level again
 };
 
+enum InstructionCacheMode {
+	kInstructionCacheOn = 0,	// Reuse decoded instructions, see Script::decodeInstruction()
+	kInstructionCacheOff = 1,	// Decode every instruction when it is executed
+	kInstructionCacheVerify = 2	// Reuse decoded instructions, and check them against freshly decoded ones
+};
+
 struct DebugState {
 	bool debugging;
 	bool breakpointWasHit;
@@ -83,6 +89,7 @@ struct DebugState {
 	StackPtr old_sp;
 	Common::List<Breakpoint> _breakpoints;   //< List of breakpoints
 	int _activeBreakpointTypes;  //< Bit mask specifying which types of breakpoints are active
+	InstructionCacheMode instructionCache;
 
 	void updateActiveBreakpointTypes();
 };
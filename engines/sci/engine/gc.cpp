@@ -21,6 +21,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -55,10 +56,11 @@ void WorklistManager::push(reg_t reg) {
 
 	debugC(kDebugLevelGC, "[GC] Adding %04x:%04x", PRINT_REG(reg));
 
-	if (_map.contains(reg))
+	bool &pushed = _map.getOrCreateVal(reg);
+	if (pushed)
 		return; // already dealt with it
 
-	_map.setVal(reg, true);
+	pushed = true;
 	_worklist.push_back(reg);
 }
 
@@ -69,6 +71,7 @@ void WorklistManager::pushArray(const Common::Array<reg_t> &tmp) {
 
 static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_map) {
 	AddrSet *normal_map = new AddrSet();
+	normal_map->reserve(nonnormal_map.size());
 
 	for (AddrSet::const_iterator i = nonnormal_map.begin(); i != nonnormal_map.end(); ++i) {
 		reg_t reg = i->_key;
@@ -180,6 +183,9 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 void run_gc(EngineState *s) {
 	SegManager *segMan = s->_segMan;
+	GCStatistics &stats = s->gcStatistics;
+	const uint64 startTime = g_system->getMicros();
+	uint32 freed = 0;
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
@@ -192,10 +198,13 @@ void run_gc(EngineState *s) {
 
 	// Compute the set of all segments references currently in use.
 	AddrSet *activeRefs = findAllActiveReferences(s);
+	const uint64 markedTime = g_system->getMicros();
 
 	// Iterate over all segments, and check for each whether it
-	// contains stuff that can be collected.
+	// contains stuff that can be collected. The list of candidates is
+	// reused for all segments.
 	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+	Common::Array<reg_t> deallocatable;
 	for (uint seg = 1; seg < heap.size(); seg++) {
 		SegmentObj *mobj = heap[seg];
 
@@ -207,13 +216,15 @@ void run_gc(EngineState *s) {
 
 			// Get a list of all deallocatable objects in this segment,
 			// then free any which are not referenced from somewhere.
-			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
-			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
+			deallocatable.resize(0); // keeps the storage, unlike clear()
+			mobj->listAllDeallocatable(seg, deallocatable);
+			for (Common::Array<reg_t>::const_iterator it = deallocatable.begin(); it != deallocatable.end(); ++it) {
 				const reg_t addr = *it;
 				if (!activeRefs->contains(addr)) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+					freed++;
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
 #endif
@@ -223,8 +234,19 @@ void run_gc(EngineState *s) {
 		}
 	}
 
+	stats.lastReachable = activeRefs->size();
 	delete activeRefs;
 
+	const uint64 endTime = g_system->getMicros();
+	stats.runs++;
+	stats.lastMarkTime = markedTime - startTime;
+	stats.lastSweepTime = endTime - markedTime;
+	stats.maxPauseTime = MAX(stats.maxPauseTime, endTime - startTime);
+	stats.totalPauseTime += endTime - startTime;
+	stats.lastFreed = freed;
+	stats.totalFreed += freed;
+	debugC(kDebugLevelGC, "[GC] Done in %u us, %u reachable, %u freed", (uint)(endTime - startTime), stats.lastReachable, freed);
+
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
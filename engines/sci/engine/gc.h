@@ -23,7 +23,7 @@
 #ifndef SCI_ENGINE_GC_H
 #define SCI_ENGINE_GC_H
 
-#include "common/hashmap.h"
+#include "common/flat-hashmap.h"
 #include "sci/engine/vm_types.h"
 #include "sci/engine/state.h"
 
@@ -37,9 +37,11 @@ struct reg_t_Hash {
 
 /*
  * The AddrSet is a "set" of reg_t values.
- * We don't have a HashSet type, so we abuse a HashMap for this.
+ * We don't have a HashSet type, so we abuse a HashMap for this. It is
+ * filled with every reachable address on each collection, so an
+ * open-addressing map is used, which needs no allocation per entry.
  */
-typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
+typedef Common::FlatHashMap<reg_t, bool, reg_t_Hash> AddrSet;
 
 /**
  * Finds all used references and normalises them to their memory addresses
@@ -49,14 +51,16 @@ typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
 AddrSet *findAllActiveReferences(EngineState *s);
 
 /**
- * Runs garbage collection on the current system state
+ * Runs garbage collection on the current system state.
+ * The collection is done in one pass; marking it incrementally would need a
+ * write barrier on every reference store of the VM and the kernel.
  * @param s The state in which we should gc
  */
 void run_gc(EngineState *s);
 
 struct WorklistManager {
 	Common::Array<reg_t> _worklist;
-	AddrSet _map;	// used for 2 contains() calls, inside push() and run_gc()
+	AddrSet _map;	// all addresses pushed so far
 
 	void push(reg_t reg);
 	void pushArray(const Common::Array<reg_t> &tmp);
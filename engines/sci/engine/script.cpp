@@ -69,6 +69,7 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_objects.clear();
 
 	_offsetLookupArray.clear();
+	_instructionCache.clear();
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
@@ -932,6 +933,47 @@ SciSpan<const byte> Script::findBlockSCI0(ScriptObjectTypes type, bool findLastB
 
 // memory operations
 
+uint Script::decodeInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]) {
+	const byte *src = getBuf(offset);
+
+	// Instructions are compared as one 64-bit word, so the ones close to the
+	// end of the buffer are not cached
+	if (offset + 8 > _buf->size())
+		return readPMachineInstruction(src, extOpcode, opparams);
+
+	if (_instructionCache.empty()) {
+		_instructionCache.resize(kInstructionCacheSize);
+		for (uint i = 0; i < kInstructionCacheSize; i++)
+			_instructionCache[i].offset = DecodedInstruction::kNoInstruction;
+	}
+
+	DecodedInstruction &instruction = _instructionCache[offset & (kInstructionCacheSize - 1)];
+	const uint64 bytes = READ_LE_UINT64(src);
+
+	if (instruction.offset == offset) {
+		const uint64 mask = (instruction.size == 8) ? ~(uint64)0 : ((uint64)1 << (instruction.size * 8)) - 1;
+		if (((bytes ^ instruction.bytes) & mask) == 0) {
+			extOpcode = instruction.extOpcode;
+			memcpy(opparams, instruction.opparams, sizeof(instruction.opparams));
+			return instruction.size;
+		}
+	}
+
+	const uint size = readPMachineInstruction(src, extOpcode, opparams);
+
+	// Instructions with file names (op_pushSelf with the low bit set) may be
+	// longer, and are decoded every time
+	if (size <= 8) {
+		instruction.offset = offset;
+		instruction.bytes = bytes;
+		instruction.extOpcode = extOpcode;
+		instruction.size = size;
+		memcpy(instruction.opparams, opparams, sizeof(instruction.opparams));
+	}
+
+	return size;
+}
+
 bool Script::isValidOffset(uint32 offset) const {
 	return offset < _buf->size();
 }
@@ -1231,9 +1273,8 @@ void Script::freeAtAddress(SegManager *segMan, reg_t addr) {
 		segMan->deallocateScript(_nr);
 }
 
-Common::Array<reg_t> Script::listAllDeallocatable(SegmentId segId) const {
-	const reg_t r = make_reg(segId, 0);
-	return Common::Array<reg_t>(&r, 1);
+void Script::listAllDeallocatable(SegmentId segId, Common::Array<reg_t> &list) const {
+	list.push_back(make_reg(segId, 0));
 }
 
 Common::Array<reg_t> Script::listAllOutgoingReferences(reg_t addr) const {
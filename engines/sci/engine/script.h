@@ -68,6 +68,22 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/**
+ * A VM instruction as decoded by readPMachineInstruction(), see
+ * Script::decodeInstruction().
+ */
+struct DecodedInstruction {
+	uint32 offset; ///< Offset of the instruction in the script buffer, or kNoInstruction
+	uint64 bytes;  ///< The bytes the instruction was decoded from (little endian, padded)
+	byte extOpcode;
+	byte size;
+	int16 opparams[4];
+
+	enum {
+		kNoInstruction = 0xFFFFFFFF
+	};
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -101,6 +117,16 @@ private:
 	uint16 _offsetLookupStringCount;
 	uint16 _offsetLookupSaidCount;
 
+	enum {
+		kInstructionCacheSize = 2048 ///< Must be a power of 2
+	};
+
+	/**
+	 * Recently executed instructions, indexed by their offset modulo the
+	 * cache size. Allocated when the first instruction is decoded.
+	 */
+	Common::Array<DecodedInstruction> _instructionCache;
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -119,6 +145,15 @@ public:
 	const byte *getBuf(uint offset = 0) const { return _buf->getUnsafeDataAt(offset); }
 	SciSpan<const byte> getSpan(uint offset) const { return _buf->subspan(offset); }
 
+	/**
+	 * Decodes the VM instruction at the given offset, like
+	 * readPMachineInstruction(). Decoded instructions are cached, and reused
+	 * as long as the bytes they were decoded from are unchanged, so the cache
+	 * stays valid when scripts get patched or overwritten.
+	 * @return the size of the instruction
+	 */
+	uint decodeInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]);
+
 	int getScriptNumber() const { return _nr; }
 	SegmentId getLocalsSegment() const { return _localsSegment; }
 	reg_t *getLocalsBegin() { return _localsBlock ? _localsBlock->_locals.begin() : NULL; }
@@ -138,7 +173,7 @@ public:
 	SegmentRef dereference(reg_t pointer) override;
 	reg_t findCanonicAddress(SegManager *segMan, reg_t sub_addr) const override;
 	void freeAtAddress(SegManager *segMan, reg_t sub_addr) override;
-	Common::Array<reg_t> listAllDeallocatable(SegmentId segId) const override;
+	void listAllDeallocatable(SegmentId segId, Common::Array<reg_t> &list) const override;
 	Common::Array<reg_t> listAllOutgoingReferences(reg_t object) const override;
 
 	/**
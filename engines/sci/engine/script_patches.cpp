@@ -21984,7 +21984,7 @@ ScriptPatcher::~ScriptPatcher() {
 }
 
 // will actually patch previously found signature area
-void ScriptPatcher::applyPatch(const SciScriptPatcherEntry *patchEntry, SciSpan<byte> scriptData, int32 signatureOffset) {
+uint32 ScriptPatcher::applyPatch(const SciScriptPatcherEntry *patchEntry, SciSpan<byte> scriptData, int32 signatureOffset) {
 	const uint16 *patchData = patchEntry->patchData;
 	byte orgData[PATCH_VALUELIMIT];
 	int32 offset = signatureOffset;
@@ -22092,6 +22092,7 @@ void ScriptPatcher::applyPatch(const SciScriptPatcherEntry *patchEntry, SciSpan<
 		patchData++;
 		patchWord = *patchData;
 	}
+	return offset;
 }
 
 bool ScriptPatcher::verifySignature(uint32 byteOffset, const uint16 *signatureData, const char *signatureDescription, const SciSpan<const byte> &scriptData) {
@@ -22210,6 +22211,29 @@ int32 ScriptPatcher::findSignature(const SciScriptPatcherEntry *patchEntry, cons
 	return findSignature(runtimeEntry->magicDWord, runtimeEntry->magicOffset, patchEntry->signatureData, patchEntry->description, scriptData);
 }
 
+void ScriptPatcher::findMagicDWords(const SciScriptPatcherRuntimeEntry *runtimeEntry, const SciSpan<const byte> &scriptData, uint32 startOffset, uint32 endOffset, Common::Array<uint32> &dWordOffsets) {
+	Common::Array<uint32> newOffsets;
+	uint32 i = 0;
+
+	// keep the offsets in front of the range
+	while (i < dWordOffsets.size() && dWordOffsets[i] < startOffset)
+		newOffsets.push_back(dWordOffsets[i++]);
+
+	// search the range again
+	for (uint32 DWordOffset = startOffset; DWordOffset < endOffset; DWordOffset++) {
+		if (runtimeEntry->magicDWord == scriptData.getUint32At(DWordOffset))
+			newOffsets.push_back(DWordOffset);
+	}
+
+	// and keep the offsets behind it
+	while (i < dWordOffsets.size() && dWordOffsets[i] < endOffset)
+		i++;
+	while (i < dWordOffsets.size())
+		newOffsets.push_back(dWordOffsets[i++]);
+
+	dWordOffsets = newOffsets;
+}
+
 // Attention: Magic DWord is returned using platform specific byte order. This is done on purpose for performance.
 void ScriptPatcher::calculateMagicDWordAndVerify(const char *signatureDescription, const uint16 *signatureData, bool magicDWordIncluded, uint32 &calculatedMagicDWord, int &calculatedMagicDWordOffset) {
 	Selector curSelector = -1;
@@ -22360,6 +22384,7 @@ void ScriptPatcher::initSignature(const SciScriptPatcherEntry *patchTable) {
 
 	curEntry = patchTable;
 	curRuntimeEntry = _runtimeTable;
+	_scriptIndex.clear();
 	while (curEntry->signatureData) {
 		// process signature
 		curRuntimeEntry->active = curEntry->defaultActive;
@@ -22371,6 +22396,12 @@ void ScriptPatcher::initSignature(const SciScriptPatcherEntry *patchTable) {
 		// We verify the patch data
 		calculateMagicDWordAndVerify(curEntry->description, curEntry->patchData, false, curRuntimeEntry->magicDWord, curRuntimeEntry->magicOffset);
 
+		// Add the entry to the index of its script
+		SciScriptPatcherScriptIndex &scriptIndex = _scriptIndex[curEntry->scriptNr];
+		scriptIndex.entries.push_back(curEntry - patchTable);
+		const uint filterBit = SciScriptPatcherScriptIndex::filterBit(curRuntimeEntry->magicDWord);
+		scriptIndex.filter[filterBit >> 5] |= 1U << (filterBit & 31);
+
 		curEntry++; curRuntimeEntry++;
 	}
 }
@@ -22718,24 +22749,63 @@ void ScriptPatcher::processScript(uint16 scriptNr, SciSpan<byte> scriptData) {
 			}
 		}
 
-		curEntry = signatureTable;
-		curRuntimeEntry = _runtimeTable;
-
-		while (curEntry->signatureData) {
-			if ((scriptNr == curEntry->scriptNr) && (curRuntimeEntry->active)) {
-				int32 foundOffset = 0;
-				int16 applyCount = curEntry->applyCount;
-				do {
-					foundOffset = findSignature(curEntry, curRuntimeEntry, scriptData);
-					if (foundOffset != -1) {
-						// found, so apply the patch
-						debugC(kDebugLevelPatcher, "Script-Patcher: '%s' on script %d offset %d", curEntry->description, scriptNr, foundOffset);
-						applyPatch(curEntry, scriptData, foundOffset);
-					}
-					applyCount--;
-				} while ((foundOffset != -1) && (applyCount));
+		ScriptIndexMap::const_iterator index = _scriptIndex.find(scriptNr);
+		if (index == _scriptIndex.end() || scriptData.size() < 4) // we need to find a DWORD, so less than 4 bytes is not okay
+			return;
+
+		const SciScriptPatcherScriptIndex &scriptIndex = index->_value;
+		const uint entryCount = scriptIndex.entries.size();
+
+		// Search for the magic DWORDs of all entries of this script in one go
+		Common::Array<Common::Array<uint32> > dWordOffsets(entryCount);
+		const uint32 searchLimit = scriptData.size() - 3;
+		const byte *data = scriptData.getUnsafeDataAt(0, scriptData.size());
+		for (uint32 DWordOffset = 0; DWordOffset < searchLimit; DWordOffset++) {
+			// magicDWord is in platform-specific BE/LE form, see calculateMagicDWordAndVerify()
+			const uint32 dWord = READ_UINT32(data + DWordOffset);
+			const uint filterBit = SciScriptPatcherScriptIndex::filterBit(dWord);
+			if (!(scriptIndex.filter[filterBit >> 5] & (1U << (filterBit & 31))))
+				continue;
+
+			for (uint entryNr = 0; entryNr < entryCount; entryNr++) {
+				if (_runtimeTable[scriptIndex.entries[entryNr]].magicDWord == dWord)
+					dWordOffsets[entryNr].push_back(DWordOffset);
 			}
-			curEntry++; curRuntimeEntry++;
+		}
+
+		for (uint entryNr = 0; entryNr < entryCount; entryNr++) {
+			curEntry = signatureTable + scriptIndex.entries[entryNr];
+			curRuntimeEntry = _runtimeTable + scriptIndex.entries[entryNr];
+			if (!curRuntimeEntry->active)
+				continue;
+
+			int32 foundOffset = 0;
+			int16 applyCount = curEntry->applyCount;
+			do {
+				// same as findSignature(), but only checks where the magic DWORD is
+				foundOffset = -1;
+				for (uint i = 0; i < dWordOffsets[entryNr].size(); i++) {
+					uint32 offset = dWordOffsets[entryNr][i] + curRuntimeEntry->magicOffset;
+					if (verifySignature(offset, curEntry->signatureData, curEntry->description, scriptData)) {
+						foundOffset = offset;
+						break;
+					}
+				}
+
+				if (foundOffset != -1) {
+					// found, so apply the patch
+					debugC(kDebugLevelPatcher, "Script-Patcher: '%s' on script %d offset %d", curEntry->description, scriptNr, foundOffset);
+					uint32 patchEnd = applyPatch(curEntry, scriptData, foundOffset);
+
+					// The patch may have added or removed magic DWORDs of this entry
+					// and the following ones, so search the patched area again
+					uint32 searchStart = (foundOffset > 3) ? foundOffset - 3 : 0;
+					uint32 searchEnd = MIN(patchEnd, searchLimit);
+					for (uint laterEntryNr = entryNr; laterEntryNr < entryCount; laterEntryNr++)
+						findMagicDWords(_runtimeTable + scriptIndex.entries[laterEntryNr], scriptData, searchStart, searchEnd, dWordOffsets[laterEntryNr]);
+				}
+				applyCount--;
+			} while ((foundOffset != -1) && (applyCount));
 		}
 	}
 }
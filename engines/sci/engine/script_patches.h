@@ -22,6 +22,9 @@
 #ifndef SCI_ENGINE_SCRIPT_PATCHES_H
 #define SCI_ENGINE_SCRIPT_PATCHES_H
 
+#include "common/array.h"
+#include "common/hashmap.h"
+
 #include "sci/sci.h"
 
 namespace Sci {
@@ -83,6 +86,29 @@ struct SciScriptPatcherRuntimeEntry {
 	int magicOffset;
 };
 
+/**
+ * The entries of a signature table which belong to one script. All their
+ * magic DWords are searched for in a single pass over the script data,
+ * instead of one pass per entry.
+ */
+struct SciScriptPatcherScriptIndex {
+	enum {
+		kFilterBits = 1024
+	};
+
+	Common::Array<uint> entries; ///< Indices into the signature table, in table order
+
+	/**
+	 * Bloom filter of the magic DWords of the entries, so that most
+	 * offsets are rejected without comparing them to every magic DWord.
+	 */
+	uint32 filter[kFilterBits / 32];
+
+	SciScriptPatcherScriptIndex() { memset(filter, 0, sizeof(filter)); }
+
+	static uint filterBit(uint32 dWord) { return (dWord * 2654435761U) >> 22; }
+};
+
 /**
  * ScriptPatcher class, handles on-the-fly patching of script data
  */
@@ -116,11 +142,20 @@ private:
 	// returns -1 in case it was not found or an offset to the matching data
 	int32 findSignature(const SciScriptPatcherEntry *patchEntry, const SciScriptPatcherRuntimeEntry *runtimeEntry, const SciSpan<const byte> &scriptData);
 
+	// Adds the offsets in [startOffset, endOffset) at which the magic DWord of the given entry occurs
+	// to the sorted offset list, replacing the ones previously found in that range
+	void findMagicDWords(const SciScriptPatcherRuntimeEntry *runtimeEntry, const SciSpan<const byte> &scriptData, uint32 startOffset, uint32 endOffset, Common::Array<uint32> &dWordOffsets);
+
 	// Applies a patch to a given script + offset (overwrites parts)
-	void applyPatch(const SciScriptPatcherEntry *patchEntry, SciSpan<byte> scriptData, int32 signatureOffset);
+	// returns the offset behind the last patched byte
+	uint32 applyPatch(const SciScriptPatcherEntry *patchEntry, SciSpan<byte> scriptData, int32 signatureOffset);
 
 	Selector *_selectorIdTable;
 	SciScriptPatcherRuntimeEntry *_runtimeTable;
+
+	// Signature table entries per script number, set up by initSignature()
+	typedef Common::HashMap<uint16, SciScriptPatcherScriptIndex> ScriptIndexMap;
+	ScriptIndexMap _scriptIndex;
 	bool _isMacSci11;
 };
 
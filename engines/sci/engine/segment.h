@@ -125,11 +125,9 @@ public:
 	/**
 	 * Iterates over and reports all addresses within the segment.
 	 * Used by the garbage collector.
-	 * @return a list of addresses within the segment
+	 * @param list	array to which the addresses within the segment are appended
 	 */
-	virtual Common::Array<reg_t> listAllDeallocatable(SegmentId segId) const {
-		return Common::Array<reg_t>();
-	}
+	virtual void listAllDeallocatable(SegmentId segId, Common::Array<reg_t> &list) const {}
 
 	/**
 	 * Iterates over all references reachable from the specified object.
@@ -297,12 +295,10 @@ public:
 		entries_used--;
 	}
 
-	Common::Array<reg_t> listAllDeallocatable(SegmentId segId) const override {
-		Common::Array<reg_t> tmp;
+	void listAllDeallocatable(SegmentId segId, Common::Array<reg_t> &list) const override {
 		for (uint i = 0; i < _table.size(); i++)
 			if (isValidEntry(i))
-				tmp.push_back(make_reg(segId, i));
-		return tmp;
+				list.push_back(make_reg(segId, i));
 	}
 
 	uint size() const { return _table.size(); }
@@ -400,9 +396,8 @@ public:
 	reg_t findCanonicAddress(SegManager *segMan, reg_t addr) const override {
 		return make_reg(addr.getSegment(), 0);
 	}
-	Common::Array<reg_t> listAllDeallocatable(SegmentId segId) const override {
-		const reg_t r = make_reg(segId, 0);
-		return Common::Array<reg_t>(&r, 1);
+	void listAllDeallocatable(SegmentId segId, Common::Array<reg_t> &list) const override {
+		list.push_back(make_reg(segId, 0));
 	}
 
 	void saveLoadWithSerializer(Common::Serializer &ser) override;
@@ -97,6 +97,29 @@ struct SciCallOrigin {
 	}
 };
 
+/**
+ * Statistics about the garbage collector, shown by the gc_stats console
+ * command. Times are in microseconds.
+ */
+struct GCStatistics {
+	uint32 runs; /**< Number of collections */
+	uint64 lastMarkTime; /**< Time spent finding the reachable addresses in the last collection */
+	uint64 lastSweepTime; /**< Time spent freeing unreachable objects in the last collection */
+	uint64 maxPauseTime; /**< Longest collection */
+	uint64 totalPauseTime; /**< Time spent in all collections */
+	uint32 lastReachable; /**< Number of reachable addresses found by the last collection */
+	uint32 lastFreed; /**< Number of objects freed by the last collection */
+	uint32 totalFreed; /**< Number of objects freed by all collections */
+
+	GCStatistics() { reset(); }
+
+	void reset() {
+		runs = 0;
+		lastMarkTime = lastSweepTime = maxPauseTime = totalPauseTime = 0;
+		lastReachable = lastFreed = totalFreed = 0;
+	}
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -194,6 +217,7 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	GCStatistics gcStatistics; /**< Pause times of the garbage collector, see run_gc() */
 
 	MessageState *_msgState;
 
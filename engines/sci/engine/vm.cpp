@@ -568,6 +568,15 @@ uint32 findOffset(const int16 relOffset, const Script *scr, const uint32 pcOffse
 	return offset;
 }
 
+static void verifyDecodedInstruction(const Script *scr, uint32 offset, uint size, byte extOpcode, const int16 opparams[4]) {
+	byte expectedExtOpcode;
+	int16 expectedOpparams[4];
+	const uint expectedSize = readPMachineInstruction(scr->getBuf(offset), expectedExtOpcode, expectedOpparams);
+
+	if (size != expectedSize || extOpcode != expectedExtOpcode || memcmp(opparams, expectedOpparams, sizeof(expectedOpparams)))
+		error("run_vm(): cached instruction at %d in script %d differs from the script data", offset, scr->getScriptNumber());
+}
+
 void run_vm(EngineState *s) {
 	assert(s);
 
@@ -635,7 +644,8 @@ void run_vm(EngineState *s) {
 		if (s->abortScriptProcessing != kAbortNone)
 			return; // Stop processing
 
-		g_sci->checkAddressBreakpoint(s->xs->addr.pc);
+		if (g_sci->_debugState._activeBreakpointTypes & BREAK_ADDRESS)
+			g_sci->checkAddressBreakpoint(s->xs->addr.pc);
 
 		// Debug if this has been requested:
 		// TODO: re-implement sci_debug_flags
@@ -658,7 +668,15 @@ void run_vm(EngineState *s) {
 
 		// Get opcode
 		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		uint instructionSize;
+		if (g_sci->_debugState.instructionCache == kInstructionCacheOff) {
+			instructionSize = readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams);
+		} else {
+			instructionSize = scr->decodeInstruction(s->xs->addr.pc.getOffset(), extOpcode, opparams);
+			if (g_sci->_debugState.instructionCache == kInstructionCacheVerify)
+				verifyDecodedInstruction(scr, s->xs->addr.pc.getOffset(), instructionSize, extOpcode, opparams);
+		}
+		s->xs->addr.pc.incOffset(instructionSize);
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
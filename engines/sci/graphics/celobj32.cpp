@@ -34,6 +34,12 @@
 #include "common/config-manager.h"
 #include "common/gui_options.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 namespace Sci {
 #pragma mark CelScaler
 
@@ -328,7 +334,7 @@ public:
 	_sourceHeight(celObj._height),
 #endif
 	_sourceWidth(celObj._width) {
-		const SciSpan<const byte> resource = celObj.getResPointer();
+		const SciSpan<const byte> resource = celObj.getDrawResPointer();
 		const uint32 pixelsOffset = resource.getUint32SEAt(celObj._celHeaderOffset + 24);
 		const int32 numPixels = MIN<int32>(resource.size() - pixelsOffset, celObj._width * celObj._height);
 
@@ -362,7 +368,7 @@ private:
 
 public:
 	READER_Compressed(const CelObj &celObj, const int16 maxWidth) :
-	_resource(celObj.getResPointer()),
+	_resource(celObj.getDrawResPointer()),
 	_y(-1),
 	_sourceHeight(celObj._height),
 	_skipColor(celObj._skipColor),
@@ -513,10 +519,15 @@ struct MAPPER_NoMap {
 };
 
 void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const {
+	_drawBlackLines = screenItem._drawBlackLines;
+	drawConcurrently(target, screenItem, targetRect);
+	_drawBlackLines = false;
+}
+
+void CelObj::drawConcurrently(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const {
 	const Common::Point &scaledPosition = screenItem._scaledPosition;
 	const Ratio &scaleX = screenItem._ratioX;
 	const Ratio &scaleY = screenItem._ratioY;
-	_drawBlackLines = screenItem._drawBlackLines;
 
 	if (_remap) {
 		// In SSCI, this check was `g_Remap_numActiveRemaps && _remap`, but
@@ -599,7 +610,24 @@ void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Re
 		}
 	}
 
-	_drawBlackLines = false;
+}
+
+bool CelObj::canDrawConcurrently(const ScreenItem &screenItem) const {
+	return screenItem._ratioX.isOne() && screenItem._ratioY.isOne() && !screenItem._drawBlackLines;
+}
+
+void CelObj::prepareConcurrentDraw(const bool mirrorX) {
+	_drawMirrored = mirrorX;
+	if (_info.type != kCelTypeColor) {
+		// The span is rebuilt without a name, so that copying it in the
+		// drawing threads does not touch the reference count of a string
+		const SciSpan<const byte> resource = getResPointer();
+		_boundResource = SciSpan<const byte>(resource.getUnsafeDataAt(0, resource.size()), resource.size());
+	}
+}
+
+void CelObj::finishConcurrentDraw() {
+	_boundResource.clear();
 }
 
 void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect, bool mirrorX) {
@@ -730,6 +758,76 @@ void CelObj::putCopyInCache(const int cacheIndex) const {
 #pragma mark -
 #pragma mark CelObj - Drawing
 
+template<typename MAPPER, typename SCALER>
+inline void drawRowPixels(MAPPER &mapper, SCALER &scaler, byte *target, const int16 width, const uint8 skipColor, const bool isMacSource) {
+	for (int16 x = 0; x < width; ++x) {
+		mapper.draw(target++, scaler.read(), skipColor, isMacSource);
+	}
+}
+
+/**
+ * Copies a row of pixels, except for those with the skip color, 16 at a time
+ * where SIMD instructions are available.
+ */
+static inline void copyRowSkip(byte *target, const byte *source, const int16 width, const uint8 skipColor) {
+	int16 x = 0;
+#if defined(__SSE2__)
+	const __m128i skip = _mm_set1_epi8((char)skipColor);
+	for (; x + 16 <= width; x += 16) {
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)(source + x));
+		const __m128i background = _mm_loadu_si128((const __m128i *)(target + x));
+		const __m128i mask = _mm_cmpeq_epi8(pixels, skip);
+		_mm_storeu_si128((__m128i *)(target + x), _mm_or_si128(_mm_and_si128(mask, background), _mm_andnot_si128(mask, pixels)));
+	}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	const uint8x16_t skip = vdupq_n_u8(skipColor);
+	for (; x + 16 <= width; x += 16) {
+		const uint8x16_t pixels = vld1q_u8(source + x);
+		const uint8x16_t mask = vceqq_u8(pixels, skip);
+		vst1q_u8(target + x, vbslq_u8(mask, vld1q_u8(target + x), pixels));
+	}
+#endif
+	for (; x < width; ++x) {
+		if (source[x] != skipColor) {
+			target[x] = source[x];
+		}
+	}
+}
+
+/**
+ * Draws one row of a cel. Rows of unscaled, unmirrored cels without remap
+ * pixels are contiguous in the source, so unless their colors need to be
+ * translated they are copied as a whole instead of pixel by pixel.
+ */
+template<typename MAPPER, typename SCALER>
+struct ROW_DRAWER {
+	static inline void draw(MAPPER &mapper, SCALER &scaler, byte *target, const int16 width, const uint8 skipColor, const bool isMacSource) {
+		drawRowPixels(mapper, scaler, target, width, skipColor, isMacSource);
+	}
+};
+
+template<typename READER>
+struct ROW_DRAWER<MAPPER_NoMD, SCALER_NoScale<false, READER> > {
+	static inline void draw(MAPPER_NoMD &mapper, SCALER_NoScale<false, READER> &scaler, byte *target, const int16 width, const uint8 skipColor, const bool isMacSource) {
+		if (isMacSource) {
+			drawRowPixels(mapper, scaler, target, width, skipColor, isMacSource);
+		} else {
+			copyRowSkip(target, scaler._row, width, skipColor);
+		}
+	}
+};
+
+template<typename READER>
+struct ROW_DRAWER<MAPPER_NoMDNoSkip, SCALER_NoScale<false, READER> > {
+	static inline void draw(MAPPER_NoMDNoSkip &mapper, SCALER_NoScale<false, READER> &scaler, byte *target, const int16 width, const uint8 skipColor, const bool isMacSource) {
+		if (isMacSource) {
+			drawRowPixels(mapper, scaler, target, width, skipColor, isMacSource);
+		} else {
+			memcpy(target, scaler._row, width);
+		}
+	}
+};
+
 template<typename MAPPER, typename SCALER, bool DRAW_BLACK_LINES>
 struct RENDERER {
 	MAPPER &_mapper;
@@ -757,12 +855,8 @@ struct RENDERER {
 			}
 
 			_scaler.setTarget(targetRect.left, targetRect.top + y);
-
-			for (int16 x = 0; x < targetWidth; ++x) {
-				_mapper.draw(targetPixel++, _scaler.read(), _skipColor, _isMacSource);
-			}
-
-			targetPixel += skipStride;
+			ROW_DRAWER<MAPPER, SCALER>::draw(_mapper, _scaler, targetPixel, targetWidth, _skipColor, _isMacSource);
+			targetPixel += targetWidth + skipStride;
 		}
 	}
 };
@@ -1362,6 +1456,9 @@ void CelObjColor::draw(Buffer &target, const Common::Rect &targetRect, const Com
 void CelObjColor::draw(Buffer &target, const Common::Rect &targetRect) const {
 	target.fillRect(targetRect, translateMacColor(_isMacSource, _info.color));
 }
+void CelObjColor::drawConcurrently(Buffer &target, const ScreenItem &, const Common::Rect &targetRect) const {
+	draw(target, targetRect);
+}
 
 CelObjColor *CelObjColor::duplicate() const {
 	return new CelObjColor(*this);
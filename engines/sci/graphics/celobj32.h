@@ -262,6 +262,14 @@ protected:
 	 */
 	bool _drawMirrored;
 
+	/**
+	 * The resource data of this cel while it is prepared for concurrent
+	 * drawing, or an empty span otherwise.
+	 *
+	 * @see prepareConcurrentDraw
+	 */
+	SciSpan<const byte> _boundResource;
+
 public:
 	static CelScaler *_scaler;
 
@@ -389,6 +397,34 @@ public:
 	 */
 	void drawTo(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio &scaleX, const Ratio &scaleY) const;
 
+	/**
+	 * Returns true if the cel can be drawn for the given screen item by
+	 * several threads at once with drawConcurrently. This is not the case for
+	 * scaled cels and cels drawn with black lines, since their scalers share
+	 * static lookup tables.
+	 */
+	bool canDrawConcurrently(const ScreenItem &screenItem) const;
+
+	/**
+	 * Prepares the cel for drawConcurrently by setting the mirror flag and
+	 * looking up the resource data in advance, since neither the resource
+	 * manager nor the segment manager may be used from other threads.
+	 * finishConcurrentDraw must be called once drawing is complete.
+	 */
+	void prepareConcurrentDraw(const bool mirrorX);
+
+	/**
+	 * Releases the resource data looked up by prepareConcurrentDraw.
+	 */
+	void finishConcurrentDraw();
+
+	/**
+	 * Draws the part of the cel inside `targetRect` like draw, without
+	 * changing any state shared with other cels. Different threads may draw
+	 * non-overlapping parts of the target buffer at the same time.
+	 */
+	virtual void drawConcurrently(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const;
+
 	/**
 	 * Creates a copy of this cel on the free store and returns a pointer to the
 	 * new object. The new cel will point to a shared copy of bitmap/resource
@@ -402,6 +438,14 @@ public:
 	 */
 	virtual const SciSpan<const byte> getResPointer() const = 0;
 
+	/**
+	 * Retrieves the resource data for drawing the cel, which comes from
+	 * prepareConcurrentDraw if the cel is being drawn concurrently.
+	 */
+	const SciSpan<const byte> getDrawResPointer() const {
+		return _boundResource.data() ? _boundResource : getResPointer();
+	}
+
 	/**
 	 * Reads the pixel at the given coordinates. This method is valid only for
 	 * CelObjView and CelObjPic.
@@ -599,6 +643,7 @@ public:
 	void draw(Buffer &target, const Common::Rect &targetRect) const;
 	void draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect, const bool mirrorX) override;
 	void draw(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const bool mirrorX) override;
+	void drawConcurrently(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const override;
 
 	CelObjColor *duplicate() const override;
 	const SciSpan<const byte> getResPointer() const override;
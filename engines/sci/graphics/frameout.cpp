@@ -27,6 +27,7 @@
 #include "common/str.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/worker-pool.h"
 #include "engines/engine.h"
 #include "engines/util.h"
 #include "graphics/palette.h"
@@ -491,6 +492,8 @@ void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseR
 		remapMarkRedraw();
 	}
 
+	const uint64 calcListsStart = g_system->getMicros();
+
 	calcLists(screenItemLists, eraseLists, eraseRect);
 
 	for (ScreenItemListList::iterator list = screenItemLists.begin(); list != screenItemLists.end(); ++list) {
@@ -505,9 +508,22 @@ void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseR
 
 	_remapOccurred = _palette->updateForFrame();
 
+	const uint64 drawStart = g_system->getMicros();
+
+	uint32 drawCount = 0;
 	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
-		drawEraseList(eraseLists[i], *_planes[i]);
-		drawScreenItemList(screenItemLists[i]);
+		drawCount += screenItemLists[i].size();
+		if (_planes[i]->_type == kPlaneTypeColored) {
+			drawCount += eraseLists[i].size();
+		}
+	}
+
+	const bool drewConcurrently = drawListsConcurrently(screenItemLists, eraseLists);
+	if (!drewConcurrently) {
+		for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+			drawEraseList(eraseLists[i], *_planes[i]);
+			drawScreenItemList(screenItemLists[i]);
+		}
 	}
 
 	if (robotIsActive) {
@@ -516,10 +532,26 @@ void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseR
 
 	_palette->updateHardware();
 
+	const uint64 showBitsStart = g_system->getMicros();
+
 	if (shouldShowBits) {
 		showBits();
 	}
 
+	const uint64 frameEnd = g_system->getMicros();
+	++_statistics.frames;
+	if (drewConcurrently) {
+		++_statistics.concurrentFrames;
+	}
+	_statistics.lastCalcListsTime = (uint32)(drawStart - calcListsStart);
+	_statistics.lastDrawTime = (uint32)(showBitsStart - drawStart);
+	_statistics.lastShowBitsTime = (uint32)(frameEnd - showBitsStart);
+	_statistics.lastDrawCount = drawCount;
+	_statistics.maxFrameTime = MAX(_statistics.maxFrameTime, (uint32)(frameEnd - calcListsStart));
+	_statistics.totalCalcListsTime += _statistics.lastCalcListsTime;
+	_statistics.totalDrawTime += _statistics.lastDrawTime;
+	_statistics.totalShowBitsTime += _statistics.lastShowBitsTime;
+
 	if (robotIsActive) {
 		robotPlayer.frameNowVisible();
 	}
@@ -1009,6 +1041,103 @@ void GfxFrameout::drawScreenItemList(const DrawList &screenItemList) {
 	}
 }
 
+namespace {
+/**
+ * The minimum number of pixels a frame must draw, and the minimum height of
+ * the bands, for drawListsConcurrently to split the drawing between threads.
+ */
+enum {
+	kMinConcurrentDrawArea = 64 * 64,
+	kMinConcurrentBandHeight = 16
+};
+} // End of anonymous namespace
+
+struct GfxFrameout::ConcurrentDrawState {
+	Buffer *target;
+	const ConcurrentDrawOpList *ops;
+	int16 bandHeight;
+};
+
+bool GfxFrameout::drawListsConcurrently(const ScreenItemListList &screenItemLists, const EraseListList &eraseLists) {
+	const uint threadCount = Common::WorkerPool::instance().getThreadCount();
+	if (threadCount < 2 || _currentBuffer.h < 2 * kMinConcurrentBandHeight) {
+		return false;
+	}
+
+	_concurrentDrawOps.clear();
+	int area = 0;
+	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+		if (_planes[i]->_type == kPlaneTypeColored) {
+			const RectList &eraseList = eraseLists[i];
+			for (RectList::size_type j = 0; j < eraseList.size(); ++j) {
+				const ConcurrentDrawOp op = { *eraseList[j], nullptr, _planes[i]->_back };
+				_concurrentDrawOps.push_back(op);
+				area += op.rect.width() * op.rect.height();
+			}
+		}
+
+		const DrawList &screenItemList = screenItemLists[i];
+		for (DrawList::size_type j = 0; j < screenItemList.size(); ++j) {
+			const DrawItem &drawItem = *screenItemList[j];
+			if (!drawItem.screenItem->_celObj->canDrawConcurrently(*drawItem.screenItem)) {
+				return false;
+			}
+			const ConcurrentDrawOp op = { drawItem.rect, drawItem.screenItem, 0 };
+			_concurrentDrawOps.push_back(op);
+			area += op.rect.width() * op.rect.height();
+		}
+	}
+
+	if (area < kMinConcurrentDrawArea) {
+		return false;
+	}
+
+	for (ConcurrentDrawOpList::const_iterator op = _concurrentDrawOps.begin(); op != _concurrentDrawOps.end(); ++op) {
+		mergeToShowList(op->rect, _showList, _overdrawThreshold);
+		if (op->screenItem) {
+			CelObj &celObj = *op->screenItem->_celObj;
+			celObj.prepareConcurrentDraw(op->screenItem->_mirrorX ^ celObj._mirrorX);
+		}
+	}
+
+	const uint bandCount = MIN<uint>(threadCount * 2, _currentBuffer.h / kMinConcurrentBandHeight);
+	ConcurrentDrawState state;
+	state.target = &_currentBuffer;
+	state.ops = &_concurrentDrawOps;
+	state.bandHeight = (_currentBuffer.h + bandCount - 1) / bandCount;
+	Common::WorkerPool::instance().run(bandCount, drawConcurrentBand, &state);
+
+	for (ConcurrentDrawOpList::const_iterator op = _concurrentDrawOps.begin(); op != _concurrentDrawOps.end(); ++op) {
+		if (op->screenItem) {
+			op->screenItem->_celObj->finishConcurrentDraw();
+		}
+	}
+
+	return true;
+}
+
+void GfxFrameout::drawConcurrentBand(uint index, void *param) {
+	const ConcurrentDrawState &state = *static_cast<const ConcurrentDrawState *>(param);
+	const int16 top = index * state.bandHeight;
+	if (top >= state.target->h) {
+		return;
+	}
+	const Common::Rect band(0, top, state.target->w, MIN<int16>(top + state.bandHeight, state.target->h));
+
+	for (ConcurrentDrawOpList::const_iterator op = state.ops->begin(); op != state.ops->end(); ++op) {
+		const Common::Rect rect = op->rect.findIntersectingRect(band);
+		if (rect.isEmpty()) {
+			continue;
+		}
+
+		if (op->screenItem) {
+			op->screenItem->_celObj->drawConcurrently(*state.target, *op->screenItem, rect);
+		} else {
+			state.target->fillRect(rect, op->color);
+		}
+	}
+}
+
 void GfxFrameout::mergeToShowList(const Common::Rect &drawRect, RectList &showList, const int overdrawThreshold) {
 	RectList mergeList;
 	Common::Rect merged;
@@ -35,6 +35,30 @@ class GfxCursor32;
 class GfxTransitions32;
 struct PlaneShowStyle;
 
+/**
+ * Timings of the rendering stages of frameOut, in microseconds.
+ */
+struct FrameOutStatistics {
+	uint32 frames; //< Number of frames rendered
+	uint32 concurrentFrames; //< Number of frames drawn by several threads
+	uint32 lastCalcListsTime; //< Time spent calculating the draw and erase lists of the last frame
+	uint32 lastDrawTime; //< Time spent drawing the last frame into the screen buffer
+	uint32 lastShowBitsTime; //< Time spent sending the last frame to the backend
+	uint32 lastDrawCount; //< Number of cels and erase rects drawn in the last frame
+	uint32 maxFrameTime; //< Longest frame
+	uint64 totalCalcListsTime;
+	uint64 totalDrawTime;
+	uint64 totalShowBitsTime;
+
+	FrameOutStatistics() { reset(); }
+
+	void reset() {
+		frames = concurrentFrames = 0;
+		lastCalcListsTime = lastDrawTime = lastShowBitsTime = lastDrawCount = maxFrameTime = 0;
+		totalCalcListsTime = totalDrawTime = totalShowBitsTime = 0;
+	}
+};
+
 /**
  * Frameout class, kFrameOut and relevant functions for SCI32 games.
  * Roughly equivalent to GraphicsMgr in SSCI.
@@ -232,6 +256,12 @@ public:
 
 	void kernelFrameOut(const bool showBits);
 
+	/**
+	 * Timings of the frames rendered by frameOut, shown by the frameout_stats
+	 * console command.
+	 */
+	FrameOutStatistics _statistics;
+
 	/**
 	 * Throttles the engine as necessary to maintain 60fps output.
 	 */
@@ -368,6 +398,38 @@ private:
 	 */
 	void drawScreenItemList(const DrawList &screenItemList);
 
+	/**
+	 * A fill of an erase rect or a cel drawn by drawListsConcurrently.
+	 */
+	struct ConcurrentDrawOp {
+		Common::Rect rect;
+		const ScreenItem *screenItem; //< nullptr for an erase rect
+		uint8 color; //< The fill color of an erase rect
+	};
+
+	typedef Common::Array<ConcurrentDrawOp> ConcurrentDrawOpList;
+
+	/**
+	 * The erase rects and cels of the frame being drawn by
+	 * drawListsConcurrently. Kept between frames to reuse its storage.
+	 */
+	ConcurrentDrawOpList _concurrentDrawOps;
+
+	/**
+	 * Draws the erase and draw lists of all planes, like drawEraseList and
+	 * drawScreenItemList do, with the screen split into horizontal bands
+	 * which are drawn by different threads. Every band replays all drawing
+	 * in order, clipped to the band, so the result is identical to drawing
+	 * serially.
+	 *
+	 * Returns false without drawing anything if the frame cannot be drawn
+	 * concurrently or is too small to be worth it.
+	 */
+	bool drawListsConcurrently(const ScreenItemListList &screenItemLists, const EraseListList &eraseLists);
+
+	struct ConcurrentDrawState;
+	static void drawConcurrentBand(uint index, void *param);
+
 	/**
 	 * Adds a new rectangle to the list of regions to write out to the hardware.
 	 * The provided rect may be merged into an existing rectangle to reduce the
@@ -28,6 +28,7 @@
 #include "scumm/actor.h"
 #include "scumm/boxes.h"
 #include "scumm/debugger.h"
+#include "scumm/he/intern_he.h"
 #include "scumm/imuse/imuse.h"
 #include "scumm/imuse_digi/dimuse_engine.h"
 #include "scumm/object.h"
@@ -37,6 +38,8 @@
 
 namespace Scumm {
 
+extern const char *nameOfResType(ResType type);
+
 void debugC(int channel, const char *s, ...) {
 	char buf[STRINGBUFLEN];
 	va_list va;
@@ -79,6 +82,13 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	registerCmd("scr",       WRAP_METHOD(ScummDebugger, Cmd_Script));
 	registerCmd("scripts",   WRAP_METHOD(ScummDebugger, Cmd_PrintScript));
 	registerCmd("importres", WRAP_METHOD(ScummDebugger, Cmd_ImportRes));
+	registerCmd("resources", WRAP_METHOD(ScummDebugger, Cmd_Resources));
+	registerCmd("strips",    WRAP_METHOD(ScummDebugger, Cmd_Strips));
+	registerCmd("drawbench", WRAP_METHOD(ScummDebugger, Cmd_DrawBench));
+#ifdef ENABLE_HE
+	if (_vm->_game.heversion >= 71)
+		registerCmd("wiz",   WRAP_METHOD(ScummDebugger, Cmd_Wiz));
+#endif
 
 	if (_vm->_game.id == GID_LOOM)
 		registerCmd("drafts",  WRAP_METHOD(ScummDebugger, Cmd_PrintDraft));
@@ -509,6 +519,198 @@ bool ScummDebugger::Cmd_ImportRes(int argc, const char** argv) {
 	return true;
 }
 
+bool ScummDebugger::Cmd_Resources(int argc, const char **argv) {
+	ResourceManager *res = _vm->_res;
+	const ResourceManager::CacheStats &stats = res->_stats;
+
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset"))) {
+		debugPrintf("Syntax: resources [reset]\n");
+		return true;
+	}
+
+	if (argc == 2) {
+		res->_stats = ResourceManager::CacheStats();
+		return true;
+	}
+
+	debugPrintf("+---------------+------+------+----------+\n");
+	debugPrintf("|type           |loaded|locked|     bytes|\n");
+	debugPrintf("+---------------+------+------+----------+\n");
+	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
+		uint loaded = 0, locked = 0;
+		uint32 size = 0;
+
+		for (ResId idx = 0; idx < res->_types[type].size(); idx++) {
+			if (res->_types[type][idx]._address) {
+				loaded++;
+				size += res->_types[type][idx]._size;
+				if (res->_types[type][idx].isLocked())
+					locked++;
+			}
+		}
+
+		if (loaded)
+			debugPrintf("|%-15s|%6d|%6d|%10d|\n", nameOfResType(type), loaded, locked, size);
+	}
+	debugPrintf("+---------------+------+------+----------+\n");
+
+	uint32 accesses = stats.hits + stats.misses;
+	debugPrintf("Heap: %d of %d bytes used, peak %d\n", res->getAllocatedSize(), res->getMaxHeapThreshold(), stats.peakSize);
+	debugPrintf("Lookups: %d hits, %d misses (%d%% hits)\n", stats.hits, stats.misses, accesses ? (int)(100LL * stats.hits / accesses) : 0);
+	debugPrintf("Expired: %d resources, %d bytes\n", stats.expired, stats.expiredSize);
+	debugPrintf("Prefetched: %d resources, %d of them used, %d queued\n", stats.prefetched, stats.prefetchHits, res->getPrefetchQueueSize());
+
+	return true;
+}
+
+bool ScummDebugger::Cmd_Strips(int argc, const char **argv) {
+	Gdi *gdi = _vm->_gdi;
+
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		gdi->_stripStats = Gdi::StripStats();
+		return true;
+	} else if (argc == 3 && !strcmp(argv[1], "cache") && (!strcmp(argv[2], "on") || !strcmp(argv[2], "off"))) {
+		gdi->enableStripCache(!strcmp(argv[2], "on"));
+		return true;
+	} else if (argc == 3 && !strcmp(argv[1], "simd") && (!strcmp(argv[2], "on") || !strcmp(argv[2], "off"))) {
+		Gdi::enableSimd(!strcmp(argv[2], "on"));
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Syntax: strips [reset | cache on|off | simd on|off]\n");
+		return true;
+	}
+
+	const Gdi::StripStats &stats = gdi->_stripStats;
+	const uint32 drawn = stats.decoded + stats.cacheHits;
+	debugPrintf("Strips: %d decoded, %d copied from the cache (%d%%), %d with transparent pixels\n",
+		stats.decoded, stats.cacheHits, drawn ? (int)(100LL * stats.cacheHits / drawn) : 0, stats.transparent);
+	debugPrintf("Cache: %s, %d bytes\n", gdi->isStripCacheEnabled() ? "on" : "off", gdi->getStripCacheSize());
+	debugPrintf("SIMD: %s\n", Gdi::isSimdEnabled() ? "on" : "off");
+
+	return true;
+}
+
+#ifdef ENABLE_HE
+bool ScummDebugger::Cmd_Wiz(int argc, const char **argv) {
+	Wiz *wiz = ((ScummEngine_v71he *)_vm)->_wiz;
+
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		wiz->_drawStats = WizDrawStats();
+		return true;
+	} else if (argc == 3 && !strcmp(argv[1], "cache") && (!strcmp(argv[2], "on") || !strcmp(argv[2], "off"))) {
+		wiz->enableImageCache(!strcmp(argv[2], "on"));
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Syntax: wiz [reset | cache on|off]\n");
+		return true;
+	}
+
+	const WizDrawStats &stats = wiz->_drawStats;
+	const uint32 cached = stats.cacheHits + stats.cacheMisses;
+	debugPrintf("Images: %d drawn, %d in %d batches (%d drawn by several threads)\n",
+		stats.draws, stats.batched, stats.batches, stats.concurrent);
+	debugPrintf("Time: %.2f microseconds per image\n", stats.draws ? (double)stats.drawTime / stats.draws : 0.0);
+	debugPrintf("Cache: %s, %d bytes, %d hits (%d%%), %d decoded, %d of them for another palette\n",
+		wiz->isImageCacheEnabled() ? "on" : "off", wiz->getImageCacheSize(), stats.cacheHits,
+		cached ? (int)(100LL * stats.cacheHits / cached) : 0, stats.cacheMisses, stats.paletteMisses);
+
+	return true;
+}
+#endif
+
+bool ScummDebugger::Cmd_DrawBench(int argc, const char **argv) {
+	const int kPasses = 10;
+
+	if (argc > 2) {
+		debugPrintf("Syntax: drawbench [room]\n");
+		return true;
+	}
+
+	// The older games decode their rooms up front in Gdi::roomChanged(),
+	// and only for the current room.
+	if (_vm->_game.version < 3 || (_vm->_game.features & GF_OLD_BUNDLE) || _vm->_game.platform == Common::kPlatformPCEngine) {
+		debugPrintf("drawbench is not supported for this game\n");
+		return true;
+	}
+
+	int first = 1, last = _vm->_res->_types[rtRoom].size() - 1;
+	if (argc == 2) {
+		first = last = atoi(argv[1]);
+		if (first < 1 || first >= (int)_vm->_res->_types[rtRoom].size()) {
+			debugPrintf("Room %d is out of range\n", first);
+			return true;
+		}
+	}
+
+	const bool simd = Gdi::isSimdEnabled();
+	uint32 totalStrips = 0, decodeMillis = 0, cachedMillis = 0, portableMillis = 0;
+
+	debugPrintf("Times are per strip, in microseconds\n");
+	debugPrintf("+----+---------+------+-------+-------+--------+\n");
+	debugPrintf("|room|     size|strips| decode| cached|portable|\n");
+	debugPrintf("+----+---------+------+-------+-------+--------+\n");
+	for (int room = first; room <= last; room++) {
+		const ResourceManager::Resource &res = _vm->_res->_types[rtRoom][room];
+		if (!res._roomno || res._roomoffs == RES_INVALID_OFFSET)
+			continue;
+
+		byte *roomptr = _vm->getResourceAddress(rtRoom, room);
+		if (!roomptr)
+			continue;
+
+		int width, height, numObjects;
+		_vm->readRoomHeader(roomptr, width, height, numObjects);
+		const uint32 offset = _vm->findRoomImage(roomptr, room);
+		const byte *image = _vm->getResourceAddress(_vm->_game.heversion >= 70 ? rtRoomImage : rtRoom, room) + offset;
+		const int numStrips = width / 8;
+		if (numStrips <= 0 || height <= 0)
+			continue;
+
+		Gdi::enableSimd(true);
+		const uint32 decode = _vm->_gdi->benchmarkStrips(image, numStrips, height, kPasses, false);
+		const uint32 cached = _vm->_gdi->benchmarkStrips(image, numStrips, height, kPasses, true);
+		Gdi::enableSimd(false);
+		const uint32 portable = _vm->_gdi->benchmarkStrips(image, numStrips, height, kPasses, true);
+
+		const double scale = 1000.0 / (kPasses * numStrips);
+		debugPrintf("|%4d|%4dx%-4d|%6d|%7.2f|%7.2f|%8.2f|\n", room, width, height, numStrips,
+			decode * scale, cached * scale, portable * scale);
+
+		totalStrips += numStrips;
+		decodeMillis += decode;
+		cachedMillis += cached;
+		portableMillis += portable;
+	}
+	debugPrintf("+----+---------+------+-------+-------+--------+\n");
+
+	if (totalStrips) {
+		const double scale = 1000.0 / (kPasses * totalStrips);
+		debugPrintf("All rooms: %d strips, decode %.2f, cached %.2f (portable %.2f) microseconds per strip\n",
+			totalStrips, decodeMillis * scale, cachedMillis * scale, portableMillis * scale);
+	}
+
+	// Compositing the text and copying to the screen, for the current room
+	VirtScreen *vs = &_vm->_virtscr[kMainVirtScreen];
+	if (_vm->_currentRoom && vs->w >= 8) {
+		const int kFrames = 50;
+		uint32 millis[2];
+
+		for (int i = 0; i < 2; i++) {
+			Gdi::enableSimd(i == 1);
+			const uint32 start = g_system->getMillis();
+			for (int frame = 0; frame < kFrames; frame++)
+				_vm->drawStripToScreen(vs, 0, vs->w, 0, vs->h);
+			millis[i] = g_system->getMillis() - start;
+		}
+
+		const double scale = 1000.0 / (kFrames * (vs->w / 8));
+		debugPrintf("Screen update: portable %.2f, SIMD %.2f microseconds per strip\n", millis[0] * scale, millis[1] * scale);
+	}
+
+	Gdi::enableSimd(simd);
+	return true;
+}
+
 bool ScummDebugger::Cmd_PrintScript(int argc, const char **argv) {
 	int i;
 	ScriptSlot *ss = _vm->vm.slot;
@@ -56,6 +56,12 @@ private:
 	bool Cmd_Script(int argc, const char **argv);
 	bool Cmd_PrintScript(int argc, const char **argv);
 	bool Cmd_ImportRes(int argc, const char **argv);
+	bool Cmd_Resources(int argc, const char **argv);
+	bool Cmd_Strips(int argc, const char **argv);
+	bool Cmd_DrawBench(int argc, const char **argv);
+#ifdef ENABLE_HE
+	bool Cmd_Wiz(int argc, const char **argv);
+#endif
 
 	bool Cmd_PrintDraft(int argc, const char **argv);
 	bool Cmd_Passcode(int argc, const char **argv);
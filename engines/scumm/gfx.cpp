@@ -45,6 +45,17 @@ extern "C" void asmDrawStripToScreen(int height, int width, void const* text, vo
 extern "C" void asmCopy8Col(byte* dst, int dstPitch, const byte* src, int height, uint8 bitDepth);
 #endif /* USE_ARM_GFX_ASM */
 
+// The strip copies work on a row of eight pixels at a time, the text
+// compositing on sixteen. Both only move and compare whole bytes, so they
+// do not depend on the byte order.
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SCUMM_GFX_SIMD
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SCUMM_GFX_SIMD
+#endif
+
 namespace Scumm {
 
 static void blit(byte *dst, int dstPitch, const byte *src, int srcPitch, int w, int h, uint8 bitDepth);
@@ -52,7 +63,11 @@ static void fill(byte *dst, int dstPitch, uint16 color, int w, int h, uint8 bitD
 #ifndef USE_ARM_GFX_ASM
 static void copy8Col(byte *dst, int dstPitch, const byte *src, int height, uint8 bitDepth);
 #endif
+static void copy8ColFrom(byte *dst, int dstPitch, const byte *src, int srcPitch, int height, uint8 bitDepth);
 static void clear8Col(byte *dst, int dstPitch, int height, uint8 bitDepth);
+#ifndef USE_ARM_GFX_ASM
+static void composeText(byte *dst, const byte *src, int srcSkip, const byte *text, int textSkip, int width, int height);
+#endif
 
 static void ditherHerc(byte *src, byte *hercbuf, int srcPitch, int *x, int *y, int *width, int *height);
 
@@ -214,6 +229,8 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_zbufferDisabled = false;
 	_objectMode = false;
 	_distaff = false;
+	_stripCacheEnabled = true;
+	_stripCacheColorsChecked = false;
 }
 
 Gdi::~Gdi() {
@@ -680,6 +697,17 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 
 			for (int h = 0; h < height * m; ++h) {
 				for (int w = 0; w < width * m; ++w) {
+					// Most of the screen has no text on it, so copy runs of
+					// four pixels without any at once.
+					if (vs->format.bytesPerPixel == 2 && !(w & 3) && READ_UINT32(textPtr) == CHARSET_MASK_TRANSPARENCY_32) {
+						memcpy(dstPtr, srcPtr, 8);
+						textPtr += 4;
+						srcPtr += 8;
+						dstPtr += 8;
+						w += 3;
+						continue;
+					}
+
 					uint16 tmp = *textPtr++;
 					if (tmp == CHARSET_MASK_TRANSPARENCY) {
 						tmp = READ_UINT16(srcPtr);
@@ -698,36 +726,8 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 #ifdef USE_ARM_GFX_ASM
 			asmDrawStripToScreen(height, width, text, src, _compositeBuf, vs->pitch, width, _textSurface.pitch);
 #else
-			// We blit four pixels at a time, for improved performance.
-			const uint32 *src32 = (const uint32 *)src;
-			uint32 *dst32 = (uint32 *)_compositeBuf;
-
-			vsPitch >>= 2;
-
-			const uint32 *text32 = (const uint32 *)text;
-			const int textPitch = (_textSurface.pitch - width * m) >> 2;
-			for (int h = height * m; h > 0; --h) {
-				for (int w = width * m; w > 0; w -= 4) {
-					uint32 temp = *text32++;
-
-					// Generate a byte mask for those text pixels (bytes) with
-					// value CHARSET_MASK_TRANSPARENCY. In the end, each byte
-					// in mask will be either equal to 0x00 or 0xFF.
-					// Doing it this way avoids branches and bytewise operations,
-					// at the cost of readability ;).
-					uint32 mask = temp ^ CHARSET_MASK_TRANSPARENCY_32;
-					mask = (((mask & 0x7f7f7f7f) + 0x7f7f7f7f) | mask) & 0x80808080;
-					mask = ((mask >> 7) + 0x7f7f7f7f) ^ 0x80808080;
-
-					// The following line is equivalent to this code:
-					//   *dst32++ = (*src32++ & mask) | (temp & ~mask);
-					// However, some compilers can generate somewhat better
-					// machine code for this equivalent statement:
-					*dst32++ = ((temp ^ *src32++) & mask) ^ temp;
-				}
-				src32 += vsPitch;
-				text32 += textPitch;
-			}
+			composeText(_compositeBuf, (const byte *)src, vs->pitch - width, (const byte *)text,
+				_textSurface.pitch - width * m, width * m, height * m);
 #endif
 		}
 		src = _compositeBuf;
@@ -1227,6 +1227,20 @@ static void fill(byte *dst, int dstPitch, uint16 color, int w, int h, uint8 bitD
 	}
 }
 
+static bool s_simdStrips = true;
+
+void Gdi::enableSimd(bool enable) {
+	s_simdStrips = enable;
+}
+
+bool Gdi::isSimdEnabled() {
+#ifdef SCUMM_GFX_SIMD
+	return s_simdStrips;
+#else
+	return false;
+#endif
+}
+
 #ifdef USE_ARM_GFX_ASM
 
 #define copy8Col(A,B,C,D,E) asmCopy8Col(A,B,C,D,E)
@@ -1234,6 +1248,40 @@ static void fill(byte *dst, int dstPitch, uint16 color, int w, int h, uint8 bitD
 #else
 
 static void copy8Col(byte *dst, int dstPitch, const byte *src, int height, uint8 bitDepth) {
+	copy8ColFrom(dst, dstPitch, src, dstPitch, height, bitDepth);
+}
+
+#endif /* USE_ARM_GFX_ASM */
+
+static void copy8ColFrom(byte *dst, int dstPitch, const byte *src, int srcPitch, int height, uint8 bitDepth) {
+#ifdef SCUMM_GFX_SIMD
+	// One unaligned load and store per row, which also suits the targets
+	// that cannot do unaligned 32 bit accesses.
+	if (s_simdStrips) {
+		if (bitDepth == 2) {
+			do {
+#if defined(__SSE2__)
+				_mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+#else
+				vst1q_u8(dst, vld1q_u8(src));
+#endif
+				dst += dstPitch;
+				src += srcPitch;
+			} while (--height);
+		} else {
+			do {
+#if defined(__SSE2__)
+				_mm_storel_epi64((__m128i *)dst, _mm_loadl_epi64((const __m128i *)src));
+#else
+				vst1_u8(dst, vld1_u8(src));
+#endif
+				dst += dstPitch;
+				src += srcPitch;
+			} while (--height);
+		}
+		return;
+	}
+#endif
 
 	do {
 #if defined(SCUMM_NEED_ALIGNMENT)
@@ -1247,12 +1295,10 @@ static void copy8Col(byte *dst, int dstPitch, const byte *src, int height, uint8
 		}
 #endif
 		dst += dstPitch;
-		src += dstPitch;
+		src += srcPitch;
 	} while (--height);
 }
 
-#endif /* USE_ARM_GFX_ASM */
-
 static void clear8Col(byte *dst, int dstPitch, int height, uint8 bitDepth) {
 	do {
 #if defined(SCUMM_NEED_ALIGNMENT)
@@ -1273,6 +1319,70 @@ static void clear8Col(byte *dst, int dstPitch, int height, uint8 bitDepth) {
 	} while (--height);
 }
 
+#ifndef USE_ARM_GFX_ASM
+/**
+ * Composite the text surface over 8 bit game graphics, into a buffer as wide
+ * as one row. The width is a multiple of four pixels; wherever the text has
+ * CHARSET_MASK_TRANSPARENCY, the game graphics show through.
+ */
+static void composeText(byte *dst, const byte *src, int srcSkip, const byte *text, int textSkip, int width, int height) {
+#if defined(__SSE2__)
+	const __m128i transparent = _mm_set1_epi8((char)CHARSET_MASK_TRANSPARENCY);
+#elif defined(SCUMM_GFX_SIMD)
+	const uint8x16_t transparent = vdupq_n_u8(CHARSET_MASK_TRANSPARENCY);
+#endif
+
+	for (int h = height; h > 0; --h) {
+		int w = width;
+
+#ifdef SCUMM_GFX_SIMD
+		if (s_simdStrips) {
+			for (; w >= 16; w -= 16) {
+#if defined(__SSE2__)
+				const __m128i t = _mm_loadu_si128((const __m128i *)text);
+				const __m128i g = _mm_loadu_si128((const __m128i *)src);
+				const __m128i mask = _mm_cmpeq_epi8(t, transparent);
+				_mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_and_si128(mask, g), _mm_andnot_si128(mask, t)));
+#else
+				const uint8x16_t t = vld1q_u8(text);
+				vst1q_u8(dst, vbslq_u8(vceqq_u8(t, transparent), vld1q_u8(src), t));
+#endif
+				text += 16;
+				src += 16;
+				dst += 16;
+			}
+		}
+#endif
+
+		// We blit four pixels at a time, for improved performance.
+		for (; w > 0; w -= 4) {
+			uint32 temp = *(const uint32 *)text;
+
+			// Generate a byte mask for those text pixels (bytes) with
+			// value CHARSET_MASK_TRANSPARENCY. In the end, each byte
+			// in mask will be either equal to 0x00 or 0xFF.
+			// Doing it this way avoids branches and bytewise operations,
+			// at the cost of readability ;).
+			uint32 mask = temp ^ CHARSET_MASK_TRANSPARENCY_32;
+			mask = (((mask & 0x7f7f7f7f) + 0x7f7f7f7f) | mask) & 0x80808080;
+			mask = ((mask >> 7) + 0x7f7f7f7f) ^ 0x80808080;
+
+			// The following line is equivalent to this code:
+			//   *dst32 = (*src32 & mask) | (temp & ~mask);
+			// However, some compilers can generate somewhat better
+			// machine code for this equivalent statement:
+			*(uint32 *)dst = ((temp ^ *(const uint32 *)src) & mask) ^ temp;
+			text += 4;
+			src += 4;
+			dst += 4;
+		}
+
+		src += srcSkip;
+		text += textSkip;
+	}
+}
+#endif /* USE_ARM_GFX_ASM */
+
 void ScummEngine::drawBox(int x, int y, int x2, int y2, int color) {
 	int width, height;
 	VirtScreen *vs;
@@ -1819,12 +1929,7 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	// Check whether lights are turned on or not
 	const bool lightsOn = _vm->isLightOn();
 
-	if ((_vm->_game.features & GF_SMALL_HEADER) || _vm->_game.version == 8) {
-		smap_ptr = ptr;
-	} else {
-		smap_ptr = _vm->findResource(MKTAG('S','M','A','P'), ptr);
-		assert(smap_ptr);
-	}
+	smap_ptr = findStripMap(ptr);
 
 	numzbuf = getZPlanes(ptr, zplane_list, false);
 
@@ -1842,6 +1947,7 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	_vertStripNextInc = height * vs->pitch - 1 * vs->format.bytesPerPixel;
 
 	_objectMode = (flag & dbObjectMode) == dbObjectMode;
+	_stripCacheColorsChecked = false;
 	prepareDrawBitmap(ptr, vs, x, y, width, height, stripnr, numstrip);
 
 	sx = x - vs->xstart / 8;
@@ -1862,6 +1968,7 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		limit = numstrip;
 	if (limit > _numStrips - sx)
 		limit = _numStrips - sx;
+	const int firstX = x;
 	for (int k = 0; k < limit; ++k, ++stripnr, ++sx, ++x) {
 		if (y < vs->tdirty[sx])
 			vs->tdirty[sx] = y;
@@ -1882,13 +1989,8 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		if (_vm->_game.version == 8 || _vm->_game.heversion >= 60)
 			transpStrip = true;
 
-		if (vs->hasTwoBuffers) {
-			byte *frontBuf = (byte *)vs->getBasePtr(x * 8, y);
-			if (lightsOn)
-				copy8Col(frontBuf, vs->pitch, dstPtr, height, vs->format.bytesPerPixel);
-			else
-				clear8Col(frontBuf, vs->pitch, height, vs->format.bytesPerPixel);
-		}
+		if (vs->hasTwoBuffers && !lightsOn)
+			clear8Col((byte *)vs->getBasePtr(x * 8, y), vs->pitch, height, vs->format.bytesPerPixel);
 
 		decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag);
 
@@ -1916,10 +2018,29 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		}
 #endif
 	}
+
+	// The strips lie next to each other in the back buffer, so copy them to
+	// the screen a row at a time rather than a column at a time.
+	if (vs->hasTwoBuffers && lightsOn && limit > 0) {
+		blit((byte *)vs->getBasePtr(firstX * 8, y), vs->pitch,
+			vs->backBuf + y * vs->pitch + firstX * 8 * vs->format.bytesPerPixel, vs->pitch,
+			limit * 8, height, vs->format.bytesPerPixel);
+	}
+}
+
+const byte *Gdi::findStripMap(const byte *ptr) {
+	if ((_vm->_game.features & GF_SMALL_HEADER) || _vm->_game.version == 8)
+		return ptr;
+
+	const byte *smap_ptr = _vm->findResource(MKTAG('S','M','A','P'), ptr);
+	assert(smap_ptr);
+	return smap_ptr;
 }
 
 bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
 					int stripnr, const byte *smap_ptr) {
+	const byte *smapKey = smap_ptr;
+
 	// Do some input verification and make sure the strip/strip offset
 	// are actually valid. Normally, this should never be a problem,
 	// but if e.g. a savegame gets corrupted, we can easily get into
@@ -1957,7 +2078,142 @@ bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width,
 			_roomPalette = _vm->_roomPalette;
 	}
 
-	return decompressBitmap(dstPtr, vs->pitch, smap_ptr + offset, height);
+	// Room backgrounds are decoded once and then copied from the strip
+	// cache. Strips with transparent pixels depend on what was drawn
+	// before, so they are always decoded.
+	CachedStrip *cached = nullptr;
+	if (canCacheStrip(vs)) {
+		checkStripCacheColors();
+		if (stripnr >= (int)_stripCache.size())
+			_stripCache.resize(stripnr + 1);
+
+		cached = &_stripCache[stripnr];
+		if (cached->smap == smapKey && cached->y == y && cached->height == height) {
+			copy8ColFrom(dstPtr, vs->pitch, cached->pixels.data(), 8 * vs->format.bytesPerPixel, height, vs->format.bytesPerPixel);
+			_stripStats.cacheHits++;
+			return false;
+		}
+	}
+
+	_stripStats.decoded++;
+	const bool transpStrip = decompressBitmap(dstPtr, vs->pitch, smap_ptr + offset, height);
+
+	if (cached) {
+		if (transpStrip) {
+			cached->smap = nullptr;
+			_stripStats.transparent++;
+		} else {
+			cached->smap = smapKey;
+			cached->y = y;
+			cached->height = height;
+			cached->pixels.resize(8 * vs->format.bytesPerPixel * height);
+			copy8ColFrom(cached->pixels.data(), 8 * vs->format.bytesPerPixel, dstPtr, vs->pitch, height, vs->format.bytesPerPixel);
+		}
+	}
+
+	return transpStrip;
+}
+
+bool Gdi::canCacheStrip(const VirtScreen *vs) const {
+	// Only the room background of the main screen is worth caching, other
+	// images are drawn once or share their strip numbers with the room.
+	return _stripCacheEnabled && !_objectMode && vs->number == kMainVirtScreen && vs->hasTwoBuffers;
+}
+
+/**
+ * Throw away the strip cache if the colors the room is decoded with have
+ * changed since the strips were decoded. This is checked once per
+ * drawBitmap() call.
+ */
+void Gdi::checkStripCacheColors() {
+	if (_stripCacheColorsChecked)
+		return;
+	_stripCacheColorsChecked = true;
+
+	uint size;
+	const byte *colors = getRoomColors(size);
+	if (_stripCacheColors.size() == size && !memcmp(_stripCacheColors.data(), colors, size))
+		return;
+
+	for (uint i = 0; i < _stripCache.size(); i++)
+		_stripCache[i].smap = nullptr;
+	_stripCacheColors = Common::Array<byte>(colors, size);
+}
+
+const byte *Gdi::getRoomColors(uint &size) const {
+	size = 256;
+	return _roomPalette;
+}
+
+#ifdef USE_RGB_COLOR
+const byte *GdiHE16bit::getRoomColors(uint &size) const {
+	size = 512;
+	return _vm->_hePalettes + 2048;
+}
+#endif
+
+void Gdi::enableStripCache(bool enable) {
+	_stripCacheEnabled = enable;
+	if (!enable)
+		clearStripCache();
+}
+
+void Gdi::clearStripCache() {
+	_stripCache.clear();
+	_stripCacheColors.clear();
+}
+
+uint32 Gdi::getStripCacheSize() const {
+	uint32 size = 0;
+	for (uint i = 0; i < _stripCache.size(); i++)
+		size += _stripCache[i].pixels.size();
+	return size;
+}
+
+/**
+ * Decode all strips of a room image @p passes times into a scratch buffer,
+ * for the "drawbench" debugger command, and return the time it took. With
+ * @p cached set, the strips are decoded once beforehand and then copied
+ * from the strip cache. The strip cache is emptied afterwards.
+ */
+uint32 Gdi::benchmarkStrips(const byte *ptr, int numStrips, int height, int passes, bool cached) {
+	const int bytesPerPixel = _vm->_virtscr[kMainVirtScreen].format.bytesPerPixel;
+	const byte *smap_ptr = findStripMap(ptr);
+
+	VirtScreen scratch;
+	scratch.number = kMainVirtScreen;
+	scratch.hasTwoBuffers = true;
+	scratch.format = _vm->_virtscr[kMainVirtScreen].format;
+	scratch.pitch = 8 * bytesPerPixel;
+	Common::Array<byte> pixels(scratch.pitch * height);
+
+	const bool wasEnabled = _stripCacheEnabled;
+	const bool wasObjectMode = _objectMode;
+	const StripStats stats = _stripStats;
+	clearStripCache();
+	_stripCacheEnabled = cached;
+	_objectMode = false;
+	_vertStripNextInc = height * scratch.pitch - bytesPerPixel;
+
+	if (cached) {
+		_stripCacheColorsChecked = false;
+		for (int strip = 0; strip < numStrips; strip++)
+			drawStrip(pixels.data(), &scratch, strip, 0, 8, height, strip, smap_ptr);
+	}
+
+	const uint32 start = g_system->getMillis();
+	for (int pass = 0; pass < passes; pass++) {
+		_stripCacheColorsChecked = false;
+		for (int strip = 0; strip < numStrips; strip++)
+			drawStrip(pixels.data(), &scratch, strip, 0, 8, height, strip, smap_ptr);
+	}
+	const uint32 millis = g_system->getMillis() - start;
+
+	clearStripCache();
+	_stripCacheEnabled = wasEnabled;
+	_objectMode = wasObjectMode;
+	_stripStats = stats;
+	return millis;
 }
 
 bool GdiNES::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
@@ -23,6 +23,7 @@
 #define SCUMM_GFX_H
 
 #include "common/system.h"
+#include "common/array.h"
 #include "common/list.h"
 
 #include "graphics/surface.h"
@@ -205,7 +206,29 @@ struct StripTable;
 #define CHARSET_MASK_TRANSPARENCY_32 0xFDFDFDFD
 
 class Gdi {
+public:
+	/** Counters for the "strips" debugger command. */
+	struct StripStats {
+		uint32 decoded;     ///< strips which went through a decoder
+		uint32 cacheHits;   ///< room strips copied from the strip cache
+		uint32 transparent; ///< room strips which cannot be cached
+
+		StripStats() : decoded(0), cacheHits(0), transparent(0) {}
+	};
+
 protected:
+	/**
+	 * A decoded strip of the room background. Its key is the image data
+	 * it was decoded from, together with the rows that were drawn.
+	 */
+	struct CachedStrip {
+		const byte *smap;
+		int y, height;
+		Common::Array<byte> pixels;
+
+		CachedStrip() : smap(nullptr), y(0), height(0) {}
+	};
+
 	ScummEngine *_vm;
 
 	byte _paletteMod;
@@ -219,6 +242,16 @@ protected:
 	/** Flag which is true when an object is being rendered, false otherwise. */
 	bool _objectMode;
 
+	/**
+	 * Decoded room background strips, indexed by strip number. They are
+	 * decoded once and then copied from here for as long as the room and
+	 * the colors it is decoded with stay the same.
+	 */
+	Common::Array<CachedStrip> _stripCache;
+	Common::Array<byte> _stripCacheColors;
+	bool _stripCacheEnabled;
+	bool _stripCacheColorsChecked;
+
 public:
 	/** Flag which is true when loading objects or titles for distaff, in PCEngine version of Loom. */
 	bool _distaff;
@@ -227,6 +260,8 @@ public:
 	int _imgBufOffs[8];
 	int32 _numStrips;
 
+	StripStats _stripStats;
+
 protected:
 	/* Bitmap decompressors */
 	bool decompressBitmap(byte *dst, int dstPitch, const byte *src, int numLinesToProcess);
@@ -246,6 +281,7 @@ protected:
 
 	void drawStripHE(byte *dst, int dstPitch, const byte *src, int width, int height, const bool transpCheck) const;
 	virtual void writeRoomColor(byte *dst, byte color) const;
+	virtual const byte *getRoomColors(uint &size) const;
 
 	/* Mask decompressors */
 	void decompressMaskImgOr(byte *dst, const byte *src, int height) const;
@@ -253,6 +289,10 @@ protected:
 
 	/* Misc */
 	int getZPlanes(const byte *smap_ptr, const byte *zplane_list[9], bool bmapImage) const;
+	const byte *findStripMap(const byte *ptr);
+
+	bool canCacheStrip(const VirtScreen *vs) const;
+	void checkStripCacheColors();
 
 	virtual bool drawStrip(byte *dstPtr, VirtScreen *vs,
 					int x, int y, const int width, const int height,
@@ -289,6 +329,23 @@ public:
 
 	void resetBackground(int top, int bottom, int strip);
 
+	void enableStripCache(bool enable);
+	bool isStripCacheEnabled() const { return _stripCacheEnabled; }
+	void clearStripCache();
+	uint32 getStripCacheSize() const;
+
+	uint32 benchmarkStrips(const byte *ptr, int numStrips, int height, int passes, bool cached);
+
+	/**
+	 * Enable or disable the SSE2/NEON strip copies and text compositing. They
+	 * are enabled by default where they are compiled in; disabling them is
+	 * only useful for benchmarking.
+	 */
+	static void enableSimd(bool enable);
+
+	/** Return whether the SSE2/NEON strip copies and text compositing are used. */
+	static bool isSimdEnabled();
+
 	enum DrawBitmapFlags {
 		dbAllowMaskOr   = 1 << 0,
 		dbDrawMaskOnAll = 1 << 1,
@@ -460,6 +517,7 @@ public:
 class GdiHE16bit : public GdiHE {
 protected:
 	void writeRoomColor(byte *dst, byte color) const override;
+	const byte *getRoomColors(uint &size) const override;
 public:
 	GdiHE16bit(ScummEngine *vm);
 };
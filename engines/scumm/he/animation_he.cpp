@@ -73,6 +73,9 @@ int MoviePlayer::load(const Common::String &filename, int flags, int image) {
 		return -1;
 	}
 
+	// Decode a few frames ahead on another thread, so that large frames
+	// do not hold up the scripts. The Smacker decoder does not support it.
+	_video->setLookAhead(4);
 	_video->start();
 
 	debug(1, "Playing video %s", filename.c_str());
@@ -156,6 +159,7 @@ void MoviePlayer::handleNextFrame() {
 	VirtScreen *pvs = &_vm->_virtscr[kMainVirtScreen];
 
 	if (_flags & 2) {
+		_vm->_wiz->invalidateCachedImage(_wizResNum);
 		uint8 *dstPtr = _vm->getResourceAddress(rtImage, _wizResNum);
 		assert(dstPtr);
 		uint8 *dst = _vm->findWrappedBlock(MKTAG('W','I','Z','D'), dstPtr, 0, 0);
@@ -159,6 +159,7 @@ void ScummEngine_v70he::o70_resourceRoutines() {
 		resid = pop();
 		ensureResourceLoaded(rtRoomImage, resid);
 		ensureResourceLoaded(rtRoom, resid);
+		_res->prefetchRoom(resid);
 		break;
 	case 104:		// SO_NUKE_SCRIPT
 		resid = pop();
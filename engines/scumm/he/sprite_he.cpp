@@ -1259,6 +1259,9 @@ void Sprite::processImages(bool arg) {
 	int32 w, h;
 	WizParameters wiz;
 
+	// Sprites are drawn by the hundreds, so queue them and draw them together
+	_vm->_wiz->beginBatch();
+
 	for (int i = 0; i < _numSpritesToProcess; i++) {
 		SpriteInfo *spi = _activeSpritesTable[i];
 
@@ -1269,7 +1272,7 @@ void Sprite::processImages(bool arg) {
 
 		if (arg) {
 			if (spi->zorder >= 0)
-				return;
+				break;
 		} else {
 			if (spi->zorder < 0)
 				continue;
@@ -1390,6 +1393,8 @@ void Sprite::processImages(bool arg) {
 		}
 		_vm->_wiz->displayWizComplexImage(&wiz);
 	}
+
+	_vm->_wiz->endBatch();
 }
 
 static void syncWithSerializer(Common::Serializer &s, SpriteInfo &si) {
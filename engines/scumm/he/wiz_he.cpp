@@ -21,8 +21,10 @@
 
 #ifdef ENABLE_HE
 
+#include "common/algorithm.h"
 #include "common/archive.h"
 #include "common/system.h"
+#include "common/worker-pool.h"
 #include "graphics/cursorman.h"
 #include "graphics/primitives.h"
 #include "scumm/he/intern_he.h"
@@ -40,6 +42,13 @@ Wiz::Wiz(ScummEngine_v71he *vm) : _vm(vm) {
 	memset(&_polygons, 0, sizeof(_polygons));
 	_cursorImage = false;
 	_rectOverrideEnabled = false;
+	_batching = false;
+	_batchCount = 1;
+	_imageCacheEnabled = true;
+}
+
+Wiz::~Wiz() {
+	clearImageCache();
 }
 
 void Wiz::clearWizBuffer() {
@@ -375,12 +384,14 @@ void Wiz::copy16BitWizImage(uint8 *dst, const uint8 *src, int dstPitch, int dstT
 	if (calcClipRects(dstw, dsth, srcx, srcy, srcw, srch, rect, r1, r2)) {
 		dst += r2.top * dstPitch + r2.left * 2;
 		if (flags & kWIFFlipY) {
-			const int dy = (srcy < 0) ? srcy : (srch - r1.height());
-			r1.translate(0, dy);
+			const int t = r1.top;
+			r1.top = srch - r1.bottom;
+			r1.bottom = srch - t;
 		}
 		if (flags & kWIFFlipX) {
-			const int dx = (srcx < 0) ? srcx : (srcw - r1.width());
-			r1.translate(dx, 0);
+			const int l = r1.left;
+			r1.left = srcw - r1.right;
+			r1.right = srcw - l;
 		}
 		if (xmapPtr) {
 			decompress16BitWizImage<kWizXMap>(dst, dstPitch, dstType, src, r1, flags, xmapPtr);
@@ -396,12 +407,14 @@ void Wiz::copyWizImage(uint8 *dst, const uint8 *src, int dstPitch, int dstType,
 	if (calcClipRects(dstw, dsth, srcx, srcy, srcw, srch, rect, r1, r2)) {
 		dst += r2.top * dstPitch + r2.left * bitDepth;
 		if (flags & kWIFFlipY) {
-			const int dy = (srcy < 0) ? srcy : (srch - r1.height());
-			r1.translate(0, dy);
+			const int t = r1.top;
+			r1.top = srch - r1.bottom;
+			r1.bottom = srch - t;
 		}
 		if (flags & kWIFFlipX) {
-			const int dx = (srcx < 0) ? srcx : (srcw - r1.width());
-			r1.translate(dx, 0);
+			const int l = r1.left;
+			r1.left = srcw - r1.right;
+			r1.right = srcw - l;
 		}
 		if (xmapPtr) {
 			decompressWizImage<kWizXMap>(dst, dstPitch, dstType, src, r1, flags, palPtr, xmapPtr, bitDepth);
@@ -1440,6 +1453,12 @@ uint8 *Wiz::drawWizImage(int resNum, int state, int maskNum, int maskState, int
 	uint8 *dataPtr;
 	uint8 *dst = NULL;
 
+	// The draws which are not queued may change the palette or use the
+	// screen, so the queued images have to be drawn first
+	const bool batch = _batching && canBatchDraw(maskNum, flags, dstResNum);
+	if (_batching && !batch)
+		flushBatch();
+
 	const uint8 *xmapPtr = NULL;
 	if (shadow) {
 		dataPtr = _vm->getResourceAddress(rtImage, shadow);
@@ -1520,6 +1539,7 @@ uint8 *Wiz::drawWizImage(int resNum, int state, int maskNum, int maskState, int
 		dstType = (_cursorImage) ? kDstCursor : kDstMemory;
 	} else {
 		if (dstResNum) {
+			invalidateCachedImage(dstResNum);
 			uint8 *dstPtr = _vm->getResourceAddress(rtImage, dstResNum);
 			assert(dstPtr);
 			dst = _vm->findWrappedBlock(MKTAG('W','I','Z','D'), dstPtr, 0, 0);
@@ -1573,17 +1593,27 @@ uint8 *Wiz::drawWizImage(int resNum, int state, int maskNum, int maskState, int
 		transColor = (trns == NULL) ? _vm->VAR(_vm->VAR_WIZ_TCOLOR) : -1;
 	}
 
+	const uint64 drawStart = g_system->getMicros();
 	if (_vm->_game.id == GID_MOONBASE &&
 			((ScummEngine_v100he *)_vm)->_moonbase->isFOW(resNum, state, conditionBits)) {
+		if (batch)
+			flushBatch();
 		((ScummEngine_v100he *)_vm)->_moonbase->renderFOW(dst, dstPitch, dstType, cw, ch, flags);
 		x1 = 0;
 		y1 = 0;
 		width = rScreen.width();
 		height = rScreen.height();
+	} else if (batch && canBatchComp(comp, flags)) {
+		queueBatchDraw(dst, dataPtr, dstPitch, cw, ch, x1, y1, width, height,
+			resNum, state, comp, rScreen, flags, palPtr, transColor, shadow, xmapPtr);
 	} else {
+		if (batch)
+			flushBatch();
 		drawWizImageEx(dst, dataPtr, mask, dstPitch, dstType, cw, ch, x1, y1, width, height,
 			state, &rScreen, flags, palPtr, transColor, _vm->_bytesPerPixel, xmapPtr, conditionBits);
 	}
+	++_drawStats.draws;
+	_drawStats.drawTime += g_system->getMicros() - drawStart;
 
 	if (!(flags & kWIFBlitToMemBuffer) && dstResNum == 0) {
 		Common::Rect rImage(x1, y1, x1 + width, y1 + height);
@@ -2008,6 +2038,9 @@ void Wiz::drawWizPolygonTransform(int resNum, int state, Common::Point *wp, int
 	uint8 *srcWizBuf = NULL;
 	bool freeBuffer = true;
 
+	if (_batching)
+		flushBatch();
+
 	if (_vm->_game.heversion >= 99) {
 		if (getWizImageData(resNum, state, 0) != 0 || (flags & (kWIFRemapPalette | kWIFFlipX | kWIFFlipY)) || palette != 0) {
 			flags |= kWIFBlitToMemBuffer;
@@ -2044,6 +2077,7 @@ void Wiz::drawWizPolygonTransform(int resNum, int state, Common::Point *wp, int
 	VirtScreen *pvs = &_vm->_virtscr[kMainVirtScreen];
 
 	if (dstResNum) {
+		invalidateCachedImage(dstResNum);
 		uint8 *dstPtr = _vm->getResourceAddress(rtImage, dstResNum);
 		assert(dstPtr);
 		dst = _vm->findWrappedBlock(MKTAG('W','I','Z','D'), dstPtr, 0, 0);
@@ -2208,6 +2242,371 @@ void Wiz::flushWizBuffer() {
 	_imagesNum = 0;
 }
 
+namespace {
+/**
+ * The minimum number of pixels a batch must draw, and the minimum height of
+ * the bands, for Wiz::flushBatch to split the drawing between threads.
+ */
+enum {
+	kMinConcurrentDrawArea = 64 * 64,
+	kMinConcurrentBandHeight = 16
+};
+
+/** The size above which the least recently drawn images leave the image cache. */
+const uint32 kImageCacheBudget = 16 * 1024 * 1024;
+
+uint32 imageCacheKey(int resNum, int state, int flags) {
+	return (resNum << 16) | ((state & 0x3FFF) << 2) | ((flags & kWIFFlipX) ? 1 : 0) | ((flags & kWIFFlipY) ? 2 : 0);
+}
+} // End of anonymous namespace
+
+struct Wiz::BatchBandState {
+	const Common::Array<BatchOp> *ops;
+	int dstw, dsth;
+	int bandHeight;
+};
+
+bool Wiz::canBatchComp(int comp, int flags) {
+	switch (comp) {
+	case 0:
+#ifdef USE_RGB_COLOR
+	case 2:
+#endif
+		// Flipped raw images are copied from the mirrored source rect
+		// without being mirrored, so a part clipped to a band would not
+		// match the same part of the whole image
+		return !(flags & (kWIFFlipX | kWIFFlipY));
+	case 1:
+#ifdef USE_RGB_COLOR
+	case 5:
+#endif
+		return true;
+	default:
+		return false;
+	}
+}
+
+void Wiz::beginBatch() {
+	_batching = true;
+}
+
+void Wiz::endBatch() {
+	flushBatch();
+	_batching = false;
+}
+
+bool Wiz::canBatchDraw(int maskNum, int flags, int dstResNum) const {
+	if (maskNum || dstResNum || !(flags & kWIFMarkBufferDirty))
+		return false;
+
+	return !(flags & (kWIFHasPalette | kWIFRemapPalette | kWIFPrint | kWIFBlitToFrontVideoBuffer |
+		kWIFBlitToMemBuffer | kWIFZPlaneOn | kWIFZPlaneOff));
+}
+
+void Wiz::queueBatchDraw(uint8 *dst, uint8 *dataPtr, int dstPitch, int dstw, int dsth, int x1, int y1, int width, int height,
+		int resNum, int state, int comp, const Common::Rect &rect, int flags, const uint8 *palPtr, int transColor,
+		int shadow, const uint8 *xmapPtr) {
+	BatchOp op;
+	op.dst = dst;
+	op.wizd = _vm->findWrappedBlock(MKTAG('W','I','Z','D'), dataPtr, state, 0);
+	assert(op.wizd);
+	op.palPtr = palPtr;
+	op.xmapPtr = xmapPtr;
+	op.cached = xmapPtr ? nullptr : findCachedImage(dataPtr, op.wizd, resNum, state, comp, width, height, flags, palPtr);
+	op.rect = rect;
+	op.dstPitch = dstPitch;
+	op.dstw = dstw;
+	op.dsth = dsth;
+	op.x1 = x1;
+	op.y1 = y1;
+	op.width = width;
+	op.height = height;
+	op.comp = comp;
+	op.flags = flags;
+	op.transColor = transColor;
+	op.bitDepth = _vm->_bytesPerPixel;
+
+	// Loading the images of the following draws must not expire this one
+	op.resNum = resNum;
+	op.unlockImage = !_vm->_res->isLocked(rtImage, resNum);
+	if (op.unlockImage)
+		_vm->_res->lock(rtImage, resNum);
+	op.shadow = shadow;
+	op.unlockShadow = shadow && !_vm->_res->isLocked(rtImage, shadow);
+	if (op.unlockShadow)
+		_vm->_res->lock(rtImage, shadow);
+
+	_batchOps.push_back(op);
+	++_drawStats.batched;
+}
+
+void Wiz::flushBatch() {
+	if (_batchOps.empty())
+		return;
+
+	const uint64 flushStart = g_system->getMicros();
+	Common::WorkerPool &pool = Common::WorkerPool::instance();
+
+	if (!_pendingDecodes.empty()) {
+		pool.run(_pendingDecodes.size(), decodeCachedImage, &_pendingDecodes);
+		_pendingDecodes.resize(0);
+	}
+
+	int area = 0;
+	for (uint i = 0; i < _batchOps.size(); ++i) {
+		const BatchOp &op = _batchOps[i];
+		Common::Rect r(op.x1, op.y1, op.x1 + op.width, op.y1 + op.height);
+		if (r.intersects(op.rect)) {
+			r.clip(op.rect);
+			area += r.width() * r.height();
+		}
+	}
+
+	BatchBandState state;
+	state.ops = &_batchOps;
+	state.dstw = _batchOps[0].dstw;
+	state.dsth = _batchOps[0].dsth;
+
+	const uint threadCount = pool.getThreadCount();
+	if (threadCount >= 2 && area >= kMinConcurrentDrawArea && state.dsth >= 2 * kMinConcurrentBandHeight) {
+		const uint bandCount = MIN<uint>(threadCount * 2, state.dsth / kMinConcurrentBandHeight);
+		state.bandHeight = (state.dsth + bandCount - 1) / bandCount;
+		pool.run(bandCount, drawBatchBand, &state);
+		++_drawStats.concurrent;
+	} else {
+		state.bandHeight = state.dsth;
+		drawBatchBand(0, &state);
+	}
+
+	for (uint i = 0; i < _batchOps.size(); ++i) {
+		const BatchOp &op = _batchOps[i];
+		if (op.unlockImage)
+			_vm->_res->unlock(rtImage, op.resNum);
+		if (op.unlockShadow)
+			_vm->_res->unlock(rtImage, op.shadow);
+	}
+	_batchOps.resize(0);
+	++_batchCount;
+	++_drawStats.batches;
+
+	expireCachedImages();
+	_drawStats.drawTime += g_system->getMicros() - flushStart;
+}
+
+void Wiz::drawBatchBand(uint index, void *param) {
+	const BatchBandState &state = *static_cast<const BatchBandState *>(param);
+	const Common::Array<BatchOp> &ops = *state.ops;
+	const int top = index * state.bandHeight;
+	if (top >= state.dsth)
+		return;
+	const Common::Rect band(0, top, state.dstw, MIN<int>(top + state.bandHeight, state.dsth));
+
+	for (uint i = 0; i < ops.size(); ++i) {
+		Common::Rect clip = ops[i].rect;
+		if (!clip.intersects(band))
+			continue;
+		clip.clip(band);
+		drawBatchOp(ops[i], clip);
+	}
+}
+
+void Wiz::drawBatchOp(const BatchOp &op, const Common::Rect &clip) {
+	if (op.cached) {
+		const CachedImage &image = *op.cached;
+		Common::Rect r(op.x1, op.y1, op.x1 + image.width, op.y1 + image.height);
+		if (!r.intersects(clip))
+			return;
+		r.clip(clip);
+
+		const int bpp = image.bitDepth;
+		for (int y = r.top; y < r.bottom; ++y) {
+			const int row = y - op.y1;
+			const uint8 *src = image.pixels.begin() + (row * image.width - op.x1) * bpp;
+			uint8 *dst = op.dst + y * op.dstPitch;
+			for (uint32 i = image.rows[row]; i < image.rows[row + 1]; i += 2) {
+				const int left = MAX<int>(op.x1 + image.spans[i], r.left);
+				const int right = MIN<int>(op.x1 + image.spans[i] + image.spans[i + 1], r.right);
+				if (left < right)
+					memcpy(dst + left * bpp, src + left * bpp, (right - left) * bpp);
+			}
+		}
+		return;
+	}
+
+	switch (op.comp) {
+	case 0:
+		copyRawWizImage(op.dst, op.wizd, op.dstPitch, kDstScreen, op.dstw, op.dsth, op.x1, op.y1, op.width, op.height, &clip, op.flags, op.palPtr, op.transColor, op.bitDepth);
+		break;
+	case 1:
+		copyWizImage(op.dst, op.wizd, op.dstPitch, kDstScreen, op.dstw, op.dsth, op.x1, op.y1, op.width, op.height, &clip, op.flags, op.palPtr, op.xmapPtr, op.bitDepth);
+		break;
+#ifdef USE_RGB_COLOR
+	case 2:
+		copyRaw16BitWizImage(op.dst, op.wizd, op.dstPitch, kDstScreen, op.dstw, op.dsth, op.x1, op.y1, op.width, op.height, &clip, op.flags, op.transColor);
+		break;
+	case 5:
+		copy16BitWizImage(op.dst, op.wizd, op.dstPitch, kDstScreen, op.dstw, op.dsth, op.x1, op.y1, op.width, op.height, &clip, op.flags, op.xmapPtr);
+		break;
+#endif
+	default:
+		break;
+	}
+}
+
+Wiz::CachedImage *Wiz::findCachedImage(const uint8 *dataPtr, const uint8 *wizd, int resNum, int state, int comp, int width, int height, int flags, const uint8 *palPtr) {
+	// Only the RLE images are worth keeping decoded, and the images which
+	// are changed by the scripts may change without moving
+	if (!_imageCacheEnabled || (comp != 1 && comp != 5) || width <= 0 || height <= 0 || width > 0xFFFF ||
+			_uncachedImages.contains(resNum) || _vm->_res->isModified(rtImage, resNum))
+		return nullptr;
+
+	const uint32 key = imageCacheKey(resNum, state, flags);
+	const uint paletteSize = (comp == 1 && palPtr) ? 256 * _vm->_bytesPerPixel : 0;
+	CachedImage *image = _imageCache.getValOrDefault(key, nullptr);
+	if (image) {
+		const bool sameImage = image->data == dataPtr && image->resNum == resNum && image->state == state &&
+			image->bitDepth == _vm->_bytesPerPixel;
+		const bool samePalette = image->palette.size() == paletteSize &&
+			(!paletteSize || !memcmp(image->palette.begin(), palPtr, paletteSize));
+		if (sameImage && samePalette) {
+			image->lastUsed = _batchCount;
+			++_drawStats.cacheHits;
+			return image;
+		}
+
+		// Draws queued earlier in this batch still need the current pixels
+		if (image->lastUsed == _batchCount)
+			return nullptr;
+		if (sameImage)
+			++_drawStats.paletteMisses;
+	} else {
+		image = new CachedImage();
+		_imageCache[key] = image;
+	}
+
+	image->data = dataPtr;
+	image->wizd = wizd;
+	image->resNum = resNum;
+	image->state = state;
+	image->flags = flags & (kWIFFlipX | kWIFFlipY);
+	image->comp = comp;
+	image->width = width;
+	image->height = height;
+	image->bitDepth = _vm->_bytesPerPixel;
+	image->palette.resize(paletteSize);
+	if (paletteSize)
+		memcpy(image->palette.begin(), palPtr, paletteSize);
+	image->lastUsed = _batchCount;
+	_pendingDecodes.push_back(image);
+	++_drawStats.cacheMisses;
+	return image;
+}
+
+void Wiz::decodeCachedImage(uint index, void *param) {
+	CachedImage &image = *(*static_cast<Common::Array<CachedImage *> *>(param))[index];
+	const int pitch = image.width * image.bitDepth;
+	const uint size = pitch * image.height;
+	const uint8 *palPtr = image.palette.empty() ? nullptr : image.palette.begin();
+
+	// Decode the image over two different backgrounds; the pixels which
+	// come out the same in both are the opaque ones
+	Common::Array<uint8> other;
+	image.pixels.resize(size);
+	other.resize(size);
+	memset(image.pixels.begin(), 0, size);
+	memset(other.begin(), 0xFF, size);
+	for (int pass = 0; pass < 2; ++pass) {
+		uint8 *dst = pass ? other.begin() : image.pixels.begin();
+		if (image.comp == 1) {
+			copyWizImage(dst, image.wizd, pitch, kDstScreen, image.width, image.height, 0, 0, image.width, image.height, nullptr, image.flags, palPtr, nullptr, image.bitDepth);
+#ifdef USE_RGB_COLOR
+		} else {
+			copy16BitWizImage(dst, image.wizd, pitch, kDstScreen, image.width, image.height, 0, 0, image.width, image.height, nullptr, image.flags, nullptr);
+#endif
+		}
+	}
+
+	image.spans.resize(0);
+	image.rows.resize(0);
+	for (int y = 0; y < image.height; ++y) {
+		image.rows.push_back(image.spans.size());
+		const uint8 *a = image.pixels.begin() + y * pitch;
+		const uint8 *b = other.begin() + y * pitch;
+		int x = 0;
+		while (x < image.width) {
+			while (x < image.width && memcmp(a + x * image.bitDepth, b + x * image.bitDepth, image.bitDepth))
+				++x;
+			const int left = x;
+			while (x < image.width && !memcmp(a + x * image.bitDepth, b + x * image.bitDepth, image.bitDepth))
+				++x;
+			if (x > left) {
+				image.spans.push_back(left);
+				image.spans.push_back(x - left);
+			}
+		}
+	}
+	image.rows.push_back(image.spans.size());
+	image.wizd = nullptr;
+}
+
+bool Wiz::compareCachedImageUse(const CachedImage *a, const CachedImage *b) {
+	return a->lastUsed < b->lastUsed;
+}
+
+void Wiz::expireCachedImages() {
+	uint32 size = getImageCacheSize();
+	if (size <= kImageCacheBudget)
+		return;
+
+	Common::Array<CachedImage *> images;
+	for (CachedImageMap::const_iterator i = _imageCache.begin(); i != _imageCache.end(); ++i)
+		images.push_back(i->_value);
+	Common::sort(images.begin(), images.end(), compareCachedImageUse);
+
+	for (uint i = 0; i < images.size() && size > kImageCacheBudget; ++i) {
+		CachedImage *image = images[i];
+		size -= image->getSize();
+		_imageCache.erase(imageCacheKey(image->resNum, image->state, image->flags));
+		delete image;
+	}
+}
+
+void Wiz::enableImageCache(bool enable) {
+	if (!enable)
+		clearImageCache();
+	_imageCacheEnabled = enable;
+}
+
+void Wiz::clearImageCache() {
+	flushBatch();
+	for (CachedImageMap::iterator i = _imageCache.begin(); i != _imageCache.end(); ++i)
+		delete i->_value;
+	_imageCache.clear();
+	_uncachedImages.clear();
+}
+
+uint32 Wiz::getImageCacheSize() const {
+	uint32 size = 0;
+	for (CachedImageMap::const_iterator i = _imageCache.begin(); i != _imageCache.end(); ++i) {
+		size += i->_value->getSize();
+	}
+	return size;
+}
+
+void Wiz::invalidateCachedImage(int resNum) {
+	if (_uncachedImages.contains(resNum))
+		return;
+
+	flushBatch();
+	for (CachedImageMap::iterator i = _imageCache.begin(); i != _imageCache.end(); ++i) {
+		if (i->_value->resNum == resNum) {
+			delete i->_value;
+			_imageCache.erase(i);
+		}
+	}
+	_uncachedImages[resNum] = true;
+}
+
 void Wiz::loadWizCursor(int resId, int palette) {
 	int32 x, y;
 	getWizImageSpot(resId, 0, x, y);
@@ -22,6 +22,8 @@
 #if !defined(SCUMM_HE_WIZ_HE_H) && defined(ENABLE_HE)
 #define SCUMM_HE_WIZ_HE_H
 
+#include "common/array.h"
+#include "common/hashmap.h"
 #include "common/rect.h"
 
 namespace Scumm {
@@ -230,6 +232,23 @@ enum DstSurface {
  	kDstCursor   = 3
 };
 
+/**
+ * Counters for the images drawn by Wiz::drawWizImage, shown by the "wiz"
+ * debugger command.
+ */
+struct WizDrawStats {
+	uint32 draws;         ///< images drawn
+	uint32 batched;       ///< images queued in a batch, see Wiz::beginBatch()
+	uint32 batches;       ///< batches which drew at least one image
+	uint32 concurrent;    ///< batches drawn by several threads
+	uint32 cacheHits;     ///< images copied from the decoded image cache
+	uint32 cacheMisses;   ///< images decoded into the cache
+	uint32 paletteMisses; ///< cached images decoded again for another palette
+	uint64 drawTime;      ///< time spent drawing and queuing images, in microseconds
+
+	WizDrawStats() : draws(0), batched(0), batches(0), concurrent(0), cacheHits(0), cacheMisses(0), paletteMisses(0), drawTime(0) {}
+};
+
 class ScummEngine_v71he;
 
 class Wiz {
@@ -244,6 +263,7 @@ public:
 	WizPolygon _polygons[NUM_POLYGONS];
 
 	Wiz(ScummEngine_v71he *vm);
+	~Wiz();
 
 	void clearWizBuffer();
 	Common::Rect _rectOverride;
@@ -280,6 +300,27 @@ public:
 
 	void flushWizBuffer();
 
+	/**
+	 * Queue the plain screen draws of drawWizImage until endBatch() is
+	 * called, instead of drawing them immediately. Draws which cannot be
+	 * queued, e.g. with a palette change or to another image, draw the
+	 * queue first, so the images still end up in the order they were drawn.
+	 */
+	void beginBatch();
+
+	/** Draw the queued images and stop queuing. */
+	void endBatch();
+
+	void enableImageCache(bool enable);
+	bool isImageCacheEnabled() const { return _imageCacheEnabled; }
+	void clearImageCache();
+	uint32 getImageCacheSize() const;
+
+	/** Drop the decoded copies of an image which is drawn into, and don't cache it again. */
+	void invalidateCachedImage(int resNum);
+
+	WizDrawStats _drawStats;
+
 	void getWizImageSpot(int resId, int state, int32 &x, int32 &y);
 	void getWizImageSpot(uint8 *data, int state, int32 &x, int32 &y);
 	void loadWizCursor(int resId, int palette);
@@ -333,6 +374,76 @@ public:
 
 private:
 	ScummEngine_v71he *_vm;
+
+	/**
+	 * A fully decoded RLE image state, in the pixel format of the screen,
+	 * with the opaque runs of each row so it can be drawn with plain copies.
+	 */
+	struct CachedImage {
+		const uint8 *data;   ///< image resource the pixels were decoded from
+		const uint8 *wizd;   ///< WIZD block to decode, only valid until decoded
+		int resNum, state, flags, comp;
+		int width, height;
+		uint8 bitDepth;
+		Common::Array<uint8> palette; ///< copy of the remap table the pixels were decoded with
+		Common::Array<uint8> pixels;
+		Common::Array<uint16> spans;  ///< x and width of the opaque runs of all rows
+		Common::Array<uint32> rows;   ///< index into spans of the first run of each row, and the end
+		uint32 lastUsed;     ///< _batchCount of the last batch which drew it
+
+		uint32 getSize() const {
+			return pixels.size() + spans.size() * sizeof(uint16) + rows.size() * sizeof(uint32) + palette.size();
+		}
+	};
+
+	typedef Common::HashMap<uint32, CachedImage *> CachedImageMap;
+
+	/** An image queued by drawWizImage while batching. */
+	struct BatchOp {
+		uint8 *dst;
+		const uint8 *wizd;
+		const uint8 *palPtr;
+		const uint8 *xmapPtr;
+		const CachedImage *cached; ///< nullptr to decode the image from wizd
+		Common::Rect rect;         ///< clip rect on the screen
+		int dstPitch, dstw, dsth;
+		int x1, y1, width, height;
+		int comp, flags, transColor;
+		uint8 bitDepth;
+		int resNum, shadow;
+		bool unlockImage, unlockShadow;
+	};
+
+	/**
+	 * Draw the queued images. The screen is split into horizontal bands
+	 * which are drawn by different threads, and every band draws all images
+	 * in order, clipped to the band, so the result is identical to drawing
+	 * them one after the other.
+	 */
+	void flushBatch();
+
+	bool canBatchDraw(int maskNum, int flags, int dstResNum) const;
+	static bool canBatchComp(int comp, int flags);
+	void queueBatchDraw(uint8 *dst, uint8 *dataPtr, int dstPitch, int dstw, int dsth, int x1, int y1, int width, int height,
+		int resNum, int state, int comp, const Common::Rect &rect, int flags, const uint8 *palPtr, int transColor,
+		int shadow, const uint8 *xmapPtr);
+	CachedImage *findCachedImage(const uint8 *dataPtr, const uint8 *wizd, int resNum, int state, int comp, int width, int height, int flags, const uint8 *palPtr);
+	void expireCachedImages();
+	static bool compareCachedImageUse(const CachedImage *a, const CachedImage *b);
+
+	struct BatchBandState;
+	static void decodeCachedImage(uint index, void *param);
+	static void drawBatchBand(uint index, void *param);
+	static void drawBatchOp(const BatchOp &op, const Common::Rect &clip);
+
+	bool _batching;
+	uint32 _batchCount;
+	Common::Array<BatchOp> _batchOps;           ///< kept between batches to reuse its storage
+	Common::Array<CachedImage *> _pendingDecodes; ///< cache entries to decode in flushBatch()
+
+	bool _imageCacheEnabled;
+	CachedImageMap _imageCache;
+	Common::HashMap<int, bool> _uncachedImages;
 };
 
 } // End of namespace Scumm
@@ -45,10 +45,10 @@ namespace Scumm {
 
 enum {
 	RF_LOCK = 0x80,
-	RF_USAGE = 0x7F,
-	RF_USAGE_MAX = RF_USAGE,
+	RF_USAGE_MAX = 0x7F,
 
 	RS_MODIFIED = 0x10,
+	RS_PREFETCHED = 0x20,
 	RF_OFFHEAP = 0x40
 };
 
@@ -544,8 +544,15 @@ void ResourceManager::allocResTypeData(ResType type, uint32 tag, int num, ResTyp
 
 	// If there was data in there, let's clear it out completely. This is important
 	// in case we are restarting the game.
+	for (ResId idx = 0; idx < _types[type].size(); idx++)
+		nukeResource(type, idx);
 	_types[type].clear();
 	_types[type].resize(num);
+	for (ResId idx = 0; idx < num; idx++) {
+		_types[type][idx]._type = type;
+		_types[type][idx]._idx = idx;
+	}
+	_prefetchQueue.clear();
 
 /*
 	TODO: Use multiple Resource subclasses, one for each res mode; then,
@@ -752,7 +759,9 @@ byte *ScummEngine::getResourceAddress(ResType type, ResId idx) {
 		return nullptr;
 
 	// If the resource is missing, but loadable from the game data files, try to do so.
-	if (!_res->_types[type][idx]._address && _res->_types[type]._mode != kDynamicResTypeMode) {
+	bool loadable = _res->_types[type]._mode != kDynamicResTypeMode;
+	bool missing = !_res->_types[type][idx]._address;
+	if (missing && loadable) {
 		ensureResourceLoaded(type, idx);
 	}
 
@@ -762,6 +771,18 @@ byte *ScummEngine::getResourceAddress(ResType type, ResId idx) {
 		return nullptr;
 	}
 
+	if (loadable) {
+		if (missing)
+			_res->_stats.misses++;
+		else
+			_res->_stats.hits++;
+
+		if (_res->_types[type][idx].isPrefetched()) {
+			_res->_types[type][idx].setPrefetched(false);
+			_res->_stats.prefetchHits++;
+		}
+	}
+
 	_res->setResourceCounter(type, idx, 1);
 
 	debugC(DEBUG_RESOURCE, "getResourceAddress(%s,%d) == %p", nameOfResType(type), idx, (void *)ptr);
@@ -793,28 +814,63 @@ void ResourceManager::increaseExpireCounter() {
 }
 
 void ResourceManager::increaseResourceCounters() {
-	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-		ResId idx = _types[type].size();
-		while (idx-- > 0) {
-			byte counter = _types[type][idx].getResourceCounter();
-			if (counter && counter < RF_USAGE_MAX) {
-				setResourceCounter(type, idx, counter + 1);
-			}
-		}
-	}
+	// The counters are relative to the current pass, so this ages every
+	// loaded resource at once
+	_expirePass++;
 }
 
 void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter) {
-	_types[type][idx].setResourceCounter(counter);
+	Resource &res = _types[type][idx];
+	res._lastUsed = _expirePass - (MIN<byte>(MAX<byte>(counter, 1), RF_USAGE_MAX) - 1);
+
+	// Keep the expire list ordered: a resource which was just used goes to
+	// the end, one which scripts no longer need goes to the front
+	if (!res._prev && _lruFirst != &res)
+		return;
+
+	unlinkResource(res);
+	if (counter > 1 && _lruFirst) {
+		res._next = _lruFirst;
+		_lruFirst->_prev = &res;
+		_lruFirst = &res;
+	} else {
+		linkResource(res);
+	}
 }
 
-void ResourceManager::Resource::setResourceCounter(byte counter) {
-	_flags &= RF_LOCK;	// Clear lower 7 bits, preserve the lock bit.
-	_flags |= counter;	// Update the usage counter
+byte ResourceManager::getResourceCounter(ResType type, ResId idx) const {
+	const Resource &res = _types[type][idx];
+	if (!res._address)
+		return 0;
+	return MIN<uint32>(_expirePass - res._lastUsed + 1, RF_USAGE_MAX);
 }
 
-byte ResourceManager::Resource::getResourceCounter() const {
-	return _flags & RF_USAGE;
+void ResourceManager::linkResource(Resource &res) {
+	if (res._prev || _lruFirst == &res)
+		return;
+
+	res._prev = _lruLast;
+	res._next = nullptr;
+	if (_lruLast)
+		_lruLast->_next = &res;
+	else
+		_lruFirst = &res;
+	_lruLast = &res;
+}
+
+void ResourceManager::unlinkResource(Resource &res) {
+	if (!res._prev && _lruFirst != &res)
+		return;
+
+	if (res._prev)
+		res._prev->_next = res._next;
+	else
+		_lruFirst = res._next;
+	if (res._next)
+		res._next->_prev = res._prev;
+	else
+		_lruLast = res._prev;
+	res._prev = res._next = nullptr;
 }
 
 /* 2 bytes safety area to make "precaching" of bytes in the gdi drawer easier */
@@ -845,9 +901,14 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 	}
 
 	_allocatedSize += size;
+	_stats.peakSize = MAX(_stats.peakSize, _allocatedSize);
 
 	_types[type][idx]._address = ptr;
 	_types[type][idx]._size = size;
+	// A resource can be locked before it is loaded, e.g. when restoring a
+	// savegame; it joins the expire list once it is unlocked
+	if (_types[type]._mode != kDynamicResTypeMode && !_types[type][idx].isLocked())
+		linkResource(_types[type][idx]);
 	setResourceCounter(type, idx, 1);
 	return ptr;
 }
@@ -857,6 +918,10 @@ ResourceManager::Resource::Resource() {
 	_size = 0;
 	_flags = 0;
 	_status = 0;
+	_lastUsed = 0;
+	_prev = _next = nullptr;
+	_type = rtInvalid;
+	_idx = 0;
 	_roomno = 0;
 	_roomoffs = 0;
 }
@@ -871,7 +936,7 @@ void ResourceManager::Resource::nuke() {
 	_address = nullptr;
 	_size = 0;
 	_flags = 0;
-	_status &= ~RS_MODIFIED;
+	_status &= ~(RS_MODIFIED | RS_PREFETCHED);
 }
 
 ResourceManager::ResTypeData::ResTypeData() {
@@ -887,6 +952,9 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	_expirePass = 0;
+	_lruFirst = _lruLast = nullptr;
+	_prefetching = false;
 }
 
 ResourceManager::~ResourceManager() {
@@ -913,6 +981,7 @@ void ResourceManager::nukeResource(ResType type, ResId idx) {
 	if (ptr != nullptr) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", nameOfResType(type), idx);
 		_allocatedSize -= _types[type][idx]._size;
+		unlinkResource(_types[type][idx]);
 		_types[type][idx].nuke();
 	}
 }
@@ -946,12 +1015,18 @@ void ResourceManager::lock(ResType type, ResId idx) {
 	if (!validateResource("Locking", type, idx))
 		return;
 	_types[type][idx].lock();
+	unlinkResource(_types[type][idx]);
 }
 
 void ResourceManager::unlock(ResType type, ResId idx) {
 	if (!validateResource("Unlocking", type, idx))
 		return;
 	_types[type][idx].unlock();
+	if (_types[type][idx]._address && _types[type]._mode != kDynamicResTypeMode) {
+		// Put it back in the expire list where its counter says
+		linkResource(_types[type][idx]);
+		setResourceCounter(type, idx, getResourceCounter(type, idx));
+	}
 }
 
 bool ResourceManager::isLocked(ResType type, ResId idx) const {
@@ -1047,10 +1122,18 @@ void ResourceManager::Resource::setOnHeap() {
 	_status &= ~RF_OFFHEAP;
 }
 
+void ResourceManager::Resource::setPrefetched(bool prefetched) {
+	if (prefetched)
+		_status |= RS_PREFETCHED;
+	else
+		_status &= ~RS_PREFETCHED;
+}
+
+bool ResourceManager::Resource::isPrefetched() const {
+	return (_status & RS_PREFETCHED) != 0;
+}
+
 void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
-	ResType best_type;
-	int best_res = 0;
 	uint32 oldAllocatedSize;
 
 	if (_expireCounter != 0xFF) {
@@ -1061,33 +1144,33 @@ void ResourceManager::expireResources(uint32 size) {
 	if (size + _allocatedSize < _maxHeapThreshold)
 		return;
 
+	// Prefetching is only worth it if it does not throw out anything
+	if (_prefetching)
+		return;
+
 	oldAllocatedSize = _allocatedSize;
 
-	do {
-		best_type = rtInvalid;
-		best_counter = 2;
-
-		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-			if (_types[type]._mode != kDynamicResTypeMode) {
-				// Resources of this type can be reloaded from the data files,
-				// so we can potentially unload them to free memory.
-				ResId idx = _types[type].size();
-				while (idx-- > 0) {
-					Resource &tmp = _types[type][idx];
-					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
-						best_type = type;
-						best_res = idx;
-					}
-				}
-			}
-		}
+	// Only resources which can be reloaded from the data files are in the
+	// list, so we can potentially unload them to free memory. The least
+	// recently used come first, so once we meet a resource which was used
+	// in the current pass, all the ones after it were too.
+	Resource *res = _lruFirst;
+	while (res && size + _allocatedSize > _minHeapThreshold) {
+		Resource *next = res->_next;
 
-		if (!best_type)
+		if (getResourceCounter(res->_type, res->_idx) < 2)
 			break;
-		nukeResource(best_type, best_res);
-	} while (size + _allocatedSize > _minHeapThreshold);
+
+		// Locked resources are never in the list; check anyway, since
+		// expiring one would leave dangling pointers behind
+		if (!res->isLocked() && !res->isOffHeap() && !_vm->isResourceInUse(res->_type, res->_idx)) {
+			_stats.expired++;
+			_stats.expiredSize += res->_size;
+			nukeResource(res->_type, res->_idx);
+		}
+
+		res = next;
+	}
 
 	increaseResourceCounters();
 
@@ -1095,6 +1178,8 @@ void ResourceManager::expireResources(uint32 size) {
 }
 
 void ResourceManager::freeResources() {
+	_prefetchQueue.clear();
+
 	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
 		ResId idx = _types[type].size();
 		while (idx-- > 0) {
@@ -1156,6 +1241,57 @@ bool ResourceManager::isResourceLoaded(ResType type, ResId idx) const {
 	return _types[type][idx]._address != nullptr;
 }
 
+void ResourceManager::prefetchRoom(ResId room) {
+	_prefetchQueue.clear();
+
+	if (room == 0 || _vm->_game.version <= 2)
+		return;
+
+	// Objects come with the room itself, so only the resources stored next
+	// to it are left to load
+	static const ResType types[] = { rtCostume, rtSound };
+
+	for (int i = 0; i < ARRAYSIZE(types); i++) {
+		// FIXME: Sound resources are currently missing
+		if (types[i] == rtSound && _vm->_game.id == GID_LOOM && _vm->_game.platform == Common::kPlatformPCEngine)
+			continue;
+
+		for (ResId idx = 1; idx < _types[types[i]].size(); idx++) {
+			const Resource &res = _types[types[i]][idx];
+			if (res._roomno == room && !res._address && res._roomoffs != RES_INVALID_OFFSET) {
+				PrefetchEntry entry;
+				entry.type = types[i];
+				entry.idx = idx;
+				_prefetchQueue.push(entry);
+			}
+		}
+	}
+
+	debugC(DEBUG_RESOURCE, "prefetchRoom(%d): %d resources queued", room, _prefetchQueue.size());
+}
+
+void ResourceManager::prefetchResources() {
+	while (!_prefetchQueue.empty() && _allocatedSize < _maxHeapThreshold) {
+		PrefetchEntry entry = _prefetchQueue.pop();
+		Resource &res = _types[entry.type][entry.idx];
+
+		// Loaded by the scripts in the meantime
+		if (res._address)
+			continue;
+
+		Common::StackLock lock(_vm->_resourceAccessMutex);
+		_prefetching = true;
+		_vm->ensureResourceLoaded(entry.type, entry.idx);
+		_prefetching = false;
+
+		if (res._address) {
+			res.setPrefetched(true);
+			_stats.prefetched++;
+		}
+		break;
+	}
+}
+
 void ResourceManager::resourceStats() {
 	uint32 lockedSize = 0, lockedNum = 0;
 
@@ -23,6 +23,7 @@
 #define SCUMM_RESOURCE_H
 
 #include "common/array.h"
+#include "common/queue.h"
 #include "scumm/scumm.h"	// for ResType
 
 namespace Scumm {
@@ -80,6 +81,7 @@ protected:
 
 public:
 	class Resource {
+	friend class ResourceManager;
 	public:
 		/**
 		 * Pointer to the data contained in this resource
@@ -94,20 +96,34 @@ public:
 	protected:
 		/**
 		 * The uppermost bit indicates whether the resources is locked.
-		 * The lower 7 bits contain a counter. This counter measures roughly
+		 */
+		byte _flags;
+
+		/**
+		 * The status of the resource: whether it is modified, whether it is
+		 * kept off the heap and whether it was prefetched and not used yet.
+		 */
+		byte _status;
+
+		/**
+		 * The expire pass in which the resource was last used. The difference
+		 * to the current pass is the resource counter, which measures roughly
 		 * how old the resource is; it starts out with a count of 1 and can go
 		 * as high as 127. When memory falls low resp. when the engine decides
 		 * that it should throw out some unused stuff, then it begins by
 		 * removing the resources with the highest counter (excluding locked
 		 * resources and resources that are known to be in use).
 		 */
-		byte _flags;
+		uint32 _lastUsed;
 
 		/**
-		 * The status of the resource. Currently only one bit is used, which
-		 * indicates whether the resource is modified.
+		 * Neighbours in the list of loaded resources which may be expired,
+		 * ordered from the least to the most recently used.
 		 */
-		byte _status;
+		Resource *_prev, *_next;
+
+		ResType _type;
+		ResId _idx;
 
 	public:
 		/**
@@ -131,9 +147,6 @@ public:
 
 		void nuke();
 
-		inline void setResourceCounter(byte counter);
-		inline byte getResourceCounter() const;
-
 		void lock();
 		void unlock();
 		bool isLocked() const;
@@ -144,6 +157,9 @@ public:
 		void setOffHeap();
 		void setOnHeap();
 		bool isOffHeap() const;
+
+		void setPrefetched(bool prefetched);
+		bool isPrefetched() const;
 	};
 
 	/**
@@ -170,16 +186,54 @@ public:
 	};
 	ResTypeData _types[rtLast + 1];
 
+	/**
+	 * How well the resources kept in memory serve the engine. Shown by the
+	 * "resources" debugger command.
+	 */
+	struct CacheStats {
+		uint32 hits;			///< Resources found in memory by getResourceAddress
+		uint32 misses;			///< Resources getResourceAddress had to load
+		uint32 expired;			///< Resources thrown out to stay within the heap threshold
+		uint32 expiredSize;
+		uint32 prefetched;		///< Resources loaded ahead of the room which needs them
+		uint32 prefetchHits;	///< Prefetched resources which were used later on
+		uint32 peakSize;
+
+		CacheStats() : hits(0), misses(0), expired(0), expiredSize(0), prefetched(0), prefetchHits(0), peakSize(0) {}
+	};
+	CacheStats _stats;
+
 protected:
 	uint32 _allocatedSize;
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	/**
+	 * Counts the expire passes, see increaseResourceCounters.
+	 */
+	uint32 _expirePass;
+
+	/**
+	 * Loaded resources which may be expired, least recently used first.
+	 * Resources which cannot be reloaded from the data files and locked
+	 * resources are not in the list.
+	 */
+	Resource *_lruFirst, *_lruLast;
+
+	struct PrefetchEntry {
+		ResType type;
+		ResId idx;
+	};
+	Common::Queue<PrefetchEntry> _prefetchQueue;
+	bool _prefetching;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
 
 	void setHeapThreshold(int min, int max);
+	uint32 getAllocatedSize() const { return _allocatedSize; }
+	uint32 getMaxHeapThreshold() const { return _maxHeapThreshold; }
 
 	void allocResTypeData(ResType type, uint32 tag, int num, ResTypeMode mode);
 	void freeResources();
@@ -210,24 +264,44 @@ public:
 	void increaseExpireCounter();
 
 	/**
-	 * Update the specified resource's counter.
+	 * Update the specified resource's counter. A counter of 1 marks the
+	 * resource as just used, higher counters make it expire sooner.
 	 */
 	void setResourceCounter(ResType type, ResId idx, byte counter);
+	byte getResourceCounter(ResType type, ResId idx) const;
 
 	/**
-	 * Increment the counter of all unlocked loaded resources.
-	 * The maximal count is 255.
+	 * Increment the counter of all loaded resources, by starting a new
+	 * expire pass. The maximal count is 127.
 	 * This is called by increaseExpireCounter and expireResources,
 	 * but also by ScummEngine::startScene.
 	 */
 	void increaseResourceCounters();
 
+	/**
+	 * Queue the costumes and sounds stored with the given room, so that
+	 * prefetchResources loads them before the room is entered. Called when
+	 * a script asks for a room to be loaded.
+	 */
+	void prefetchRoom(ResId room);
+
+	/**
+	 * Load the next queued resource, if there is room on the heap for it
+	 * without expiring anything. It is invoked once per frame in the
+	 * engine's main loop ScummEngine::scummLoop().
+	 */
+	void prefetchResources();
+	uint getPrefetchQueueSize() const { return _prefetchQueue.size(); }
+
 	void resourceStats();
 
 //protected:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
 	void expireResources(uint32 size);
+
+	void linkResource(Resource &res);
+	void unlinkResource(Resource &res);
 };
 
 } // End of namespace Scumm
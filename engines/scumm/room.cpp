@@ -130,6 +130,9 @@ void ScummEngine::startScene(int room, Actor *a, int objectNr) {
 	if (room != 0)
 		ensureResourceLoaded(rtRoom, room);
 
+	// The new room image may have been loaded where the old one was
+	_gdi->clearStripCache();
+
 	clearRoomObjects();
 
 	if (_currentRoom == 0) {
@@ -260,35 +263,12 @@ void ScummEngine::setupRoomSubBlocks() {
 	//
 	// Determine the room dimensions (width/height)
 	//
-	rmhd = (const RoomHeader *)findResourceData(MKTAG('R','M','H','D'), roomptr);
-
-	if (_game.version == 8) {
-		_roomWidth = READ_LE_UINT32(&(rmhd->v8.width));
-		_roomHeight = READ_LE_UINT32(&(rmhd->v8.height));
-		_numObjectsInRoom = (byte)READ_LE_UINT32(&(rmhd->v8.numObjects));
-	} else if (_game.version == 7) {
-		_roomWidth = READ_LE_UINT16(&(rmhd->v7.width));
-		_roomHeight = READ_LE_UINT16(&(rmhd->v7.height));
-		_numObjectsInRoom = (byte)READ_LE_UINT16(&(rmhd->v7.numObjects));
-	} else {
-		_roomWidth = READ_LE_UINT16(&(rmhd->old.width));
-		_roomHeight = READ_LE_UINT16(&(rmhd->old.height));
-		_numObjectsInRoom = (byte)READ_LE_UINT16(&(rmhd->old.numObjects));
-	}
+	readRoomHeader(roomptr, _roomWidth, _roomHeight, _numObjectsInRoom);
 
 	//
 	// Find the room image data
 	//
-	if (_game.version == 8) {
-		_IM00_offs = getObjectImage(roomptr, 1) - roomptr;
-	} else if (_game.features & GF_SMALL_HEADER) {
-		_IM00_offs = findResourceData(MKTAG('I','M','0','0'), roomptr) - roomptr;
-	} else if (_game.heversion >= 70) {
-		byte *roomImagePtr = getResourceAddress(rtRoomImage, _roomResource);
-		_IM00_offs = findResource(MKTAG('I','M','0','0'), roomImagePtr) - roomImagePtr;
-	} else {
-		_IM00_offs = findResource(MKTAG('I','M','0','0'), findResource(MKTAG('R','M','I','M'), roomptr)) - roomptr;
-	}
+	_IM00_offs = findRoomImage(roomptr, _roomResource);
 
 	//
 	// Look for an exit script
@@ -418,9 +398,10 @@ void ScummEngine::setupRoomSubBlocks() {
 
 	// Transparent color
 	byte trans;
-	if (_game.version == 8)
+	if (_game.version == 8) {
+		rmhd = (const RoomHeader *)findResourceData(MKTAG('R','M','H','D'), roomptr);
 		trans = (byte)READ_LE_UINT32(&(rmhd->v8.transparency));
-	else {
+	} else {
 		ptr = findResourceData(MKTAG('T','R','N','S'), roomptr);
 		if (ptr)
 			trans = ptr[0];
@@ -457,6 +438,45 @@ void ScummEngine::setupRoomSubBlocks() {
 	_gdi->setTransparentColor(trans);
 }
 
+/**
+ * Read the size and the number of objects of a room from its RMHD block.
+ */
+void ScummEngine::readRoomHeader(const byte *roomptr, int &width, int &height, int &numObjects) {
+	const RoomHeader *rmhd = (const RoomHeader *)findResourceData(MKTAG('R','M','H','D'), roomptr);
+
+	if (_game.version == 8) {
+		width = READ_LE_UINT32(&(rmhd->v8.width));
+		height = READ_LE_UINT32(&(rmhd->v8.height));
+		numObjects = (byte)READ_LE_UINT32(&(rmhd->v8.numObjects));
+	} else if (_game.version == 7) {
+		width = READ_LE_UINT16(&(rmhd->v7.width));
+		height = READ_LE_UINT16(&(rmhd->v7.height));
+		numObjects = (byte)READ_LE_UINT16(&(rmhd->v7.numObjects));
+	} else {
+		width = READ_LE_UINT16(&(rmhd->old.width));
+		height = READ_LE_UINT16(&(rmhd->old.height));
+		numObjects = (byte)READ_LE_UINT16(&(rmhd->old.numObjects));
+	}
+}
+
+/**
+ * Return the offset of the room background image, as passed to
+ * Gdi::drawBitmap() by redrawBGStrip(). HE games from version 70 on keep
+ * the image in a resource of its own, so the offset is relative to that.
+ */
+uint32 ScummEngine::findRoomImage(const byte *roomptr, ResId room) {
+	if (_game.version == 8) {
+		return getObjectImage(roomptr, 1) - roomptr;
+	} else if (_game.features & GF_SMALL_HEADER) {
+		return findResourceData(MKTAG('I','M','0','0'), roomptr) - roomptr;
+	} else if (_game.heversion >= 70) {
+		byte *roomImagePtr = getResourceAddress(rtRoomImage, room);
+		return findResource(MKTAG('I','M','0','0'), roomImagePtr) - roomImagePtr;
+	} else {
+		return findResource(MKTAG('I','M','0','0'), findResource(MKTAG('R','M','I','M'), roomptr)) - roomptr;
+	}
+}
+
 /**
  * Init some dynamic room data after a room has been loaded.
  * E.g. the initial box data is loaded, the initial palette is set etc.
@@ -536,6 +536,7 @@ bool ScummEngine::loadState(int slot, bool compat, Common::String &filename) {
 
 	// Load the static room data
 	setupRoomSubBlocks();
+	_gdi->clearStripCache();
 
 	if (_game.version < 7) {
 		camera._last.x = camera._cur.x;
@@ -1656,6 +1657,10 @@ void ScummEngine_v71he::saveLoadWithSerializer(Common::Serializer &s) {
 	ScummEngine_v70he::saveLoadWithSerializer(s);
 
 	s.syncArray(_wiz->_polygons, ARRAYSIZE(_wiz->_polygons), syncWithSerializer);
+
+	// The images may have been reloaded, or restored from the savegame
+	if (s.isLoading())
+		_wiz->clearImageCache();
 }
 
 void syncWithSerializer(Common::Serializer &s, FloodFillParameters &ffp) {
@@ -1657,6 +1657,7 @@ void ScummEngine_v5::o5_resourceRoutines() {
 				_res->setResourceCounter(rtRoom, resid, 1);
 			}
 		}
+		_res->prefetchRoom(resid);
 		break;
 
 	case 5:			// SO_NUKE_SCRIPT
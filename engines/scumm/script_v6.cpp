@@ -1544,6 +1544,7 @@ void ScummEngine_v6::o6_resourceRoutines() {
 	case 103:		// SO_LOAD_ROOM
 		resid = pop();
 		ensureResourceLoaded(rtRoom, resid);
+		_res->prefetchRoom(resid);
 		break;
 	case 104:		// SO_NUKE_SCRIPT
 		resid = pop();
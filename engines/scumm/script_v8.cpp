@@ -639,6 +639,7 @@ void ScummEngine_v8::o8_resourceRoutines() {
 		break;
 	case 0x3F:		// SO_HEAP_LOAD_ROOM Load room to heap
 		ensureResourceLoaded(rtRoom, resid);
+		_res->prefetchRoom(resid);
 		break;
 	case 0x40:		// SO_HEAP_LOAD_SCRIPT Load script to heap
 		ensureResourceLoaded(rtScript, resid);
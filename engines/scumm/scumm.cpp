@@ -1629,7 +1629,12 @@ void ScummEngine::setupScumm(const Common::String &macResourceFile) {
 		maxHeapThreshold = 550000;
 	}
 
-	_res->setHeapThreshold(400000, maxHeapThreshold);
+	// Allow capping (or raising) the memory used for resources of each game
+	// separately, e.g. when running many of them at once
+	if (ConfMan.hasKey("resource_cache_size"))
+		maxHeapThreshold = MAX(ConfMan.getInt("resource_cache_size"), 64) * 1024;
+
+	_res->setHeapThreshold(MIN(400000, maxHeapThreshold), maxHeapThreshold);
 
 	free(_compositeBuf);
 	_compositeBuf = (byte *)malloc(_screenWidth * _textSurfaceMultiplier * _screenHeight * _textSurfaceMultiplier * _outputPixelFormat.bytesPerPixel);
@@ -2652,6 +2657,7 @@ load_game:
 	camera._last = camera._cur;
 
 	_res->increaseExpireCounter();
+	_res->prefetchResources();
 
 	animateCursor();
 
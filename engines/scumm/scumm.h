@@ -685,6 +685,8 @@ protected:
 
 	virtual void setupRoomSubBlocks();
 	virtual void resetRoomSubBlocks();
+	void readRoomHeader(const byte *roomptr, int &width, int &height, int &numObjects);
+	uint32 findRoomImage(const byte *roomptr, ResId room);
 
 	virtual void clearRoomObjects();
 	virtual void resetRoomObjects();
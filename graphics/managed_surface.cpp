@@ -679,6 +679,70 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 	delete[] lookup;
 }
 
+/**
+ * Unscaled blits of sprites between surfaces of the same 32-bit format with
+ * 8-bit channels. Most sprites are made of runs of fully transparent and fully
+ * opaque pixels, so the pixels are checked four at a time: groups which are
+ * transparent are skipped, opaque ones are copied, and only the others go
+ * through transBlitPixel(). The results are the same as those of transBlit().
+ *
+ * @return false if the blit has to be done by transBlit()
+ */
+static bool transBlitSprite32(const Surface &src, const Common::Rect &srcRect, ManagedSurface &dest, const Common::Rect &destRect,
+		uint transColor, bool flipped, uint srcAlpha, const Surface *mask) {
+	const PixelFormat &format = src.format;
+	if (format != dest.format || format.bytesPerPixel != 4 || format.rBits() != 8 || format.gBits() != 8 ||
+			format.bBits() != 8 || format.aBits() != 8)
+		return false;
+
+	// Source color keys, masks, global alpha and destination color keys all
+	// need the checks of transBlit() for every pixel
+	if ((transColor != 0 && transColor != (uint)-1) || srcAlpha != 0xff || mask || dest.hasTransparentColor())
+		return false;
+	if (srcRect.width() != destRect.width() || srcRect.height() != destRect.height())
+		return false;
+
+	const uint32 alphaMask = format.ARGBToColor(0xff, 0, 0, 0);
+	const int left = MAX<int>(destRect.left, 0), right = MIN<int>(destRect.right, dest.w);
+	const int top = MAX<int>(destRect.top, 0), bottom = MIN<int>(destRect.bottom, dest.h);
+
+	for (int destY = top; destY < bottom; ++destY) {
+		const uint32 *srcLine = (const uint32 *)src.getBasePtr(srcRect.left, destY - destRect.top + srcRect.top);
+		uint32 *destLine = (uint32 *)dest.getBasePtr(destRect.left, destY);
+
+		int xCtr = left - destRect.left;
+		const int xEnd = right - destRect.left;
+		const uint32 *srcP = flipped ? srcLine + src.w - xCtr - 1 : srcLine + xCtr;
+		const int srcStep = flipped ? -1 : 1;
+
+		for (; xCtr < xEnd; xCtr += 4, srcP += srcStep * 4) {
+			const int count = MIN(4, xEnd - xCtr);
+			if (count == 4) {
+				const uint32 p0 = srcP[0], p1 = srcP[srcStep], p2 = srcP[srcStep * 2], p3 = srcP[srcStep * 3];
+				if (((p0 | p1 | p2 | p3) & alphaMask) == 0)
+					continue;
+
+				if ((p0 & p1 & p2 & p3 & alphaMask) == alphaMask &&
+						p0 != transColor && p1 != transColor && p2 != transColor && p3 != transColor) {
+					destLine[xCtr] = p0;
+					destLine[xCtr + 1] = p1;
+					destLine[xCtr + 2] = p2;
+					destLine[xCtr + 3] = p3;
+					continue;
+				}
+			}
+
+			for (int i = 0; i < count; ++i) {
+				const uint32 srcVal = srcP[srcStep * i];
+				if (srcVal != transColor)
+					transBlitPixel<uint32, uint32>(srcVal, destLine[xCtr + i], format, format, 0, srcAlpha, nullptr, nullptr);
+			}
+		}
+	}
+
+	return true;
+}
+
 #define HANDLE_BLIT(SRC_BYTES, DEST_BYTES, SRC_TYPE, DEST_TYPE) \
 	if (src.format.bytesPerPixel == SRC_BYTES && format.bytesPerPixel == DEST_BYTES) \
 		transBlit<SRC_TYPE, DEST_TYPE>(src, srcRect, *this, destRect, transColor, flipped, overrideColor, srcAlpha, srcPalette, dstPalette, mask, maskOnly); \
@@ -695,6 +759,11 @@ void ManagedSurface::transBlitFromInner(const Surface &src, const Common::Rect &
 			error("Surface::transBlitFrom: mask dimensions do not match src");
 	}
 
+	if (transBlitSprite32(src, srcRect, *this, destRect, transColor, flipped, srcAlpha, mask)) {
+		addDirtyRect(destRect);
+		return;
+	}
+
 	HANDLE_BLIT(1, 1, byte, byte)
 	HANDLE_BLIT(1, 2, byte, uint16)
 	HANDLE_BLIT(1, 4, byte, uint32)
@@ -31,6 +31,7 @@ public:
 protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 							uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) override;
+	bool canScaleInBands() const override { return true; }
 private:
 	// Allocate enough for 32bpp formats
 	uint32 lookup[17];
@@ -159,6 +159,17 @@ static void scale3x(void* void_dst, unsigned dst_slice, const void* void_src, un
 	}
 }
 
+/**
+ * The number of pixels by which the intermediate Scale2x rows of Scale4x are
+ * wider than the source on each side. Scale2x looks at the pixels left and
+ * right of a row, which for the intermediate rows must be real intermediate
+ * pixels rather than whatever is next to the row in the buffer. The margin
+ * keeps the row width a multiple of what the MMX version expects.
+ */
+static inline unsigned scale4x_margin(unsigned pixel) {
+	return 4 / pixel;
+}
+
 /**
  * Apply the Scale4x effect on a bitmap.
  * The destination bitmap is filled with the scaled version of the source bitmap.
@@ -166,8 +177,8 @@ static void scale3x(void* void_dst, unsigned dst_slice, const void* void_src, un
  * The destination bitmap must be manually allocated before calling the function,
  * note that the resulting size is exactly 4x4 times the size of the source bitmap.
  * \note This function requires also a small buffer bitmap used internally to store
- * intermediate results. This bitmap must have at least an horizontal size in bytes of 2*width*pixel,
- * and a vertical size of 6 rows. The memory of this buffer must not be allocated
+ * intermediate results. This bitmap must have at least an horizontal size in bytes of
+ * 2*(width+2*scale4x_margin(pixel))*pixel, and a vertical size of 6 rows. The memory of this buffer must not be allocated
  * in video memory because it's also read and not only written. Generally
  * a heap (malloc) or a stack (alloca) buffer is the best choices.
  * @param void_dst Pointer at the first pixel of the destination bitmap.
@@ -185,6 +196,10 @@ static void scale4x_buf(void* void_dst, unsigned dst_slice, void* void_mid, unsi
 	const unsigned char* src = (const unsigned char*)void_src;
 	unsigned count;
 	unsigned char* mid[6];
+	const unsigned margin = scale4x_margin(pixel);
+	const unsigned src_margin = margin * pixel;
+	const unsigned mid_margin = 2 * margin * pixel;
+	const unsigned mid_width = width + 2 * margin;
 
 	assert(height >= 4);
 
@@ -198,13 +213,13 @@ static void scale4x_buf(void* void_dst, unsigned dst_slice, void* void_mid, unsi
 	mid[4] = mid[3] + mid_slice;
 	mid[5] = mid[4] + mid_slice;
 
-	stage_scale2x(SCMID(0), SCMID(1), SCSRC(0), SCSRC(1), SCSRC(2), pixel, width);
-	stage_scale2x(SCMID(2), SCMID(3), SCSRC(1), SCSRC(2), SCSRC(3), pixel, width);
+	stage_scale2x(SCMID(0), SCMID(1), SCSRC(0) - src_margin, SCSRC(1) - src_margin, SCSRC(2) - src_margin, pixel, mid_width);
+	stage_scale2x(SCMID(2), SCMID(3), SCSRC(1) - src_margin, SCSRC(2) - src_margin, SCSRC(3) - src_margin, pixel, mid_width);
 	while (count) {
 		unsigned char* tmp;
 
-		stage_scale2x(SCMID(4), SCMID(5), SCSRC(2), SCSRC(3), SCSRC(4), pixel, width);
-		stage_scale4x(SCDST(0), SCDST(1), SCDST(2), SCDST(3), SCMID(1), SCMID(2), SCMID(3), SCMID(4), pixel, width);
+		stage_scale2x(SCMID(4), SCMID(5), SCSRC(2) - src_margin, SCSRC(3) - src_margin, SCSRC(4) - src_margin, pixel, mid_width);
+		stage_scale4x(SCDST(0), SCDST(1), SCDST(2), SCDST(3), SCMID(1) + mid_margin, SCMID(2) + mid_margin, SCMID(3) + mid_margin, SCMID(4) + mid_margin, pixel, width);
 
 		dst = SCDST(4);
 		src = SCSRC(1);
@@ -246,7 +261,7 @@ static void scale4x(void* void_dst, unsigned dst_slice, const void* void_src, un
 	unsigned mid_slice;
 	void* mid;
 
-	mid_slice = 2 * pixel * width; /* required space for 1 row buffer */
+	mid_slice = 2 * pixel * (width + 2 * scale4x_margin(pixel)); /* required space for 1 row buffer */
 
 	mid_slice = (mid_slice + 0x7) & ~0x7; /* align to 8 bytes */
 
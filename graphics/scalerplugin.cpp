@@ -20,6 +20,8 @@
 
 #include "graphics/scalerplugin.h"
 
+#include "common/worker-pool.h"
+
 namespace {
 /**
  * Trivial 'scaler' - in fact it doesn't do any scaling but just copies the
@@ -40,6 +42,26 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 		dstPtr += dstPitch;
 	}
 }
+
+enum {
+	/** The fewest source rows worth scaling on a thread of their own. */
+	kMinBandRows = 32
+};
+
+/** The arguments of a scale() call, shared by all the bands of rows it is split into. */
+struct ScaleBands {
+	Scaler *scaler;
+	const uint8 *srcPtr;
+	uint32 srcPitch;
+	uint8 *dstPtr;
+	uint32 dstPitch;
+	int width;
+	int height;
+	int x;
+	int y;
+	int bandHeight;
+	uint bands;
+};
 } // End of anonymous namespace
 
 void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
@@ -50,9 +72,37 @@ void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 		} else {
 			Normal1x<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 		}
-	} else {
+		return;
+	}
+
+	uint bands = 1;
+	if (canScaleInBands()) {
+		Common::WorkerPool &pool = Common::WorkerPool::instance();
+		if (pool.getThreadCount() > 1)
+			bands = CLIP<uint>(height / kMinBandRows, 1, pool.getThreadCount() * 2);
+	}
+
+	if (bands == 1) {
 		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+	} else {
+		// The last band takes the rows left over, so that no band is shorter
+		// than kMinBandRows
+		ScaleBands job = { this, srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y, height / (int)bands, bands };
+		Common::WorkerPool::instance().run(bands, scaleBand, &job);
 	}
+
+	finishScale(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+}
+
+void Scaler::scaleBand(uint index, void *param) {
+	const ScaleBands &job = *(const ScaleBands *)param;
+	const int top = index * job.bandHeight;
+	const int rows = (index == job.bands - 1) ? job.height - top : job.bandHeight;
+	const uint factor = job.scaler->_factor;
+
+	job.scaler->scaleIntern(job.srcPtr + top * job.srcPitch, job.srcPitch,
+	                        job.dstPtr + top * factor * job.dstPitch, job.dstPitch,
+	                        job.width, rows, job.x, job.y + top);
 }
 
 SourceScaler::SourceScaler(const Graphics::PixelFormat &format) : Scaler(format), _width(0), _height(0), _oldSrc(NULL), _enable(false) {
@@ -109,6 +159,16 @@ void SourceScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstP
 	            _oldSrc + offset, srcPitch,
 	            width, height,
 	            (uint8 *)_bufferedOutput.getBasePtr(x * _factor, y * _factor), _bufferedOutput.pitch);
+}
+
+void SourceScaler::finishScale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+						 uint32 dstPitch, int width, int height, int x, int y) {
+	// The old source and buffered output are only updated once all bands are
+	// done, as the bands next to them may still be comparing against them
+	if (!_enable)
+		return;
+
+	int offset = (_padding + x) * _format.bytesPerPixel + (_padding + y) * srcPitch;
 
 	// Update the destination buffer
 	byte *buffer = (byte *)_bufferedOutput.getBasePtr(x * _factor, y * _factor);
@@ -33,6 +33,11 @@ public:
 	/**
 	 * Scale a rect.
 	 *
+	 * Large rects are scaled in bands of rows on several threads, if the
+	 * scaler supports it.
+	 *
+	 * @see canScaleInBands
+	 *
 	 * @param srcPtr   Pointer to the source buffer.
 	 * @param srcPitch The number of bytes in a scanline of the source.
 	 * @param dstPtr   Pointer to the destination buffer.
@@ -101,8 +106,28 @@ protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) = 0;
 
+	/**
+	 * Scalers which keep no state of their own while scaling may return true,
+	 * so that large rects are split into bands of rows, which scaleIntern()
+	 * scales on the threads of Common::WorkerPool at the same time. A band
+	 * reads the rows around it from the source like a whole rect does, so
+	 * scalers looking at neighbouring pixels need no special handling.
+	 */
+	virtual bool canScaleInBands() const { return false; }
+
+	/**
+	 * Called by scale() once scaleIntern() has scaled all the bands of a rect.
+	 *
+	 * @see scale
+	 */
+	virtual void finishScale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+	                         uint32 dstPitch, int width, int height, int x, int y) {}
+
 	uint _factor;
 	Graphics::PixelFormat _format;
+
+private:
+	static void scaleBand(uint index, void *param);
 };
 
 /**
@@ -127,6 +152,9 @@ protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) final;
 
+	virtual void finishScale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+	                         uint32 dstPitch, int width, int height, int x, int y) final;
+
 	/**
 	 * Scalers must implement this function. It will be called by oldSrcScale.
 	 * If by comparing the src and oldsrc images it is discovered that no change
@@ -394,6 +394,11 @@ void GLContext::gl_draw_triangle_fill(GLContext *c, GLVertex *p0, GLVertex *p1,
 	}
 #endif
 
+	// Skip triangles above or below the scissor rectangle, e.g. the ones
+	// outside of the band of the screen rendered by a tile context.
+	if (c->fb->scissorRows(MIN(p0->zp.y, MIN(p1->zp.y, p2->zp.y)), MAX(p0->zp.y, MAX(p1->zp.y, p2->zp.y))))
+		return;
+
 	if (!c->color_mask_red && !c->color_mask_green && !c->color_mask_blue && !c->color_mask_alpha) {
 		c->fb->fillTriangleDepthOnly(&p0->zp, &p1->zp, &p2->zp);
 	} else if (c->texture_2d_enabled && c->current_texture->images[0].pixmap) {
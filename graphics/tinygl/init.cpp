@@ -29,6 +29,8 @@
 #include "graphics/tinygl/zblit.h"
 #include "graphics/tinygl/zdirtyrect.h"
 
+#include "common/worker-pool.h"
+
 namespace TinyGL {
 
 GLContext *gl_ctx;
@@ -259,8 +261,9 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_drawCallAllocator[0].initialize(kDrawCallMemory);
 	_drawCallAllocator[1].initialize(kDrawCallMemory);
 	_debugRectsEnabled = false;
+	_enableTiledRendering = Common::WorkerPool::instance().getThreadCount() > 1;
 
-	TinyGL::Internal::tglBlitResetScissorRect();
+	TinyGL::Internal::tglBlitResetScissorRect(this);
 }
 
 GLContext *gl_get_context() {
@@ -278,6 +281,7 @@ void destroyContext() {
 void GLContext::deinit() {
 	disposeDrawCallLists();
 	disposeResources();
+	disposeTileContexts();
 
 	specbuf_cleanup();
 	for (int i = 0; i < 3; i++)
@@ -76,6 +76,26 @@ void TexelBuffer::getARGBAt(
 	);
 }
 
+void TexelBuffer::getARGBSpan(
+	uint wrap_s, uint wrap_t,
+	int s, int t, int dsdx, int dtdx,
+	int count, uint32 *argb
+) const {
+	uint pixels[kMaxSpanTexels], ds[kMaxSpanTexels], dt[kMaxSpanTexels];
+	assert(count <= kMaxSpanTexels);
+	for (int i = 0; i < count; i++) {
+		uint x, y;
+		x = wrap(wrap_s, s, _fracTextureUnit, _fracTextureMask) * _widthRatio;
+		y = wrap(wrap_t, t, _fracTextureUnit, _fracTextureMask) * _heightRatio;
+		pixels[i] = (x >> ZB_POINT_ST_FRAC_BITS) + (y >> ZB_POINT_ST_FRAC_BITS) * _width;
+		ds[i] = x & ZB_POINT_ST_FRAC_MASK;
+		dt[i] = y & ZB_POINT_ST_FRAC_MASK;
+		s += dsdx;
+		t += dtdx;
+	}
+	getARGBSpan(pixels, ds, dt, count, argb);
+}
+
 // Nearest: store texture in original size.
 NearestTexelBuffer::NearestTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize) : TexelBuffer(width, height, textureSize) {
 	uint pixel_count = _width * _height;
@@ -95,6 +115,18 @@ void NearestTexelBuffer::getARGBAt(
 	_buf.getARGBAt(pixel, a, r, g, b);
 }
 
+void NearestTexelBuffer::getARGBSpan(
+	const uint *pixels,
+	const uint *, const uint *,
+	int count, uint32 *argb
+) const {
+	for (int i = 0; i < count; i++) {
+		uint8 a, r, g, b;
+		_buf.getARGBAt(pixels[i], a, r, g, b);
+		argb[i] = ((uint32)a << 24) | (r << 16) | (g << 8) | b;
+	}
+}
+
 // Bilinear: each texture coordinates corresponds to the 4 original image
 // pixels linear interpolation has to work on, so that they are near each
 // other in CPU data cache, and a single actual memory fetch happens. This
@@ -221,4 +253,16 @@ void BilinearTexelBuffer::getARGBAt(
 	);
 }
 
+void BilinearTexelBuffer::getARGBSpan(
+	const uint *pixels,
+	const uint *ds, const uint *dt,
+	int count, uint32 *argb
+) const {
+	for (int i = 0; i < count; i++) {
+		uint8 a, r, g, b;
+		BilinearTexelBuffer::getARGBAt(pixels[i], ds[i], dt[i], a, r, g, b);
+		argb[i] = ((uint32)a << 24) | (r << 16) | (g << 8) | b;
+	}
+}
+
 } // end of namespace TinyGL
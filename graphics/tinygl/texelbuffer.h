@@ -37,12 +37,30 @@ public:
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const;
 
+	static const int kMaxSpanTexels = 8;
+
+	/**
+	 * Fetch count texels along a span, starting at (s, t) and stepping by
+	 * (dsdx, dtdx) for each pixel, as 0xAARRGGBB values. count must not be
+	 * larger than kMaxSpanTexels.
+	 */
+	void getARGBSpan(
+		uint wrap_s, uint wrap_t,
+		int s, int t, int dsdx, int dtdx,
+		int count, uint32 *argb
+	) const;
+
 protected:
 	virtual void getARGBAt(
 		uint pixel,
 		uint ds, uint dt,
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const = 0;
+	virtual void getARGBSpan(
+		const uint *pixels,
+		const uint *ds, const uint *dt,
+		int count, uint32 *argb
+	) const = 0;
 	uint _width, _height, _fracTextureUnit, _fracTextureMask;
 	float _widthRatio, _heightRatio;
 };
@@ -58,6 +76,11 @@ protected:
 		uint, uint,
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const override;
+	void getARGBSpan(
+		const uint *pixels,
+		const uint *, const uint *,
+		int count, uint32 *argb
+	) const override;
 
 private:
 	Graphics::PixelBuffer _buf;
@@ -74,6 +97,11 @@ protected:
 		uint ds, uint dt,
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const override;
+	void getARGBSpan(
+		const uint *pixels,
+		const uint *ds, const uint *dt,
+		int count, uint32 *argb
+	) const override;
 
 private:
 	uint32 *_texels;
@@ -36,6 +36,8 @@ void presentBuffer();
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas);
 void getSurfaceRef(Graphics::Surface &surface);
 Graphics::Surface *copyToBuffer(const Graphics::PixelFormat &dstFormat);
+// Select the SSE2/NEON triangle fillers (when available) or the portable ones
+void enableSimdSpans(bool enable);
 
 } // end of namespace TinyGL
 
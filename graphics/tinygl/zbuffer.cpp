@@ -90,20 +90,44 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_zbuf = (uint *)gl_zalloc(_pbufWidth * _pbufHeight * sizeof(uint));
 	if (enableStencilBuffer)
 		_sbuf = (byte *)gl_zalloc(_pbufWidth * _pbufHeight * sizeof(byte));
+	else
+		_sbuf = nullptr;
+	_isView = false;
 
 	_offscreenBuffer.pbuf = _pbuf.getRawBuffer();
 	_offscreenBuffer.zbuf = _zbuf;
 
 	_currentTexture = nullptr;
+	_enableScissor = false;
+	enableSimdSpans(true);
 }
 
 FrameBuffer::~FrameBuffer() {
+	if (_isView)
+		return;
 	_pbuf.free();
 	gl_free(_zbuf);
 	if (_sbuf)
 		gl_free(_sbuf);
 }
 
+FrameBuffer *FrameBuffer::createView() const {
+	FrameBuffer *view = new FrameBuffer(*this);
+	view->_isView = true;
+	return view;
+}
+
+void FrameBuffer::enableSimdSpans(bool enable) {
+#ifdef TINYGL_SIMD_SPANS
+	// The span code writes 32-bit pixels with 8-bit color channels
+	_simdSpans = enable && _pbufBpp == 4 &&
+		_pbufFormat.rLoss == 0 && _pbufFormat.gLoss == 0 && _pbufFormat.bLoss == 0 &&
+		(_pbufFormat.aLoss == 0 || _pbufFormat.aLoss == 8);
+#else
+	_simdSpans = false;
+#endif
+}
+
 Buffer *FrameBuffer::genOffscreenBuffer() {
 	Buffer *buf = (Buffer *)gl_malloc(sizeof(Buffer));
 	buf->pbuf = (byte *)gl_zalloc(_pbufHeight * _pbufPitch);
@@ -306,6 +330,12 @@ void getSurfaceRef(Graphics::Surface &surface) {
 	c->fb->getSurfaceRef(surface);
 }
 
+void enableSimdSpans(bool enable) {
+	GLContext *c = gl_get_context();
+	assert(c->fb);
+	c->fb->enableSimdSpans(enable);
+}
+
 Graphics::Surface *copyToBuffer(const Graphics::PixelFormat &dstFormat) {
 	GLContext *c = gl_get_context();
 	assert(c->fb);
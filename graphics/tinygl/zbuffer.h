@@ -35,6 +35,11 @@
 
 #include "common/rect.h"
 
+// Triangle spans can be filled four pixels at a time with SSE2 or NEON
+#if defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define TINYGL_SIMD_SPANS
+#endif
+
 namespace TinyGL {
 
 // Z buffer
@@ -104,6 +109,25 @@ struct FrameBuffer {
 	FrameBuffer(int width, int height, const Graphics::PixelFormat &format, bool enableStencilBuffer);
 	~FrameBuffer();
 
+	/**
+	 * Creates a frame buffer that renders into the same color, depth and stencil
+	 * buffers as this one but keeps its own raster state. Used to rasterize
+	 * disjoint parts of the screen on several threads; the buffers are not freed
+	 * when the view is deleted.
+	 */
+	FrameBuffer *createView() const;
+
+	/**
+	 * Selects whether triangle spans are filled with the SSE2/NEON code paths,
+	 * the default when the build and the pixel format allow it, or with the
+	 * portable ones.
+	 */
+	void enableSimdSpans(bool enable);
+
+	bool simdSpansEnabled() const {
+		return _simdSpans;
+	}
+
 	Graphics::PixelFormat getPixelFormat() {
 		return _pbufFormat;
 	}
@@ -319,6 +343,16 @@ private:
 	template <bool kDepthWrite, bool kEnableScissor, bool kStencilEnabled, bool kDepthTestEnabled>
 	FORCEINLINE void putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &z, int &dzdx);
 
+#ifdef TINYGL_SIMD_SPANS
+	template <bool kDepthWrite, bool kDepthTestEnabled>
+	FORCEINLINE void fillSpanDepth(uint *pz, int count, uint &z, int dzdx);
+
+	template <bool kDepthWrite, bool kTexture, bool kSmoothMode, bool kDepthTestEnabled>
+	FORCEINLINE void fillSpan(int fbOffset, const uint32 *texels, uint *pz, int count,
+	                          uint &z, uint &r, uint &g, uint &b, uint &a,
+	                          int dzdx, int drdx, int dgdx, int dbdx, uint dadx);
+#endif
+
 
 	template <bool kEnableAlphaTest>
 	FORCEINLINE void writePixel(int pixel, int value) {
@@ -496,6 +530,11 @@ public:
 		_enableScissor = false;
 	}
 
+	// Whether the scissor rectangle excludes all the rows from y1 to y2.
+	FORCEINLINE bool scissorRows(int y1, int y2) const {
+		return _enableScissor && (y2 < _clipRectangle.top || y1 >= _clipRectangle.bottom);
+	}
+
 	FORCEINLINE void enableBlending(bool enable) {
 		_blendingEnabled = enable;
 	}
@@ -651,6 +690,8 @@ private:
 
 	uint *_zbuf;
 	byte *_sbuf;
+	bool _isView;
+	bool _simdSpans;
 
 	bool _enableStencil;
 	int _textureSize;
@@ -25,6 +25,7 @@
 
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/worker-pool.h"
 
 namespace TinyGL {
 
@@ -107,6 +108,97 @@ void GLContext::disposeDrawCallLists() {
 	_drawCallsQueue.clear();
 }
 
+namespace {
+enum {
+	kMinTileBandHeight = 16
+};
+
+struct TiledExecutionState {
+	GLContext *context;
+	const Common::Array<Common::Rect> *rectangles;
+	int bandHeight;
+};
+
+void executeDrawCallsInBand(uint index, void *param) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+
+	const TiledExecutionState &state = *(const TiledExecutionState *)param;
+	const Common::Rect &renderRect = state.context->renderRect;
+	const int top = renderRect.top + index * state.bandHeight;
+	if (top >= renderRect.bottom)
+		return;
+	const Common::Rect band(renderRect.left, top, renderRect.right, MIN<int>(top + state.bandHeight, renderRect.bottom));
+
+	Common::Array<Common::Rect> clipRectangles;
+	for (uint i = 0; i < state.rectangles->size(); i++) {
+		Common::Rect clipRectangle = (*state.rectangles)[i].findIntersectingRect(band);
+		if (!clipRectangle.isEmpty())
+			clipRectangles.push_back(clipRectangle);
+	}
+
+	// Replay the whole frame in the band: every pixel sees the same sequence
+	// of operations as with a single thread.
+	GLContext *c = state.context->_tileContexts[index];
+	const Common::List<DrawCall *> &drawCalls = state.context->_drawCallsQueue;
+	for (DrawCallIterator it = drawCalls.begin(); it != drawCalls.end(); ++it) {
+		Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		for (uint i = 0; i < clipRectangles.size(); i++) {
+			if (clipRectangles[i].intersects(drawCallRegion)) {
+				(*it)->execute(c, clipRectangles[i], false);
+			}
+		}
+	}
+}
+} // End of anonymous namespace
+
+bool GLContext::executeDrawCallsTiled(const Common::Array<Common::Rect> &rectangles) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+
+	if (!_enableTiledRendering || render_mode != TGL_RENDER)
+		return false;
+
+	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+		if ((*it)->getType() == DrawCall::DrawCall_Blitting && !((const BlittingDrawCall *)*it)->isClipInvariant())
+			return false;
+	}
+
+	const uint bandCount = MIN<uint>(Common::WorkerPool::instance().getThreadCount() * 2, renderRect.height() / kMinTileBandHeight);
+	if (bandCount < 2)
+		return false;
+
+	while (_tileContexts.size() < bandCount) {
+		GLContext *tileContext = new GLContext();
+		_tileContexts.push_back(tileContext);
+	}
+
+	// The raster state of every draw call is applied when it is executed,
+	// only what the calls do not capture has to be copied.
+	for (uint i = 0; i < bandCount; i++) {
+		GLContext *tileContext = _tileContexts[i];
+		delete tileContext->fb;
+		tileContext->fb = fb->createView();
+		tileContext->renderRect = renderRect;
+		tileContext->_scissorRect = renderRect;
+		tileContext->render_mode = render_mode;
+		tileContext->current_cull_face = current_cull_face;
+	}
+
+	TiledExecutionState state;
+	state.context = this;
+	state.rectangles = &rectangles;
+	state.bandHeight = (renderRect.height() + bandCount - 1) / bandCount;
+	Common::WorkerPool::instance().run(bandCount, executeDrawCallsInBand, &state);
+	return true;
+}
+
+void GLContext::disposeTileContexts() {
+	for (uint i = 0; i < _tileContexts.size(); i++) {
+		delete _tileContexts[i]->fb;
+		delete _tileContexts[i];
+	}
+	_tileContexts.clear();
+}
+
 static inline void _appendDirtyRectangle(const DrawCall &call, Common::List<DirtyRectangle> &rectangles, int r, int g, int b) {
 	Common::Rect dirty_region = call.getDirtyRegion();
 	if (rectangles.empty() || dirty_region != rectangles.back().rectangle)
@@ -188,17 +280,21 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 	}
 
 	if (!rectangles.empty()) {
+		Common::Array<Common::Rect> tiledRectangles;
 		for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
 			dirtyAreas.push_back((*itRect).rectangle);
+			tiledRectangles.push_back((*itRect).rectangle);
 		}
 
 		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+		if (!executeDrawCallsTiled(tiledRectangles)) {
+			for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+					Common::Rect dirtyRegion = (*itRect).rectangle;
+					if (dirtyRegion.intersects(drawCallRegion)) {
+						(*it)->execute(this, dirtyRegion, true);
+					}
 				}
 			}
 		}
@@ -240,8 +336,10 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 
 	dirtyAreas.push_back(Common::Rect(fb->getPixelBufferWidth(), fb->getPixelBufferHeight()));
 
+	const bool tiled = executeDrawCallsTiled(Common::Array<Common::Rect>(1, renderRect));
 	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
+		if (!tiled)
+			(*it)->execute(this, true);
 		delete *it;
 	}
 
@@ -294,8 +392,8 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleFront = c->draw_triangle_front;
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(GLVertex) * _vertexCount);
-	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	_state = captureState(c);
+	if (c->_enableDirtyRectangles || c->_enableTiledRendering) {
 		computeDirtyRegion();
 	}
 }
@@ -333,24 +431,27 @@ void RasterizationDrawCall::computeDirtyRegion() {
 	}
 }
 
-void RasterizationDrawCall::execute(bool restoreState) const {
-	GLContext *c = gl_get_context();
-
+void RasterizationDrawCall::execute(GLContext *c, bool restoreState) const {
 	RasterizationDrawCall::RasterizationState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
 	}
-	applyState(_state);
+	applyState(c, _state);
 
 	GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	// Rasterization modifies the vertices: work on a copy, so that the call
+	// gives the same result every time it is executed for another rectangle.
+	c->_drawCallVertices.resize(_vertexCount);
+	memcpy(c->_drawCallVertices.data(), _vertex, sizeof(GLVertex) * _vertexCount);
+
+	c->vertex = c->_drawCallVertices.data();
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
 
-	int n = c->vertex_n;
+	int n = _vertexCount;
 	int cnt = c->vertex_cnt;
 
 	switch (c->begin_type) {
@@ -429,13 +530,12 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	c->vertex_cnt = prevVertexCount;
 
 	if (restoreState) {
-		applyState(backupState);
+		applyState(c, backupState);
 	}
 }
 
-RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
+RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState(GLContext *c) const {
 	RasterizationState state;
-	GLContext *c = gl_get_context();
 	state.enableBlending = c->blending_enabled;
 	state.sfactor = c->source_blending_factor;
 	state.dfactor = c->destination_blending_factor;
@@ -480,8 +580,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	GLContext *c = gl_get_context();
+void RasterizationDrawCall::applyState(GLContext *c, const RasterizationDrawCall::RasterizationState &state) const {
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableAlphaTest(state.alphaTestEnabled);
@@ -538,10 +637,9 @@ void RasterizationDrawCall::applyState(const RasterizationDrawCall::Rasterizatio
 	memcpy(c->viewport.trans._v, state.viewportTranslation, sizeof(c->viewport.trans._v));
 }
 
-void RasterizationDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	TinyGL::GLContext *c = gl_get_context();
+void RasterizationDrawCall::execute(GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const {
 	c->fb->setScissorRectangle(clippingRectangle);
-	execute(restoreState);
+	execute(c, restoreState);
 	c->fb->resetScissorRectangle();
 }
 
@@ -562,10 +660,11 @@ bool RasterizationDrawCall::operator==(const RasterizationDrawCall &other) const
 
 
 BlittingDrawCall::BlittingDrawCall(BlitImage *image, const BlitTransform &transform, BlittingMode blittingMode) : DrawCall(DrawCall_Blitting), _transform(transform), _mode(blittingMode), _image(image) {
+	GLContext *c = gl_get_context();
 	tglIncBlitImageRef(image);
-	_blitState = captureState();
+	_blitState = captureState(c);
 	_imageVersion = tglGetBlitImageVersion(image);
-	if (gl_get_context()->_enableDirtyRectangles) {
+	if (c->_enableDirtyRectangles || c->_enableTiledRendering) {
 		computeDirtyRegion();
 	}
 }
@@ -574,43 +673,57 @@ BlittingDrawCall::~BlittingDrawCall() {
 	tglDeleteBlitImage(_image);
 }
 
-void BlittingDrawCall::execute(bool restoreState) const {
+void BlittingDrawCall::execute(GLContext *c, bool restoreState) const {
 	BlittingState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
 	}
-	applyState(_blitState);
+	applyState(c, _blitState);
 
 	switch (_mode) {
 	case BlittingDrawCall::BlitMode_Regular:
-		Internal::tglBlit(_image, _transform);
+		Internal::tglBlit(c, _image, _transform);
 		break;
 	case BlittingDrawCall::BlitMode_NoBlend:
-		Internal::tglBlitNoBlend(_image, _transform);
+		Internal::tglBlitNoBlend(c, _image, _transform);
 		break;
 	case BlittingDrawCall::BlitMode_Fast:
-		Internal::tglBlitFast(_image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
+		Internal::tglBlitFast(c, _image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
 		break;
 	case BlittingDrawCall::BlitMode_ZBuffer:
-		Internal::tglBlitZBuffer(_image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
+		Internal::tglBlitZBuffer(c, _image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
 		break;
 	default:
 		break;
 	}
 	if (restoreState) {
-		applyState(backupState);
+		applyState(c, backupState);
 	}
 }
 
-void BlittingDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	Internal::tglBlitSetScissorRect(clippingRectangle);
-	execute(restoreState);
-	Internal::tglBlitResetScissorRect();
+void BlittingDrawCall::execute(GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const {
+	Internal::tglBlitSetScissorRect(c, clippingRectangle);
+	execute(c, restoreState);
+	Internal::tglBlitResetScissorRect(c);
 }
 
-BlittingDrawCall::BlittingState BlittingDrawCall::captureState() const {
+bool BlittingDrawCall::isClipInvariant() const {
+	switch (_mode) {
+	case BlittingDrawCall::BlitMode_Fast:
+	case BlittingDrawCall::BlitMode_ZBuffer:
+		return true;
+	case BlittingDrawCall::BlitMode_Regular:
+		// Flipped, scaled and rotated blits derive their source coordinates
+		// from the size of the clipped destination.
+		return !_transform._flipHorizontally && !_transform._flipVertically && _transform._rotation == 0 &&
+		       _transform._destinationRectangle.width() == 0 && _transform._destinationRectangle.height() == 0;
+	default:
+		return false;
+	}
+}
+
+BlittingDrawCall::BlittingState BlittingDrawCall::captureState(GLContext *c) const {
 	BlittingState state;
-	TinyGL::GLContext *c = gl_get_context();
 	state.enableBlending = c->blending_enabled;
 	state.sfactor = c->source_blending_factor;
 	state.dfactor = c->destination_blending_factor;
@@ -621,8 +734,7 @@ BlittingDrawCall::BlittingState BlittingDrawCall::captureState() const {
 	return state;
 }
 
-void BlittingDrawCall::applyState(const BlittingState &state) const {
-	TinyGL::GLContext *c = gl_get_context();
+void BlittingDrawCall::applyState(GLContext *c, const BlittingState &state) const {
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableAlphaTest(state.alphaTest);
@@ -685,18 +797,16 @@ ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue,
 	  _rValue(rValue), _gValue(gValue), _bValue(bValue), _clearStencilBuffer(clearStencilBuffer),
 	  _stencilValue(stencilValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = gl_get_context();
-	if (c->_enableDirtyRectangles) {
+	if (c->_enableDirtyRectangles || c->_enableTiledRendering) {
 		_dirtyRegion = c->renderRect;
 	}
 }
 
-void ClearBufferDrawCall::execute(bool restoreState) const {
-	TinyGL::GLContext *c = gl_get_context();
+void ClearBufferDrawCall::execute(GLContext *c, bool restoreState) const {
 	c->fb->clear(_clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue, _clearStencilBuffer, _stencilValue);
 }
 
-void ClearBufferDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	TinyGL::GLContext *c = gl_get_context();
+void ClearBufferDrawCall::execute(GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const {
 	Common::Rect clearRect = clippingRectangle.findIntersectingRect(getDirtyRegion());
 	c->fb->clearRegion(clearRect.left, clearRect.top, clearRect.width(), clearRect.height(),
 	                   _clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue,
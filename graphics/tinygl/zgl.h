@@ -434,6 +434,13 @@ struct GLContext {
 	LinearAllocator _drawCallAllocator[2];
 	bool _debugRectsEnabled;
 
+	// Tiled rendering: draw calls are replayed on several threads, each one
+	// rasterizing a horizontal band of the screen through its own context.
+	bool _enableTiledRendering;
+	Common::Array<GLContext *> _tileContexts;
+	// Scratch copy of the vertices of the draw call being executed.
+	Common::Array<GLVertex> _drawCallVertices;
+
 	void gl_vertex_transform(GLVertex *v);
 
 public:
@@ -482,6 +489,8 @@ public:
 
 	void presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas);
 	void presentBufferSimple(Common::List<Common::Rect> &dirtyAreas);
+	bool executeDrawCallsTiled(const Common::Array<Common::Rect> &rectangles);
+	void disposeTileContexts();
 
 	void debugDrawRectangle(Common::Rect rect, int r, int g, int b);
 
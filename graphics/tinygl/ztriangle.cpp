@@ -30,6 +30,12 @@
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 namespace TinyGL {
 
 static const int NB_INTERP = 8;
@@ -147,6 +153,253 @@ FORCEINLINE void FrameBuffer::putPixelDepth(uint *pz, byte *ps, int _a, int x, i
 	z += dzdx;
 }
 
+#ifdef TINYGL_SIMD_SPANS
+
+// Four 32-bit lanes, holding depths, color channels or pixels of a span
+
+#if defined(__SSE2__)
+
+typedef __m128i SpanVector;
+
+static FORCEINLINE SpanVector spanLoad(const uint32 *src) {
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+static FORCEINLINE void spanStore(uint32 *dst, SpanVector v) {
+	_mm_storeu_si128((__m128i *)dst, v);
+}
+
+static FORCEINLINE SpanVector spanSplat(uint32 v) {
+	return _mm_set1_epi32((int)v);
+}
+
+static FORCEINLINE SpanVector spanRamp(uint32 v, uint32 step) {
+	return _mm_setr_epi32((int)v, (int)(v + step), (int)(v + 2 * step), (int)(v + 3 * step));
+}
+
+static FORCEINLINE SpanVector spanAdd(SpanVector a, SpanVector b) {
+	return _mm_add_epi32(a, b);
+}
+
+static FORCEINLINE SpanVector spanAnd(SpanVector a, SpanVector b) {
+	return _mm_and_si128(a, b);
+}
+
+static FORCEINLINE SpanVector spanOr(SpanVector a, SpanVector b) {
+	return _mm_or_si128(a, b);
+}
+
+static FORCEINLINE SpanVector spanNot(SpanVector v) {
+	return _mm_xor_si128(v, _mm_set1_epi32(-1));
+}
+
+// The lanes of a where mask is set, the ones of b elsewhere
+static FORCEINLINE SpanVector spanSelect(SpanVector mask, SpanVector a, SpanVector b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static FORCEINLINE SpanVector spanShiftLeft(SpanVector v, int count) {
+	return _mm_sll_epi32(v, _mm_cvtsi32_si128(count));
+}
+
+static FORCEINLINE SpanVector spanShiftRight(SpanVector v, int count) {
+	return _mm_srl_epi32(v, _mm_cvtsi32_si128(count));
+}
+
+// Unsigned a < b
+static FORCEINLINE SpanVector spanLess(SpanVector a, SpanVector b) {
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	return _mm_cmplt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
+
+static FORCEINLINE SpanVector spanEqual(SpanVector a, SpanVector b) {
+	return _mm_cmpeq_epi32(a, b);
+}
+
+// The low 16 bits of a * b, for lanes of a that fit in 16 bits
+static FORCEINLINE SpanVector spanMulLow16(SpanVector a, SpanVector b) {
+	return _mm_mullo_epi16(a, b);
+}
+
+#else
+
+typedef uint32x4_t SpanVector;
+
+static FORCEINLINE SpanVector spanLoad(const uint32 *src) {
+	return vld1q_u32(src);
+}
+
+static FORCEINLINE void spanStore(uint32 *dst, SpanVector v) {
+	vst1q_u32(dst, v);
+}
+
+static FORCEINLINE SpanVector spanSplat(uint32 v) {
+	return vdupq_n_u32(v);
+}
+
+static FORCEINLINE SpanVector spanRamp(uint32 v, uint32 step) {
+	const uint32 lanes[4] = { v, v + step, v + 2 * step, v + 3 * step };
+	return vld1q_u32(lanes);
+}
+
+static FORCEINLINE SpanVector spanAdd(SpanVector a, SpanVector b) {
+	return vaddq_u32(a, b);
+}
+
+static FORCEINLINE SpanVector spanAnd(SpanVector a, SpanVector b) {
+	return vandq_u32(a, b);
+}
+
+static FORCEINLINE SpanVector spanOr(SpanVector a, SpanVector b) {
+	return vorrq_u32(a, b);
+}
+
+static FORCEINLINE SpanVector spanNot(SpanVector v) {
+	return vmvnq_u32(v);
+}
+
+// The lanes of a where mask is set, the ones of b elsewhere
+static FORCEINLINE SpanVector spanSelect(SpanVector mask, SpanVector a, SpanVector b) {
+	return vbslq_u32(mask, a, b);
+}
+
+static FORCEINLINE SpanVector spanShiftLeft(SpanVector v, int count) {
+	return vshlq_u32(v, vdupq_n_s32(count));
+}
+
+static FORCEINLINE SpanVector spanShiftRight(SpanVector v, int count) {
+	return vshlq_u32(v, vdupq_n_s32(-count));
+}
+
+// Unsigned a < b
+static FORCEINLINE SpanVector spanLess(SpanVector a, SpanVector b) {
+	return vcltq_u32(a, b);
+}
+
+static FORCEINLINE SpanVector spanEqual(SpanVector a, SpanVector b) {
+	return vceqq_u32(a, b);
+}
+
+// The low 16 bits of a * b, for lanes of a that fit in 16 bits
+static FORCEINLINE SpanVector spanMulLow16(SpanVector a, SpanVector b) {
+	return vreinterpretq_u32_u16(vmulq_u16(vreinterpretq_u16_u32(a), vreinterpretq_u16_u32(b)));
+}
+
+#endif
+
+// Same comparisons as FrameBuffer::compareDepth
+static FORCEINLINE SpanVector spanDepthTest(int depthFunc, SpanVector zSrc, SpanVector zDst) {
+	switch (depthFunc) {
+	case TGL_LESS:
+		return spanLess(zDst, zSrc);
+	case TGL_EQUAL:
+		return spanEqual(zDst, zSrc);
+	case TGL_LEQUAL:
+		return spanNot(spanLess(zSrc, zDst));
+	case TGL_GREATER:
+		return spanLess(zSrc, zDst);
+	case TGL_NOTEQUAL:
+		return spanNot(spanEqual(zDst, zSrc));
+	case TGL_GEQUAL:
+		return spanNot(spanLess(zDst, zSrc));
+	case TGL_ALWAYS:
+		return spanSplat(0xFFFFFFFF);
+	default:
+		return spanSplat(0);
+	}
+}
+
+// Does the same as putPixelDepth without scissor and stencil, for count pixels
+// (a multiple of 4)
+template <bool kDepthWrite, bool kDepthTestEnabled>
+FORCEINLINE void FrameBuffer::fillSpanDepth(uint *pz, int count, uint &z, int dzdx) {
+	if (kDepthWrite) {
+		SpanVector vz = spanRamp(z, dzdx);
+		const SpanVector vdz = spanSplat(4 * (uint)dzdx);
+		for (int i = 0; i < count; i += 4) {
+			const SpanVector zDst = spanLoad(pz + i);
+			if (kDepthTestEnabled) {
+				spanStore(pz + i, spanSelect(spanDepthTest(_depthFunc, vz, zDst), vz, zDst));
+			} else {
+				spanStore(pz + i, vz);
+			}
+			vz = spanAdd(vz, vdz);
+		}
+	}
+	z += (uint)count * (uint)dzdx;
+}
+
+// Does the same as putPixelNoTexture, or putPixelTexture in lights mode with
+// the texels fetched beforehand, without alpha test, scissor, blending and
+// stencil, for count pixels (a multiple of 4)
+template <bool kDepthWrite, bool kTexture, bool kSmoothMode, bool kDepthTestEnabled>
+FORCEINLINE void FrameBuffer::fillSpan(int fbOffset, const uint32 *texels, uint *pz, int count,
+                                       uint &z, uint &r, uint &g, uint &b, uint &a,
+                                       int dzdx, int drdx, int dgdx, int dbdx, uint dadx) {
+	uint32 *pp = (uint32 *)_pbuf.getRawBuffer(fbOffset);
+	const SpanVector channelMask = spanSplat(0xFF);
+	const SpanVector alphaMask = spanSplat(_pbufFormat.aLoss == 0 ? 0xFF : 0);
+	const int rShift = _pbufFormat.rShift, gShift = _pbufFormat.gShift;
+	const int bShift = _pbufFormat.bShift, aShift = _pbufFormat.aShift;
+
+	SpanVector vz = spanRamp(z, dzdx);
+	SpanVector vr = spanRamp(r, kSmoothMode ? drdx : 0);
+	SpanVector vg = spanRamp(g, kSmoothMode ? dgdx : 0);
+	SpanVector vb = spanRamp(b, kSmoothMode ? dbdx : 0);
+	SpanVector va = spanRamp(a, kSmoothMode ? dadx : 0);
+	const SpanVector vdz = spanSplat(4 * (uint)dzdx);
+	const SpanVector vdr = spanSplat(4 * (uint)drdx);
+	const SpanVector vdg = spanSplat(4 * (uint)dgdx);
+	const SpanVector vdb = spanSplat(4 * (uint)dbdx);
+	const SpanVector vda = spanSplat(4 * dadx);
+
+	for (int i = 0; i < count; i += 4) {
+		const SpanVector zDst = spanLoad(pz + i);
+		const SpanVector pass = kDepthTestEnabled ? spanDepthTest(_depthFunc, vz, zDst) : spanSplat(0xFFFFFFFF);
+
+		SpanVector cr, cg, cb, ca;
+		if (kTexture) {
+			// (c * l) >> 8, truncated to 8 bits, only depends on the low 16 bits of the product
+			const SpanVector texel = spanLoad(texels + i);
+			cr = spanShiftRight(spanMulLow16(spanAnd(spanShiftRight(texel, 16), channelMask), spanShiftRight(vr, 8)), 8);
+			cg = spanShiftRight(spanMulLow16(spanAnd(spanShiftRight(texel, 8), channelMask), spanShiftRight(vg, 8)), 8);
+			cb = spanShiftRight(spanMulLow16(spanAnd(texel, channelMask), spanShiftRight(vb, 8)), 8);
+			ca = spanShiftRight(spanMulLow16(spanShiftRight(texel, 24), spanShiftRight(va, 8)), 8);
+		} else {
+			cr = spanAnd(spanShiftRight(vr, 8), channelMask);
+			cg = spanAnd(spanShiftRight(vg, 8), channelMask);
+			cb = spanAnd(spanShiftRight(vb, 8), channelMask);
+			ca = spanAnd(spanShiftRight(va, 8), channelMask);
+		}
+		const SpanVector color = spanOr(
+			spanOr(spanShiftLeft(cr, rShift), spanShiftLeft(cg, gShift)),
+			spanOr(spanShiftLeft(cb, bShift), spanShiftLeft(spanAnd(ca, alphaMask), aShift)));
+
+		spanStore(pp + i, spanSelect(pass, color, spanLoad(pp + i)));
+		if (kDepthWrite) {
+			spanStore(pz + i, spanSelect(pass, vz, zDst));
+		}
+
+		vz = spanAdd(vz, vdz);
+		if (kSmoothMode) {
+			vr = spanAdd(vr, vdr);
+			vg = spanAdd(vg, vdg);
+			vb = spanAdd(vb, vdb);
+			va = spanAdd(va, vda);
+		}
+	}
+
+	z += (uint)count * (uint)dzdx;
+	if (kSmoothMode) {
+		r += (uint)count * (uint)drdx;
+		g += (uint)count * (uint)dgdx;
+		b += (uint)count * (uint)dbdx;
+		a += (uint)count * dadx;
+	}
+}
+
+#endif
+
 template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, int kSmoothMode,
           bool kDepthWrite, bool kAlphaTestEnabled, bool kEnableScissor, bool kBlendingEnabled,
           bool kStencilEnabled, bool kDepthTestEnabled>
@@ -395,7 +648,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			if (!kInterpRGB) {
+			if (_enableScissor && (y < _clipRectangle.top || y >= _clipRectangle.bottom)) {
+				// the scan line is scissored out: only step the edges
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
@@ -408,6 +663,15 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				if (kStencilEnabled) {
 					ps = ps1 + x1;
 				}
+#ifdef TINYGL_SIMD_SPANS
+				if (kInterpZ && !kEnableScissor && !kStencilEnabled && _simdSpans && n >= 3) {
+					const int count = (n + 1) & ~3;
+					fillSpanDepth<kDepthWrite, kDepthTestEnabled>(pz, count, z, dzdx);
+					pz += count;
+					n -= count;
+					x += count;
+				}
+#endif
 				while (n >= 3) {
 					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kDepthTestEnabled>(pz, ps, 0, x, y, z, dzdx);
 					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kDepthTestEnabled>(pz, ps, 1, x, y, z, dzdx);
@@ -451,6 +715,16 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				if (kStencilEnabled) {
 					ps = ps1 + x1;
 				}
+#ifdef TINYGL_SIMD_SPANS
+				if (kInterpZ && !kAlphaTestEnabled && !kEnableScissor && !kBlendingEnabled && !kStencilEnabled && _simdSpans && n >= 3) {
+					const int count = (n + 1) & ~3;
+					fillSpan<kDepthWrite, false, kSmoothMode, kDepthTestEnabled>(pp, nullptr, pz, count, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
+					pp += count;
+					pz += count;
+					n -= count;
+					x += count;
+				}
+#endif
 				while (n >= 3) {
 					putPixelNoTexture<kDepthWrite, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>(pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
 					putPixelNoTexture<kDepthWrite, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>(pp, pz, ps, 1, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
@@ -517,9 +791,18 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						fz += fndzdx;
 						zinv = (float)(1.0 / fz);
 					}
-					for (int _a = 0; _a < NB_INTERP; _a++) {
-						putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-						               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+#ifdef TINYGL_SIMD_SPANS
+					if (kInterpZ && !kAlphaTestEnabled && !kEnableScissor && !kBlendingEnabled && !kStencilEnabled && _simdSpans) {
+						uint32 texels[NB_INTERP];
+						texture->getARGBSpan(_wrapS, _wrapT, s, t, dsdx, dtdx, NB_INTERP, texels);
+						fillSpan<kDepthWrite, true, kSmoothMode, kDepthTestEnabled>(pp, texels, pz, NB_INTERP, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
+					} else
+#endif
+					{
+						for (int _a = 0; _a < NB_INTERP; _a++) {
+							putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+							               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+						}
 					}
 					pp += NB_INTERP;
 					if (kInterpZ) {
@@ -643,7 +926,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 
 template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, int kSmoothMode, bool kDepthWrite, bool kEnableAlphaTest>
 void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2) {
-	if (_enableScissor) {
+	// Scan lines outside of the scissor rectangle are always skipped, the
+	// pixels only need to be tested when it does not span the whole width.
+	if (_enableScissor && (_clipRectangle.left > 0 || _clipRectangle.right < _pbufWidth)) {
 		fillTriangle<kInterpRGB, kInterpZ, kInterpST, kInterpSTZ, kSmoothMode, kDepthWrite, kEnableAlphaTest, true>(p0, p1, p2);
 	} else {
 		fillTriangle<kInterpRGB, kInterpZ, kInterpST, kInterpSTZ, kSmoothMode, kDepthWrite, kEnableAlphaTest, false>(p0, p1, p2);
@@ -32,6 +32,16 @@
 #include "graphics/transparent_surface.h"
 #include "graphics/transform_tools.h"
 
+// The SIMD blitters work on four pixels at a time. They only handle the byte
+// order of little endian systems, where the alpha channel is the first byte.
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define TRANSPARENT_SURFACE_SIMD
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(SCUMM_LITTLE_ENDIAN)
+#include <arm_neon.h>
+#define TRANSPARENT_SURFACE_SIMD
+#endif
+
 namespace Graphics {
 
 static const int kBModShift = 8;//img->format.bShift;
@@ -76,10 +86,296 @@ TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Sur
 	}
 }
 
+static bool s_simdBlits = true;
+
+void TransparentSurface::enableSimd(bool enable) {
+	s_simdBlits = enable;
+}
+
+bool TransparentSurface::isSimdEnabled() {
+#ifdef TRANSPARENT_SURFACE_SIMD
+	return s_simdBlits;
+#else
+	return false;
+#endif
+}
+
+#ifdef TRANSPARENT_SURFACE_SIMD
+
+#if defined(__SSE2__)
+
+// Four pixels, and the channels of two pixels in 16-bit lanes
+typedef __m128i PixelVector;
+typedef __m128i ChannelVector;
+
+static FORCEINLINE PixelVector pixelLoad(const byte *src) {
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+// The four pixels ending at src, in reverse order
+static FORCEINLINE PixelVector pixelLoadReversed(const byte *src) {
+	return _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(src - 12)), _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static FORCEINLINE void pixelStore(byte *dst, PixelVector v) {
+	_mm_storeu_si128((__m128i *)dst, v);
+}
+
+static FORCEINLINE PixelVector pixelSplat(uint32 v) {
+	return _mm_set1_epi32((int)v);
+}
+
+static FORCEINLINE PixelVector pixelAnd(PixelVector a, PixelVector b) {
+	return _mm_and_si128(a, b);
+}
+
+static FORCEINLINE PixelVector pixelOr(PixelVector a, PixelVector b) {
+	return _mm_or_si128(a, b);
+}
+
+// The pixels of a where the mask is set, those of b elsewhere
+static FORCEINLINE PixelVector pixelSelect(PixelVector mask, PixelVector a, PixelVector b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// All bits set in the pixels which are zero
+static FORCEINLINE PixelVector pixelIsZero(PixelVector v) {
+	return _mm_cmpeq_epi32(v, _mm_setzero_si128());
+}
+
+static FORCEINLINE bool pixelAllSet(PixelVector mask) {
+	return _mm_movemask_epi8(mask) == 0xFFFF;
+}
+
+// Every byte of each pixel set to its alpha value
+static FORCEINLINE PixelVector pixelSpreadAlpha(PixelVector v) {
+	v = _mm_and_si128(v, _mm_set1_epi32(0xFF));
+	v = _mm_or_si128(v, _mm_slli_epi32(v, 8));
+	return _mm_or_si128(v, _mm_slli_epi32(v, 16));
+}
+
+static FORCEINLINE ChannelVector channelsLow(PixelVector v) {
+	return _mm_unpacklo_epi8(v, _mm_setzero_si128());
+}
+
+static FORCEINLINE ChannelVector channelsHigh(PixelVector v) {
+	return _mm_unpackhi_epi8(v, _mm_setzero_si128());
+}
+
+// The channels are at most 255 here, so they are packed without saturating
+static FORCEINLINE PixelVector channelsPack(ChannelVector low, ChannelVector high) {
+	return _mm_packus_epi16(low, high);
+}
+
+static FORCEINLINE ChannelVector channelSplat4(uint16 c0, uint16 c1, uint16 c2, uint16 c3) {
+	return _mm_setr_epi16(c0, c1, c2, c3, c0, c1, c2, c3);
+}
+
+static FORCEINLINE ChannelVector channelAdd(ChannelVector a, ChannelVector b) {
+	return _mm_add_epi16(a, b);
+}
+
+static FORCEINLINE ChannelVector channelSub(ChannelVector a, ChannelVector b) {
+	return _mm_sub_epi16(a, b);
+}
+
+static FORCEINLINE ChannelVector channelMul(ChannelVector a, ChannelVector b) {
+	return _mm_mullo_epi16(a, b);
+}
+
+// (a * b) >> 16
+static FORCEINLINE ChannelVector channelMulHigh(ChannelVector a, ChannelVector b) {
+	return _mm_mulhi_epu16(a, b);
+}
+
+static FORCEINLINE ChannelVector channelShift8(ChannelVector v) {
+	return _mm_srli_epi16(v, 8);
+}
+
+#else
+
+typedef uint32x4_t PixelVector;
+typedef uint16x8_t ChannelVector;
+
+static FORCEINLINE PixelVector pixelLoad(const byte *src) {
+	return vreinterpretq_u32_u8(vld1q_u8(src));
+}
+
+// The four pixels ending at src, in reverse order
+static FORCEINLINE PixelVector pixelLoadReversed(const byte *src) {
+	const uint32x4_t v = vrev64q_u32(pixelLoad(src - 12));
+	return vcombine_u32(vget_high_u32(v), vget_low_u32(v));
+}
+
+static FORCEINLINE void pixelStore(byte *dst, PixelVector v) {
+	vst1q_u8(dst, vreinterpretq_u8_u32(v));
+}
+
+static FORCEINLINE PixelVector pixelSplat(uint32 v) {
+	return vdupq_n_u32(v);
+}
+
+static FORCEINLINE PixelVector pixelAnd(PixelVector a, PixelVector b) {
+	return vandq_u32(a, b);
+}
+
+static FORCEINLINE PixelVector pixelOr(PixelVector a, PixelVector b) {
+	return vorrq_u32(a, b);
+}
+
+// The pixels of a where the mask is set, those of b elsewhere
+static FORCEINLINE PixelVector pixelSelect(PixelVector mask, PixelVector a, PixelVector b) {
+	return vbslq_u32(mask, a, b);
+}
+
+// All bits set in the pixels which are zero
+static FORCEINLINE PixelVector pixelIsZero(PixelVector v) {
+	return vceqq_u32(v, vdupq_n_u32(0));
+}
+
+static FORCEINLINE bool pixelAllSet(PixelVector mask) {
+	const uint32x2_t m = vand_u32(vget_low_u32(mask), vget_high_u32(mask));
+	return (vget_lane_u32(m, 0) & vget_lane_u32(m, 1)) == 0xFFFFFFFF;
+}
+
+// Every byte of each pixel set to its alpha value
+static FORCEINLINE PixelVector pixelSpreadAlpha(PixelVector v) {
+	return vmulq_n_u32(vandq_u32(v, vdupq_n_u32(0xFF)), 0x01010101);
+}
+
+static FORCEINLINE ChannelVector channelsLow(PixelVector v) {
+	return vmovl_u8(vget_low_u8(vreinterpretq_u8_u32(v)));
+}
+
+static FORCEINLINE ChannelVector channelsHigh(PixelVector v) {
+	return vmovl_u8(vget_high_u8(vreinterpretq_u8_u32(v)));
+}
+
+// The channels are at most 255 here, so they are packed without saturating
+static FORCEINLINE PixelVector channelsPack(ChannelVector low, ChannelVector high) {
+	return vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+}
+
+static FORCEINLINE ChannelVector channelSplat4(uint16 c0, uint16 c1, uint16 c2, uint16 c3) {
+	const uint16 channels[8] = { c0, c1, c2, c3, c0, c1, c2, c3 };
+	return vld1q_u16(channels);
+}
+
+static FORCEINLINE ChannelVector channelAdd(ChannelVector a, ChannelVector b) {
+	return vaddq_u16(a, b);
+}
+
+static FORCEINLINE ChannelVector channelSub(ChannelVector a, ChannelVector b) {
+	return vsubq_u16(a, b);
+}
+
+static FORCEINLINE ChannelVector channelMul(ChannelVector a, ChannelVector b) {
+	return vmulq_u16(a, b);
+}
+
+// (a * b) >> 16
+static FORCEINLINE ChannelVector channelMulHigh(ChannelVector a, ChannelVector b) {
+	const uint32x4_t low = vmull_u16(vget_low_u16(a), vget_low_u16(b));
+	const uint32x4_t high = vmull_u16(vget_high_u16(a), vget_high_u16(b));
+	return vcombine_u16(vshrn_n_u32(low, 16), vshrn_n_u32(high, 16));
+}
+
+static FORCEINLINE ChannelVector channelShift8(ChannelVector v) {
+	return vshrq_n_u16(v, 8);
+}
+
+#endif
+
+static FORCEINLINE PixelVector loadPixels(const byte *in, int32 inStep) {
+	return (inStep > 0) ? pixelLoad(in) : pixelLoadReversed(in);
+}
+
+/**
+ * The row blitters below handle as many groups of four pixels as fit in the
+ * row, with exactly the results of the per-pixel loops of the doBlit*()
+ * functions, and return the number of pixels they blitted.
+ */
+
+static uint32 blitRowOpaqueSimd(const byte *in, byte *out, uint32 width, int32 inStep) {
+	const PixelVector alpha = pixelSplat(0xFF);
+	uint32 x = 0;
+	for (; x + 4 <= width; x += 4, in += inStep * 4, out += 16)
+		pixelStore(out, pixelOr(loadPixels(in, inStep), alpha));
+	return x;
+}
+
+static uint32 blitRowBinarySimd(const byte *in, byte *out, uint32 width, int32 inStep) {
+	const PixelVector alpha = pixelSplat(0xFF);
+	uint32 x = 0;
+	for (; x + 4 <= width; x += 4, in += inStep * 4, out += 16) {
+		const PixelVector src = loadPixels(in, inStep);
+		const PixelVector transparent = pixelIsZero(pixelAnd(src, alpha));
+		if (pixelAllSet(transparent))
+			continue;
+		pixelStore(out, pixelSelect(transparent, pixelLoad(out), pixelOr(src, alpha)));
+	}
+	return x;
+}
+
+// out = (in * a + out * (255 - a)) >> 8 for each channel of the pixels with a != 0
+static uint32 blitRowAlphaSimd(const byte *in, byte *out, uint32 width, int32 inStep) {
+	const PixelVector alphaMask = pixelSplat(0xFF);
+	const ChannelVector full = channelSplat4(255, 255, 255, 255);
+	uint32 x = 0;
+	for (; x + 4 <= width; x += 4, in += inStep * 4, out += 16) {
+		const PixelVector src = loadPixels(in, inStep);
+		const PixelVector transparent = pixelIsZero(pixelAnd(src, alphaMask));
+		if (pixelAllSet(transparent))
+			continue;
+
+		const PixelVector dst = pixelLoad(out);
+		const PixelVector alpha = pixelSpreadAlpha(src);
+		const ChannelVector alphaLow = channelsLow(alpha), alphaHigh = channelsHigh(alpha);
+		const ChannelVector low = channelShift8(channelAdd(channelMul(channelsLow(src), alphaLow),
+				channelMul(channelsLow(dst), channelSub(full, alphaLow))));
+		const ChannelVector high = channelShift8(channelAdd(channelMul(channelsHigh(src), alphaHigh),
+				channelMul(channelsHigh(dst), channelSub(full, alphaHigh))));
+		pixelStore(out, pixelSelect(transparent, dst, pixelOr(channelsPack(low, high), alphaMask)));
+	}
+	return x;
+}
+
+// With ina = a * ca >> 8, out = (out * (255 - ina) >> 8) + (in * ina * c >> 16) for
+// each channel of the pixels with ina != 0
+static uint32 blitRowTintedAlphaSimd(const byte *in, byte *out, uint32 width, int32 inStep, uint32 color) {
+	const PixelVector alphaMask = pixelSplat(0xFF);
+	const ChannelVector full = channelSplat4(255, 255, 255, 255);
+	const uint16 ca = (color >> kAModShift) & 0xFF;
+	const ChannelVector colorAlpha = channelSplat4(ca, ca, ca, ca);
+	// The channels of a pixel are in the order of the bytes, alpha first
+	const ChannelVector tint = channelSplat4(0, (color >> kBModShift) & 0xFF, (color >> kGModShift) & 0xFF, (color >> kRModShift) & 0xFF);
+	uint32 x = 0;
+	for (; x + 4 <= width; x += 4, in += inStep * 4, out += 16) {
+		const PixelVector src = loadPixels(in, inStep);
+		const PixelVector alpha = pixelSpreadAlpha(src);
+		const ChannelVector alphaLow = channelShift8(channelMul(channelsLow(alpha), colorAlpha));
+		const ChannelVector alphaHigh = channelShift8(channelMul(channelsHigh(alpha), colorAlpha));
+		const PixelVector transparent = pixelIsZero(channelsPack(alphaLow, alphaHigh));
+		if (pixelAllSet(transparent))
+			continue;
+
+		const PixelVector dst = pixelLoad(out);
+		const ChannelVector low = channelAdd(channelShift8(channelMul(channelsLow(dst), channelSub(full, alphaLow))),
+				channelMulHigh(channelMul(channelsLow(src), alphaLow), tint));
+		const ChannelVector high = channelAdd(channelShift8(channelMul(channelsHigh(dst), channelSub(full, alphaHigh))),
+				channelMulHigh(channelMul(channelsHigh(src), alphaHigh), tint));
+		pixelStore(out, pixelSelect(transparent, dst, pixelOr(channelsPack(low, high), alphaMask)));
+	}
+	return x;
+}
+
+#endif
+
 /**
  * Optimized version of doBlit to be used w/opaque blitting (no alpha).
  */
-void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+template<bool simd>
+static void doBlitOpaqueFastImpl(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
 
 	byte *in;
 	byte *out;
@@ -87,20 +383,49 @@ void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	for (uint32 i = 0; i < height; i++) {
 		out = outo;
 		in = ino;
-		memcpy(out, in, width * 4);
-		for (uint32 j = 0; j < width; j++) {
-			out[kAIndex] = 0xFF;
-			out += 4;
+		uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+		if (simd) {
+			j = blitRowOpaqueSimd(in, out, width, inStep);
+			in += (int32)j * inStep;
+			out += j * 4;
+		}
+#endif
+		if (inStep == 4) {
+			memcpy(out, in, (width - j) * 4);
+			for (; j < width; j++) {
+				out[kAIndex] = 0xFF;
+				out += 4;
+			}
+		} else {
+			// Flipped horizontally
+			for (; j < width; j++) {
+				*(uint32 *)out = *(const uint32 *)in;
+				out[kAIndex] = 0xFF;
+				out += 4;
+				in += inStep;
+			}
 		}
 		outo += pitch;
 		ino += inoStep;
 	}
 }
 
+void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+#ifdef TRANSPARENT_SURFACE_SIMD
+	if (s_simdBlits) {
+		doBlitOpaqueFastImpl<true>(ino, outo, width, height, pitch, inStep, inoStep);
+		return;
+	}
+#endif
+	doBlitOpaqueFastImpl<false>(ino, outo, width, height, pitch, inStep, inoStep);
+}
+
 /**
  * Optimized version of doBlit to be used w/binary blitting (blit or no-blit, no blending).
  */
-void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+template<bool simd>
+static void doBlitBinaryFastImpl(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
 
 	byte *in;
 	byte *out;
@@ -108,7 +433,15 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	for (uint32 i = 0; i < height; i++) {
 		out = outo;
 		in = ino;
-		for (uint32 j = 0; j < width; j++) {
+		uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+		if (simd) {
+			j = blitRowBinarySimd(in, out, width, inStep);
+			in += (int32)j * inStep;
+			out += j * 4;
+		}
+#endif
+		for (; j < width; j++) {
 			uint32 pix = *(uint32 *)in;
 			int a = in[kAIndex];
 
@@ -124,6 +457,16 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	}
 }
 
+void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+#ifdef TRANSPARENT_SURFACE_SIMD
+	if (s_simdBlits) {
+		doBlitBinaryFastImpl<true>(ino, outo, width, height, pitch, inStep, inoStep);
+		return;
+	}
+#endif
+	doBlitBinaryFastImpl<false>(ino, outo, width, height, pitch, inStep, inoStep);
+}
+
 /**
  * Optimized version of doBlit to be used with alpha blended blitting
  * @param ino a pointer to the input surface
@@ -135,7 +478,8 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * @inoStep width in bytes of every row on the *input* surface / kind of like pitch
  * @color colormod in 0xAARRGGBB format - 0xFFFFFFFF for no colormod
  */
-void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+template<bool simd>
+static void doBlitAlphaBlendImpl(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
 	byte *in;
 	byte *out;
 
@@ -144,7 +488,15 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+			if (simd) {
+				j = blitRowAlphaSimd(in, out, width, inStep);
+				in += (int32)j * inStep;
+				out += j * 4;
+			}
+#endif
+			for (; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kAIndex] = 255;
@@ -169,7 +521,15 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+			if (simd) {
+				j = blitRowTintedAlphaSimd(in, out, width, inStep, color);
+				in += (int32)j * inStep;
+				out += j * 4;
+			}
+#endif
+			for (; j < width; j++) {
 
 				uint32 ina = in[kAIndex] * ca >> 8;
 
@@ -193,6 +553,16 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	}
 }
 
+void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+#ifdef TRANSPARENT_SURFACE_SIMD
+	if (s_simdBlits) {
+		doBlitAlphaBlendImpl<true>(ino, outo, width, height, pitch, inStep, inoStep, color);
+		return;
+	}
+#endif
+	doBlitAlphaBlendImpl<false>(ino, outo, width, height, pitch, inStep, inoStep, color);
+}
+
 /**
  * Optimized version of doBlit to be used with additive blended blitting
  */
@@ -166,6 +166,16 @@ struct TransparentSurface : public Graphics::Surface {
 
 	AlphaType getAlphaMode() const;
 	void setAlphaMode(AlphaType);
+
+	/**
+	 * Enable or disable the SSE2/NEON versions of the opaque, binary and alpha
+	 * blended blits. They are enabled by default where they are compiled in;
+	 * disabling them is only useful for testing and benchmarking.
+	 */
+	static void enableSimd(bool enable);
+
+	/** Return whether the SSE2/NEON blits are used. */
+	static bool isSimdEnabled();
 private:
 	AlphaType _alphaMode;
 };
@@ -82,9 +82,19 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/worker-pool.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
+// 32-bit pixels are stored as interleaved 16-bit halves, low half first
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define YUV_TO_RGB_SIMD
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(SCUMM_LITTLE_ENDIAN)
+#include <arm_neon.h>
+#define YUV_TO_RGB_SIMD
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 }
@@ -97,12 +107,14 @@ public:
 
 	Graphics::PixelFormat getFormat() const { return _format; }
 	YUVToRGBManager::LuminanceScale getScale() const { return _scale; }
+	bool getAlphaMode() const { return _alphaMode; }
 	const uint32 *getRGBToPix() const { return _rgbToPix; }
 	const uint32 *getAlphaToPix() const { return _alphaToPix; }
 
 private:
 	Graphics::PixelFormat _format;
 	YUVToRGBManager::LuminanceScale _scale;
+	bool _alphaMode;
 	uint32 _rgbToPix[3 * 768]; // 9216 bytes
 	uint32 _alphaToPix[256];   // 958 bytes
 };
@@ -110,6 +122,7 @@ private:
 YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale, bool alphaMode) {
 	_format = format;
 	_scale = scale;
+	_alphaMode = alphaMode;
 
 	int alphaValue = alphaMode ? 0 : 255;
 
@@ -166,8 +179,11 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 }
 
 YUVToRGBManager::YUVToRGBManager() {
-	_lookup = 0;
-	_alphaMode = false;
+#ifdef YUV_TO_RGB_SIMD
+	_simd = true;
+#else
+	_simd = false;
+#endif
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -189,19 +205,478 @@ YUVToRGBManager::YUVToRGBManager() {
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
-	delete _lookup;
+	for (uint i = 0; i < _lookups.size(); i++)
+		delete _lookups[i];
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale, bool alphaMode) {
-	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale && _alphaMode == alphaMode)
-		return _lookup;
+	Common::StackLock lock(_lookupMutex);
 
-	_alphaMode = alphaMode;
-	delete _lookup;
-	_lookup = new YUVToRGBLookup(format, scale, alphaMode);
-	return _lookup;
+	// Videos rarely use more than one format, so the most recent lookup is checked first
+	for (int i = _lookups.size() - 1; i >= 0; i--) {
+		YUVToRGBLookup *lookup = _lookups[i];
+		if (lookup->getFormat() == format && lookup->getScale() == scale && lookup->getAlphaMode() == alphaMode)
+			return lookup;
+	}
+
+	_lookups.push_back(new YUVToRGBLookup(format, scale, alphaMode));
+	return _lookups.back();
+}
+
+void YUVToRGBManager::enableSimd(bool enable) {
+#ifdef YUV_TO_RGB_SIMD
+	_simd = enable;
+#endif
+}
+
+namespace {
+
+enum {
+	/** The fewest rows worth converting on a thread of their own. */
+	kMinBandRows = 32
+};
+
+/** The arguments of a conversion, shared by all the bands of rows it is split into. */
+struct YUVConversion {
+	byte *dstPtr;
+	int dstPitch;
+	const YUVToRGBLookup *lookup;
+	int16 *colorTab;
+	const byte *ySrc;
+	const byte *uSrc;
+	const byte *vSrc;
+	const byte *aSrc;
+	int yWidth;
+	int yHeight;
+	int yPitch;
+	int uvPitch;
+	int bandHeight;
+	bool simd;
+
+	/** Return the number of rows of the band starting at row @p y. */
+	int getBandHeight(int y) const { return MIN(bandHeight, yHeight - y); }
+};
+
+/**
+ * Convert the image in bands of rows on the worker pool. Bands start on
+ * multiples of @p rowAlignment rows, so that they start on a chroma row.
+ */
+void convertBands(YUVConversion &conversion, int rowAlignment, Common::WorkerPool::TaskProc proc) {
+	Common::WorkerPool &pool = Common::WorkerPool::instance();
+
+	int bands = 1;
+	if (pool.getThreadCount() > 1)
+		bands = CLIP<int>(conversion.yHeight / kMinBandRows, 1, pool.getThreadCount() * 2);
+
+	conversion.bandHeight = ((conversion.yHeight + bands - 1) / bands + rowAlignment - 1) / rowAlignment * rowAlignment;
+	if (conversion.bandHeight == 0)
+		return;
+
+	pool.run((conversion.yHeight + conversion.bandHeight - 1) / conversion.bandHeight, proc, &conversion);
+}
+
+#ifdef YUV_TO_RGB_SIMD
+
+// Eight 16-bit lanes, holding the samples or color channels of eight pixels
+
+#if defined(__SSE2__)
+
+typedef __m128i YUVVector;
+
+static FORCEINLINE YUVVector yuvLoad8(const byte *src) {
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+// The first and the last four lanes, each repeated for two pixels
+static FORCEINLINE YUVVector yuvDoubleLow(YUVVector v) {
+	return _mm_unpacklo_epi16(v, v);
+}
+
+static FORCEINLINE YUVVector yuvDoubleHigh(YUVVector v) {
+	return _mm_unpackhi_epi16(v, v);
+}
+
+static FORCEINLINE YUVVector yuvLoad(const int16 *src) {
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+static FORCEINLINE YUVVector yuvSplat(int16 v) {
+	return _mm_set1_epi16(v);
+}
+
+// The first value in the first four lanes, the second one in the others
+static FORCEINLINE YUVVector yuvSplatHalves(int16 first, int16 second) {
+	return _mm_setr_epi16(first, first, first, first, second, second, second, second);
+}
+
+static FORCEINLINE YUVVector yuvAdd(YUVVector a, YUVVector b) {
+	return _mm_add_epi16(a, b);
+}
+
+static FORCEINLINE YUVVector yuvSub(YUVVector a, YUVVector b) {
+	return _mm_sub_epi16(a, b);
+}
+
+static FORCEINLINE YUVVector yuvMul(YUVVector a, YUVVector b) {
+	return _mm_mullo_epi16(a, b);
+}
+
+// The high 16 bits of the unsigned products
+static FORCEINLINE YUVVector yuvMulHigh(YUVVector a, YUVVector b) {
+	return _mm_mulhi_epu16(a, b);
+}
+
+static FORCEINLINE YUVVector yuvMin(YUVVector a, YUVVector b) {
+	return _mm_min_epi16(a, b);
+}
+
+static FORCEINLINE YUVVector yuvMax(YUVVector a, YUVVector b) {
+	return _mm_max_epi16(a, b);
+}
+
+static FORCEINLINE YUVVector yuvOr(YUVVector a, YUVVector b) {
+	return _mm_or_si128(a, b);
+}
+
+static FORCEINLINE YUVVector yuvXor(YUVVector a, YUVVector b) {
+	return _mm_xor_si128(a, b);
+}
+
+// All bits set in the negative lanes
+static FORCEINLINE YUVVector yuvSignMask(YUVVector v) {
+	return _mm_srai_epi16(v, 15);
+}
+
+static FORCEINLINE YUVVector yuvShiftLeft(YUVVector v, int count) {
+	return _mm_sll_epi16(v, _mm_cvtsi32_si128(count));
+}
+
+static FORCEINLINE YUVVector yuvShiftRight(YUVVector v, int count) {
+	return _mm_srl_epi16(v, _mm_cvtsi32_si128(count));
+}
+
+static FORCEINLINE void yuvStore(uint16 *dst, YUVVector v) {
+	_mm_storeu_si128((__m128i *)dst, v);
+}
+
+// Store eight 32-bit pixels, given their low and high halves
+static FORCEINLINE void yuvStoreHalves(uint32 *dst, YUVVector low, YUVVector high) {
+	_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(low, high));
+	_mm_storeu_si128((__m128i *)dst + 1, _mm_unpackhi_epi16(low, high));
+}
+
+#else
+
+typedef int16x8_t YUVVector;
+
+static FORCEINLINE YUVVector yuvLoad8(const byte *src) {
+	return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src)));
+}
+
+// The first and the last four lanes, each repeated for two pixels
+static FORCEINLINE YUVVector yuvDoubleLow(YUVVector v) {
+	return vzipq_s16(v, v).val[0];
+}
+
+static FORCEINLINE YUVVector yuvDoubleHigh(YUVVector v) {
+	return vzipq_s16(v, v).val[1];
+}
+
+static FORCEINLINE YUVVector yuvLoad(const int16 *src) {
+	return vld1q_s16(src);
+}
+
+static FORCEINLINE YUVVector yuvSplat(int16 v) {
+	return vdupq_n_s16(v);
+}
+
+// The first value in the first four lanes, the second one in the others
+static FORCEINLINE YUVVector yuvSplatHalves(int16 first, int16 second) {
+	return vcombine_s16(vdup_n_s16(first), vdup_n_s16(second));
+}
+
+static FORCEINLINE YUVVector yuvAdd(YUVVector a, YUVVector b) {
+	return vaddq_s16(a, b);
 }
 
+static FORCEINLINE YUVVector yuvSub(YUVVector a, YUVVector b) {
+	return vsubq_s16(a, b);
+}
+
+static FORCEINLINE YUVVector yuvMul(YUVVector a, YUVVector b) {
+	return vmulq_s16(a, b);
+}
+
+// The high 16 bits of the unsigned products
+static FORCEINLINE YUVVector yuvMulHigh(YUVVector a, YUVVector b) {
+	const uint16x8_t ua = vreinterpretq_u16_s16(a), ub = vreinterpretq_u16_s16(b);
+	const uint32x4_t low = vmull_u16(vget_low_u16(ua), vget_low_u16(ub));
+	const uint32x4_t high = vmull_u16(vget_high_u16(ua), vget_high_u16(ub));
+	return vreinterpretq_s16_u16(vcombine_u16(vshrn_n_u32(low, 16), vshrn_n_u32(high, 16)));
+}
+
+static FORCEINLINE YUVVector yuvMin(YUVVector a, YUVVector b) {
+	return vminq_s16(a, b);
+}
+
+static FORCEINLINE YUVVector yuvMax(YUVVector a, YUVVector b) {
+	return vmaxq_s16(a, b);
+}
+
+static FORCEINLINE YUVVector yuvOr(YUVVector a, YUVVector b) {
+	return vorrq_s16(a, b);
+}
+
+static FORCEINLINE YUVVector yuvXor(YUVVector a, YUVVector b) {
+	return veorq_s16(a, b);
+}
+
+// All bits set in the negative lanes
+static FORCEINLINE YUVVector yuvSignMask(YUVVector v) {
+	return vshrq_n_s16(v, 15);
+}
+
+static FORCEINLINE YUVVector yuvShiftLeft(YUVVector v, int count) {
+	return vreinterpretq_s16_u16(vshlq_u16(vreinterpretq_u16_s16(v), vdupq_n_s16(count)));
+}
+
+static FORCEINLINE YUVVector yuvShiftRight(YUVVector v, int count) {
+	return vreinterpretq_s16_u16(vshlq_u16(vreinterpretq_u16_s16(v), vdupq_n_s16(-count)));
+}
+
+static FORCEINLINE void yuvStore(uint16 *dst, YUVVector v) {
+	vst1q_u16(dst, vreinterpretq_u16_s16(v));
+}
+
+// Store eight 32-bit pixels, given their low and high halves
+static FORCEINLINE void yuvStoreHalves(uint32 *dst, YUVVector low, YUVVector high) {
+	uint16x8x2_t halves;
+	halves.val[0] = vreinterpretq_u16_s16(low);
+	halves.val[1] = vreinterpretq_u16_s16(high);
+	vst2q_u16((uint16 *)dst, halves);
+}
+
+#endif
+
+/**
+ * trunc(c * k) for chroma samples c in [-128, 127], as the color tables
+ * of YUVToRGBManager hold them. k is (@p factor << @p preShift) / 65536;
+ * the factors are chosen to give exactly the same results as the tables.
+ */
+static FORCEINLINE YUVVector yuvScaleChroma(YUVVector c, int preShift, uint16 factor) {
+	const YUVVector sign = yuvSignMask(c);
+	const YUVVector magnitude = yuvSub(yuvXor(c, sign), sign);
+	const YUVVector scaled = yuvMulHigh(yuvShiftLeft(magnitude, preShift), yuvSplat((int16)factor));
+	return yuvSub(yuvXor(scaled, sign), sign);
+}
+
+/** The value of a color channel, as the rgbToPix table of YUVToRGBLookup maps it. */
+template<bool kITUScale>
+static FORCEINLINE YUVVector yuvChannel(YUVVector v) {
+	if (kITUScale) {
+		// (v - 16) * 255 / 219, with v clipped to [16, 235]
+		v = yuvSub(yuvMin(yuvMax(v, yuvSplat(16)), yuvSplat(235)), yuvSplat(16));
+		return yuvMulHigh(yuvShiftLeft(v, 1), yuvSplat((int16)38155));
+	}
+
+	return yuvMin(yuvMax(v, yuvSplat(0)), yuvSplat(255));
+}
+
+/**
+ * Where the channels of a pixel format go. The pixels are put together in
+ * halves of 16 bits, so each channel has to fit in one of the halves.
+ */
+struct YUVPixelLayout {
+	struct Channel {
+		int loss;
+		int lowShift;  ///< The shift within the low half of the pixel, 16 if the channel is not in it
+		int highShift; ///< The shift within the high half of the pixel, 16 if the channel is not in it
+
+		void set(int bits, int channelLoss, int channelShift) {
+			loss = channelLoss;
+			lowShift = (channelShift < 16) ? channelShift : 16;
+			highShift = (channelShift < 16) ? 16 : channelShift - 16;
+			if (bits && lowShift < 16 && lowShift + bits > 16)
+				loss = -1;
+		}
+	};
+
+	Channel r, g, b, a;
+	uint16 lowAlphaBits, highAlphaBits; ///< The alpha bits of all pixels, unless alpha comes from an alpha plane
+	bool lossless; ///< Whether the channels are stored with all their bits, as in most 32-bit formats
+
+	YUVPixelLayout(const Graphics::PixelFormat &format, bool alphaMode) {
+		r.set(format.rBits(), format.rLoss, format.rShift);
+		g.set(format.gBits(), format.gLoss, format.gShift);
+		b.set(format.bBits(), format.bLoss, format.bShift);
+		a.set(format.aBits(), format.aLoss, format.aShift);
+
+		const uint32 alphaBits = alphaMode ? 0 : format.ARGBToColor(255, 0, 0, 0);
+		lowAlphaBits = alphaBits & 0xFFFF;
+		highAlphaBits = alphaBits >> 16;
+		lossless = r.loss == 0 && g.loss == 0 && b.loss == 0 && (a.loss == 0 || !alphaMode);
+	}
+
+	/** Return whether all channels fit in the halves of the pixels. */
+	bool isSupported() const {
+		return r.loss >= 0 && g.loss >= 0 && b.loss >= 0 && a.loss >= 0;
+	}
+};
+
+/**
+ * Add a channel to the halves of eight pixels. Shifting 16-bit lanes by 16
+ * clears them, which leaves the half without the channel unchanged.
+ */
+template<typename PixelInt, bool kLossless>
+static FORCEINLINE void yuvPack(const YUVPixelLayout::Channel &channel, YUVVector v, YUVVector &low, YUVVector &high) {
+	if (!kLossless)
+		v = yuvShiftRight(v, channel.loss);
+	low = yuvOr(low, yuvShiftLeft(v, channel.lowShift));
+	if (sizeof(PixelInt) == 4)
+		high = yuvOr(high, yuvShiftLeft(v, channel.highShift));
+}
+
+template<typename PixelInt, bool kAlpha, bool kITUScale, bool kLossless>
+static FORCEINLINE void yuvConvertPixels(PixelInt *dst, const YUVPixelLayout &layout, const byte *ySrc, const byte *aSrc, YUVVector crR, YUVVector crbG, YUVVector cbB) {
+	const YUVVector y = yuvLoad8(ySrc);
+	YUVVector low = yuvSplat((int16)layout.lowAlphaBits);
+	YUVVector high = yuvSplat((int16)layout.highAlphaBits);
+	yuvPack<PixelInt, kLossless>(layout.r, yuvChannel<kITUScale>(yuvAdd(y, crR)), low, high);
+	yuvPack<PixelInt, kLossless>(layout.g, yuvChannel<kITUScale>(yuvAdd(y, crbG)), low, high);
+	yuvPack<PixelInt, kLossless>(layout.b, yuvChannel<kITUScale>(yuvAdd(y, cbB)), low, high);
+	if (kAlpha)
+		yuvPack<PixelInt, kLossless>(layout.a, yuvLoad8(aSrc), low, high);
+
+	if (sizeof(PixelInt) == 2)
+		yuvStore((uint16 *)dst, low);
+	else
+		yuvStoreHalves((uint32 *)dst, low, high);
+}
+
+/** The color table offsets of eight pixels, see the constructor of YUVToRGBManager. */
+static FORCEINLINE void yuvChromaOffsets(YUVVector u, YUVVector v, YUVVector &crR, YUVVector &crbG, YUVVector &cbB) {
+	const YUVVector cb = yuvSub(u, yuvSplat(128));
+	const YUVVector cr = yuvSub(v, yuvSplat(128));
+	crR = yuvScaleChroma(cr, 1, 45876);
+	crbG = yuvSub(yuvSplat(0), yuvAdd(yuvScaleChroma(cr, 0, 46735), yuvScaleChroma(cb, 0, 22562)));
+	cbB = yuvScaleChroma(cb, 1, 58109);
+}
+
+/** How the chroma planes are subsampled. */
+enum YUVChroma {
+	kChroma444,
+	kChroma420,
+	kChroma410
+};
+
+/**
+ * Convert the rows [firstRow, firstRow + rowCount) of a conversion with the
+ * same results as the lookup tables. 444 and 410 images are converted eight
+ * pixels at a time, 420 images in blocks of 16x2 pixels sharing 8 chroma samples.
+ *
+ * @return the number of columns converted, the rest is left to the lookup tables
+ */
+template<typename PixelInt, YUVChroma kChroma, bool kAlpha, bool kITUScale, bool kLossless>
+int convertYUVToRGBSimd(const YUVConversion &job, const YUVPixelLayout &layout, int firstRow, int rowCount) {
+	const int step = (kChroma == kChroma420) ? 16 : 8;
+	const int width = job.yWidth & ~(step - 1);
+	const int rowStep = (kChroma == kChroma420) ? 2 : 1;
+
+	for (int row = firstRow; row < firstRow + rowCount; row += rowStep) {
+		PixelInt *dst = (PixelInt *)(job.dstPtr + row * job.dstPitch);
+		PixelInt *nextDst = (PixelInt *)(job.dstPtr + (row + 1) * job.dstPitch);
+		const byte *ySrc = job.ySrc + row * job.yPitch;
+		const byte *aSrc = kAlpha ? job.aSrc + row * job.yPitch : ySrc;
+
+		const int chromaRow = (kChroma == kChroma444) ? row : (kChroma == kChroma420) ? (row >> 1) : (row >> 2);
+		const byte *uSrc = job.uSrc + chromaRow * job.uvPitch;
+		const byte *vSrc = job.vSrc + chromaRow * job.uvPitch;
+
+		// Bilinear weights of the four chroma samples around each of four pixels
+		int16 weights[4][8];
+		if (kChroma == kChroma410) {
+			const int yDiff = row & 3;
+			for (int i = 0; i < 8; i++) {
+				const int xDiff = i & 3;
+				weights[0][i] = (4 - xDiff) * (4 - yDiff);
+				weights[1][i] = xDiff * (4 - yDiff);
+				weights[2][i] = yDiff * (4 - xDiff);
+				weights[3][i] = xDiff * yDiff;
+			}
+		}
+
+		for (int x = 0; x < width; x += step) {
+			YUVVector u, v;
+			if (kChroma == kChroma444) {
+				u = yuvLoad8(uSrc + x);
+				v = yuvLoad8(vSrc + x);
+			} else if (kChroma == kChroma420) {
+				u = yuvLoad8(uSrc + (x >> 1));
+				v = yuvLoad8(vSrc + (x >> 1));
+			} else {
+				const byte *uQuad = uSrc + (x >> 2);
+				const byte *vQuad = vSrc + (x >> 2);
+				const int p = job.uvPitch;
+				u = yuvAdd(yuvAdd(yuvMul(yuvSplatHalves(uQuad[0], uQuad[1]), yuvLoad(weights[0])),
+						yuvMul(yuvSplatHalves(uQuad[1], uQuad[2]), yuvLoad(weights[1]))),
+						yuvAdd(yuvMul(yuvSplatHalves(uQuad[p], uQuad[p + 1]), yuvLoad(weights[2])),
+						yuvMul(yuvSplatHalves(uQuad[p + 1], uQuad[p + 2]), yuvLoad(weights[3]))));
+				v = yuvAdd(yuvAdd(yuvMul(yuvSplatHalves(vQuad[0], vQuad[1]), yuvLoad(weights[0])),
+						yuvMul(yuvSplatHalves(vQuad[1], vQuad[2]), yuvLoad(weights[1]))),
+						yuvAdd(yuvMul(yuvSplatHalves(vQuad[p], vQuad[p + 1]), yuvLoad(weights[2])),
+						yuvMul(yuvSplatHalves(vQuad[p + 1], vQuad[p + 2]), yuvLoad(weights[3]))));
+				u = yuvShiftRight(u, 4);
+				v = yuvShiftRight(v, 4);
+			}
+
+			YUVVector crR, crbG, cbB;
+			yuvChromaOffsets(u, v, crR, crbG, cbB);
+			if (kChroma != kChroma420) {
+				yuvConvertPixels<PixelInt, kAlpha, kITUScale, kLossless>(dst + x, layout, ySrc + x, aSrc + x, crR, crbG, cbB);
+				continue;
+			}
+
+			const byte *nextYSrc = ySrc + job.yPitch;
+			const byte *nextASrc = aSrc + job.yPitch;
+			for (int half = 0; half < 2; half++) {
+				const YUVVector halfCrR = half ? yuvDoubleHigh(crR) : yuvDoubleLow(crR);
+				const YUVVector halfCrbG = half ? yuvDoubleHigh(crbG) : yuvDoubleLow(crbG);
+				const YUVVector halfCbB = half ? yuvDoubleHigh(cbB) : yuvDoubleLow(cbB);
+				const int column = x + half * 8;
+				yuvConvertPixels<PixelInt, kAlpha, kITUScale, kLossless>(dst + column, layout, ySrc + column, aSrc + column, halfCrR, halfCrbG, halfCbB);
+				yuvConvertPixels<PixelInt, kAlpha, kITUScale, kLossless>(nextDst + column, layout, nextYSrc + column, nextASrc + column, halfCrR, halfCrbG, halfCbB);
+			}
+		}
+	}
+
+	return width;
+}
+
+/** Pick the instance of convertYUVToRGBSimd() for the scale and the pixel format of the conversion. */
+template<typename PixelInt, YUVChroma kChroma, bool kAlpha>
+int convertBandSimd(const YUVConversion &job, int firstRow, int rowCount) {
+	const YUVPixelLayout layout(job.lookup->getFormat(), kAlpha);
+	if (!layout.isSupported())
+		return 0;
+
+	// Skipping the loss shifts only pays off with the more numerous channel shifts of 32-bit pixels
+	const bool kCanBeLossless = (sizeof(PixelInt) == 4);
+	const bool lossless = kCanBeLossless && layout.lossless;
+	if (job.lookup->getScale() == YUVToRGBManager::kScaleITU) {
+		if (lossless)
+			return convertYUVToRGBSimd<PixelInt, kChroma, kAlpha, true, kCanBeLossless>(job, layout, firstRow, rowCount);
+		return convertYUVToRGBSimd<PixelInt, kChroma, kAlpha, true, false>(job, layout, firstRow, rowCount);
+	}
+
+	if (lossless)
+		return convertYUVToRGBSimd<PixelInt, kChroma, kAlpha, false, kCanBeLossless>(job, layout, firstRow, rowCount);
+	return convertYUVToRGBSimd<PixelInt, kChroma, kAlpha, false, false>(job, layout, firstRow, rowCount);
+}
+
+#endif
+
+} // End of anonymous namespace
+
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
@@ -237,6 +712,21 @@ void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	}
 }
 
+template<typename PixelInt>
+void convertYUV444Band(uint index, void *param) {
+	const YUVConversion &job = *(const YUVConversion *)param;
+	const int y = index * job.bandHeight;
+	int x = 0;
+#ifdef YUV_TO_RGB_SIMD
+	if (job.simd)
+		x = convertBandSimd<PixelInt, kChroma444, false>(job, y, job.getBandHeight(y));
+#endif
+	if (x < job.yWidth)
+		convertYUV444ToRGB<PixelInt>(job.dstPtr + y * job.dstPitch + x * sizeof(PixelInt), job.dstPitch, job.lookup, job.colorTab,
+				job.ySrc + y * job.yPitch + x, job.uSrc + y * job.uvPitch + x, job.vSrc + y * job.uvPitch + x,
+				job.yWidth - x, job.getBandHeight(y), job.yPitch, job.uvPitch);
+}
+
 void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -244,12 +734,13 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(ySrc && uSrc && vSrc);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	YUVConversion conversion = { (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, 0, yWidth, yHeight, yPitch, uvPitch, 0, _simd };
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertBands(conversion, 1, convertYUV444Band<uint16>);
 	else
-		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertBands(conversion, 1, convertYUV444Band<uint32>);
 }
 
 template<typename PixelInt>
@@ -284,13 +775,28 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
 		vSrc += uvPitch - halfWidth;
 	}
 }
 
+template<typename PixelInt>
+void convertYUV420Band(uint index, void *param) {
+	const YUVConversion &job = *(const YUVConversion *)param;
+	const int y = index * job.bandHeight;
+	int x = 0;
+#ifdef YUV_TO_RGB_SIMD
+	if (job.simd)
+		x = convertBandSimd<PixelInt, kChroma420, false>(job, y, job.getBandHeight(y));
+#endif
+	if (x < job.yWidth)
+		convertYUV420ToRGB<PixelInt>(job.dstPtr + y * job.dstPitch + x * sizeof(PixelInt), job.dstPitch, job.lookup, job.colorTab,
+				job.ySrc + y * job.yPitch + x, job.uSrc + y / 2 * job.uvPitch + x / 2, job.vSrc + y / 2 * job.uvPitch + x / 2,
+				job.yWidth - x, job.getBandHeight(y), job.yPitch, job.uvPitch);
+}
+
 void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -300,12 +806,13 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yHeight & 1) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	YUVConversion conversion = { (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, 0, yWidth, yHeight, yPitch, uvPitch, 0, _simd };
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertBands(conversion, 2, convertYUV420Band<uint16>);
 	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertBands(conversion, 2, convertYUV420Band<uint32>);
 }
 
 #define PUT_PIXELA(s, a, d) \
@@ -347,7 +854,7 @@ void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVToRGBLookup *look
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		aSrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
@@ -355,6 +862,21 @@ void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVToRGBLookup *look
 	}
 }
 
+template<typename PixelInt>
+void convertYUVA420Band(uint index, void *param) {
+	const YUVConversion &job = *(const YUVConversion *)param;
+	const int y = index * job.bandHeight;
+	int x = 0;
+#ifdef YUV_TO_RGB_SIMD
+	if (job.simd)
+		x = convertBandSimd<PixelInt, kChroma420, true>(job, y, job.getBandHeight(y));
+#endif
+	if (x < job.yWidth)
+		convertYUVA420ToRGBA<PixelInt>(job.dstPtr + y * job.dstPitch + x * sizeof(PixelInt), job.dstPitch, job.lookup, job.colorTab,
+				job.ySrc + y * job.yPitch + x, job.uSrc + y / 2 * job.uvPitch + x / 2, job.vSrc + y / 2 * job.uvPitch + x / 2, job.aSrc + y * job.yPitch + x,
+				job.yWidth - x, job.getBandHeight(y), job.yPitch, job.uvPitch);
+}
+
 void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -364,12 +886,13 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 	assert((yHeight & 1) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale, true);
+	YUVConversion conversion = { (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch, 0, _simd };
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertBands(conversion, 2, convertYUVA420Band<uint16>);
 	else
-		convertYUVA420ToRGBA<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertBands(conversion, 2, convertYUVA420Band<uint32>);
 }
 
 #define READ_QUAD(ptr, prefix) \
@@ -440,6 +963,21 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 #undef DO_INTERPOLATION
 #undef DO_YUV410_PIXEL
 
+template<typename PixelInt>
+void convertYUV410Band(uint index, void *param) {
+	const YUVConversion &job = *(const YUVConversion *)param;
+	const int y = index * job.bandHeight;
+	int x = 0;
+#ifdef YUV_TO_RGB_SIMD
+	if (job.simd)
+		x = convertBandSimd<PixelInt, kChroma410, false>(job, y, job.getBandHeight(y));
+#endif
+	if (x < job.yWidth)
+		convertYUV410ToRGB<PixelInt>(job.dstPtr + y * job.dstPitch + x * sizeof(PixelInt), job.dstPitch, job.lookup, job.colorTab,
+				job.ySrc + y * job.yPitch + x, job.uSrc + y / 4 * job.uvPitch + x / 4, job.vSrc + y / 4 * job.uvPitch + x / 4,
+				job.yWidth - x, job.getBandHeight(y), job.yPitch, job.uvPitch);
+}
+
 void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -449,12 +987,13 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yHeight & 3) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	YUVConversion conversion = { (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, 0, yWidth, yHeight, yPitch, uvPitch, 0, _simd };
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertBands(conversion, 4, convertYUV410Band<uint16>);
 	else
-		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertBands(conversion, 4, convertYUV410Band<uint32>);
 }
 
 } // End of namespace Graphics
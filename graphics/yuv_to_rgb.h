@@ -38,6 +38,8 @@
 #define GRAPHICS_YUV_TO_RGB_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
 #include "common/singleton.h"
 #include "graphics/surface.h"
 
@@ -45,6 +47,16 @@ namespace Graphics {
 
 class YUVToRGBLookup;
 
+/**
+ * Converts YUV images to RGB surfaces.
+ *
+ * Large images are split into bands of rows, which are converted on the
+ * threads of Common::WorkerPool. The conversion functions may be called from
+ * several threads at once, e.g. by a video decoder decoding frames ahead.
+ *
+ * Where SSE2 or NEON is available, the rows are converted eight pixels at a
+ * time, with the same results as the lookup tables.
+ */
 class YUVToRGBManager : public Common::Singleton<YUVToRGBManager> {
 public:
 	/** The scale of the luminance values */
@@ -120,6 +132,15 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Enable or disable the SSE2/NEON conversion. It is enabled by default where
+	 * it is compiled in; disabling it is only useful for testing and benchmarking.
+	 */
+	void enableSimd(bool enable);
+
+	/** Return whether the SSE2/NEON conversion is used. */
+	bool isSimdEnabled() const { return _simd; }
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -127,9 +148,14 @@ private:
 
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale, bool alphaMode = false);
 
-	YUVToRGBLookup *_lookup;
+	/**
+	 * The lookup tables built so far. They are kept until the manager is
+	 * destroyed, as conversions on other threads may still be using them.
+	 */
+	Common::Array<YUVToRGBLookup *> _lookups;
+	Common::Mutex _lookupMutex;
 	int16 _colorTab[4 * 256]; // 2048 bytes
-	bool _alphaMode;
+	bool _simd;
 };
  /** @} */
 } // End of namespace Graphics
@@ -36,6 +36,8 @@
 
 #include "engines/engine.h"
 
+#include "audio/mixer.h"
+
 #include "gui/debugger.h"
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 	#include "gui/console.h"
@@ -78,6 +80,8 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+
+	registerCmd("audiostats",		WRAP_METHOD(Debugger, cmdAudioStats));
 }
 
 Debugger::~Debugger() {
@@ -810,6 +814,38 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdAudioStats(int argc, const char **argv) {
+	Audio::Mixer *mixer = g_system->getMixer();
+
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "on") && strcmp(argv[1], "off") && strcmp(argv[1], "reset"))) {
+		debugPrintf("Usage: %s [on | off | reset]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		if (!strcmp(argv[1], "on")) {
+			mixer->enableStatistics(true);
+			debugPrintf("Mixer statistics enabled\n");
+		} else if (!strcmp(argv[1], "off")) {
+			mixer->enableStatistics(false);
+			debugPrintf("Mixer statistics disabled\n");
+		} else {
+			mixer->resetStatistics();
+			debugPrintf("Mixer statistics reset\n");
+		}
+		return true;
+	}
+
+	const Common::String report = mixer->getStatisticsReport();
+	if (report.empty())
+		debugPrintf("The mixer does not provide statistics\n");
+	else
+		debugPrintf("%s", report.c_str());
+	if (!mixer->isStatisticsEnabled())
+		debugPrintf("Use '%s on' to start collecting statistics\n", argv[0]);
+	return true;
+}
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
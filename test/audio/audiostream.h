@@ -205,4 +205,17 @@ public:
 	void test_sub_looping_audio_stream_stereo_22050_end_fixed_iter() {
 		testSubLoopingAudioStreamFixedIter(22050, true, 2, 2);
 	}
+
+	void test_stream_type_forwarding() {
+		Audio::SeekableAudioStream *s = createSineStream<int16>(11025, 1, 0, false, false);
+		TS_ASSERT_EQUALS(s->getStreamType(), Audio::kAudioStreamRaw);
+
+		Audio::SubSeekableAudioStream *sub = new Audio::SubSeekableAudioStream(s, Audio::Timestamp(0, 11025), Audio::Timestamp(500, 11025));
+		TS_ASSERT_EQUALS(sub->getStreamType(), Audio::kAudioStreamRaw);
+
+		Audio::LoopingAudioStream *loop = new Audio::LoopingAudioStream(sub, 2);
+		TS_ASSERT_EQUALS(loop->getStreamType(), Audio::kAudioStreamRaw);
+
+		delete loop;
+	}
 };
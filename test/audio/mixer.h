@@ -0,0 +1,140 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+#include "audio/decoders/raw.h"
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_MIXER 1
+#else
+#define TEST_MIXER 0
+#endif
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kRate = 22050,
+		kSamples = 4096
+	};
+
+	byte _data[kSamples];
+
+	Audio::AudioStream *makeStream(uint32 size = kSamples) {
+		return Audio::makeRawStream(_data, size, kRate, Audio::FLAG_UNSIGNED, DisposeAfterUse::NO);
+	}
+
+	static void mix(Audio::MixerImpl &mixer, int pairs = 256) {
+		int16 buf[512];
+		mixer.mixCallback((byte *)buf, pairs * 4);
+	}
+
+	public:
+	void setUp() {
+#if TEST_MIXER
+		Common::install_null_g_system();
+		memset(_data, 0xC0, sizeof(_data));
+#endif
+	}
+
+	void test_play_and_stop() {
+#if TEST_MIXER
+		Audio::MixerImpl mixerImpl(kRate);
+		Audio::Mixer &mixer = mixerImpl;
+		mixerImpl.setReady(true);
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, makeStream(), 42, 100, -20);
+
+		// The channel is known before the mixer has picked it up
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundIDActive(42));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 42);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 100);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), -20);
+		TS_ASSERT(mixer.hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+
+		// A sound with the same id is not played
+		Audio::SoundHandle duplicate;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &duplicate, makeStream(), 42);
+		TS_ASSERT(!mixer.isSoundHandleActive(duplicate));
+
+		mix(mixerImpl);
+		TS_ASSERT_EQUALS(mixerImpl.getCallbackStats().callbacks, 1U);
+		TS_ASSERT(mixerImpl.getCallbackStats().lastCommands >= 1U);
+
+		mixer.setChannelVolume(handle, 50);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 50);
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(!mixer.isSoundIDActive(42));
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 0);
+
+		// Nothing is mixed anymore
+		int16 buf[512];
+		memset(buf, 0x55, sizeof(buf));
+		mixerImpl.mixCallback((byte *)buf, sizeof(buf));
+		bool silent = true;
+		for (int i = 0; i < ARRAYSIZE(buf); i++)
+			silent &= (buf[i] == 0);
+		TS_ASSERT(silent);
+#endif
+	}
+
+	void test_finished_channels_are_freed() {
+#if TEST_MIXER
+		Audio::MixerImpl mixerImpl(kRate);
+		Audio::Mixer &mixer = mixerImpl;
+		mixerImpl.setReady(true);
+
+		// Play more sounds than there are channels, one after the other
+		for (int i = 0; i < 100; i++) {
+			Audio::SoundHandle handle;
+			mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, makeStream(64));
+			TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+			mix(mixerImpl);
+			mix(mixerImpl);
+			TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		}
+#endif
+	}
+
+	void test_stop_all() {
+#if TEST_MIXER
+		Audio::MixerImpl mixerImpl(kRate);
+		Audio::Mixer &mixer = mixerImpl;
+		mixerImpl.setReady(true);
+
+		Audio::SoundHandle handle, permanent;
+		mixer.playStream(Audio::Mixer::kMusicSoundType, &handle, makeStream());
+		mixer.playStream(Audio::Mixer::kMusicSoundType, &permanent, makeStream(), -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::YES, true);
+		mix(mixerImpl);
+
+		mixer.stopAll();
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundHandleActive(permanent));
+		mix(mixerImpl);
+		TS_ASSERT(mixer.isSoundHandleActive(permanent));
+#endif
+	}
+
+	void test_full_command_queue() {
+#if TEST_MIXER
+		Audio::MixerImpl mixerImpl(kRate);
+		Audio::Mixer &mixer = mixerImpl;
+		mixerImpl.setReady(true);
+
+		// Without a mixer callback, the commands have to be applied by the
+		// engine thread once the queue is full
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, makeStream());
+		for (int i = 0; i < 1000; i++)
+			mixer.setChannelVolume(handle, i & 0xFF);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 999 & 0xFF);
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+#endif
+	}
+};
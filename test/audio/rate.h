@@ -0,0 +1,104 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/decoders/raw.h"
+
+#include "common/memstream.h"
+
+class RateTestSuite : public CxxTest::TestSuite
+{
+private:
+	static void fillNoise(int16 *buf, int count, uint32 seed) {
+		for (int i = 0; i < count; ++i) {
+			seed = seed * 1103515245 + 12345;
+			buf[i] = (int16)(seed >> 16);
+		}
+		// Make sure the extreme values get tested as well
+		if (count >= 4) {
+			buf[0] = 32767;
+			buf[1] = -32768;
+			buf[2] = -1;
+			buf[3] = 1;
+		}
+	}
+
+	static void mixReference(int16 *obuf, const int16 *ibuf, int frames, bool stereo, bool reverseStereo, uint16 vol_l, uint16 vol_r) {
+		for (int i = 0; i < frames; ++i) {
+			const int16 out0 = *ibuf++;
+			const int16 out1 = (stereo ? *ibuf++ : out0);
+			Audio::clampedAdd(obuf[reverseStereo ? 1 : 0], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+			Audio::clampedAdd(obuf[reverseStereo ? 0 : 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+			obuf += 2;
+		}
+	}
+
+	void mixBufferTest(bool stereo, bool reverseStereo, uint16 vol_l, uint16 vol_r) {
+		// An odd frame count exercises the scalar tail of the vector kernels
+		const int frames = 203;
+		int16 in[frames * 2];
+		int16 expected[frames * 2];
+		int16 result[frames * 2];
+
+		fillNoise(in, frames * 2, 1);
+		fillNoise(expected, frames * 2, 2);
+		memcpy(result, expected, sizeof(result));
+
+		mixReference(expected, in, frames, stereo, reverseStereo, vol_l, vol_r);
+		Audio::mixBuffer(result, in, frames, stereo, reverseStereo, vol_l, vol_r);
+
+		TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(result)), 0);
+	}
+
+	void sincDCTest(int inRate, int outRate, bool stereo) {
+		// A constant signal has to pass through the filter unchanged, once
+		// the filter history has been filled.
+		const int inSamples = inRate / 10 * (stereo ? 2 : 1);
+		int16 *data = (int16 *)malloc(inSamples * sizeof(int16));
+		for (int i = 0; i < inSamples; ++i)
+			data[i] = (stereo && (i & 1)) ? -12345 : 10000;
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, inSamples * sizeof(int16), DisposeAfterUse::YES);
+		Audio::AudioStream *input = Audio::makeRawStream(stream, inRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (stereo ? Audio::FLAG_STEREO : 0));
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, false, Audio::kResamplerSinc);
+
+		const int frames = outRate / 20;
+		int16 *output = new int16[frames * 2];
+		memset(output, 0, frames * 2 * sizeof(int16));
+		TS_ASSERT_EQUALS(converter->flow(*input, output, frames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), frames);
+
+		for (int i = frames / 2; i < frames; ++i) {
+			TS_ASSERT_EQUALS(output[i * 2], 10000);
+			TS_ASSERT_EQUALS(output[i * 2 + 1], stereo ? -12345 : 10000);
+		}
+
+		delete[] output;
+		delete converter;
+		delete input;
+	}
+
+public:
+	void test_mix_buffer_mono() {
+		mixBufferTest(false, false, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		mixBufferTest(false, false, 100, 37);
+		mixBufferTest(false, false, 0, 255);
+	}
+
+	void test_mix_buffer_stereo() {
+		mixBufferTest(true, false, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		mixBufferTest(true, false, 100, 37);
+		mixBufferTest(true, false, 1, 0);
+	}
+
+	void test_mix_buffer_reverse_stereo() {
+		mixBufferTest(true, true, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		mixBufferTest(true, true, 100, 37);
+		mixBufferTest(false, true, 13, 200);
+	}
+
+	void test_sinc_converter_dc() {
+		sincDCTest(11025, 44100, false);
+		sincDCTest(22050, 48000, true);
+		sincDCTest(48000, 22050, true);
+	}
+};
@@ -0,0 +1,98 @@
+#include "helper.h"
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/decoders/raw.h"
+
+#include "common/memstream.h"
+
+class AudioRateBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kOutputRate = 44100,
+		kChannels = 32,
+		kFramesPerCallback = 1024,
+		kCallbacks = 2000
+	};
+
+	static Audio::AudioStream *createNoiseStream(int rate, bool stereo, uint32 seed) {
+		const int samples = rate * (stereo ? 2 : 1);
+		int16 *data = (int16 *)malloc(samples * sizeof(int16));
+		for (int i = 0; i < samples; ++i) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = (int16)(seed >> 16) / 4;
+		}
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, samples * sizeof(int16), DisposeAfterUse::YES);
+		byte flags = Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (stereo ? Audio::FLAG_STEREO : 0);
+		return Audio::makeLoopingAudioStream(Audio::makeRawStream(stream, rate, flags), 0);
+	}
+
+	void runMixBenchmark(const char *name, int inputRate, bool stereo, Audio::ResamplerQuality quality = Audio::kResamplerLinear) {
+		Audio::AudioStream *streams[kChannels];
+		Audio::RateConverter *converters[kChannels];
+		for (int i = 0; i < kChannels; ++i) {
+			streams[i] = createNoiseStream(inputRate, stereo, i + 1);
+			converters[i] = Audio::makeRateConverter(inputRate, kOutputRate, stereo, false, quality);
+		}
+
+		int16 *output = new int16[kFramesPerCallback * 2];
+
+		BenchmarkTimer timer;
+		for (int n = 0; n < kCallbacks; ++n) {
+			memset(output, 0, kFramesPerCallback * 2 * sizeof(int16));
+			for (int i = 0; i < kChannels; ++i)
+				converters[i]->flow(*streams[i], output, kFramesPerCallback, 200, 150);
+		}
+		const uint32 millis = timer.elapsedMillis();
+
+		const double frames = (double)kCallbacks * kFramesPerCallback * kChannels;
+		BENCHMARK_REPORT("%s: %.2f ns per output frame per channel", name, millis * 1000000.0 / frames);
+
+		delete[] output;
+		for (int i = 0; i < kChannels; ++i) {
+			delete converters[i];
+			delete streams[i];
+		}
+	}
+
+public:
+	void test_mix_buffer() {
+		int16 *input = new int16[kFramesPerCallback * 2];
+		int16 *output = new int16[kFramesPerCallback * 2];
+		for (int i = 0; i < kFramesPerCallback * 2; ++i)
+			input[i] = (int16)(i * 37);
+		memset(output, 0, kFramesPerCallback * 2 * sizeof(int16));
+
+		BenchmarkTimer timer;
+		for (int n = 0; n < kCallbacks * kChannels; ++n)
+			Audio::mixBuffer(output, input, kFramesPerCallback, true, false, 200, 150);
+		const uint32 millis = timer.elapsedMillis();
+
+		const double frames = (double)kCallbacks * kFramesPerCallback * kChannels;
+		BENCHMARK_REPORT("mixBuffer: %.2f ns per output frame per channel", millis * 1000000.0 / frames);
+
+		delete[] input;
+		delete[] output;
+	}
+
+	void test_copy_converter() {
+		runMixBenchmark("CopyRateConverter stereo", kOutputRate, true);
+	}
+
+	void test_simple_converter() {
+		runMixBenchmark("SimpleRateConverter mono", kOutputRate * 2, false);
+	}
+
+	void test_linear_converter() {
+		runMixBenchmark("LinearRateConverter mono", 22050, false);
+		runMixBenchmark("LinearRateConverter stereo", 11025, true);
+	}
+
+	void test_sinc_converter() {
+		runMixBenchmark("SincRateConverter mono", 22050, false, Audio::kResamplerSinc);
+		runMixBenchmark("SincRateConverter stereo", 11025, true, Audio::kResamplerSinc);
+	}
+};
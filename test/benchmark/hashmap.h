@@ -0,0 +1,73 @@
+#include "helper.h"
+
+#include "common/array.h"
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+
+class HashMapBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kEntries = 100000,
+		kRounds = 10
+	};
+
+	template<class Map, class Key>
+	void runBenchmark(const char *name, const Common::Array<Key> &keys, const Common::Array<Key> &missing) {
+		uint32 insertMillis = 0, findMillis = 0, iterateMillis = 0;
+		uint32 checksum = 0;
+
+		for (int round = 0; round < kRounds; ++round) {
+			Map map;
+
+			BenchmarkTimer insertTimer;
+			for (uint i = 0; i < keys.size(); ++i)
+				map[keys[i]] = i;
+			insertMillis += insertTimer.elapsedMillis();
+
+			BenchmarkTimer findTimer;
+			for (uint i = 0; i < keys.size(); ++i) {
+				checksum += map.getValOrDefault(keys[i], 0);
+				checksum += map.contains(missing[i]);
+			}
+			findMillis += findTimer.elapsedMillis();
+
+			BenchmarkTimer iterateTimer;
+			for (int n = 0; n < 10; ++n) {
+				for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+					checksum += it->_value;
+			}
+			iterateMillis += iterateTimer.elapsedMillis();
+		}
+
+		const double ops = (double)kRounds * keys.size();
+		BENCHMARK_REPORT("%s: insert %.1f ns, find %.1f ns (hit + miss), iterate %.1f ns per entry (checksum %u)",
+			name, insertMillis * 1000000.0 / ops, findMillis * 1000000.0 / ops, iterateMillis * 100000.0 / ops, checksum);
+	}
+
+public:
+	void test_int_keys() {
+		Common::Array<uint32> keys, missing;
+		uint32 seed = 1;
+		for (int i = 0; i < kEntries; ++i) {
+			seed = seed * 1103515245 + 12345;
+			keys.push_back(seed & ~1);
+			missing.push_back(seed | 1);
+		}
+
+		runBenchmark<Common::HashMap<uint32, uint32>, uint32>("HashMap<uint32>", keys, missing);
+		runBenchmark<Common::FlatHashMap<uint32, uint32>, uint32>("FlatHashMap<uint32>", keys, missing);
+	}
+
+	void test_string_keys() {
+		Common::Array<Common::String> keys, missing;
+		for (int i = 0; i < kEntries; ++i) {
+			keys.push_back(Common::String::format("resource/%08d.dat", i));
+			missing.push_back(Common::String::format("resource/%08d.bin", i));
+		}
+
+		runBenchmark<Common::HashMap<Common::String, uint32, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo>, Common::String>("HashMap<String>", keys, missing);
+		runBenchmark<Common::FlatHashMap<Common::String, uint32, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo>, Common::String>("FlatHashMap<String>", keys, missing);
+	}
+};
@@ -0,0 +1,38 @@
+#ifndef TEST_BENCHMARK_HELPER_H
+#define TEST_BENCHMARK_HELPER_H
+
+#include <cxxtest/TestSuite.h>
+
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Simple wall clock timer for the benchmarks, based on OSystem::getMillis().
+ * Benchmarks should run their workload for at least a few hundred
+ * milliseconds to get meaningful numbers out of it.
+ */
+class BenchmarkTimer {
+public:
+	BenchmarkTimer() {
+		if (!g_system)
+			Common::install_null_g_system();
+		_start = g_system->getMillis();
+	}
+
+	uint32 elapsedMillis() const {
+		const uint32 elapsed = g_system->getMillis() - _start;
+		return elapsed ? elapsed : 1;
+	}
+
+private:
+	uint32 _start;
+};
+
+/**
+ * Report the result of a benchmark through the CxxTest trace mechanism.
+ */
+#define BENCHMARK_REPORT(...) TS_TRACE(Common::String::format(__VA_ARGS__).c_str())
+
+#endif
@@ -0,0 +1,115 @@
+#include "helper.h"
+
+#include "common/array.h"
+#include "common/bitstream.h"
+#include "common/huffman.h"
+#include "common/memstream.h"
+
+#include "audio/decoders/wmadata.h"
+#include "video/binkdata.h"
+
+class HuffmanBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kSymbols = 200000,
+		kRounds = 10
+	};
+
+	struct Result {
+		uint32 getSymbolMillis;
+		uint32 getSymbolsMillis;
+		uint32 symbols;
+		uint32 checksum;
+
+		Result() : getSymbolMillis(0), getSymbolsMillis(0), symbols(0), checksum(0) {}
+	};
+
+	/**
+	 * Encode symbols picked with the probabilities their code lengths stand
+	 * for, then decode them with getSymbol() and getSymbols().
+	 */
+	template<class BITSTREAM>
+	static void runCodebook(uint32 codeCount, const uint32 *codes, const uint8 *lengths, Result &result) {
+		Common::Huffman<BITSTREAM> huffman(0, codeCount, codes, lengths);
+
+		// Cumulative probabilities, in units of 2^-32
+		Common::Array<uint64> cumulative;
+		uint64 total = 0;
+		for (uint32 i = 0; i < codeCount; ++i) {
+			total += (uint64)1 << (32 - lengths[i]);
+			cumulative.push_back(total);
+		}
+
+		Common::Array<byte> buffer;
+		buffer.resize(kSymbols * 4 + 8);
+		memset(buffer.data(), 0, buffer.size());
+		uint32 bitPos = 0, seed = 1;
+		for (uint i = 0; i < kSymbols; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const uint64 pick = (((uint64)seed << 16) ^ (seed >> 8)) % total;
+			uint32 symbol = 0;
+			while (cumulative[symbol] <= pick)
+				++symbol;
+
+			// MSB2LSB streams start with the most significant bit of the codes,
+			// LSB2MSB ones with the least significant bit
+			const uint8 length = lengths[symbol];
+			for (int bit = 0; bit < length; ++bit, ++bitPos) {
+				if (BITSTREAM::isMSB2LSB()) {
+					if ((codes[symbol] >> (length - 1 - bit)) & 1)
+						buffer[bitPos / 8] |= 0x80 >> (bitPos % 8);
+				} else {
+					if ((codes[symbol] >> bit) & 1)
+						buffer[bitPos / 8] |= 1 << (bitPos % 8);
+				}
+			}
+		}
+
+		Common::Array<uint32> symbols;
+		symbols.resize(kSymbols);
+		for (int round = 0; round < kRounds; ++round) {
+			Common::MemoryReadStream stream(buffer.data(), buffer.size());
+			BITSTREAM bits(stream);
+			BenchmarkTimer timer;
+			for (uint i = 0; i < kSymbols; ++i)
+				result.checksum += huffman.getSymbol(bits);
+			result.getSymbolMillis += timer.elapsedMillis();
+		}
+
+		for (int round = 0; round < kRounds; ++round) {
+			Common::MemoryReadStream stream(buffer.data(), buffer.size());
+			BITSTREAM bits(stream);
+			BenchmarkTimer timer;
+			huffman.getSymbols(bits, symbols.data(), kSymbols);
+			result.getSymbolsMillis += timer.elapsedMillis();
+			result.checksum -= symbols[kSymbols - 1];
+		}
+
+		result.symbols += kSymbols * kRounds;
+	}
+
+	static void report(const char *name, const Result &result) {
+		BENCHMARK_REPORT("%s: getSymbol %.1f ns, getSymbols %.1f ns per symbol (checksum %u)",
+			name, result.getSymbolMillis * 1000000.0 / result.symbols,
+			result.getSymbolsMillis * 1000000.0 / result.symbols, result.checksum);
+	}
+
+public:
+	void test_bink_codebooks() {
+		Result result;
+		for (int i = 0; i < 16; ++i)
+			runCodebook<Common::BitStream32LELSB>(16, Video::binkHuffmanCodes[i], Video::binkHuffmanLengths[i], result);
+		report("Huffman, Bink codebooks", result);
+	}
+
+	void test_wma_codebooks() {
+		Result result;
+		for (int i = 0; i < ARRAYSIZE(Audio::coefHuffmanParam); ++i) {
+			const Audio::WMACoefHuffmanParam &param = Audio::coefHuffmanParam[i];
+			runCodebook<Common::BitStream8MSB>(param.n, param.huffCodes, param.huffBits, result);
+		}
+		runCodebook<Common::BitStream8MSB>(ARRAYSIZE(Audio::scaleHuffCodes), Audio::scaleHuffCodes, Audio::scaleHuffBits, result);
+		report("Huffman, WMA codebooks", result);
+	}
+};
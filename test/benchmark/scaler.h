@@ -0,0 +1,119 @@
+#include "helper.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/config-manager.h"
+#include "common/worker-pool.h"
+#include "graphics/surface.h"
+
+#ifdef USE_SCALERS
+#include "graphics/scaler/normal.h"
+#include "graphics/scaler/sai.h"
+#include "graphics/scaler/scalebit.h"
+#include "graphics/scaler/tv.h"
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+#endif
+
+class ScalerBenchmarkSuite : public CxxTest::TestSuite
+{
+#ifdef USE_SCALERS
+private:
+	enum {
+		// Scaled three times, this fills a 1080p screen
+		kWidth = 640,
+		kHeight = 360,
+		kPadding = 4,
+		kFrames = 20
+	};
+
+	template<class T>
+	static Scaler *create(const Graphics::PixelFormat &format) {
+		return new T(format);
+	}
+
+	typedef Scaler *(*CreateProc)(const Graphics::PixelFormat &format);
+
+	static uint32 scaleFrames(uint threads, CreateProc createProc, uint factor) {
+		if (!g_system)
+			Common::install_null_g_system();
+		Common::WorkerPool::destroy();
+		ConfMan.setInt("worker_threads", threads, Common::ConfigManager::kApplicationDomain);
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		Graphics::Surface source;
+		source.create(kWidth + kPadding * 2, kHeight + kPadding * 2, format);
+		uint32 seed = 1;
+		for (int y = 0; y < source.h; ++y) {
+			uint32 *row = (uint32 *)source.getBasePtr(0, y);
+			for (int x = 0; x < source.w; ++x) {
+				seed = seed * 1103515245 + 12345;
+				row[x] = ((x / 4 + y / 6) & 1) ? (seed & 0xFF0F0F0F) : 0xFFE0C0A0;
+			}
+		}
+		Graphics::Surface target;
+		target.create(kWidth * factor, kHeight * factor, format);
+
+		Scaler *scaler = createProc(format);
+		scaler->setFactor(factor);
+		BenchmarkTimer timer;
+		for (int frame = 0; frame < kFrames; ++frame) {
+			scaler->scale((const uint8 *)source.getBasePtr(kPadding, kPadding), source.pitch,
+				(uint8 *)target.getPixels(), target.pitch, kWidth, kHeight, 0, 0);
+		}
+		const uint32 millis = timer.elapsedMillis();
+		delete scaler;
+
+		target.free();
+		source.free();
+		Common::WorkerPool::destroy();
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kApplicationDomain);
+		return millis;
+	}
+
+	static void report(const char *name, CreateProc createProc, uint factor) {
+		const uint32 baseMillis = scaleFrames(1, createProc, factor);
+		BENCHMARK_REPORT("Scaler %s %dx%d to %dx%d: 1 thread %.2f ms per frame",
+			name, kWidth, kHeight, kWidth * factor, kHeight * factor, (double)baseMillis / kFrames);
+
+		const uint threadCounts[] = { 2, 4, 8 };
+		for (uint i = 0; i < ARRAYSIZE(threadCounts); ++i) {
+			const uint32 millis = scaleFrames(threadCounts[i], createProc, factor);
+			BENCHMARK_REPORT("Scaler %s %dx%d to %dx%d: %u threads %.2f ms per frame (%.2fx)",
+				name, kWidth, kHeight, kWidth * factor, kHeight * factor, threadCounts[i],
+				(double)millis / kFrames, (double)baseMillis / MAX<uint32>(millis, 1));
+		}
+	}
+#endif
+
+public:
+	void test_normal() {
+#ifdef USE_SCALERS
+		report("Normal3x", create<NormalScaler>, 3);
+#endif
+	}
+
+	void test_advmame() {
+#ifdef USE_SCALERS
+		report("AdvMame2x", create<AdvMameScaler>, 2);
+		report("AdvMame3x", create<AdvMameScaler>, 3);
+#endif
+	}
+
+	void test_hq() {
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS)
+		report("HQ2x", create<HQScaler>, 2);
+		report("HQ3x", create<HQScaler>, 3);
+#endif
+	}
+
+	void test_sai_tv() {
+#ifdef USE_SCALERS
+		report("SuperSAI", create<SuperSAIScaler>, 2);
+		report("TV", create<TVScaler>, 2);
+#endif
+	}
+};
@@ -0,0 +1,105 @@
+#include "helper.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/config-manager.h"
+#include "common/worker-pool.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/tinygl.h"
+#endif
+
+class TinyGLBenchmarkSuite : public CxxTest::TestSuite
+{
+#ifdef USE_TINYGL
+private:
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kTriangles = 3000,
+		kFrames = 30
+	};
+
+	// A depth tested, smooth shaded scene with enough overdraw to keep the
+	// rasterizer busy, similar to a room of the 3D adventure games.
+	static void drawScene(int frame) {
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglRotatef(frame * 2.0f, 0.0f, 0.0f, 1.0f);
+
+		tglClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+
+		uint32 seed = 1;
+		tglBegin(TGL_TRIANGLES);
+		for (int i = 0; i < kTriangles; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const float x = ((seed >> 8) & 0xffff) / 32768.0f - 1.0f;
+			seed = seed * 1103515245 + 12345;
+			const float y = ((seed >> 8) & 0xffff) / 32768.0f - 1.0f;
+			const float z = ((seed >> 4) & 0xff) / 128.0f - 1.0f;
+			tglColor3f(1.0f, 0.0f, 0.0f);
+			tglVertex3f(x, y, z);
+			tglColor3f(0.0f, 1.0f, 0.0f);
+			tglVertex3f(x + 0.3f, y, z);
+			tglColor3f(0.0f, 0.0f, 1.0f);
+			tglVertex3f(x, y + 0.3f, z);
+		}
+		tglEnd();
+	}
+
+	static uint32 renderFrames(uint threads, bool simdSpans = true) {
+		if (!g_system)
+			Common::install_null_g_system();
+		Common::WorkerPool::destroy();
+		ConfMan.setInt("worker_threads", threads, Common::ConfigManager::kApplicationDomain);
+
+		TinyGL::createContext(kWidth, kHeight, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 256, false, false);
+		TinyGL::enableSimdSpans(simdSpans);
+		BenchmarkTimer timer;
+		for (int frame = 0; frame < kFrames; ++frame) {
+			drawScene(frame);
+			TinyGL::presentBuffer();
+		}
+		const uint32 millis = timer.elapsedMillis();
+		TinyGL::destroyContext();
+
+		Common::WorkerPool::destroy();
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kApplicationDomain);
+		return millis;
+	}
+#endif
+
+public:
+	void test_tiled_rasterization() {
+#ifdef USE_TINYGL
+		const uint32 baseMillis = renderFrames(1);
+		BENCHMARK_REPORT("TinyGL %dx%d, %d triangles: 1 thread %.2f ms per frame",
+			kWidth, kHeight, kTriangles, (double)baseMillis / kFrames);
+
+		const uint threadCounts[] = { 2, 4, 8 };
+		for (uint i = 0; i < ARRAYSIZE(threadCounts); ++i) {
+			const uint32 millis = renderFrames(threadCounts[i]);
+			BENCHMARK_REPORT("TinyGL %dx%d, %d triangles: %u threads %.2f ms per frame (%.2fx)",
+				kWidth, kHeight, kTriangles, threadCounts[i], (double)millis / kFrames, (double)baseMillis / millis);
+		}
+#endif
+	}
+
+	void test_simd_spans() {
+#ifdef USE_TINYGL
+		const uint32 portableMillis = renderFrames(1, false);
+		const uint32 simdMillis = renderFrames(1, true);
+		BENCHMARK_REPORT("TinyGL %dx%d, %d triangles: portable spans %.2f ms, SIMD spans %.2f ms per frame (%.2fx)",
+			kWidth, kHeight, kTriangles, (double)portableMillis / kFrames, (double)simdMillis / kFrames,
+			(double)portableMillis / MAX<uint32>(simdMillis, 1));
+#endif
+	}
+};
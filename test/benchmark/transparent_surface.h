@@ -0,0 +1,78 @@
+#include "helper.h"
+
+#include "graphics/transparent_surface.h"
+
+class TransparentSurfaceBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kSpriteWidth = 200,
+		kSpriteHeight = 150,
+		kTargetWidth = 640,
+		kTargetHeight = 480,
+		kBlits = 2000
+	};
+
+	// Runs of transparent, opaque and translucent pixels, as in most sprites
+	static void fillSprite(Graphics::TransparentSurface &sprite) {
+		sprite.create(kSpriteWidth, kSpriteHeight, Graphics::TransparentSurface::getSupportedPixelFormat());
+		uint32 seed = 1;
+		for (int y = 0; y < sprite.h; ++y) {
+			uint32 *row = (uint32 *)sprite.getBasePtr(0, y);
+			for (int x = 0; x < sprite.w; ++x) {
+				seed = seed * 1103515245 + 12345;
+				const int run = (x / 16 + y / 8) % 4;
+				const byte alpha = run == 0 ? 0 : run == 3 ? (seed >> 24) : 0xFF;
+				row[x] = (seed & 0xFFFFFF00) | alpha;
+			}
+		}
+	}
+
+	static uint32 runBlits(bool simd, Graphics::AlphaType alphaMode, uint color, int flipping) {
+		Graphics::TransparentSurface::enableSimd(simd);
+
+		Graphics::TransparentSurface sprite;
+		fillSprite(sprite);
+		sprite.setAlphaMode(alphaMode);
+		Graphics::Surface target;
+		target.create(kTargetWidth, kTargetHeight, Graphics::TransparentSurface::getSupportedPixelFormat());
+		memset(target.getPixels(), 0x40, target.pitch * target.h);
+
+		BenchmarkTimer timer;
+		for (int i = 0; i < kBlits; ++i)
+			sprite.blit(target, (i * 37) % (kTargetWidth - kSpriteWidth), (i * 23) % (kTargetHeight - kSpriteHeight), flipping, nullptr, color);
+		const uint32 millis = timer.elapsedMillis();
+
+		target.free();
+		sprite.free();
+		Graphics::TransparentSurface::enableSimd(true);
+		return millis;
+	}
+
+	static void compare(const char *name, Graphics::AlphaType alphaMode, uint color, int flipping = Graphics::FLIP_NONE) {
+		const uint32 portableMillis = runBlits(false, alphaMode, color, flipping);
+		const uint32 simdMillis = runBlits(true, alphaMode, color, flipping);
+		const double megapixels = (double)kSpriteWidth * kSpriteHeight * kBlits / 1000000.0;
+		BENCHMARK_REPORT("TransparentSurface %s %dx%d: portable %.1f, SIMD %.1f megapixels per second (%.2fx)",
+			name, kSpriteWidth, kSpriteHeight, megapixels * 1000.0 / MAX<uint32>(portableMillis, 1),
+			megapixels * 1000.0 / MAX<uint32>(simdMillis, 1), (double)portableMillis / MAX<uint32>(simdMillis, 1));
+	}
+
+public:
+	void test_opaque_blit() {
+		compare("opaque", Graphics::ALPHA_OPAQUE, TS_ARGB(255, 255, 255, 255));
+	}
+
+	void test_binary_blit() {
+		compare("binary", Graphics::ALPHA_BINARY, TS_ARGB(255, 255, 255, 255));
+	}
+
+	void test_alpha_blit() {
+		compare("alpha", Graphics::ALPHA_FULL, TS_ARGB(255, 255, 255, 255));
+		compare("alpha, flipped", Graphics::ALPHA_FULL, TS_ARGB(255, 255, 255, 255), Graphics::FLIP_H);
+	}
+
+	void test_tinted_alpha_blit() {
+		compare("tinted alpha", Graphics::ALPHA_FULL, TS_ARGB(160, 255, 200, 100));
+	}
+};
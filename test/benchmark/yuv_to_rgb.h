@@ -0,0 +1,86 @@
+#include "helper.h"
+
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/worker-pool.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+class YUVToRGBBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		// Every size converts about the same number of pixels, 100 frames of 720p
+		kPixels = 1280 * 720 * 100
+	};
+
+	typedef Common::Array<byte> Plane;
+
+	static void fillPlane(Plane &plane, uint size, uint32 seed) {
+		plane.resize(size);
+		for (uint i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			plane[i] = seed >> 16;
+		}
+	}
+
+	static int getFrameCount(int width, int height) {
+		return kPixels / (width * height);
+	}
+
+	static uint32 convertFrames(bool simd, bool alpha, int width, int height, const Graphics::PixelFormat &format) {
+		if (!g_system)
+			Common::install_null_g_system();
+		Common::WorkerPool::destroy();
+		ConfMan.setInt("worker_threads", 1, Common::ConfigManager::kApplicationDomain);
+		YUVToRGBMan.enableSimd(simd);
+
+		Plane y, u, v, a;
+		fillPlane(y, width * height, 1);
+		fillPlane(u, width * height / 4, 2);
+		fillPlane(v, width * height / 4, 3);
+		fillPlane(a, width * height, 4);
+
+		Graphics::Surface surface;
+		surface.create(width, height, format);
+		BenchmarkTimer timer;
+		for (int frame = 0; frame < getFrameCount(width, height); ++frame) {
+			if (alpha)
+				YUVToRGBMan.convert420Alpha(&surface, Graphics::YUVToRGBManager::kScaleFull, y.data(), u.data(), v.data(), a.data(), width, height, width, width / 2);
+			else
+				YUVToRGBMan.convert420(&surface, Graphics::YUVToRGBManager::kScaleITU, y.data(), u.data(), v.data(), width, height, width, width / 2);
+		}
+		const uint32 millis = timer.elapsedMillis();
+		surface.free();
+
+		YUVToRGBMan.enableSimd(true);
+		Common::WorkerPool::destroy();
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kApplicationDomain);
+		return millis;
+	}
+
+	static void compare(const char *name, bool alpha, const Graphics::PixelFormat &format) {
+		const int sizes[][2] = { { 320, 240 }, { 640, 480 }, { 1280, 720 } };
+		for (int i = 0; i < ARRAYSIZE(sizes); ++i) {
+			const int frames = getFrameCount(sizes[i][0], sizes[i][1]);
+			const uint32 lookupMillis = convertFrames(false, alpha, sizes[i][0], sizes[i][1], format);
+			const uint32 simdMillis = convertFrames(true, alpha, sizes[i][0], sizes[i][1], format);
+			BENCHMARK_REPORT("%s %dx%d: lookup tables %.3f ms, SIMD %.3f ms per frame (%.2fx)",
+				name, sizes[i][0], sizes[i][1], (double)lookupMillis / frames, (double)simdMillis / frames,
+				(double)lookupMillis / MAX<uint32>(simdMillis, 1));
+		}
+	}
+
+public:
+	void test_convert420_rgb565() {
+		compare("YUV420 to RGB565", false, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+
+	void test_convert420_rgba8888() {
+		compare("YUV420 to RGBA8888", false, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	}
+
+	void test_convert420_alpha_rgba8888() {
+		compare("YUVA420 to RGBA8888", true, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	}
+};
@@ -0,0 +1,118 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/arena.h"
+#include "common/pool-allocator.h"
+
+class ArenaTestSuite : public CxxTest::TestSuite
+{
+	struct PooledObject : public Common::PoolAllocated {
+		uint32 values[10];
+	};
+
+	public:
+	void test_arena_alignment() {
+		Common::Arena arena(256);
+
+		for (int i = 1; i < 100; ++i) {
+			byte *small = (byte *)arena.allocate(1, 1);
+			uint32 *aligned = (uint32 *)arena.allocate(i * 3, 16);
+			TS_ASSERT(small != nullptr);
+			TS_ASSERT_EQUALS((size_t)aligned & 15, 0U);
+			// The memory has to be usable
+			memset(aligned, 0xAA, i * 3);
+		}
+	}
+
+	void test_arena_reset() {
+		Common::Arena arena(1024);
+
+		for (int frame = 0; frame < 3; ++frame) {
+			void *first = arena.allocate(16);
+			for (int i = 0; i < 100; ++i)
+				arena.allocate(40);
+			// Larger than a block
+			byte *big = arena.allocateArray<byte>(5000);
+			memset(big, 0, 5000);
+
+			const Common::Arena::Stats stats = arena.getStats();
+			TS_ASSERT_EQUALS(stats.allocations, 102U);
+			TS_ASSERT_EQUALS(stats.bytesUsed, 16U + 100 * 40 + 5000);
+
+			// The memory of the previous frame is reused
+			static void *firstOfFirstFrame = nullptr;
+			if (frame == 0)
+				firstOfFirstFrame = first;
+			else
+				TS_ASSERT_EQUALS(first, firstOfFirstFrame);
+
+			arena.reset();
+		}
+
+		const Common::Arena::Stats stats = arena.getStats();
+		TS_ASSERT_EQUALS(stats.frames, 3U);
+		TS_ASSERT_EQUALS(stats.bytesUsed, 0U);
+		TS_ASSERT_EQUALS(stats.lastFrameAllocations, 102U);
+		TS_ASSERT_EQUALS(stats.peakBytes, 16U + 100 * 40 + 5000);
+
+		arena.release();
+		TS_ASSERT_EQUALS(arena.getStats().reservedBytes, 0U);
+	}
+
+	void test_arena_placement_new() {
+		Common::Arena arena;
+		int *value = new (arena) int(42);
+		TS_ASSERT_EQUALS(*value, 42);
+	}
+
+	void test_pool_allocator() {
+		const Common::PoolAllocator::Stats before = Common::PoolAllocator::getStats();
+
+		void *blocks[200];
+		for (int i = 0; i < 200; ++i) {
+			blocks[i] = Common::PoolAllocator::allocate(i * 2);
+			memset(blocks[i], i, i * 2);
+		}
+		for (int i = 0; i < 200; ++i) {
+			// Blocks must not overlap
+			for (int j = 0; j < i * 2; ++j)
+				TS_ASSERT_EQUALS(((byte *)blocks[i])[j], i);
+		}
+
+		Common::PoolAllocator::Stats stats = Common::PoolAllocator::getStats();
+		TS_ASSERT_EQUALS(stats.allocations - before.allocations, 200U);
+		TS_ASSERT_EQUALS(stats.largeAllocations - before.largeAllocations, 200U - 129);
+		TS_ASSERT(stats.peakBytesInUse >= stats.bytesInUse);
+
+		for (int i = 0; i < 200; ++i)
+			Common::PoolAllocator::deallocate(blocks[i], i * 2);
+
+		stats = Common::PoolAllocator::getStats();
+		TS_ASSERT_EQUALS(stats.deallocations - before.deallocations, 200U);
+		TS_ASSERT_EQUALS(stats.bytesInUse, before.bytesInUse);
+
+		PooledObject *object = new PooledObject();
+		object->values[9] = 1;
+		delete object;
+		TS_ASSERT_EQUALS(Common::PoolAllocator::getStats().bytesInUse, before.bytesInUse);
+
+		Common::PoolAllocator::flushThreadCache();
+	}
+
+	void test_pool_allocator_peak() {
+		Common::PoolAllocator::resetPeak();
+		const Common::PoolAllocator::Stats before = Common::PoolAllocator::getStats();
+
+		// The peak is reached and left again without reading the statistics
+		void *blocks[1024];
+		for (int i = 0; i < ARRAYSIZE(blocks); ++i)
+			blocks[i] = Common::PoolAllocator::allocate(256);
+		for (int i = 0; i < ARRAYSIZE(blocks); ++i)
+			Common::PoolAllocator::deallocate(blocks[i], 256);
+
+		const Common::PoolAllocator::Stats stats = Common::PoolAllocator::getStats();
+		TS_ASSERT_EQUALS(stats.bytesInUse, before.bytesInUse);
+		TS_ASSERT(stats.peakBytesInUse >= before.bytesInUse + 256 * 1024 - 16 * 1024);
+
+		Common::PoolAllocator::flushThreadCache();
+	}
+};
@@ -0,0 +1,152 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		Common::FlatHashMap<Common::String, Common::String> container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+		TS_ASSERT(!container2.contains("foo"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(container.find(0));
+		TS_ASSERT(!container.contains(0));
+		container.erase(1);
+		container.erase(2);
+		TS_ASSERT(container.empty());
+		TS_ASSERT_EQUALS(container.find(2), container.end());
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(1, -10), -1);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17, -10), -10);
+
+		int val = 0;
+		TS_ASSERT(containerRef.tryGetVal(1, val));
+		TS_ASSERT_EQUALS(val, -1);
+		TS_ASSERT(!containerRef.tryGetVal(2, val));
+	}
+
+	void test_copy() {
+		Common::FlatHashMap<Common::String, int> map1, container2;
+		for (int i = 0; i < 100; ++i)
+			map1[Common::String::format("key%d", i)] = i;
+		map1.erase("key50");
+
+		container2 = map1;
+		Common::FlatHashMap<Common::String, int> container3(map1);
+		map1.clear();
+
+		TS_ASSERT_EQUALS(container2.size(), 99U);
+		TS_ASSERT_EQUALS(container3.size(), 99U);
+		TS_ASSERT_EQUALS(container2["key23"], 23);
+		TS_ASSERT_EQUALS(container3["key99"], 99);
+		TS_ASSERT(!container2.contains("key50"));
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		container.erase(1);
+		container[1] = 42;
+		container.erase(0);
+		container.erase(1);
+
+		int found = 0;
+		for (Common::FlatHashMap<int, int>::const_iterator i = container.begin(); i != container.end(); ++i) {
+			int key = i->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+
+		// Values can be changed through the iterators
+		for (Common::FlatHashMap<int, int>::iterator i = container.begin(); i != container.end(); ++i)
+			i->_value = (*i)._key * 2;
+		TS_ASSERT_EQUALS(container[2], 4);
+		TS_ASSERT_EQUALS(container[4], 8);
+	}
+
+	void test_against_hashmap() {
+		// Mix insertions and removals, so that the map has to grow and
+		// to reuse deleted slots, and compare with a regular HashMap.
+		Common::FlatHashMap<uint32, uint32> flat;
+		Common::HashMap<uint32, uint32> reference;
+
+		uint32 seed = 1;
+		for (int i = 0; i < 20000; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const uint32 key = (seed >> 16) % 3000;
+			if (seed & 0x100) {
+				flat[key] = i;
+				reference[key] = i;
+			} else {
+				flat.erase(key);
+				reference.erase(key);
+			}
+		}
+
+		TS_ASSERT_EQUALS(flat.size(), reference.size());
+		for (Common::HashMap<uint32, uint32>::const_iterator i = reference.begin(); i != reference.end(); ++i)
+			TS_ASSERT_EQUALS(flat.getValOrDefault(i->_key, 0xFFFFFFFF), i->_value);
+
+		uint count = 0;
+		for (Common::FlatHashMap<uint32, uint32>::iterator i = flat.begin(); i != flat.end(); ++i) {
+			TS_ASSERT(reference.contains(i->_key));
+			count++;
+		}
+		TS_ASSERT_EQUALS(count, reference.size());
+	}
+
+	void test_reserve() {
+		Common::FlatHashMap<int, int> container;
+		container.reserve(1000);
+		container[5] = 5;
+
+		// Values must not move while adding the reserved number of entries
+		int *value = &container[5];
+		for (int i = 0; i < 999; ++i)
+			container[i + 1000] = i;
+		TS_ASSERT_EQUALS(value, &container[5]);
+		TS_ASSERT_EQUALS(container.size(), 1000U);
+	}
+};
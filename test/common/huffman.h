@@ -2,6 +2,7 @@
 #include "common/huffman.h"
 #include "common/bitstream.h"
 #include "common/memstream.h"
+#include "common/array.h"
 
 /**
 * A test suite for the Huffman decoder in common/huffman.h
@@ -10,7 +11,98 @@
 * TODO: It could be improved by generating one at runtime.
 */
 class HuffmanTestSuite : public CxxTest::TestSuite {
+	/**
+	 * Write a code to a buffer in the bit order of a MSB2LSB or LSB2MSB bit
+	 * stream, starting with its most or least significant bit respectively.
+	 */
+	static void writeCode(Common::Array<byte> &buffer, uint32 &bitPos, uint32 code, uint8 length, bool msb2lsb) {
+		for (int i = 0; i < length; i++, bitPos++) {
+			if (bitPos / 8 >= buffer.size())
+				buffer.push_back(0);
+			if ((code >> (msb2lsb ? length - 1 - i : i)) & 1)
+				buffer[bitPos / 8] |= msb2lsb ? (0x80 >> (bitPos % 8)) : (1 << (bitPos % 8));
+		}
+	}
+
+	/**
+	 * Assign canonical codes to the lengths, which are sorted by increasing length.
+	 * The codes are prefix free when read from their most significant bit.
+	 */
+	static void canonicalCodes(const Common::Array<uint8> &lengths, Common::Array<uint32> &codes) {
+		uint32 code = 0;
+		for (uint i = 0; i < lengths.size(); i++) {
+			if (i > 0)
+				code = (code + 1) << (lengths[i] - lengths[i - 1]);
+			codes.push_back(code);
+		}
+	}
+
+	template<class BITSTREAM>
+	static void checkRoundTrip(const Common::Array<uint8> &lengths) {
+		Common::Array<uint32> codes, symbols;
+		canonicalCodes(lengths, codes);
+		for (uint i = 0; i < lengths.size(); i++) {
+			// LSB2MSB streams read the codes from their least significant bit
+			if (!BITSTREAM::isMSB2LSB())
+				codes[i] = Common::REVERSEBITS(codes[i]) >> (32 - lengths[i]);
+			symbols.push_back(i * 3 + 7);
+		}
+
+		Common::Huffman<BITSTREAM> h(0, lengths.size(), codes.data(), lengths.data(), symbols.data());
+
+		// Every symbol once, then a pseudo random sequence
+		Common::Array<uint32> expected;
+		for (uint i = 0; i < lengths.size(); i++)
+			expected.push_back(i);
+		uint32 seed = 1;
+		for (uint i = 0; i < 1000; i++) {
+			seed = seed * 1103515245 + 12345;
+			expected.push_back((seed >> 8) % lengths.size());
+		}
+
+		Common::Array<byte> buffer;
+		uint32 bitPos = 0;
+		for (uint i = 0; i < expected.size(); i++)
+			writeCode(buffer, bitPos, codes[expected[i]], lengths[expected[i]], BITSTREAM::isMSB2LSB());
+
+		Common::MemoryReadStream ms(buffer.data(), buffer.size());
+		BITSTREAM bs(ms);
+		const uint half = expected.size() / 2;
+		for (uint i = 0; i < half; i++)
+			TS_ASSERT_EQUALS(h.getSymbol(bs), symbols[expected[i]]);
+
+		Common::Array<uint32> decoded;
+		decoded.resize(expected.size() - half);
+		h.getSymbols(bs, decoded.data(), decoded.size());
+		for (uint i = 0; i < decoded.size(); i++)
+			TS_ASSERT_EQUALS(decoded[i], symbols[expected[half + i]]);
+		TS_ASSERT_EQUALS(bs.pos(), bitPos);
+	}
+
 	public:
+	void test_long_codes() {
+		// A code of each length up to 30 bits, taking up to three lookups
+		Common::Array<uint8> lengths;
+		for (uint8 length = 1; length < 30; length++)
+			lengths.push_back(length);
+		lengths.push_back(29);
+
+		checkRoundTrip<Common::BitStream8MSB>(lengths);
+		checkRoundTrip<Common::BitStream8LSB>(lengths);
+	}
+
+	void test_many_codes() {
+		// 12 and 13 bit codes all spreading over the second level tables
+		Common::Array<uint8> lengths;
+		for (uint i = 0; i < 2048; i++)
+			lengths.push_back(12);
+		for (uint i = 0; i < 4096; i++)
+			lengths.push_back(13);
+
+		checkRoundTrip<Common::BitStream8MSB>(lengths);
+		checkRoundTrip<Common::BitStream8LSB>(lengths);
+	}
+
 	void test_get_with_full_symbols() {
 
 		/*
@@ -0,0 +1,116 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+#include "common/config-manager.h"
+#include "common/mutex.h"
+#include "common/worker-pool.h"
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_WORKER_POOL 1
+#else
+#define TEST_WORKER_POOL 0
+#endif
+
+class WorkerPoolTestSuite : public CxxTest::TestSuite
+{
+	struct SumTask {
+		uint32 values[1000];
+		volatile uint32 calls;
+	};
+
+	struct NestedTask {
+		volatile uint32 succeeded;
+	};
+
+	struct CounterTask {
+		Common::Mutex mutex;
+		uint32 counter;
+	};
+
+	static void squareTask(uint index, void *param) {
+		SumTask *task = (SumTask *)param;
+		task->values[index] = index * index;
+		Common::atomicAdd(&task->calls, 1U);
+	}
+
+	static void nestedTask(uint index, void *param) {
+		// Runs on the calling thread, since the pool is busy
+		SumTask inner;
+		inner.calls = 0;
+		Common::WorkerPool::instance().run(10, squareTask, &inner);
+		if (inner.calls == 10 && inner.values[9] == 81)
+			Common::atomicAdd(&((NestedTask *)param)->succeeded, 1U);
+	}
+
+	static void countTask(uint index, void *param) {
+		CounterTask *task = (CounterTask *)param;
+		for (int i = 0; i < 10000; ++i) {
+			Common::StackLock lock(task->mutex);
+			task->counter++;
+		}
+	}
+
+	public:
+	void setUp() {
+#if TEST_WORKER_POOL
+		// Use several threads even on machines with a single core
+		Common::install_null_g_system();
+		Common::WorkerPool::destroy();
+		ConfMan.setInt("worker_threads", 4, Common::ConfigManager::kApplicationDomain);
+#endif
+	}
+
+	void tearDown() {
+#if TEST_WORKER_POOL
+		Common::WorkerPool::destroy();
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kApplicationDomain);
+#endif
+	}
+
+	void test_run() {
+#if TEST_WORKER_POOL
+		TS_ASSERT_EQUALS(Common::WorkerPool::instance().getThreadCount(), 4U);
+
+		SumTask task;
+		for (int round = 0; round < 50; ++round) {
+			task.calls = 0;
+			for (uint i = 0; i < ARRAYSIZE(task.values); ++i)
+				task.values[i] = 0;
+
+			Common::WorkerPool::instance().run(ARRAYSIZE(task.values), squareTask, &task);
+
+			TS_ASSERT_EQUALS(task.calls, (uint32)ARRAYSIZE(task.values));
+			bool correct = true;
+			for (uint i = 0; i < ARRAYSIZE(task.values); ++i)
+				correct &= (task.values[i] == i * i);
+			TS_ASSERT(correct);
+		}
+
+		task.calls = 0;
+		Common::WorkerPool::instance().run(0, squareTask, &task);
+		TS_ASSERT_EQUALS(task.calls, 0U);
+		Common::WorkerPool::instance().run(1, squareTask, &task);
+		TS_ASSERT_EQUALS(task.calls, 1U);
+#endif
+	}
+
+	void test_nested_run() {
+#if TEST_WORKER_POOL
+		NestedTask task;
+		task.succeeded = 0;
+		Common::WorkerPool::instance().run(20, nestedTask, &task);
+		TS_ASSERT_EQUALS(task.succeeded, 20U);
+#endif
+	}
+
+	void test_mutex() {
+#if TEST_WORKER_POOL
+		// Mutexes have to exclude each other when the threads are real
+		CounterTask task;
+		task.counter = 0;
+		Common::WorkerPool::instance().run(8, countTask, &task);
+		TS_ASSERT_EQUALS(task.counter, 80000U);
+#endif
+	}
+};
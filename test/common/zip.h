@@ -0,0 +1,196 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/unzip.h"
+#include "../null_osystem.h"
+
+// Archives use a mutex to serialize reads, which needs an OSystem
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_ZIP 1
+#else
+#define TEST_ZIP 0
+#endif
+
+// A ZIP file with two members: "readme.txt", which is stored, and
+// "data/pattern.bin", which is deflated and contains 40000 bytes generated
+// by patternByte().
+static const byte zipData[] = {
+	0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00, 0x6a, 0xf1,
+	0x84, 0x4e, 0x21, 0x00, 0x00, 0x00, 0x21, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x72, 0x65,
+	0x61, 0x64, 0x6d, 0x65, 0x2e, 0x74, 0x78, 0x74, 0x53, 0x74, 0x6f, 0x72, 0x65, 0x64, 0x20, 0x6d,
+	0x65, 0x6d, 0x62, 0x65, 0x72, 0x20, 0x6f, 0x66, 0x20, 0x61, 0x20, 0x74, 0x65, 0x73, 0x74, 0x20,
+	0x61, 0x72, 0x63, 0x68, 0x69, 0x76, 0x65, 0x2e, 0x0a, 0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00,
+	0x00, 0x08, 0x00, 0x00, 0x00, 0x21, 0x00, 0x0f, 0x0f, 0x82, 0x2b, 0x19, 0x04, 0x00, 0x00, 0x40,
+	0x9c, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x64, 0x61, 0x74, 0x61, 0x2f, 0x70, 0x61, 0x74, 0x74,
+	0x65, 0x72, 0x6e, 0x2e, 0x62, 0x69, 0x6e, 0xed, 0xcf, 0xe7, 0x22, 0x10, 0x0a, 0x00, 0x06, 0x50,
+	0x7b, 0x86, 0xc8, 0xcc, 0x4c, 0x36, 0xd9, 0x5b, 0x46, 0x92, 0x86, 0xbd, 0x8a, 0xec, 0x2d, 0xc9,
+	0x0a, 0xa5, 0x6c, 0x52, 0x29, 0x8a, 0x86, 0xbd, 0x47, 0x0a, 0xc9, 0xca, 0xc8, 0xa6, 0xec, 0x2d,
+	0x15, 0x95, 0x51, 0x54, 0x56, 0xc3, 0xaa, 0xac, 0xfb, 0xf3, 0xbe, 0x42, 0x3f, 0xbe, 0xf3, 0x06,
+	0x87, 0x80, 0x9c, 0x96, 0x89, 0xe3, 0xa0, 0x88, 0x94, 0xa2, 0xba, 0xb6, 0x9e, 0xa9, 0xa5, 0xc3,
+	0x39, 0xef, 0x4b, 0x21, 0xd7, 0x6e, 0xdf, 0x4b, 0xc9, 0x2e, 0x2c, 0x7d, 0xde, 0xd0, 0xde, 0x33,
+	0xfc, 0x6e, 0xea, 0xcb, 0xf2, 0xda, 0x16, 0x31, 0x15, 0x3d, 0x2b, 0xb7, 0xc0, 0x21, 0x59, 0x15,
+	0xcd, 0x93, 0x86, 0x67, 0x6c, 0x9c, 0x3d, 0x2e, 0x5e, 0x09, 0xbf, 0x71, 0xe7, 0x61, 0x7a, 0x5e,
+	0x51, 0x79, 0x6d, 0x73, 0x47, 0xff, 0xeb, 0xf7, 0x9f, 0xe6, 0x7f, 0xfe, 0xde, 0x25, 0xa3, 0x61,
+	0x64, 0xe7, 0x15, 0x96, 0x54, 0x50, 0x3b, 0xa6, 0x6b, 0x72, 0xd6, 0xde, 0xcd, 0x2b, 0x20, 0x38,
+	0xea, 0x56, 0x42, 0x72, 0xd6, 0xa3, 0xa7, 0x55, 0xf5, 0x6d, 0xdd, 0x43, 0x6f, 0x27, 0xe7, 0x96,
+	0x56, 0x37, 0x89, 0x28, 0xf7, 0xb2, 0x70, 0xf1, 0x8b, 0xc9, 0x28, 0x1f, 0x39, 0x61, 0x70, 0xda,
+	0xda, 0xe9, 0xbc, 0x6f, 0x60, 0xd8, 0xf5, 0xb8, 0x07, 0x69, 0xb9, 0x4f, 0xca, 0x6a, 0x9a, 0x5e,
+	0xf5, 0x8d, 0x4e, 0xcc, 0x7c, 0xfb, 0xb1, 0xb1, 0x43, 0xba, 0x67, 0xdf, 0xfe, 0x03, 0x42, 0x12,
+	0xf2, 0xaa, 0x5a, 0x3a, 0xc6, 0x16, 0x76, 0xae, 0x9e, 0xfe, 0x41, 0x91, 0x31, 0xf1, 0x49, 0x99,
+	0x05, 0x25, 0x95, 0x2f, 0x5a, 0xbb, 0x06, 0xdf, 0x7c, 0x9c, 0x5d, 0x5c, 0xf9, 0x4b, 0x48, 0x41,
+	0xc7, 0xcc, 0xc9, 0x27, 0x2a, 0xad, 0xa4, 0x71, 0x5c, 0xdf, 0xcc, 0xca, 0xd1, 0xdd, 0xe7, 0x72,
+	0x68, 0x74, 0xec, 0xfd, 0xd4, 0x9c, 0xc7, 0xcf, 0xaa, 0x1b, 0x5f, 0xf6, 0x8e, 0x8c, 0x4f, 0x7f,
+	0xfd, 0xbe, 0xbe, 0x4d, 0x42, 0xcd, 0xc0, 0xc6, 0x23, 0x28, 0x2e, 0x77, 0xf8, 0xe8, 0x29, 0x23,
+	0x73, 0x5b, 0x97, 0x0b, 0x7e, 0x57, 0x23, 0x6e, 0xde, 0x4d, 0xcc, 0xc8, 0x2f, 0xae, 0xa8, 0x6b,
+	0xe9, 0x1c, 0x18, 0xfb, 0xf0, 0x79, 0xe1, 0xd7, 0x1f, 0x02, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc,
+	0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1,
+	0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7,
+	0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f,
+	0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f,
+	0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xff, 0x07, 0xfe, 0x84, 0x64, 0x74, 0x8c, 0x9c, 0xbc,
+	0xa2, 0x92, 0x4a, 0x6a, 0xc7, 0x75, 0xcd, 0xce, 0x3a, 0xba, 0xf9, 0x04, 0x84, 0x46, 0xc5, 0x26,
+	0xa4, 0x66, 0x3d, 0x7e, 0x5a, 0x5d, 0xff, 0xb2, 0x7b, 0xe4, 0xed, 0xf4, 0xdc, 0xf7, 0xd5, 0x6d,
+	0x22, 0xea, 0xbd, 0x6c, 0x5c, 0x82, 0x62, 0x72, 0xca, 0x47, 0x4f, 0x18, 0x9d, 0xb6, 0x75, 0xba,
+	0xe0, 0x7b, 0x35, 0xec, 0x66, 0x5c, 0x62, 0x5a, 0xfe, 0x93, 0x8a, 0x9a, 0x96, 0x57, 0x03, 0xa3,
+	0x1f, 0x66, 0x16, 0x7e, 0xfc, 0xd9, 0x21, 0xdf, 0xc3, 0xb4, 0xff, 0xa0, 0x90, 0x94, 0xbc, 0xba,
+	0x96, 0x9e, 0xb1, 0xa5, 0xdd, 0x39, 0xcf, 0x4b, 0x41, 0xd7, 0x62, 0xee, 0x25, 0x65, 0x17, 0x94,
+	0x56, 0x36, 0xb4, 0xf6, 0x0c, 0xbe, 0xfb, 0xf8, 0x65, 0x71, 0xed, 0x2f, 0x31, 0x05, 0x3d, 0x33,
+	0x37, 0xdf, 0x21, 0x69, 0x15, 0x8d, 0x93, 0xfa, 0x67, 0xac, 0x9c, 0xdd, 0x2f, 0x5e, 0x0e, 0x8f,
+	0xbe, 0x73, 0x3f, 0x3d, 0xa7, 0xe8, 0x59, 0x6d, 0x63, 0x47, 0xef, 0xeb, 0xf1, 0x4f, 0x5f, 0x7f,
+	0xae, 0xef, 0x92, 0xd0, 0x30, 0xb0, 0xf3, 0x08, 0x8b, 0x2b, 0x1c, 0x3e, 0x76, 0xca, 0xc4, 0xdc,
+	0xde, 0xc5, 0xcb, 0x2f, 0x38, 0xe2, 0xd6, 0xdd, 0xe4, 0x8c, 0x47, 0xc5, 0x55, 0x75, 0x6d, 0x9d,
+	0x43, 0x63, 0x93, 0x9f, 0x97, 0x7e, 0x6d, 0x12, 0x50, 0xd2, 0xb2, 0x70, 0xf0, 0x8b, 0xc8, 0x28,
+	0x1e, 0xd1, 0x36, 0x30, 0xb5, 0x76, 0x38, 0xef, 0x1d, 0x18, 0x72, 0xfd, 0xf6, 0x83, 0x94, 0xdc,
+	0xc2, 0xb2, 0xe7, 0x4d, 0xed, 0x7d, 0xc3, 0x13, 0x53, 0xdf, 0x96, 0x37, 0xb6, 0x48, 0xa9, 0xf6,
+	0xb1, 0x1e, 0x10, 0x90, 0x90, 0x55, 0xd5, 0xd4, 0x31, 0xb4, 0xb0, 0x71, 0xf5, 0xf0, 0xbf, 0x12,
+	0x79, 0x23, 0xfe, 0x61, 0x66, 0x5e, 0x49, 0xf9, 0x8b, 0xe6, 0xae, 0xfe, 0x37, 0xef, 0x67, 0xe7,
+	0x57, 0x7e, 0xe3, 0x8f, 0x3f, 0xfe, 0xf8, 0xe3, 0x8f, 0x3f, 0xfe, 0xf8, 0xe3, 0x8f, 0x3f, 0xfe,
+	0xf8, 0xe3, 0x8f, 0x3f, 0xfe, 0xf8, 0xe3, 0x8f, 0x3f, 0xfe, 0xf8, 0xe3, 0x8f, 0x3f, 0xfe, 0xf8,
+	0xe3, 0x8f, 0x3f, 0xfe, 0xf8, 0xe3, 0x8f, 0x3f, 0xfe, 0xf8, 0xe3, 0x8f, 0x3f, 0xfe, 0xf8, 0xe3,
+	0x8f, 0x3f, 0xfe, 0xf8, 0xe3, 0x8f, 0x3f, 0xfe, 0xf8, 0xe3, 0x8f, 0x3f, 0xfe, 0xf8, 0xe3, 0x8f,
+	0x3f, 0xfe, 0xf8, 0xe3, 0x8f, 0x3f, 0xfe, 0xf8, 0xe3, 0x8f, 0x3f, 0xfe, 0xf8, 0xe3, 0x8f, 0xff,
+	0xbf, 0xf0, 0x27, 0x22, 0xdd, 0xc3, 0xc2, 0x75, 0x40, 0x48, 0x46, 0x59, 0x55, 0xcb, 0xe0, 0xb4,
+	0x85, 0xdd, 0x79, 0x5f, 0xff, 0xa0, 0xeb, 0x71, 0xf1, 0x49, 0xb9, 0x4f, 0x4a, 0x2a, 0x9b, 0x5e,
+	0x75, 0x0d, 0x4e, 0xcc, 0xcc, 0x2e, 0x6e, 0xec, 0x10, 0x52, 0xec, 0xdb, 0xcf, 0xc9, 0x27, 0x21,
+	0xaf, 0xa4, 0xa1, 0x63, 0x6c, 0x66, 0xe5, 0xea, 0xe9, 0x73, 0x39, 0x32, 0x26, 0xf6, 0x7e, 0x66,
+	0xc1, 0xe3, 0x67, 0x2f, 0x5a, 0x5f, 0xf6, 0xbe, 0xf9, 0x38, 0xfd, 0x75, 0xe5, 0xef, 0x36, 0x09,
+	0x1d, 0x33, 0x1b, 0x8f, 0xa8, 0xb4, 0xdc, 0xe1, 0xe3, 0xfa, 0x46, 0xe6, 0x8e, 0xee, 0x17, 0xfc,
+	0x42, 0xa3, 0x6f, 0xde, 0x4d, 0xcd, 0xc9, 0x2f, 0xae, 0x6e, 0x6c, 0xe9, 0x1c, 0x19, 0xff, 0xf0,
+	0xf9, 0xfb, 0xfa, 0x1f, 0x02, 0x6a, 0x06, 0x26, 0x0e, 0x41, 0x71, 0x29, 0xc5, 0xa3, 0xa7, 0xf4,
+	0x4c, 0x6d, 0x5d, 0xce, 0x79, 0x5f, 0x8d, 0xb8, 0x76, 0x3b, 0x31, 0x23, 0xbb, 0xb0, 0xa2, 0xae,
+	0xa1, 0x7d, 0x60, 0xec, 0xdd, 0xd4, 0xc2, 0xaf, 0xb5, 0x2d, 0x72, 0x5a, 0x7a, 0xd6, 0x83, 0x22,
+	0x87, 0x64, 0xd5, 0xb5, 0x4f, 0x1a, 0x5a, 0x3a, 0x38, 0x7b, 0x5c, 0x0a, 0x09, 0xbf, 0x71, 0x2f,
+	0x25, 0x3d, 0xaf, 0xf4, 0x79, 0x6d, 0x73, 0xcf, 0xf0, 0xeb, 0xf7, 0x5f, 0x96, 0x7f, 0xfe, 0x26,
+	0xa6, 0xa2, 0x61, 0xe4, 0x16, 0x10, 0x96, 0x54, 0xd1, 0x3c, 0xa6, 0x7b, 0xc6, 0xc6, 0xde, 0xed,
+	0xe2, 0x95, 0xe0, 0xa8, 0x3b, 0x0f, 0x93, 0xb3, 0x8a, 0xca, 0xab, 0xea, 0x3b, 0xfa, 0x87, 0xde,
+	0x7e, 0x9a, 0x5f, 0x5a, 0xdd, 0x25, 0xa3, 0xdc, 0xcb, 0xce, 0xcb, 0x2f, 0xa6, 0xa0, 0x76, 0xe4,
+	0x84, 0xc9, 0x59, 0x6b, 0x27, 0xaf, 0x80, 0xc0, 0xb0, 0x5b, 0x09, 0x0f, 0xd2, 0x1e, 0x3d, 0x2d,
+	0xab, 0x69, 0xeb, 0xee, 0x1b, 0x9d, 0x9c, 0xfb, 0xf6, 0x63, 0x13, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f,
+	0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f,
+	0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xc7, 0x1f, 0x7f, 0xfc, 0xf1, 0xff, 0xff, 0xff, 0x1f,
+	0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00,
+	0x6a, 0xf1, 0x84, 0x4e, 0x21, 0x00, 0x00, 0x00, 0x21, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x72, 0x65,
+	0x61, 0x64, 0x6d, 0x65, 0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00,
+	0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x21, 0x00, 0x0f, 0x0f, 0x82, 0x2b, 0x19, 0x04, 0x00, 0x00,
+	0x40, 0x9c, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x80, 0x01, 0x49, 0x00, 0x00, 0x00, 0x64, 0x61, 0x74, 0x61, 0x2f, 0x70, 0x61, 0x74, 0x74, 0x65,
+	0x72, 0x6e, 0x2e, 0x62, 0x69, 0x6e, 0x50, 0x4b, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+	0x02, 0x00, 0x76, 0x00, 0x00, 0x00, 0x90, 0x04, 0x00, 0x00, 0x00, 0x00,
+};
+
+class ZipArchiveTestSuite : public CxxTest::TestSuite
+{
+	static byte patternByte(uint32 i) {
+		return ((i * 7) ^ (i >> 14)) & 0xFF;
+	}
+
+	static bool checkPattern(Common::SeekableReadStream *stream, uint32 start, uint32 count) {
+		for (uint32 i = start; i < start + count; ++i) {
+			if (stream->readByte() != patternByte(i))
+				return false;
+		}
+		return true;
+	}
+
+	static Common::Archive *openArchive(bool inMemory) {
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(zipData, sizeof(zipData));
+		if (!inMemory) {
+			// Hide the buffer, so that the archive has to seek and read
+			stream = new Common::SeekableSubReadStream(stream, 0, sizeof(zipData), DisposeAfterUse::YES);
+		}
+		return Common::makeZipArchive(stream);
+	}
+
+	void checkArchive(bool inMemory) {
+		Common::ScopedPtr<Common::Archive> archive(openArchive(inMemory));
+		TS_ASSERT(archive);
+
+		Common::ArchiveMemberList list;
+		TS_ASSERT_EQUALS(archive->listMembers(list), 2);
+		TS_ASSERT(archive->hasFile("README.TXT"));
+		TS_ASSERT(!archive->hasFile("missing.txt"));
+		TS_ASSERT(!archive->createReadStreamForMember("missing.txt"));
+
+		Common::ScopedPtr<Common::SeekableReadStream> stored(archive->createReadStreamForMember("readme.txt"));
+		TS_ASSERT(stored);
+		TS_ASSERT_EQUALS(stored->size(), 33);
+		TS_ASSERT_EQUALS(stored->readLine(), "Stored member of a test archive.");
+		stored->seek(7);
+		TS_ASSERT_EQUALS(stored->readLine(), "member of a test archive.");
+		stored->seek(-9, SEEK_END);
+		char tail[16];
+		TS_ASSERT_EQUALS(stored->read(tail, sizeof(tail)), 9U);
+		TS_ASSERT_EQUALS(Common::String(tail, 9), "archive.\n");
+		TS_ASSERT(stored->eos());
+		TS_ASSERT(!stored->err());
+
+		Common::ScopedPtr<Common::SeekableReadStream> deflated(archive->createReadStreamForMember("data/pattern.bin"));
+		Common::ScopedPtr<Common::SeekableReadStream> deflated2(archive->createReadStreamForMember("data/pattern.bin"));
+		TS_ASSERT(deflated && deflated2);
+		TS_ASSERT_EQUALS(deflated->size(), 40000);
+
+		// Interleave reads from two streams of the same member
+		TS_ASSERT(checkPattern(deflated.get(), 0, 20000));
+		TS_ASSERT(checkPattern(deflated2.get(), 0, 30000));
+		TS_ASSERT(checkPattern(deflated.get(), 20000, 20000));
+		TS_ASSERT(!deflated->eos());
+		deflated->readByte();
+		TS_ASSERT(deflated->eos());
+		TS_ASSERT(!deflated->err());
+
+		// Seek backwards within the current block, and to an earlier block
+		TS_ASSERT(deflated->seek(-100, SEEK_END));
+		TS_ASSERT(checkPattern(deflated.get(), 39900, 100));
+		TS_ASSERT(deflated->seek(1000));
+		TS_ASSERT(checkPattern(deflated.get(), 1000, 100));
+		TS_ASSERT(deflated->seek(35000));
+		TS_ASSERT_EQUALS(deflated->pos(), 35000);
+		TS_ASSERT(checkPattern(deflated.get(), 35000, 5000));
+		TS_ASSERT(!deflated->err());
+
+		// Streams remain usable after the archive is gone
+		archive.reset();
+		TS_ASSERT(checkPattern(deflated2.get(), 30000, 10000));
+		stored->seek(0);
+		TS_ASSERT_EQUALS(stored->readByte(), 'S');
+	}
+
+	public:
+	void test_memory_archive() {
+#if TEST_ZIP
+		Common::install_null_g_system();
+		checkArchive(true);
+#endif
+	}
+
+	void test_stream_archive() {
+#if TEST_ZIP
+		Common::install_null_g_system();
+		checkArchive(false);
+#endif
+	}
+};
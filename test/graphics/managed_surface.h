@@ -0,0 +1,88 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/managed_surface.h"
+
+class ManagedSurfaceTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kSpriteWidth = 29,
+		kSpriteHeight = 17
+	};
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	static void fill(Graphics::ManagedSurface &surface, int w, int h, const Graphics::PixelFormat &format, uint32 seed, bool sprite) {
+		surface.create(w, h, format);
+		for (int y = 0; y < h; ++y) {
+			for (int x = 0; x < w; ++x) {
+				const int run = (x / 6 + y) % 3;
+				byte alpha = 0xFF;
+				if (sprite)
+					alpha = run == 0 ? 0 : run == 1 ? 0xFF : nextRandom(seed) & 0xFF;
+				const uint32 rgb = nextRandom(seed);
+				surface.setPixel(x, y, format.ARGBToColor(alpha, rgb & 0xFF, (rgb >> 8) & 0xFF, (rgb >> 16) & 0xFF));
+			}
+		}
+	}
+
+	// The blending of transBlitFrom(), done one pixel at a time
+	static uint32 blendPixel(const Graphics::PixelFormat &format, uint32 srcVal, uint32 destVal) {
+		byte aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest;
+		format.colorToARGB(srcVal, aSrc, rSrc, gSrc, bSrc);
+		if (aSrc == 0)
+			return destVal;
+		if (aSrc == 0xFF)
+			return format.ARGBToColor(0xFF, rSrc, gSrc, bSrc);
+
+		format.colorToARGB(destVal, aDest, rDest, gDest, bDest);
+		double sAlpha = (double)aSrc / 255.0;
+		double dAlpha = (double)aDest / 255.0;
+		dAlpha *= (1.0 - sAlpha);
+		rDest = static_cast<uint8>((rSrc * sAlpha + rDest * dAlpha) / (sAlpha + dAlpha));
+		gDest = static_cast<uint8>((gSrc * sAlpha + gDest * dAlpha) / (sAlpha + dAlpha));
+		bDest = static_cast<uint8>((bSrc * sAlpha + bDest * dAlpha) / (sAlpha + dAlpha));
+		aDest = static_cast<uint8>(255. * (sAlpha + dAlpha));
+		return format.ARGBToColor(aDest, rDest, gDest, bDest);
+	}
+
+	static void checkSpriteBlit(const Graphics::PixelFormat &format, bool flipped) {
+		Graphics::ManagedSurface sprite, target, expected;
+		fill(sprite, kSpriteWidth, kSpriteHeight, format, 1, true);
+		fill(target, 48, 32, format, 2, false);
+		fill(expected, 48, 32, format, 2, false);
+
+		// Partially off the left and bottom edges of the target
+		const Common::Point pos(-3, 20);
+		target.transBlitFrom(sprite, pos, (uint)-1, flipped);
+
+		for (int y = 0; y < kSpriteHeight; ++y) {
+			for (int x = 0; x < kSpriteWidth; ++x) {
+				const int destX = pos.x + x, destY = pos.y + y;
+				if (destX < 0 || destY >= expected.h)
+					continue;
+				const uint32 srcVal = sprite.getPixel(flipped ? kSpriteWidth - x - 1 : x, y);
+				if (srcVal != 0xFFFFFFFF)
+					expected.setPixel(destX, destY, blendPixel(format, srcVal, expected.getPixel(destX, destY)));
+			}
+		}
+
+		for (int y = 0; y < target.h; ++y) {
+			for (int x = 0; x < target.w; ++x)
+				TS_ASSERT_EQUALS(target.getPixel(x, y), expected.getPixel(x, y));
+		}
+	}
+
+public:
+	void test_sprite_blit_rgba() {
+		checkSpriteBlit(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), false);
+		checkSpriteBlit(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), true);
+	}
+
+	void test_sprite_blit_argb() {
+		checkSpriteBlit(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24), false);
+		checkSpriteBlit(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24), true);
+	}
+};
@@ -0,0 +1,146 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/worker-pool.h"
+#include "graphics/scalerplugin.h"
+#include "../null_osystem.h"
+
+#ifdef USE_SCALERS
+#include "graphics/scaler/dotmatrix.h"
+#include "graphics/scaler/normal.h"
+#include "graphics/scaler/pm.h"
+#include "graphics/scaler/sai.h"
+#include "graphics/scaler/scalebit.h"
+#include "graphics/scaler/tv.h"
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+#endif
+
+class ScalerTestSuite : public CxxTest::TestSuite
+{
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_SCALERS)
+	enum {
+		kWidth = 96,
+		kHeight = 201,
+		kPadding = 4
+	};
+
+	typedef Common::Array<byte> Pixels;
+
+	template<class T>
+	static Scaler *create(const Graphics::PixelFormat &format) {
+		return new T(format);
+	}
+
+	typedef Scaler *(*CreateProc)(const Graphics::PixelFormat &format);
+
+	// Blocks of a few colors, so that the scalers find edges to smooth
+	static void fillSource(Graphics::Surface &source, const Graphics::PixelFormat &format) {
+		source.create(kWidth + kPadding * 2, kHeight + kPadding * 2, format);
+		uint32 seed = 1;
+		for (int y = 0; y < source.h; ++y) {
+			for (int x = 0; x < source.w; ++x) {
+				seed = seed * 1103515245 + 12345;
+				const byte shade = ((x / 3 + y / 5) & 1) ? 0x30 : 0xE0;
+				const byte noise = (seed >> 16) & 0x0F;
+				const uint32 color = format.RGBToColor(shade + noise, shade, 0xFF - shade);
+				if (format.bytesPerPixel == 2)
+					*(uint16 *)source.getBasePtr(x, y) = color;
+				else
+					*(uint32 *)source.getBasePtr(x, y) = color;
+			}
+		}
+	}
+
+	static void scale(uint threads, CreateProc createProc, uint factor, const Graphics::PixelFormat &format, Pixels &pixels) {
+		Common::WorkerPool::destroy();
+		ConfMan.setInt("worker_threads", threads, Common::ConfigManager::kApplicationDomain);
+
+		Graphics::Surface source;
+		fillSource(source, format);
+		Graphics::Surface target;
+		target.create(kWidth * factor, kHeight * factor, format);
+
+		Scaler *scaler = createProc(format);
+		scaler->setFactor(factor);
+		scaler->scale((const uint8 *)source.getBasePtr(kPadding, kPadding), source.pitch,
+			(uint8 *)target.getPixels(), target.pitch, kWidth, kHeight, 0, 0);
+		delete scaler;
+
+		const byte *dst = (const byte *)target.getPixels();
+		pixels = Pixels(dst, target.pitch * target.h);
+		target.free();
+		source.free();
+	}
+
+	static void checkBands(CreateProc createProc, uint minFactor, uint maxFactor) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		for (int i = 0; i < ARRAYSIZE(formats); ++i) {
+			for (uint factor = minFactor; factor <= maxFactor; ++factor) {
+				Pixels serial, banded;
+				scale(1, createProc, factor, formats[i], serial);
+				scale(4, createProc, factor, formats[i], banded);
+				TS_ASSERT(serial == banded);
+			}
+		}
+	}
+#endif
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_SCALERS)
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_SCALERS)
+		Common::WorkerPool::destroy();
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kApplicationDomain);
+#endif
+	}
+
+	void test_banded_normal_matches_serial() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_SCALERS)
+		checkBands(create<NormalScaler>, 2, 5);
+#endif
+	}
+
+	void test_banded_advmame_matches_serial() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_SCALERS)
+		checkBands(create<AdvMameScaler>, 2, 4);
+#endif
+	}
+
+	void test_banded_hq_matches_serial() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_SCALERS) && defined(USE_HQ_SCALERS)
+		checkBands(create<HQScaler>, 2, 3);
+#endif
+	}
+
+	void test_banded_sai_matches_serial() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_SCALERS)
+		checkBands(create<SAIScaler>, 2, 2);
+		checkBands(create<SuperSAIScaler>, 2, 2);
+		checkBands(create<SuperEagleScaler>, 2, 2);
+#endif
+	}
+
+	void test_banded_tv_dotmatrix_pm_match_serial() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_SCALERS)
+		checkBands(create<TVScaler>, 2, 2);
+		checkBands(create<DotMatrixScaler>, 2, 2);
+		checkBands(create<PMScaler>, 2, 2);
+#endif
+	}
+};
@@ -0,0 +1,286 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/worker-pool.h"
+#include "graphics/surface.h"
+#include "../null_osystem.h"
+
+#if defined(USE_TINYGL) && NULL_OSYSTEM_IS_AVAILABLE
+#include "graphics/tinygl/tinygl.h"
+#define TEST_TINYGL 1
+#else
+#define TEST_TINYGL 0
+#endif
+
+class TinyGLTestSuite : public CxxTest::TestSuite
+{
+#if TEST_TINYGL
+	enum {
+		kWidth = 320,
+		kHeight = 240,
+		kFrames = 3
+	};
+
+	typedef Common::Array<uint32> Frame;
+
+	static float nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return ((seed >> 8) & 0xffff) / 65535.0f;
+	}
+
+	static void drawScene(int frame, TinyGL::BlitImage *image) {
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+
+		// Only some of the triangles move, so that the dirty rects do not cover the whole screen
+		uint32 seed = 1;
+		for (int i = 0; i < 40; ++i) {
+			const float offset = (i % 8 == 0) ? frame * 0.05f : 0.0f;
+			tglBegin(TGL_TRIANGLES);
+			for (int v = 0; v < 3; ++v) {
+				tglColor3f(nextRandom(seed), nextRandom(seed), nextRandom(seed));
+				// Some of the vertices are outside of the view volume
+				tglVertex3f(nextRandom(seed) * 2.4f - 1.2f + offset, nextRandom(seed) * 2.4f - 1.2f, nextRandom(seed) * 1.8f - 0.9f);
+			}
+			tglEnd();
+		}
+
+		tglEnable(TGL_BLEND);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		tglBegin(TGL_QUADS);
+		tglColor4f(1.0f, 1.0f, 0.0f, 0.5f);
+		tglVertex3f(-0.5f + frame * 0.1f, -0.5f, -0.95f);
+		tglVertex3f(0.5f + frame * 0.1f, -0.5f, -0.95f);
+		tglColor4f(0.0f, 1.0f, 1.0f, 0.25f);
+		tglVertex3f(0.5f + frame * 0.1f, 0.5f, -0.95f);
+		tglVertex3f(-0.5f + frame * 0.1f, 0.5f, -0.95f);
+		tglEnd();
+
+		tglBegin(TGL_QUAD_STRIP);
+		for (int i = 0; i < 6; ++i) {
+			tglColor4f(i / 6.0f, 0.5f, 1.0f - i / 6.0f, 0.75f);
+			tglVertex3f(-0.9f + i * 0.3f, 0.6f, -0.5f);
+			tglVertex3f(-0.9f + i * 0.3f, 0.9f, -0.5f);
+		}
+		tglEnd();
+		tglDisable(TGL_BLEND);
+
+		tglBegin(TGL_LINE_STRIP);
+		for (int i = 0; i < 10; ++i) {
+			tglColor3f(1.0f, i / 10.0f, 0.0f);
+			tglVertex3f(-1.0f + i * 0.22f, (i & 1) ? -0.8f : 0.8f, 0.0f);
+		}
+		tglEnd();
+
+		tglDisable(TGL_DEPTH_TEST);
+		tglBlitFast(image, 10 + frame * 7, 150);
+		tglEnable(TGL_BLEND);
+		tglBlit(image, 250, 20 + frame * 5);
+		tglDisable(TGL_BLEND);
+	}
+
+	static void render(uint threads, bool dirtyRects, Common::Array<Frame> &frames) {
+		Common::WorkerPool::destroy();
+		ConfMan.setInt("worker_threads", threads, Common::ConfigManager::kApplicationDomain);
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		TinyGL::createContext(kWidth, kHeight, format, 256, false, dirtyRects);
+
+		Graphics::Surface imageSurface;
+		imageSurface.create(48, 40, format);
+		for (int y = 0; y < imageSurface.h; ++y) {
+			for (int x = 0; x < imageSurface.w; ++x) {
+				const uint8 alpha = ((x / 8 + y / 8) & 1) ? 0 : (y * 6);
+				imageSurface.setPixel(x, y, format.ARGBToColor(alpha, x * 5, 255 - y * 6, 128));
+			}
+		}
+		TinyGL::BlitImage *image = tglGenBlitImage();
+		tglUploadBlitImage(image, imageSurface, 0, false);
+		imageSurface.free();
+
+		for (int frame = 0; frame < kFrames; ++frame) {
+			drawScene(frame, image);
+			TinyGL::presentBuffer();
+
+			Frame pixels;
+			captureFrame(pixels);
+			frames.push_back(pixels);
+		}
+
+		tglDeleteBlitImage(image);
+		TinyGL::destroyContext();
+	}
+
+	static void captureFrame(Frame &pixels) {
+		Graphics::Surface surface;
+		TinyGL::getSurfaceRef(surface);
+		for (int y = 0; y < surface.h; ++y) {
+			const uint32 *row = (const uint32 *)surface.getBasePtr(0, y);
+			for (int x = 0; x < surface.w; ++x)
+				pixels.push_back(row[x]);
+		}
+	}
+
+	// Goes through all the triangle fillers which have SSE2/NEON variants: depth
+	// only, flat, smooth and textured (nearest and bilinear), with every depth
+	// function and with and without depth writes
+	static void drawSpanScene(const TGLuint *textures) {
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+		tglEnable(TGL_DEPTH_TEST);
+
+		uint32 seed = 7;
+		tglColorMask(TGL_FALSE, TGL_FALSE, TGL_FALSE, TGL_FALSE);
+		tglBegin(TGL_TRIANGLES);
+		for (int i = 0; i < 30; ++i)
+			tglVertex3f(nextRandom(seed) * 2.4f - 1.2f, nextRandom(seed) * 2.4f - 1.2f, nextRandom(seed) * 1.8f - 0.9f);
+		tglEnd();
+		tglColorMask(TGL_TRUE, TGL_TRUE, TGL_TRUE, TGL_TRUE);
+
+		const TGLenum depthFuncs[] = { TGL_LEQUAL, TGL_LESS, TGL_GREATER, TGL_EQUAL, TGL_NOTEQUAL, TGL_GEQUAL, TGL_ALWAYS, TGL_NEVER };
+		for (int i = 0; i < 96; ++i) {
+			tglDepthFunc(depthFuncs[i % ARRAYSIZE(depthFuncs)]);
+			tglDepthMask((i % 5 == 4) ? TGL_FALSE : TGL_TRUE);
+			tglShadeModel((i & 1) ? TGL_FLAT : TGL_SMOOTH);
+			const int texture = (i / 2) % 3;
+			if (texture) {
+				tglEnable(TGL_TEXTURE_2D);
+				tglBindTexture(TGL_TEXTURE_2D, textures[texture - 1]);
+			} else {
+				tglDisable(TGL_TEXTURE_2D);
+			}
+
+			tglBegin(TGL_TRIANGLES);
+			for (int v = 0; v < 3; ++v) {
+				tglColor4f(nextRandom(seed), nextRandom(seed), nextRandom(seed), nextRandom(seed));
+				tglTexCoord2f(nextRandom(seed) * 3.0f - 1.0f, nextRandom(seed) * 3.0f - 1.0f);
+				tglVertex3f(nextRandom(seed) * 2.4f - 1.2f, nextRandom(seed) * 2.4f - 1.2f, nextRandom(seed) * 1.8f - 0.9f);
+			}
+			tglEnd();
+		}
+		tglDisable(TGL_TEXTURE_2D);
+		tglDepthMask(TGL_TRUE);
+		tglDepthFunc(TGL_LESS);
+
+		tglDisable(TGL_DEPTH_TEST);
+		tglBegin(TGL_TRIANGLES);
+		tglColor3f(1.0f, 0.5f, 0.0f);
+		tglVertex3f(-0.2f, -0.9f, 0.0f);
+		tglColor3f(0.0f, 0.5f, 1.0f);
+		tglVertex3f(0.3f, -0.7f, 0.0f);
+		tglVertex3f(-0.1f, -0.3f, 0.0f);
+		tglEnd();
+	}
+
+	static void renderSpans(bool simd, Frame &pixels) {
+		Common::WorkerPool::destroy();
+		ConfMan.setInt("worker_threads", 1, Common::ConfigManager::kApplicationDomain);
+
+		TinyGL::createContext(kWidth, kHeight, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 256, false, false);
+		TinyGL::enableSimdSpans(simd);
+
+		byte texels[64 * 64 * 4];
+		for (int y = 0; y < 64; ++y) {
+			for (int x = 0; x < 64; ++x) {
+				byte *texel = texels + (y * 64 + x) * 4;
+				texel[0] = x * 4;
+				texel[1] = 255 - y * 4;
+				texel[2] = ((x / 8 + y / 8) & 1) ? 255 : 32;
+				texel[3] = x * y / 16;
+			}
+		}
+		TGLuint textures[2];
+		tglGenTextures(2, textures);
+		const TGLint filters[] = { TGL_NEAREST, TGL_LINEAR };
+		for (int i = 0; i < 2; ++i) {
+			tglBindTexture(TGL_TEXTURE_2D, textures[i]);
+			tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, filters[i]);
+			tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MAG_FILTER, filters[i]);
+			tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 64, 64, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+		}
+
+		drawSpanScene(textures);
+		TinyGL::presentBuffer();
+		captureFrame(pixels);
+
+		tglDeleteTextures(2, textures);
+		TinyGL::destroyContext();
+	}
+
+	static bool framesMatch(const Common::Array<Frame> &expected, const Common::Array<Frame> &actual) {
+		if (expected.size() != actual.size())
+			return false;
+		for (uint i = 0; i < expected.size(); ++i) {
+			if (expected[i] != actual[i])
+				return false;
+		}
+		return true;
+	}
+
+	void checkTiledRendering(bool dirtyRects) {
+		Common::Array<Frame> single, tiled;
+		render(1, dirtyRects, single);
+		render(4, dirtyRects, tiled);
+		TS_ASSERT(framesMatch(single, tiled));
+
+		// The scene must actually draw something
+		TS_ASSERT(single.size() == kFrames && single[0][kWidth * kHeight / 2] != single[0][0]);
+	}
+#endif
+
+public:
+	void setUp() {
+#if TEST_TINYGL
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if TEST_TINYGL
+		Common::WorkerPool::destroy();
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kApplicationDomain);
+#endif
+	}
+
+	void test_tiled_rendering_matches_single_thread() {
+#if TEST_TINYGL
+		checkTiledRendering(false);
+#endif
+	}
+
+	void test_tiled_dirty_rects_match_single_thread() {
+#if TEST_TINYGL
+		checkTiledRendering(true);
+#endif
+	}
+
+	void test_simd_spans_match_portable_spans() {
+#if TEST_TINYGL
+		Frame portable, simd;
+		renderSpans(false, portable);
+		renderSpans(true, simd);
+		TS_ASSERT(portable == simd);
+
+		TS_ASSERT(portable.size() == kWidth * kHeight && portable[kWidth * kHeight / 2] != portable[0]);
+#endif
+	}
+};
@@ -0,0 +1,120 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/rect.h"
+#include "graphics/transparent_surface.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kSpriteWidth = 37,
+		kSpriteHeight = 23,
+		kTargetWidth = 64,
+		kTargetHeight = 48
+	};
+
+	typedef Common::Array<uint32> Pixels;
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	// Runs of transparent, opaque and translucent pixels, as in most sprites
+	static void fillSprite(Graphics::TransparentSurface &sprite) {
+		sprite.create(kSpriteWidth, kSpriteHeight, Graphics::TransparentSurface::getSupportedPixelFormat());
+		uint32 seed = 1;
+		for (int y = 0; y < sprite.h; ++y) {
+			uint32 *row = (uint32 *)sprite.getBasePtr(0, y);
+			for (int x = 0; x < sprite.w; ++x) {
+				const uint32 rgb = nextRandom(seed) << 8;
+				const int run = (x / 5 + y) % 3;
+				const byte alpha = run == 0 ? 0 : run == 1 ? 0xFF : nextRandom(seed) & 0xFF;
+				row[x] = rgb | alpha;
+			}
+		}
+	}
+
+	static void fillTarget(Graphics::Surface &target) {
+		target.create(kTargetWidth, kTargetHeight, Graphics::TransparentSurface::getSupportedPixelFormat());
+		uint32 seed = 2;
+		for (int y = 0; y < target.h; ++y) {
+			uint32 *row = (uint32 *)target.getBasePtr(0, y);
+			for (int x = 0; x < target.w; ++x)
+				row[x] = nextRandom(seed) ^ (nextRandom(seed) << 24);
+		}
+	}
+
+	static void blit(bool simd, Graphics::AlphaType alphaMode, uint color, Pixels &pixels) {
+		Graphics::TransparentSurface::enableSimd(simd);
+
+		Graphics::TransparentSurface sprite;
+		fillSprite(sprite);
+		sprite.setAlphaMode(alphaMode);
+		Graphics::Surface target;
+		fillTarget(target);
+
+		// All flips, partially off the target, and with parts of the sprite
+		const int flips[] = { Graphics::FLIP_NONE, Graphics::FLIP_H, Graphics::FLIP_V, Graphics::FLIP_HV };
+		for (int i = 0; i < ARRAYSIZE(flips); ++i) {
+			sprite.blit(target, i * 9 - 5, i * 7 - 3, flips[i], nullptr, color);
+			Common::Rect part(3, 2, 3 + 30, 2 + 18);
+			sprite.blit(target, 40 - i * 3, 30 + i, flips[i], &part, color);
+			sprite.blitClip(target, Common::Rect(10, 10, 50, 40), i * 5, 12, flips[i], nullptr, color);
+		}
+
+		for (int y = 0; y < target.h; ++y) {
+			const uint32 *row = (const uint32 *)target.getBasePtr(0, y);
+			for (int x = 0; x < target.w; ++x)
+				pixels.push_back(row[x]);
+		}
+		target.free();
+		sprite.free();
+	}
+
+	static void checkBlit(Graphics::AlphaType alphaMode, uint color) {
+		Pixels portable, simd;
+		blit(false, alphaMode, color, portable);
+		blit(true, alphaMode, color, simd);
+		TS_ASSERT(portable == simd);
+	}
+
+public:
+	void tearDown() {
+		Graphics::TransparentSurface::enableSimd(true);
+	}
+
+	void test_simd_opaque_blit_matches_portable() {
+		checkBlit(Graphics::ALPHA_OPAQUE, TS_ARGB(255, 255, 255, 255));
+	}
+
+	void test_simd_binary_blit_matches_portable() {
+		checkBlit(Graphics::ALPHA_BINARY, TS_ARGB(255, 255, 255, 255));
+	}
+
+	void test_simd_alpha_blit_matches_portable() {
+		checkBlit(Graphics::ALPHA_FULL, TS_ARGB(255, 255, 255, 255));
+	}
+
+	void test_simd_tinted_alpha_blit_matches_portable() {
+		checkBlit(Graphics::ALPHA_FULL, TS_ARGB(200, 255, 128, 30));
+		checkBlit(Graphics::ALPHA_FULL, TS_ARGB(255, 90, 255, 255));
+	}
+
+	void test_flipped_opaque_blit() {
+		Graphics::TransparentSurface sprite;
+		sprite.create(6, 1, Graphics::TransparentSurface::getSupportedPixelFormat());
+		sprite.setAlphaMode(Graphics::ALPHA_OPAQUE);
+		for (int x = 0; x < 6; ++x)
+			*(uint32 *)sprite.getBasePtr(x, 0) = TS_ARGB(0, x, 0, 0);
+
+		Graphics::Surface target;
+		target.create(6, 1, Graphics::TransparentSurface::getSupportedPixelFormat());
+		sprite.blit(target, 0, 0, Graphics::FLIP_H);
+		for (int x = 0; x < 6; ++x)
+			TS_ASSERT_EQUALS(*(const uint32 *)target.getBasePtr(x, 0), TS_ARGB(255, 5 - x, 0, 0));
+
+		target.free();
+		sprite.free();
+	}
+};
@@ -0,0 +1,180 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/worker-pool.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "../null_osystem.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+#if NULL_OSYSTEM_IS_AVAILABLE
+	enum {
+		kWidth = 320,
+		kHeight = 236,
+		kYPitch = kWidth + 8,
+		kUVPitch = kWidth / 2 + 4
+	};
+
+	enum Conversion {
+		k444,
+		k420,
+		k420Alpha,
+		k410
+	};
+
+	typedef Common::Array<byte> Plane;
+
+	static void fillPlane(Plane &plane, uint size, uint32 seed) {
+		plane.resize(size);
+		for (uint i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			plane[i] = seed >> 16;
+		}
+	}
+
+	static void convert(uint threads, Conversion conversion, const Graphics::PixelFormat &format, Plane &pixels) {
+		convert(threads, true, conversion, Graphics::YUVToRGBManager::kScaleITU, format, kWidth, pixels);
+	}
+
+	static void convert(uint threads, bool simd, Conversion conversion, Graphics::YUVToRGBManager::LuminanceScale scale,
+			const Graphics::PixelFormat &format, int width, Plane &pixels) {
+		Common::WorkerPool::destroy();
+		ConfMan.setInt("worker_threads", threads, Common::ConfigManager::kApplicationDomain);
+		YUVToRGBMan.enableSimd(simd);
+
+		// The 444 conversion uses full size chroma planes, the others need less
+		Plane y, u, v, a;
+		fillPlane(y, kYPitch * kHeight, 1);
+		fillPlane(u, kYPitch * kHeight, 2);
+		fillPlane(v, kYPitch * kHeight, 3);
+		fillPlane(a, kYPitch * kHeight, 4);
+
+		Graphics::Surface surface;
+		surface.create(width, kHeight, format);
+		switch (conversion) {
+		case k444:
+			YUVToRGBMan.convert444(&surface, scale, y.data(), u.data(), v.data(), width, kHeight, kYPitch, kYPitch);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(&surface, scale, y.data(), u.data(), v.data(), width, kHeight, kYPitch, kUVPitch);
+			break;
+		case k420Alpha:
+			YUVToRGBMan.convert420Alpha(&surface, scale, y.data(), u.data(), v.data(), a.data(), width, kHeight, kYPitch, kUVPitch);
+			break;
+		case k410:
+			YUVToRGBMan.convert410(&surface, scale, y.data(), u.data(), v.data(), width, kHeight, kYPitch, kUVPitch);
+			break;
+		}
+
+		const byte *src = (const byte *)surface.getPixels();
+		pixels = Plane(src, surface.pitch * surface.h);
+		surface.free();
+	}
+
+	static void checkBands(Conversion conversion) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		for (int i = 0; i < ARRAYSIZE(formats); ++i) {
+			Plane serial, banded;
+			convert(1, conversion, formats[i], serial);
+			convert(4, conversion, formats[i], banded);
+			TS_ASSERT(serial == banded);
+		}
+	}
+
+	// The SSE2/NEON conversion must give exactly the same pixels as the lookup
+	// tables, including the columns past the last multiple of eight pixels
+	static void checkSimd(Conversion conversion) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+		const Graphics::YUVToRGBManager::LuminanceScale scales[] = {
+			Graphics::YUVToRGBManager::kScaleFull,
+			Graphics::YUVToRGBManager::kScaleITU
+		};
+		const int widths[] = { kWidth, kWidth - 4 };
+
+		for (int i = 0; i < ARRAYSIZE(formats); ++i) {
+			for (int j = 0; j < ARRAYSIZE(scales); ++j) {
+				for (int k = 0; k < ARRAYSIZE(widths); ++k) {
+					Plane lookup, simd;
+					convert(1, false, conversion, scales[j], formats[i], widths[k], lookup);
+					convert(1, true, conversion, scales[j], formats[i], widths[k], simd);
+					TS_ASSERT(lookup == simd);
+				}
+			}
+		}
+	}
+#endif
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::WorkerPool::destroy();
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kApplicationDomain);
+		YUVToRGBMan.enableSimd(true);
+#endif
+	}
+
+	void test_banded_444_matches_serial() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		checkBands(k444);
+#endif
+	}
+
+	void test_banded_420_matches_serial() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		checkBands(k420);
+#endif
+	}
+
+	void test_banded_420_alpha_matches_serial() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		checkBands(k420Alpha);
+#endif
+	}
+
+	void test_banded_410_matches_serial() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		checkBands(k410);
+#endif
+	}
+
+	void test_simd_444_matches_lookup() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		checkSimd(k444);
+#endif
+	}
+
+	void test_simd_420_matches_lookup() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		checkSimd(k420);
+#endif
+	}
+
+	void test_simd_420_alpha_matches_lookup() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		checkSimd(k420Alpha);
+#endif
+	}
+
+	void test_simd_410_matches_lookup() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		checkSimd(k410);
+#endif
+	}
+};
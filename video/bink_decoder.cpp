@@ -159,7 +159,29 @@ void BinkDecoder::readNextPacket() {
 	if (videoTrack->endOfTrack())
 		return;
 
-	VideoFrame &frame = _frames[videoTrack->getCurFrame() + 1];
+	decodeFrame(nullptr);
+}
+
+bool BinkDecoder::decodeFrameAhead(Graphics::Surface &surface) {
+	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
+
+	if (videoTrack->endOfDecoding())
+		return false;
+
+	decodeFrame(&surface);
+	return true;
+}
+
+void BinkDecoder::presentFrameAhead(Graphics::Surface &surface) {
+	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
+
+	videoTrack->presentFrame(surface);
+}
+
+void BinkDecoder::decodeFrame(Graphics::Surface *surface) {
+	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
+
+	VideoFrame &frame = _frames[videoTrack->getDecodedFrame() + 1];
 
 	if (!_bink->seek(frame.offset))
 		error("Bad bink seek");
@@ -205,7 +227,10 @@ void BinkDecoder::readNextPacket() {
 	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
 			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
 
-	videoTrack->decodePacket(frame);
+	if (surface)
+		videoTrack->decodePacket(frame, *surface);
+	else
+		videoTrack->decodePacket(frame);
 
 	delete frame.bits;
 	frame.bits = 0;
@@ -244,6 +269,7 @@ BinkDecoder::AudioInfo::~AudioInfo() {
 BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
 		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
 	_curFrame = -1;
+	_decodedFrame = -1;
 
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
@@ -449,6 +475,7 @@ bool BinkDecoder::BinkVideoTrack::rewind() {
 	}
 
 	_curFrame = -1;
+	_decodedFrame = -1;
 
 	// Re-initialize the video with solid green
 	memset(_curPlanes[0],   0, _yBlockWidth  * 8 * _yBlockHeight  * 8);
@@ -464,8 +491,20 @@ bool BinkDecoder::BinkVideoTrack::rewind() {
 }
 
 void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
+	decodePacket(frame, _surface);
+	_curFrame = _decodedFrame;
+}
+
+void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame, Graphics::Surface &surface) {
 	assert(frame.bits);
 
+	if (!surface.getPixels()) {
+		// Frames decoded ahead have the same size as our own
+		surface.create(_surfaceWidth, _surfaceHeight, _surface.format);
+		surface.w = _surface.w;
+		surface.h = _surface.h;
+	}
+
 	if (_hasAlpha) {
 		if (_id == kBIKiID)
 			frame.bits->skip(32);
@@ -490,11 +529,11 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	// to allow for odd-sized videos.
 	if (_hasAlpha) {
 		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-		YUVToRGBMan.convert420Alpha(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
+		YUVToRGBMan.convert420Alpha(&surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
 				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
 	} else {
 		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-		YUVToRGBMan.convert420(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
+		YUVToRGBMan.convert420(&surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
 				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
 	}
 
@@ -502,6 +541,17 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	for (int i = 0; i < 4; i++)
 		SWAP(_curPlanes[i], _oldPlanes[i]);
 
+	_decodedFrame++;
+}
+
+void BinkDecoder::BinkVideoTrack::presentFrame(Graphics::Surface &surface) {
+	assert(_curFrame < _decodedFrame);
+	assert(surface.pitch == _surface.pitch && surface.h == _surface.h);
+
+	void *pixels = _surface.getPixels();
+	_surface.setPixels(surface.getPixels());
+	surface.setPixels(pixels);
+
 	_curFrame++;
 }
 
@@ -1030,9 +1080,13 @@ void BinkDecoder::BinkVideoTrack::readRuns(VideoFrame &video, Bundle &bundle) {
 		memset(bundle.curDec, v, n);
 		bundle.curDec += n;
 
-	} else
-		while (bundle.curDec < decEnd)
-			*bundle.curDec++ = getHuffmanSymbol(video, bundle.huffman);
+	} else {
+		_huffman[bundle.huffman.index]->getSymbols(*video.bits, bundle.curDec, n);
+		while (bundle.curDec < decEnd) {
+			*bundle.curDec = bundle.huffman.symbols[*bundle.curDec];
+			bundle.curDec++;
+		}
+	}
 }
 
 void BinkDecoder::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bundle) {
@@ -81,6 +81,10 @@ protected:
 	bool seekIntern(const Audio::Timestamp &time);
 	uint32 findKeyFrame(uint32 frame) const;
 
+	bool supportsLookAhead() const { return true; }
+	bool decodeFrameAhead(Graphics::Surface &surface);
+	void presentFrameAhead(Graphics::Surface &surface);
+
 private:
 	static const int kAudioChannelsMax  = 2;
 	static const int kAudioBlockSizeMax = (kAudioChannelsMax << 11);
@@ -157,10 +161,19 @@ private:
 		bool isSeekable() const  override{ return true; }
 		bool seek(const Audio::Timestamp &time) override { return true; }
 		bool rewind() override;
-		void setCurFrame(uint32 frame) { _curFrame = frame; }
+		void setCurFrame(uint32 frame) { _curFrame = _decodedFrame = frame; }
+
+		/** Get the last decoded frame, which is ahead of the current one when decoding ahead. */
+		int getDecodedFrame() const { return _decodedFrame; }
+		/** Have all frames been decoded? */
+		bool endOfDecoding() const { return _decodedFrame >= _frameCount - 1; }
 
-		/** Decode a video packet. */
+		/** Decode a video packet into the frame returned by decodeNextFrame(). */
 		void decodePacket(VideoFrame &frame);
+		/** Decode a video packet into another surface, to be presented later. */
+		void decodePacket(VideoFrame &frame, Graphics::Surface &surface);
+		/** Make a frame decoded into another surface the current one. */
+		void presentFrame(Graphics::Surface &surface);
 
 		Common::Rational getFrameRate() const override { return _frameRate; }
 
@@ -239,6 +252,7 @@ private:
 		};
 
 		int _curFrame;
+		int _decodedFrame;
 		int _frameCount;
 
 		Graphics::Surface _surface;
@@ -370,6 +384,13 @@ private:
 	Common::Array<VideoFrame> _frames;      ///< All video frames.
 
 	void initAudioTrack(AudioInfo &audio);
+
+	/**
+	 * Decode the audio packets and the video packet of the frame after the
+	 * last decoded one. The video frame goes into @p surface if given, or
+	 * else becomes the current frame of the video track.
+	 */
+	void decodeFrame(Graphics::Surface *surface);
 };
 
 } // End of namespace Video
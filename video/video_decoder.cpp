@@ -24,11 +24,17 @@
 #include "audio/audiostream.h"
 #include "audio/mixer.h" // for kMaxChannelVolume
 
+#include "common/atomic.h"
+#include "common/debug.h"
 #include "common/rational.h"
 #include "common/file.h"
 #include "common/system.h"
+#include "common/thread.h"
+#include "common/worker-pool.h"
 
 #include "graphics/palette.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
 
 namespace Video {
 
@@ -49,6 +55,16 @@ VideoDecoder::VideoDecoder() {
 	_mainAudioTrack = 0;
 	_canSetDither = true;
 
+	_lookAheadSize = 0;
+	_lookAheadRead = 0;
+	_lookAheadWrite = 0;
+	_lookAheadReady = 0;
+	_lookAheadEnd = 0;
+	_lookAheadQuit = 0;
+	_lookAheadThread = 0;
+	_lookAheadFree = 0;
+	_lookAheadDecoded = 0;
+
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
 
@@ -56,7 +72,23 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	// Subclasses stop the look-ahead in close(), since it calls into them
+	assert(!_lookAheadThread);
+	freeLookAheadFrames();
+}
+
 void VideoDecoder::close() {
+	flushLookAhead();
+	freeLookAheadFrames();
+	_lookAheadSize = 0;
+
+	if (_decodeStats.frames) {
+		debug(2, "VideoDecoder: Decoded %u frames, %u us on average, %u us at most; %u frames were due before the look-ahead had them",
+			_decodeStats.frames, (uint32)(_decodeStats.totalMicros / _decodeStats.frames), _decodeStats.maxMicros, _decodeStats.lookAheadEmpty);
+	}
+	_decodeStats = DecodeStats();
+
 	if (isPlaying())
 		stop();
 
@@ -187,7 +219,12 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 	_canSetDither = false;
 
-	readNextPacket();
+	const uint64 startMicros = g_system->getMicros();
+	uint32 decodeMicros = 0;
+	bool decodedAhead = readFrameAhead(decodeMicros);
+
+	if (!decodedAhead)
+		readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
 	// any frame available for us to display.
@@ -196,6 +233,15 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 
 	const Graphics::Surface *frame = _nextVideoTrack->decodeNextFrame();
 
+	if (frame) {
+		if (!decodedAhead)
+			decodeMicros = g_system->getMicros() - startMicros;
+
+		_decodeStats.frames++;
+		_decodeStats.totalMicros += decodeMicros;
+		_decodeStats.maxMicros = MAX(_decodeStats.maxMicros, decodeMicros);
+	}
+
 	if (_nextVideoTrack->hasDirtyPalette()) {
 		_palette = _nextVideoTrack->getPalette();
 		_dirtyPalette = true;
@@ -322,6 +368,8 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	flushLookAhead();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -356,6 +404,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	flushLookAhead();
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
@@ -717,6 +767,9 @@ bool VideoDecoder::StreamFileAudioTrack::loadFromFile(const Common::String &base
 }
 
 void VideoDecoder::addTrack(Track *track, bool isExternal) {
+	// The look-ahead thread must not see the track lists change
+	stopLookAhead();
+
 	_tracks.push_back(track);
 
 	if (isExternal)
@@ -847,6 +900,158 @@ void VideoDecoder::setEndFrame(uint frame) {
 	setEndTime(time);
 }
 
+bool VideoDecoder::setLookAhead(uint frames) {
+	if (frames && !supportsLookAhead())
+		return false;
+
+	// The queue is resized once the frames in it have been displayed
+	stopLookAhead();
+	_lookAheadSize = frames;
+	return true;
+}
+
+bool VideoDecoder::startLookAhead() {
+	assert(!_lookAheadThread && !_lookAheadReady);
+
+	if (!_lookAheadSize || Common::atomicLoad(&_lookAheadEnd))
+		return false;
+
+	_lookAheadFree = g_system->createSemaphore();
+	_lookAheadDecoded = g_system->createSemaphore();
+	if (!_lookAheadFree || !_lookAheadDecoded) {
+		delete _lookAheadFree;
+		delete _lookAheadDecoded;
+		_lookAheadFree = _lookAheadDecoded = 0;
+		_lookAheadSize = 0;
+		return false;
+	}
+
+	if (_lookAheadFrames.size() != _lookAheadSize) {
+		freeLookAheadFrames();
+		_lookAheadFrames.resize(_lookAheadSize);
+		for (uint i = 0; i < _lookAheadSize; i++) {
+			_lookAheadFrames[i].surface = new Graphics::Surface();
+			_lookAheadFrames[i].decodeMicros = 0;
+		}
+	}
+
+	_lookAheadRead = _lookAheadWrite = 0;
+	for (uint i = 0; i < _lookAheadSize; i++)
+		_lookAheadFree->post();
+
+	// Singletons are not created in a thread-safe way, so create the ones
+	// decoders use on the look-ahead thread here
+	Common::WorkerPool::instance();
+	Graphics::YUVToRGBManager::instance();
+
+	Common::atomicStore(&_lookAheadQuit, 0);
+	_lookAheadThread = g_system->createThread(lookAheadMain, this);
+	if (!_lookAheadThread) {
+		delete _lookAheadFree;
+		delete _lookAheadDecoded;
+		_lookAheadFree = _lookAheadDecoded = 0;
+		_lookAheadSize = 0;
+		return false;
+	}
+
+	return true;
+}
+
+void VideoDecoder::lookAheadMain(void *param) {
+	VideoDecoder *decoder = (VideoDecoder *)param;
+
+	for (;;) {
+		decoder->_lookAheadFree->wait();
+		if (Common::atomicLoad(&decoder->_lookAheadQuit))
+			return;
+
+		LookAheadFrame &frame = decoder->_lookAheadFrames[decoder->_lookAheadWrite];
+		const uint64 startMicros = g_system->getMicros();
+		if (!decoder->decodeFrameAhead(*frame.surface))
+			break;
+		frame.decodeMicros = g_system->getMicros() - startMicros;
+
+		decoder->_lookAheadWrite = (decoder->_lookAheadWrite + 1) % decoder->_lookAheadFrames.size();
+		Common::atomicAdd(&decoder->_lookAheadReady, 1);
+		decoder->_lookAheadDecoded->post();
+	}
+
+	// Wake up decodeNextFrame() if it is waiting for a frame which will not come
+	Common::atomicStore(&decoder->_lookAheadEnd, 1);
+	decoder->_lookAheadDecoded->post();
+}
+
+bool VideoDecoder::readFrameAhead(uint32 &decodeMicros) {
+	if (!_lookAheadThread) {
+		// Frames decoded before the thread was stopped are displayed first,
+		// the decoding state is ahead of the displayed frame until then
+		if (!Common::atomicLoad(&_lookAheadReady) && !startLookAhead())
+			return false;
+	}
+
+	if (_lookAheadThread) {
+		if (!Common::atomicLoad(&_lookAheadReady)) {
+			if (Common::atomicLoad(&_lookAheadEnd)) {
+				stopLookAhead();
+				return false;
+			}
+
+			_decodeStats.lookAheadEmpty++;
+		}
+
+		// Posted for every frame, and once more if the thread runs out of frames
+		_lookAheadDecoded->wait();
+
+		if (!Common::atomicLoad(&_lookAheadReady)) {
+			stopLookAhead();
+			return false;
+		}
+	}
+
+	LookAheadFrame &frame = _lookAheadFrames[_lookAheadRead];
+	presentFrameAhead(*frame.surface);
+	decodeMicros = frame.decodeMicros;
+
+	_lookAheadRead = (_lookAheadRead + 1) % _lookAheadFrames.size();
+	Common::atomicAdd(&_lookAheadReady, -1);
+	if (_lookAheadThread)
+		_lookAheadFree->post();
+
+	return true;
+}
+
+void VideoDecoder::stopLookAhead() {
+	if (!_lookAheadThread)
+		return;
+
+	// Wake up the thread if it is waiting for the queue to drain
+	Common::atomicStore(&_lookAheadQuit, 1);
+	_lookAheadFree->post();
+	delete _lookAheadThread;
+	_lookAheadThread = 0;
+
+	delete _lookAheadFree;
+	delete _lookAheadDecoded;
+	_lookAheadFree = _lookAheadDecoded = 0;
+}
+
+void VideoDecoder::flushLookAhead() {
+	stopLookAhead();
+
+	_lookAheadRead = _lookAheadWrite = 0;
+	Common::atomicStore(&_lookAheadReady, 0);
+	Common::atomicStore(&_lookAheadEnd, 0);
+}
+
+void VideoDecoder::freeLookAheadFrames() {
+	for (uint i = 0; i < _lookAheadFrames.size(); i++) {
+		_lookAheadFrames[i].surface->free();
+		delete _lookAheadFrames[i].surface;
+	}
+
+	_lookAheadFrames.clear();
+}
+
 VideoDecoder::Track *VideoDecoder::getTrack(uint track) {
 	if (track >= _internalTracks.size())
 		return 0;
@@ -941,6 +1146,8 @@ bool VideoDecoder::hasAudio() const {
 }
 
 void VideoDecoder::eraseTrack(Track *track) {
+	stopLookAhead();
+
 	for (uint idx = 0; idx < _externalTracks.size(); ++idx) {
 		if (_externalTracks[idx] == track)
 			_externalTracks.remove_at(idx);
@@ -38,6 +38,8 @@ class SeekableAudioStream;
 
 namespace Common {
 class SeekableReadStream;
+class SemaphoreInternal;
+class ThreadInternal;
 }
 
 namespace Graphics {
@@ -52,7 +54,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -396,6 +398,40 @@ public:
 	 */
 	bool setDitheringPalette(const byte *palette);
 
+	/**
+	 * Let the decoder decode up to the given number of frames ahead of the
+	 * one being displayed, on a background thread, so that frames which take
+	 * long to decode do not hold up the engine.
+	 *
+	 * Frames are still displayed at the times given by the tracks, so this
+	 * does not change when decodeNextFrame() should be called. Decoders
+	 * which do not support this keep decoding frames in decodeNextFrame().
+	 *
+	 * This setting remains until close() is called.
+	 *
+	 * @param frames The number of frames to decode ahead, or 0 to decode
+	 *               each frame when it is needed (the default)
+	 * @return true on success, false if the decoder cannot decode ahead
+	 */
+	bool setLookAhead(uint frames);
+
+	/**
+	 * Statistics on the time spent decoding frames.
+	 */
+	struct DecodeStats {
+		uint32 frames;        ///< Number of frames decoded
+		uint64 totalMicros;   ///< Time spent decoding them, in microseconds
+		uint32 maxMicros;     ///< Longest time spent decoding one frame, in microseconds
+		uint32 lookAheadEmpty; ///< Number of frames which were due before the look-ahead had decoded them
+
+		DecodeStats() : frames(0), totalMicros(0), maxMicros(0), lookAheadEmpty(0) {}
+	};
+
+	/**
+	 * Get the statistics on the frames decoded since the video was loaded.
+	 */
+	const DecodeStats &getDecodeStats() const { return _decodeStats; }
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -936,6 +972,48 @@ protected:
 	 */
 	virtual AudioTrack *getAudioTrack(int index) { return 0; }
 
+	/**
+	 * Can this decoder decode frames ahead with decodeFrameAhead()?
+	 *
+	 * @see setLookAhead()
+	 */
+	virtual bool supportsLookAhead() const { return false; }
+
+	/**
+	 * Decode the next frame, and the audio that goes with it, into the given
+	 * surface. This is called on the look-ahead thread, so it must only
+	 * change the decoding state, and not the frame which is being displayed.
+	 *
+	 * The surface is empty on the first call and keeps its contents between
+	 * calls; it is freed by this class.
+	 *
+	 * @return false if there are no more frames to decode, true otherwise
+	 */
+	virtual bool decodeFrameAhead(Graphics::Surface &surface) { return false; }
+
+	/**
+	 * Display a frame decoded by decodeFrameAhead(), i.e. make it the frame
+	 * the video track returns next. This is called instead of readNextPacket().
+	 *
+	 * The surface may be swapped with the track's own, as long as it keeps
+	 * the same size and format.
+	 */
+	virtual void presentFrameAhead(Graphics::Surface &surface) {}
+
+	/**
+	 * Stop the look-ahead thread, keeping the frames it has decoded. These
+	 * are still displayed before decoding continues on either thread.
+	 */
+	void stopLookAhead();
+
+	/**
+	 * Stop the look-ahead thread and discard the frames it has decoded.
+	 *
+	 * This is used before seeking and rewinding, which reset the decoding
+	 * state to the frame which is displayed next.
+	 */
+	void flushLookAhead();
+
 private:
 	// Tracks owned by this VideoDecoder
 	TrackList _tracks;
@@ -978,6 +1056,32 @@ private:
 	Audio::Mixer::SoundType _soundType;
 
 	AudioTrack *_mainAudioTrack;
+
+	/** A frame decoded ahead. */
+	struct LookAheadFrame {
+		Graphics::Surface *surface;
+		uint32 decodeMicros;
+	};
+
+	// Look-ahead: the queue is a ring of frames, filled by the look-ahead
+	// thread and emptied by decodeNextFrame()
+	uint _lookAheadSize;
+	Common::Array<LookAheadFrame> _lookAheadFrames;
+	uint _lookAheadRead;
+	uint _lookAheadWrite;
+	volatile int _lookAheadReady; ///< Number of decoded frames in the queue
+	volatile int _lookAheadEnd;   ///< decodeFrameAhead() ran out of frames
+	volatile int _lookAheadQuit;
+	Common::ThreadInternal *_lookAheadThread;
+	Common::SemaphoreInternal *_lookAheadFree;    ///< Posted when a frame of the queue can be decoded into
+	Common::SemaphoreInternal *_lookAheadDecoded; ///< Posted when a frame was decoded, and when the thread ran out of frames
+
+	DecodeStats _decodeStats;
+
+	static void lookAheadMain(void *param);
+	bool startLookAhead();
+	bool readFrameAhead(uint32 &decodeMicros);
+	void freeLookAheadFrames();
 };
 
 } // End of namespace Video